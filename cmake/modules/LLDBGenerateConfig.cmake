@@ -25,6 +25,18 @@ check_cxx_source_compiles("
 
 check_library_exists(compression compression_encode_buffer "" HAVE_LIBCOMPRESSION)
 
+if(LLVM_ENABLE_ZLIB)
+  check_include_file(zlib.h HAVE_ZLIB_H)
+  if(HAVE_ZLIB_H)
+    check_library_exists(z compress2 "" HAVE_LIBZ)
+  endif()
+endif()
+
+check_include_file(lzma.h HAVE_LZMA_H)
+if(HAVE_LZMA_H)
+  check_library_exists(lzma lzma_stream_buffer_decode "" HAVE_LIBLZMA)
+endif()
+
 # These checks exist in LLVM's configuration, so I want to match the LLVM names
 # so that the check isn't duplicated, but we translate them into the LLDB names
 # so that I don't have to change all the uses at the moment.
@@ -97,6 +97,22 @@ public:
 
   lldb::SBThread GetSelectedThread() const;
 
+  //------------------------------------------------------------------
+  /// Get the backtraces of all threads, unwinding several threads at
+  /// a time.
+  ///
+  /// @param[in] max_frames
+  ///     The most frames to get for each thread, UINT32_MAX for all of
+  ///     them.
+  ///
+  /// @return
+  ///     An array with a dictionary for each thread, in thread list
+  ///     order, with the "tid", "index" and "name" of the thread and
+  ///     its "frames". Each frame has its "index" and "pc", and the
+  ///     "module", "function", "file" and "line" that are known.
+  //------------------------------------------------------------------
+  lldb::SBStructuredData GetAllBacktraces(uint32_t max_frames = UINT32_MAX);
+
   //------------------------------------------------------------------
   // Function for lazily creating a thread using the current OS
   // plug-in. This function will be removed in the future when there
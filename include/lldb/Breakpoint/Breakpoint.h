@@ -27,6 +27,7 @@
 #include "lldb/Breakpoint/Stoppoint.h"
 #include "lldb/Core/Event.h"
 #include "lldb/Core/SearchFilter.h"
+#include "lldb/Target/Statistics.h"
 #include "lldb/Utility/StringList.h"
 #include "lldb/Utility/StructuredData.h"
 
@@ -524,6 +525,12 @@ public:
   //------------------------------------------------------------------
   size_t GetNumLocations() const;
 
+  //------------------------------------------------------------------
+  /// Return the time spent resolving this breakpoint's locations, as
+  /// reported by the "statistics dump" command.
+  //------------------------------------------------------------------
+  StatsDuration &GetResolveTime() { return m_resolve_time; }
+
   //------------------------------------------------------------------
   /// Put a description of this breakpoint into the stream \a s.
   ///
@@ -796,6 +803,7 @@ private:
   // separately from the locations hit counts, since locations can go away when
   // their backing library gets unloaded, and we would lose hit counts.
   BreakpointName::Permissions m_permissions;
+  StatsDuration m_resolve_time;
 
   void SendBreakpointChangedEvent(lldb::BreakpointEventType eventKind);
 
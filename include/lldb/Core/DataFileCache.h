@@ -0,0 +1,152 @@
+//===-- DataFileCache.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_DataFileCache_h_
+#define liblldb_DataFileCache_h_
+
+// C Includes
+// C++ Includes
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Other libraries and framework includes
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+
+// Project includes
+#include "lldb/Utility/FileSpec.h"
+#include "lldb/Utility/Status.h"
+#include "lldb/Utility/UUID.h"
+#include "lldb/lldb-defines.h"
+#include "lldb/lldb-forward.h"
+#include "lldb/lldb-types.h"
+
+namespace lldb_private {
+
+class DataExtractor;
+class Stream;
+
+//----------------------------------------------------------------------
+/// @class CacheSignature DataFileCache.h "lldb/Core/DataFileCache.h"
+/// @brief Identifies the exact module contents a cache file was built
+/// from.
+///
+/// Every cache file starts with a signature. When a cache file is
+/// loaded, its signature is compared with the signature of the module
+/// being debugged and the cache file is discarded if they differ, so
+/// a rebuilt binary never picks up a stale cache entry.
+//----------------------------------------------------------------------
+struct CacheSignature {
+  CacheSignature() = default;
+
+  explicit CacheSignature(Module &module);
+
+  /// The signature of an object file that isn't the main object file of
+  /// its module, like a separate debug info file.
+  explicit CacheSignature(ObjectFile &objfile);
+
+  bool IsValid() const { return m_uuid.IsValid() || m_mod_time != 0; }
+
+  bool operator==(const CacheSignature &rhs) const {
+    return m_uuid == rhs.m_uuid && m_mod_time == rhs.m_mod_time &&
+           m_obj_mod_time == rhs.m_obj_mod_time;
+  }
+
+  bool operator!=(const CacheSignature &rhs) const { return !(*this == rhs); }
+
+  void Encode(Stream &strm) const;
+
+  bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr);
+
+  UUID m_uuid;
+  /// Modification time of the module file in seconds since the epoch.
+  uint64_t m_mod_time = 0;
+  /// Modification time of the object within the module file (for
+  /// .a archive members) in seconds since the epoch.
+  uint64_t m_obj_mod_time = 0;
+};
+
+//----------------------------------------------------------------------
+/// @class DataFileCache DataFileCache.h "lldb/Core/DataFileCache.h"
+/// @brief A directory of cache files that are looked up by key.
+///
+/// Cache files are written atomically (to a temporary file that is then
+/// renamed into place) so concurrent debug sessions never observe a
+/// partially written file, and they are read back by memory mapping
+/// them.
+//----------------------------------------------------------------------
+class DataFileCache {
+public:
+  DataFileCache(const FileSpec &cache_dir);
+
+  //------------------------------------------------------------------
+  /// Get the global index cache, or nullptr if the
+  /// "symbols.enable-index-cache" setting is off.
+  //------------------------------------------------------------------
+  static DataFileCache *GetIndexCache();
+
+  //------------------------------------------------------------------
+  /// Get the directory used by the global index cache, whether or not
+  /// the index cache is currently enabled.
+  //------------------------------------------------------------------
+  static FileSpec GetIndexCacheDirectory();
+
+  //------------------------------------------------------------------
+  /// Build a cache key that is unique to \a module and \a kind.
+  ///
+  /// The key includes the module basename, the object name for .a
+  /// archive members and the UUID (or a hash of the path when there is
+  /// no UUID) so that different modules never share cache files.
+  //------------------------------------------------------------------
+  static std::string GetModuleCacheKey(Module &module, llvm::StringRef kind);
+
+  //------------------------------------------------------------------
+  /// Memory map the cache file for \a key.
+  ///
+  /// @return
+  ///     The file contents, or an empty shared pointer if there is no
+  ///     cache file for \a key.
+  //------------------------------------------------------------------
+  lldb::DataBufferSP GetCachedData(llvm::StringRef key);
+
+  bool SetCachedData(llvm::StringRef key, llvm::ArrayRef<uint8_t> data);
+
+  Status RemoveCacheFile(llvm::StringRef key);
+
+  //------------------------------------------------------------------
+  /// Call \a callback with the path and size of each cache file until
+  /// it returns false.
+  ///
+  /// @return
+  ///     The number of cache files that were visited.
+  //------------------------------------------------------------------
+  size_t ForEachCacheFile(
+      std::function<bool(const FileSpec &file, uint64_t size)> const &callback);
+
+  //------------------------------------------------------------------
+  /// Remove every cache file in the cache directory.
+  //------------------------------------------------------------------
+  Status Purge();
+
+  const FileSpec &GetCacheDirectory() const { return m_cache_dir; }
+
+protected:
+  FileSpec GetCacheFilePath(llvm::StringRef key) const;
+
+  FileSpec m_cache_dir;
+  std::mutex m_mutex;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DataFileCache);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_DataFileCache_h_
@@ -305,6 +305,8 @@ public:
 
   bool SetTabSize(uint32_t tab_size);
 
+  uint32_t GetTaskPoolThreadCount() const;
+
   bool GetEscapeNonPrintables() const;
 
   bool GetNotifyVoid() const;
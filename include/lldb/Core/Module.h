@@ -15,6 +15,7 @@
 #include "lldb/Symbol/SymbolContextScope.h"
 #include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Target/PathMappingList.h"
+#include "lldb/Target/Statistics.h"
 #include "lldb/Utility/ArchSpec.h"
 #include "lldb/Utility/ConstString.h" // for ConstString
 #include "lldb/Utility/FileSpec.h"
@@ -630,6 +631,14 @@ public:
     m_mod_time = mod_time;
   }
 
+  //------------------------------------------------------------------
+  /// The time spent parsing the symbol table of this module and building
+  /// its name indexes, as reported by the "statistics dump" command.
+  //------------------------------------------------------------------
+  StatsDuration &GetSymtabParseTime() { return m_symtab_parse_time; }
+
+  StatsDuration &GetSymtabIndexTime() { return m_symtab_index_time; }
+
   //------------------------------------------------------------------
   /// Tells whether this module is capable of being the main executable
   /// for a process.
@@ -1170,6 +1179,8 @@ protected:
   std::atomic<bool> m_did_load_objfile{false};
   std::atomic<bool> m_did_load_symbol_vendor{false};
   std::atomic<bool> m_did_parse_uuid{false};
+  StatsDuration m_symtab_parse_time;
+  StatsDuration m_symtab_index_time;
   mutable bool m_file_has_changed : 1,
       m_first_file_changed_log : 1; /// See if the module was modified after it
                                     /// was initially opened.
@@ -82,6 +82,11 @@ public:
   FileSpec GetClangModulesCachePath() const;
   bool SetClangModulesCachePath(llvm::StringRef path);
   bool GetEnableExternalLookup() const;
+  bool GetEnableIndexCache() const;
+  bool SetEnableIndexCache(bool enable);
+  FileSpec GetIndexCachePath() const;
+  bool SetIndexCachePath(llvm::StringRef path);
+  uint64_t GetDWARFDIEMemoryLimit() const;
 }; 
 
 //----------------------------------------------------------------------
@@ -219,7 +219,8 @@ public:
   GetObjectFileCreateMemoryCallbackForPluginName(const ConstString &name);
 
   static Status SaveCore(const lldb::ProcessSP &process_sp,
-                         const FileSpec &outfile);
+                         const FileSpec &outfile,
+                         lldb::SaveCoreStyle core_style = lldb::eSaveCoreFull);
 
   //------------------------------------------------------------------
   // ObjectContainer
@@ -841,6 +841,34 @@ public:
 
   void Append(const Entry &entry) { m_entries.push_back(entry); }
 
+  // Insert an item into a sorted list and combine it with the entries
+  // right before and after it if they adjoin it and have equal data.
+  void InsertAndCombine(const Entry &entry) {
+    typename Collection::iterator pos = std::upper_bound(
+        m_entries.begin(), m_entries.end(), entry, BaseLessThan);
+    if (pos != m_entries.begin()) {
+      typename Collection::iterator prev = pos - 1;
+      if (prev->GetRangeEnd() == entry.GetRangeBase() &&
+          prev->data == entry.data) {
+        prev->SetRangeEnd(entry.GetRangeEnd());
+        if (pos != m_entries.end() &&
+            prev->GetRangeEnd() == pos->GetRangeBase() &&
+            prev->data == pos->data) {
+          prev->SetRangeEnd(pos->GetRangeEnd());
+          m_entries.erase(pos);
+        }
+        return;
+      }
+    }
+    if (pos != m_entries.end() && entry.GetRangeEnd() == pos->GetRangeBase() &&
+        entry.data == pos->data) {
+      pos->SetByteSize(pos->GetRangeEnd() - entry.GetRangeBase());
+      pos->SetRangeBase(entry.GetRangeBase());
+      return;
+    }
+    m_entries.insert(pos, entry);
+  }
+
   void Sort() {
     if (m_entries.size() > 1)
       std::stable_sort(m_entries.begin(), m_entries.end());
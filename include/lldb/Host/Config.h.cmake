@@ -26,4 +26,8 @@
 
 #cmakedefine HAVE_LIBCOMPRESSION
 
+#cmakedefine HAVE_LIBZ 1
+
+#cmakedefine HAVE_LIBLZMA 1
+
 #endif // #ifndef LLDB_HOST_CONFIG_H
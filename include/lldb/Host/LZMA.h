@@ -0,0 +1,49 @@
+//===-- LZMA.h --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_Host_LZMA_h_
+#define liblldb_Host_LZMA_h_
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Error.h"
+
+namespace lldb_private {
+
+namespace lzma {
+
+//----------------------------------------------------------------------
+/// @return
+///     True if lldb was built with liblzma, so that uncompress() can
+///     be used.
+//----------------------------------------------------------------------
+bool isAvailable();
+
+//----------------------------------------------------------------------
+/// Get the size of the data in the xz compressed \a InputBuffer once it
+/// is uncompressed, from the index at the end of the stream.
+//----------------------------------------------------------------------
+llvm::Expected<uint64_t>
+getUncompressedSize(llvm::ArrayRef<uint8_t> InputBuffer);
+
+//----------------------------------------------------------------------
+/// Uncompress the xz compressed \a InputBuffer into \a Uncompressed,
+/// which is resized to the size of the uncompressed data. Fails without
+/// allocating anything if the stream claims to uncompress to more than
+/// \a MaxUncompressedSize bytes.
+//----------------------------------------------------------------------
+llvm::Error uncompress(llvm::ArrayRef<uint8_t> InputBuffer,
+                       llvm::SmallVectorImpl<uint8_t> &Uncompressed,
+                       uint64_t MaxUncompressedSize);
+
+} // namespace lzma
+
+} // namespace lldb_private
+
+#endif // liblldb_Host_LZMA_h_
@@ -48,11 +48,15 @@ public:
   // AddTask for each task and then call wait() on each returned future.
   template <typename... T> static void RunTasks(T &&... tasks);
 
+  // Set the number of worker threads in the pool. Zero means one worker per
+  // hardware thread.
+  static void SetThreadCount(unsigned thread_count);
+
+  static unsigned GetThreadCount();
+
 private:
   TaskPool() = delete;
 
-  template <typename... T> struct RunTaskImpl;
-
   static void AddTaskImpl(std::function<void()> &&task_fn);
 };
 
@@ -68,29 +72,23 @@ TaskPool::AddTask(F &&f, Args &&... args) {
   return task_sp->get_future();
 }
 
-template <typename... T> void TaskPool::RunTasks(T &&... tasks) {
-  RunTaskImpl<T...>::Run(std::forward<T>(tasks)...);
-}
-
-template <typename Head, typename... Tail>
-struct TaskPool::RunTaskImpl<Head, Tail...> {
-  static void Run(Head &&h, Tail &&... t) {
-    auto f = AddTask(std::forward<Head>(h));
-    RunTaskImpl<Tail...>::Run(std::forward<Tail>(t)...);
-    f.wait();
-  }
-};
-
-template <> struct TaskPool::RunTaskImpl<> {
-  static void Run() {}
-};
-
 // Run 'func' on every value from begin .. end-1.  Each worker will grab
 // 'batch_size' numbers at a time to work on, so for very fast functions, batch
 // should be large enough to avoid too much cache line contention.
+//
+// The calling thread works on the values too, and at most as many threads as
+// the pool is limited to take part. Only helper tasks that already started
+// are waited for, so this can be called from a task on the pool without
+// deadlocking even if every worker thread is busy.
 void TaskMapOverInt(size_t begin, size_t end,
                     const llvm::function_ref<void(size_t)> &func);
 
+template <typename... T> void TaskPool::RunTasks(T &&... tasks) {
+  std::function<void()> task_fns[] = {std::forward<T>(tasks)...};
+  TaskMapOverInt(0, sizeof...(T),
+                 [&task_fns](size_t idx) { task_fns[idx](); });
+}
+
 unsigned GetHardwareConcurrencyHint();
 
 } // namespace lldb_private
@@ -14,6 +14,7 @@
 #include "NativeThreadProtocol.h"
 #include "NativeWatchpointList.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Core/RangeMap.h"
 #include "lldb/Host/MainLoop.h"
 #include "lldb/Utility/ArchSpec.h"
 #include "lldb/Utility/Status.h"
@@ -87,6 +88,20 @@ public:
   virtual Status ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf,
                                        size_t size, size_t &bytes_read) = 0;
 
+  //------------------------------------------------------------------
+  /// Read several ranges of memory with any software breakpoint traps
+  /// removed.
+  ///
+  /// The bytes of all ranges are stored back to back in \a buffer and
+  /// the number of bytes read for each range in \a bytes_read. A range
+  /// that couldn't be read doesn't fail the whole operation, its byte
+  /// count is just smaller than its size. The default implementation
+  /// reads the ranges one at a time.
+  //------------------------------------------------------------------
+  virtual Status ReadMemoryRangesWithoutTrap(
+      llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+      llvm::MutableArrayRef<uint8_t> buffer, std::vector<size_t> &bytes_read);
+
   virtual Status WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
                              size_t &bytes_written) = 0;
 
@@ -73,6 +73,15 @@ public:
   void ForEachFDEEntries(
       const std::function<bool(lldb::addr_t, uint32_t, dw_offset_t)> &callback);
 
+  // Call the callback with the start address of every function in the
+  // .eh_frame_hdr binary search table, in increasing order, until it returns
+  // false. This only reads the table, not the FDEs.
+  //
+  // @return
+  //      False if there is no .eh_frame_hdr table that can be used.
+  bool ForEachEHFrameHdrFunctionStart(
+      const std::function<bool(lldb::addr_t)> &callback);
+
 private:
   enum { CFI_AUG_MAX_SIZE = 8, CFI_HEADER_SIZE = 8 };
   enum CFIVersion {
@@ -125,6 +134,17 @@ private:
 
   void GetFDEIndex();
 
+  bool UseEHFrameHdr();
+
+  void ParseEHFrameHdr();
+
+  lldb::addr_t GetEHFrameHdrTableValue(uint32_t index, uint32_t field);
+
+  bool GetEHFrameHdrFDEEntry(uint32_t index, FDEEntryMap::Entry &fde_entry);
+
+  bool GetFDEEntryFromEHFrameHdr(lldb::addr_t file_addr,
+                                 FDEEntryMap::Entry &fde_entry);
+
   bool FDEToUnwindPlan(uint32_t offset, Address startaddr,
                        UnwindPlan &unwind_plan);
 
@@ -145,6 +165,7 @@ private:
   lldb::SectionSP m_section_sp;
   Flags m_flags = 0;
   cie_map_t m_cie_map;
+  std::mutex m_cie_map_mutex; // CIEs are parsed lazily with .eh_frame_hdr
 
   DataExtractor m_cfi_data;
   bool m_cfi_data_initialized = false; // only copy the section into the DE once
@@ -153,6 +174,17 @@ private:
   bool m_fde_index_initialized = false; // only scan the section for FDEs once
   std::mutex m_fde_index_mutex; // and isolate the thread that does it
 
+  // The binary search table of FDEs in .eh_frame_hdr, which is used instead
+  // of m_fde_index when there is one.
+  DataExtractor m_eh_frame_hdr_data;
+  lldb::addr_t m_eh_frame_hdr_addr = LLDB_INVALID_ADDRESS;
+  lldb::offset_t m_eh_frame_hdr_table_offset = 0;
+  uint32_t m_eh_frame_hdr_fde_count = 0;
+  uint32_t m_eh_frame_hdr_value_size = 0;
+  uint8_t m_eh_frame_hdr_table_enc = DW_EH_PE_omit;
+  bool m_eh_frame_hdr_initialized = false; // only look for the table once
+  bool m_clear_address_zeroth_bit = false;
+
   Type m_type;
 
   CIESP
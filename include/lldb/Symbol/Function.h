@@ -17,6 +17,8 @@
 #include "lldb/Symbol/Declaration.h"
 #include "lldb/Utility/UserID.h"
 
+#include <atomic>
+
 namespace lldb_private {
 
 //----------------------------------------------------------------------
@@ -444,6 +446,10 @@ public:
   //------------------------------------------------------------------
   /// Get accessor for the block list.
   ///
+  /// Several threads can ask for the blocks of the same function at once,
+  /// e.g. when threads are unwound in parallel. Only one of them parses
+  /// the blocks, the others wait for it.
+  ///
   /// @return
   ///     The block list object that describes all lexical blocks
   ///     in the function.
@@ -638,6 +644,7 @@ protected:
   Flags m_flags;
   uint32_t
       m_prologue_byte_size; ///< Compute the prologue size once and cache it
+  std::atomic<bool> m_block_parsed; ///< Set once m_block has been parsed.
 private:
   DISALLOW_COPY_AND_ASSIGN(Function);
 };
@@ -238,6 +238,31 @@ public:
 
   bool ContainsFileAddress(lldb::addr_t file_addr) const;
 
+  //------------------------------------------------------------------
+  /// Encode this symbol into \a strm so it can be saved in a cache file.
+  ///
+  /// The section of a section offset address is saved by its ID, so the
+  /// symbol can only be decoded against a section list of the same object
+  /// file. Sections of absolute symbols (eSectionTypeAbsoluteAddress) are
+  /// saved by their address instead, since they are made up by the object
+  /// file and don't have a unique ID.
+  //------------------------------------------------------------------
+  void Encode(Stream &strm) const;
+
+  //------------------------------------------------------------------
+  /// Decode a symbol that was saved with Encode().
+  ///
+  /// @param[in] section_list
+  ///     The section list to look up the section IDs of section offset
+  ///     addresses in.
+  ///
+  /// @return
+  ///     False if the data is truncated or refers to a section that isn't
+  ///     in \a section_list.
+  //------------------------------------------------------------------
+  bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+              const SectionList *section_list);
+
 protected:
   // This is the internal guts of ResolveReExportedSymbol, it assumes
   // reexport_name is not null, and that module_spec
@@ -17,6 +17,7 @@
 #include "lldb/Symbol/CompilerDeclContext.h"
 #include "lldb/Symbol/CompilerType.h"
 #include "lldb/Symbol/Type.h"
+#include "lldb/Target/Statistics.h"
 #include "lldb/lldb-private.h"
 
 #include "llvm/ADT/DenseSet.h"
@@ -258,6 +259,38 @@ public:
   virtual bool SymbolContextShouldBeExcluded(const SymbolContext &sc,
                                              uint32_t actual_line);
 
+  //------------------------------------------------------------------
+  // Statistics reported by the "statistics dump" command. Symbol files
+  // that don't keep track of these report zero.
+  //------------------------------------------------------------------
+  virtual StatsDuration::Duration GetDebugInfoParseTime() { return {}; }
+
+  virtual StatsDuration::Duration GetDebugInfoIndexTime() { return {}; }
+
+  //------------------------------------------------------------------
+  /// The size in bytes of the debug info sections in the object file.
+  //------------------------------------------------------------------
+  virtual uint64_t GetDebugInfoSize() { return 0; }
+
+  virtual uint64_t GetDebugInfoBytesParsed() { return 0; }
+
+  virtual uint64_t GetNumTypesCompleted() { return 0; }
+
+  //------------------------------------------------------------------
+  /// The number of bytes of memory used by the debug info entries that
+  /// are currently parsed.
+  //------------------------------------------------------------------
+  virtual uint64_t GetDebugInfoMemorySize() { return 0; }
+
+  //------------------------------------------------------------------
+  /// The number of times parsed debug info entries were freed to stay
+  /// under a memory limit, and the number of times they had to be
+  /// parsed again afterwards.
+  //------------------------------------------------------------------
+  virtual uint64_t GetNumDebugInfoEvictions() { return 0; }
+
+  virtual uint64_t GetNumDebugInfoReparses() { return 0; }
+
 protected:
   class SourceRange {
   public:
@@ -17,6 +17,7 @@
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/lldb-private.h"
+#include "llvm/ADT/STLExtras.h"
 
 namespace lldb_private {
 
@@ -147,6 +148,55 @@ public:
 
   ObjectFile *GetObjectFile() { return m_objfile; }
 
+  //----------------------------------------------------------------------
+  /// Encode the symbols and the name indexes of this symbol table into
+  /// \a strm, computing the name indexes first if needed.
+  //----------------------------------------------------------------------
+  void Encode(Stream &strm);
+
+  //----------------------------------------------------------------------
+  /// Replace the contents of this symbol table with what Encode() saved.
+  ///
+  /// The name indexes are adopted as they were saved, so none of the
+  /// symbol names need to be demangled again.
+  ///
+  /// @return
+  ///     False if the data is truncated or doesn't match the sections of
+  ///     the object file, in which case this symbol table is left empty.
+  //----------------------------------------------------------------------
+  bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr);
+
+  //----------------------------------------------------------------------
+  /// Load this symbol table from the index cache if it is enabled and has
+  /// an up to date entry for the module.
+  ///
+  /// @param[in] symbol_file
+  ///     The object file the symbols are read from, e.g. a separate debug
+  ///     info file. The entry is only used if it was saved from the same
+  ///     version of that file.
+  ///
+  /// @param[in] decode_object_file_data
+  ///     Called to decode the data the object file saved next to the
+  ///     symbols with SaveToCache(), before the symbols are decoded.
+  //----------------------------------------------------------------------
+  bool LoadFromCache(
+      ObjectFile *symbol_file,
+      llvm::function_ref<bool(const DataExtractor &, lldb::offset_t *)>
+          decode_object_file_data);
+
+  //----------------------------------------------------------------------
+  /// Save this symbol table to the index cache if it is enabled.
+  ///
+  /// @param[in] symbol_file
+  ///     The object file the symbols were read from.
+  ///
+  /// @param[in] encode_object_file_data
+  ///     Called to save any state of the object file that was computed
+  ///     while parsing the symbols, so LoadFromCache() can restore it.
+  //----------------------------------------------------------------------
+  void SaveToCache(ObjectFile *symbol_file,
+                   llvm::function_ref<void(Stream &)> encode_object_file_data);
+
 protected:
   typedef std::vector<Symbol> collection;
   typedef collection::iterator iterator;
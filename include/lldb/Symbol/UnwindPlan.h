@@ -328,6 +328,17 @@ public:
     void Dump(Stream &s, const UnwindPlan *unwind_plan, Thread *thread,
               lldb::addr_t base_addr) const;
 
+    //------------------------------------------------------------------
+    /// Encode this row into \a strm, see UnwindPlan::Encode().
+    ///
+    /// @return
+    ///     False if the row uses a DWARF expression, which points into
+    ///     data the row doesn't own and can't be saved.
+    //------------------------------------------------------------------
+    bool Encode(Stream &strm) const;
+
+    bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr);
+
   protected:
     typedef std::map<uint32_t, RegisterLocation> collection;
     lldb::addr_t m_offset; // Offset into the function for this row
@@ -466,6 +477,30 @@ public:
     m_personality_func_addr = presonality_func_ptr;
   }
 
+  //------------------------------------------------------------------
+  /// Encode this plan into \a strm so it can be saved in a cache file.
+  ///
+  /// Addresses are saved as file addresses, so the plan can only be
+  /// decoded against the section list of the same object file.
+  ///
+  /// @return
+  ///     False if the plan can't be saved because one of its rows uses
+  ///     a DWARF expression. \a strm is left with a partial encoding.
+  //------------------------------------------------------------------
+  bool Encode(Stream &strm) const;
+
+  //------------------------------------------------------------------
+  /// Decode a plan that was saved with Encode().
+  ///
+  /// @param[in] section_list
+  ///     The section list to resolve the file addresses of the plan in.
+  ///
+  /// @return
+  ///     False if the data is truncated or invalid.
+  //------------------------------------------------------------------
+  bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+              const SectionList *section_list);
+
 private:
   typedef std::vector<RowSP> collection;
   collection m_row_list;
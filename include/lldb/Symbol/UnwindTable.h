@@ -10,9 +10,13 @@
 #ifndef liblldb_UnwindTable_h
 #define liblldb_UnwindTable_h
 
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <string>
+#include <vector>
 
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/lldb-private.h"
 
 namespace lldb_private {
@@ -20,6 +24,17 @@ namespace lldb_private {
 // A class which holds all the FuncUnwinders objects for a given ObjectFile.
 // The UnwindTable is populated with FuncUnwinders objects lazily during
 // the debug session.
+//
+// The bounds of the functions in the ObjectFile are gathered from its symbol
+// table and its .eh_frame_hdr table the first time a FuncUnwinders is looked
+// up. Lookups of addresses inside those functions are then a binary search
+// that doesn't take any locks, so many threads can be unwound at the same
+// time.
+//
+// The UnwindPlans that FuncUnwinders builds by profiling the assembly of a
+// function are saved in the index cache, keyed by module and function
+// address, so later debug sessions with the same binary don't profile the
+// function again.
 
 class UnwindTable {
 public:
@@ -55,21 +70,89 @@ public:
 
   bool GetArchitecture(lldb_private::ArchSpec &arch);
 
+  // The kinds of UnwindPlan that are saved in the unwind plan cache.
+  enum CachedUnwindPlanKind : uint8_t {
+    eCachedUnwindPlanAssembly,
+    eCachedUnwindPlanEHFrameAugmented,
+    eCachedUnwindPlanDebugFrameAugmented
+  };
+
+  // Get the plan of the given kind for the function that starts at
+  // func_file_addr from the unwind plan cache, or an empty shared pointer.
+  lldb::UnwindPlanSP GetCachedUnwindPlan(CachedUnwindPlanKind kind,
+                                         lldb::addr_t func_file_addr);
+
+  // Add a plan to the unwind plan cache. It is written to the cache file
+  // by SaveUnwindPlanCache().
+  void CacheUnwindPlan(CachedUnwindPlanKind kind, lldb::addr_t func_file_addr,
+                       const UnwindPlan &plan);
+
+  // Write the plans added since the cache file was read back to it.
+  // Process::Finalize does this for the modules of the process.
+  void SaveUnwindPlanCache();
+
 private:
   void Dump(Stream &s);
 
   void Initialize();
+  void InitializeUnwindInfo(SectionList &sl);
+  void InitializeFunctionBounds();
   llvm::Optional<AddressRange> GetAddressRange(const Address &addr,
                                                SymbolContext &sc);
+  void LoadUnwindPlanCache();
+
+  // The file address range of a function, and its FuncUnwinders once it has
+  // been looked up. m_func_unwinders_sp is only accessed with the atomic
+  // shared_ptr functions. m_byte_size is kUnresolvedSize for functions that
+  // only the .eh_frame_hdr table knows about until their FDE is read.
+  struct FunctionBounds {
+    static const lldb::addr_t kUnresolvedSize = LLDB_INVALID_ADDRESS;
+
+    FunctionBounds(lldb::addr_t file_addr, lldb::addr_t byte_size)
+        : m_file_addr(file_addr), m_byte_size(byte_size) {}
+
+    // Only used while m_function_bounds is being built.
+    FunctionBounds(const FunctionBounds &rhs)
+        : m_file_addr(rhs.m_file_addr), m_byte_size(rhs.GetByteSize()),
+          m_func_unwinders_sp(rhs.m_func_unwinders_sp) {}
+
+    FunctionBounds &operator=(const FunctionBounds &rhs) {
+      m_file_addr = rhs.m_file_addr;
+      m_byte_size.store(rhs.GetByteSize(), std::memory_order_relaxed);
+      m_func_unwinders_sp = rhs.m_func_unwinders_sp;
+      return *this;
+    }
+
+    bool operator<(const FunctionBounds &rhs) const {
+      return m_file_addr < rhs.m_file_addr;
+    }
+
+    lldb::addr_t GetByteSize() const {
+      return m_byte_size.load(std::memory_order_acquire);
+    }
+
+    lldb::addr_t m_file_addr;
+    std::atomic<lldb::addr_t> m_byte_size;
+    lldb::FuncUnwindersSP m_func_unwinders_sp;
+  };
+
+  lldb::addr_t
+  ResolveFunctionBounds(std::vector<FunctionBounds>::iterator bounds_pos);
 
   typedef std::map<lldb::addr_t, lldb::FuncUnwindersSP> collection;
   typedef collection::iterator iterator;
   typedef collection::const_iterator const_iterator;
 
   ObjectFile &m_object_file;
+  // FuncUnwinders for functions that aren't in m_function_bounds
   collection m_unwinds;
+  // Sorted by address and never resized once m_function_bounds_once is done
+  std::vector<FunctionBounds> m_function_bounds;
+  std::once_flag m_function_bounds_once;
 
-  bool m_initialized; // delay some initialization until ObjectFile is set up
+  // Delay some initialization until ObjectFile is set up. Set with release
+  // semantics once the unwind info below is in place.
+  std::atomic<bool> m_initialized;
   std::mutex m_mutex;
 
   std::unique_ptr<DWARFCallFrameInfo> m_eh_frame_up;
@@ -77,6 +160,23 @@ private:
   std::unique_ptr<CompactUnwindInfo> m_compact_unwind_up;
   std::unique_ptr<ArmUnwindInfo> m_arm_unwind_up;
 
+  // The unwind plan cache. The key, signature and address size are computed
+  // when the cache file is read, so saving the cache doesn't need to ask the
+  // module or the object file again. m_plan_cache_key is empty when the
+  // index cache is off or the module can't be cached.
+  typedef std::pair<uint8_t, lldb::addr_t> CachedUnwindPlanKey;
+  std::once_flag m_plan_cache_once;
+  std::mutex m_plan_cache_mutex;
+  std::string m_plan_cache_key;
+  CacheSignature m_plan_cache_signature;
+  uint32_t m_plan_cache_addr_byte_size = 0;
+  lldb::DataBufferSP m_plan_cache_data_sp;
+  // The encoded plans in m_plan_cache_data_sp
+  std::map<CachedUnwindPlanKey, llvm::ArrayRef<uint8_t>> m_cached_plans;
+  // The encoded plans added in this session
+  std::map<CachedUnwindPlanKey, std::string> m_new_plans;
+  bool m_plan_cache_dirty = false; // new plans haven't been saved yet
+
   DISALLOW_COPY_AND_ASSIGN(UnwindTable);
 };
 
@@ -13,10 +13,12 @@
 // C Includes
 // C++ Includes
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 // Other libraries and framework includes
+#include "llvm/ADT/ArrayRef.h"
 
 // Project includes
 #include "lldb/Core/RangeMap.h"
@@ -26,9 +28,32 @@ namespace lldb_private {
 //----------------------------------------------------------------------
 // A class to track memory that was read from a live process between
 // runs.
+//
+// Memory is cached in pages of GetMemoryCacheLineSize() bytes that are
+// found through an open addressed hash table. Runs of adjacent pages
+// that are missing from the cache are read from the process with a
+// single read, and when reads walk forward through memory the cache
+// starts reading ahead of them. Pages from memory regions that are not
+// writable are kept when the process stops, everything else is thrown
+// away.
 //----------------------------------------------------------------------
 class MemoryCache {
 public:
+  struct Statistics {
+    // Reads that were satisfied without reading from the process.
+    uint64_t num_hits = 0;
+    // Reads that had to read at least some memory from the process.
+    uint64_t num_misses = 0;
+    // The number of times memory was read from the process.
+    uint64_t num_process_reads = 0;
+    // The number of bytes read from the process.
+    uint64_t bytes_read = 0;
+    // The number of those bytes that were read ahead of the request.
+    uint64_t bytes_prefetched = 0;
+    // The number of pages that were kept when the process stopped.
+    uint64_t num_pages_kept = 0;
+  };
+
   //------------------------------------------------------------------
   // Constructors and Destructors
   //------------------------------------------------------------------
@@ -38,11 +63,26 @@ public:
 
   void Clear(bool clear_invalid_ranges = false);
 
+  //------------------------------------------------------------------
+  // Clear everything except the pages that belong to read only memory
+  // regions. Called each time the process stops.
+  //------------------------------------------------------------------
+  void ClearWritableData();
+
   void Flush(lldb::addr_t addr, size_t size);
 
   size_t Read(lldb::addr_t addr, void *dst, size_t dst_len, Status &error);
 
-  uint32_t GetMemoryCacheLineSize() const { return m_L2_cache_line_byte_size; }
+  //------------------------------------------------------------------
+  // Read several ranges of memory into buffer, back to back. The pages
+  // that are missing for all of the ranges are read from the process
+  // with a single Process::ReadMemoryRangesFromInferior() call.
+  //------------------------------------------------------------------
+  std::vector<size_t>
+  ReadRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+             llvm::MutableArrayRef<uint8_t> buffer, Status &error);
+
+  uint32_t GetMemoryCacheLineSize() const { return m_page_size; }
 
   void AddInvalidRange(lldb::addr_t base_addr, lldb::addr_t byte_size);
 
@@ -54,10 +94,70 @@ public:
   void AddL1CacheData(lldb::addr_t addr,
                       const lldb::DataBufferSP &data_buffer_sp);
 
+  Statistics GetStatistics();
+
 protected:
   typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
   typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
   typedef Range<lldb::addr_t, lldb::addr_t> AddrRange;
+  typedef RangeDataVector<lldb::addr_t, lldb::addr_t, bool> ReadOnlyRanges;
+
+  struct Page {
+    lldb::addr_t addr;
+    // The number of valid bytes in data. Only less than the page size
+    // if the memory after them couldn't be read.
+    uint32_t size;
+    bool read_only;
+    // Set on read only pages that were kept over a stop. Their region
+    // is checked again before they are used, it may have been remapped.
+    bool check_region;
+    std::unique_ptr<uint8_t[]> data;
+  };
+
+  Page *FindPage(lldb::addr_t addr);
+
+  void AddPage(lldb::addr_t addr, const uint8_t *src, uint32_t size,
+               bool read_only);
+
+  void RemovePage(uint32_t page_idx);
+
+  void AddPages(lldb::addr_t addr, const uint8_t *src, size_t size);
+
+  uint32_t *FindPageSlot(lldb::addr_t addr);
+
+  void RebuildPageIndex();
+
+  bool ReadPages(lldb::addr_t page_addr, lldb::addr_t last_page_addr,
+                 lldb::addr_t &readable_end, Status &error);
+
+  bool IsReadOnly(lldb::addr_t addr);
+
+  struct ReadStream {
+    // The address right after the last read from the process and how
+    // much to read ahead if the next miss starts there.
+    lldb::addr_t next_addr = LLDB_INVALID_ADDRESS;
+    lldb::addr_t prefetch_size = 0;
+  };
+
+  //------------------------------------------------------------------
+  // Find the stream that a miss at page_addr continues and grow its
+  // read ahead, or start a new stream.
+  //------------------------------------------------------------------
+  ReadStream &GetReadStream(lldb::addr_t page_addr);
+
+  void ClearReadStreams();
+
+  bool ReadFromL1Cache(lldb::addr_t addr, void *dst, size_t dst_len);
+
+  bool ReadFromMappedMemory(lldb::addr_t addr, void *dst, size_t dst_len);
+
+  size_t ReadFromPages(lldb::addr_t addr, uint8_t *dst, size_t dst_len,
+                       bool &missed, Status &error);
+
+  lldb::addr_t AlignToPage(lldb::addr_t addr) const {
+    return addr & ~(lldb::addr_t)(m_page_size - 1);
+  }
+
   //------------------------------------------------------------------
   // Classes that inherit from MemoryCache can see and modify these
   //------------------------------------------------------------------
@@ -65,18 +165,29 @@ protected:
   BlockMap m_L1_cache; // A first level memory cache whose chunk sizes vary that
                        // will be used only if the memory read fits entirely in
                        // a chunk
-  BlockMap m_L2_cache; // A memory cache of fixed size chinks
-                       // (m_L2_cache_line_byte_size bytes in size each)
+  std::vector<Page> m_pages; // The cached pages in no particular order
+  // An open addressed hash table of indexes into m_pages, keyed by page
+  // address. Empty slots are UINT32_MAX.
+  std::vector<uint32_t> m_page_index;
+  // Whether the regions we have looked up since the last stop are read
+  // only, sorted and with adjoining entries of equal permissions merged.
+  // Pages whose region couldn't be looked up are recorded as writable.
+  ReadOnlyRanges m_region_permissions;
   InvalidRanges m_invalid_ranges;
   Process &m_process;
-  uint32_t m_L2_cache_line_byte_size;
+  uint32_t m_page_size;
+  // Several streams of forward reads are tracked at once, so that
+  // threads that unwind different stacks at the same time don't break
+  // each other's pattern.
+  static const uint32_t kNumReadStreams = 8;
+  ReadStream m_read_streams[kNumReadStreams];
+  uint32_t m_next_read_stream; // the stream to replace next
+  Statistics m_stats;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(MemoryCache);
 };
 
-    
-
 class AllocatedBlock {
 public:
   AllocatedBlock(lldb::addr_t addr, uint32_t byte_size, uint32_t permissions,
@@ -101,6 +101,8 @@ public:
 
   bool GetStopOnExec() const;
 
+  bool GetParallelUnwind() const;
+
 protected:
   static void OptionValueChangedCallback(void *baton,
                                          OptionValue *option_value);
@@ -1773,6 +1775,31 @@ public:
   virtual size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                               Status &error) = 0;
 
+  //------------------------------------------------------------------
+  /// Actually do the reading of several ranges of memory from a
+  /// process.
+  ///
+  /// Subclasses that can read several ranges of memory with a single
+  /// request, for example with a single packet to a remote debug
+  /// server, should override this function. The default
+  /// implementation reads the ranges one at a time with
+  /// Process::DoReadMemory().
+  ///
+  /// @param[in] ranges
+  ///     The address and size of each range to read.
+  ///
+  /// @param[out] buffer
+  ///     A buffer that receives the bytes of all ranges back to back.
+  ///     It must be at least as big as the sizes of all ranges
+  ///     combined.
+  ///
+  /// @return
+  ///     The number of bytes that were read for each range.
+  //------------------------------------------------------------------
+  virtual std::vector<size_t>
+  DoReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                     llvm::MutableArrayRef<uint8_t> buffer, Status &error);
+
   //------------------------------------------------------------------
   /// Read of memory from a process.
   ///
@@ -1805,6 +1832,65 @@ public:
   virtual size_t ReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                             Status &error);
 
+  //------------------------------------------------------------------
+  /// Read several ranges of memory from a process at once.
+  ///
+  /// This reads the ranges through the memory cache, and all the
+  /// ranges the cache doesn't hold are read from the process with as
+  /// few requests as the process plug-in allows. Use this instead of
+  /// several calls to ReadMemory() when the addresses of all ranges
+  /// are known up front.
+  ///
+  /// @param[in] ranges
+  ///     The address and size of each range to read.
+  ///
+  /// @param[out] buffer
+  ///     A buffer that receives the bytes of all ranges back to back.
+  ///     It must be at least as big as the sizes of all ranges
+  ///     combined.
+  ///
+  /// @param[out] error
+  ///     Set to the error of the first range that couldn't be read
+  ///     completely.
+  ///
+  /// @return
+  ///     The number of bytes that were read for each range. A range
+  ///     that was only partially read has its leading bytes in
+  ///     \a buffer.
+  //------------------------------------------------------------------
+  std::vector<size_t>
+  ReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                   llvm::MutableArrayRef<uint8_t> buffer, Status &error);
+
+  //------------------------------------------------------------------
+  /// Get the memory of the process without copying it.
+  ///
+  /// Processes whose memory is already in the debugger's address
+  /// space, like core files that are mapped into memory, can override
+  /// this to hand out the memory itself instead of a copy. This can be
+  /// called from several threads at once.
+  ///
+  /// @param[in] vm_addr
+  ///     A virtual load address that indicates where to start reading
+  ///     memory from.
+  ///
+  /// @param[in] size
+  ///     The number of bytes to get.
+  ///
+  /// @param[out] data
+  ///     Set to refer to the memory, sharing the buffer that holds it
+  ///     so that the memory stays valid for as long as \a data does.
+  ///
+  /// @return
+  ///     The number of bytes in \a data, which can be less than
+  ///     \a size. Zero if the memory isn't available this way, in
+  ///     which case it has to be read with ReadMemory().
+  //------------------------------------------------------------------
+  virtual size_t PeekMemory(lldb::addr_t vm_addr, size_t size,
+                            DataExtractor &data) {
+    return 0;
+  }
+
   //------------------------------------------------------------------
   /// Read a NULL terminated string from memory
   ///
@@ -1855,6 +1941,15 @@ public:
   size_t ReadMemoryFromInferior(lldb::addr_t vm_addr, void *buf, size_t size,
                                 Status &error);
 
+  std::vector<size_t> ReadMemoryRangesFromInferior(
+      llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+      llvm::MutableArrayRef<uint8_t> buffer, Status &error);
+
+  //------------------------------------------------------------------
+  /// Get the cache that ReadMemory() reads process memory through.
+  //------------------------------------------------------------------
+  MemoryCache &GetMemoryCache() { return m_memory_cache; }
+
   //------------------------------------------------------------------
   /// Reads an unsigned integer of the specified byte size from
   /// process memory.
@@ -2454,6 +2549,32 @@ public:
   // used.
   uint32_t AssignIndexIDToThread(uint64_t thread_id);
 
+  //------------------------------------------------------------------
+  /// Fetch the registers needed to start unwinding \a threads ahead of
+  /// time.
+  ///
+  /// Commands that are about to walk the stacks of many threads call
+  /// this so that plug-ins can fetch the registers of all of the
+  /// threads at once instead of one register at a time.
+  //------------------------------------------------------------------
+  virtual void PrefetchThreadRegisters(llvm::ArrayRef<lldb::ThreadSP> threads) {
+  }
+
+  //------------------------------------------------------------------
+  /// Unwind the stacks of \a threads, several threads at a time unless
+  /// the "parallel-unwind" setting is off.
+  ///
+  /// The frames are cached in each thread, so showing the stacks
+  /// afterwards, one thread at a time and in any order, doesn't unwind
+  /// again.
+  ///
+  /// @param[in] max_frames
+  ///     The number of frames to unwind in each thread, UINT32_MAX to
+  ///     unwind the whole stack.
+  //------------------------------------------------------------------
+  void UnwindThreads(llvm::ArrayRef<lldb::ThreadSP> threads,
+                     uint32_t max_frames);
+
   //------------------------------------------------------------------
   // Queue Queries
   //------------------------------------------------------------------
@@ -3315,6 +3436,12 @@ private:
 
   void ControlPrivateStateThread(uint32_t signal);
 
+  //------------------------------------------------------------------
+  /// Read the top of the stack of each of \a threads into the memory
+  /// cache with a single call to ReadMemoryRanges().
+  //------------------------------------------------------------------
+  void PrefetchThreadStacks(llvm::ArrayRef<lldb::ThreadSP> threads);
+
   DISALLOW_COPY_AND_ASSIGN(Process);
 };
 
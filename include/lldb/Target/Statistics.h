@@ -0,0 +1,104 @@
+//===-- Statistics.h --------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_Statistics_h_
+#define liblldb_Statistics_h_
+
+// C Includes
+// C++ Includes
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+// Other libraries and framework includes
+#include "llvm/ADT/StringRef.h"
+
+// Project includes
+#include "lldb/Utility/StructuredData.h"
+#include "lldb/lldb-defines.h"
+#include "lldb/lldb-forward.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class StatsDuration Statistics.h "lldb/Target/Statistics.h"
+/// @brief An accumulated duration that can be added to from any thread.
+///
+/// Work that runs in parallel (e.g. indexing DWARF) adds the time spent
+/// on every thread, so the total can be larger than the wall clock time.
+//----------------------------------------------------------------------
+class StatsDuration {
+public:
+  typedef std::chrono::duration<double> Duration;
+
+  Duration get() const {
+    return std::chrono::nanoseconds(m_nanos.load(std::memory_order_relaxed));
+  }
+
+  StatsDuration &operator+=(std::chrono::nanoseconds duration) {
+    m_nanos.fetch_add(duration.count(), std::memory_order_relaxed);
+    return *this;
+  }
+
+private:
+  std::atomic<uint64_t> m_nanos{0};
+};
+
+//----------------------------------------------------------------------
+/// @class ElapsedTime Statistics.h "lldb/Target/Statistics.h"
+/// @brief Add the time this object was alive to a StatsDuration.
+//----------------------------------------------------------------------
+class ElapsedTime {
+public:
+  explicit ElapsedTime(StatsDuration &duration)
+      : m_duration(duration), m_start(std::chrono::steady_clock::now()) {}
+
+  ~ElapsedTime() {
+    m_duration += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_start);
+  }
+
+private:
+  StatsDuration &m_duration;
+  std::chrono::steady_clock::time_point m_start;
+
+  DISALLOW_COPY_AND_ASSIGN(ElapsedTime);
+};
+
+//----------------------------------------------------------------------
+/// @class TargetStats Statistics.h "lldb/Target/Statistics.h"
+/// @brief Collects the statistics reported by "statistics dump" and
+/// SBTarget::GetStatistics().
+///
+/// The core statistics (the command counters, per module symbol table
+/// and debug info timings, breakpoint resolution times and memory use)
+/// are always reported. Subsystems that live in plug-ins register a
+/// callback that adds their own statistics under their name.
+//----------------------------------------------------------------------
+class TargetStats {
+public:
+  typedef std::function<void(Target &target,
+                             StructuredData::Dictionary &stats)>
+      Callback;
+
+  //------------------------------------------------------------------
+  /// Register \a callback to add statistics to the dictionary named
+  /// \a name. Registering a callback with the same name again replaces
+  /// the previous callback.
+  //------------------------------------------------------------------
+  static void RegisterCallback(llvm::StringRef name, Callback callback);
+
+  static void UnregisterCallback(llvm::StringRef name);
+
+  static StructuredData::DictionarySP ReportStatistics(Target &target);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_Statistics_h_
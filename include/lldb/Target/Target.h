@@ -531,6 +531,17 @@ public:
   lldb::ModuleSP GetSharedModule(const ModuleSpec &module_spec,
                                  Status *error_ptr = nullptr);
 
+  //----------------------------------------------------------------------
+  /// Find or create the module for \a module_spec the same way
+  /// GetSharedModule() does, using the image search paths and the
+  /// platform, without adding it to the target. Safe to call from
+  /// several threads at once.
+  //----------------------------------------------------------------------
+  Status FindSharedModule(const ModuleSpec &module_spec,
+                          lldb::ModuleSP &module_sp,
+                          lldb::ModuleSP *old_module_sp = nullptr,
+                          bool *did_create_module = nullptr);
+
   //----------------------------------------------------------------------
   // Settings accessors
   //----------------------------------------------------------------------
@@ -14,6 +14,7 @@
 #include "llvm/Support/FormatVariadic.h" // for format_provider
 
 #include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t, uint64_t
 
 namespace lldb_private {
 class Stream;
@@ -59,6 +60,24 @@ public:
 
   explicit ConstString(const llvm::StringRef &s);
 
+  //------------------------------------------------------------------
+  /// Construct with a string whose hash is already known.
+  ///
+  /// Uniquing a string requires hashing it. Callers that already have
+  /// the DJB hash of the string (see ConstString::Hash()), for example
+  /// from an accelerator table, can pass it in to avoid hashing the
+  /// string a second time when it is already in the pool. A wrong
+  /// hash doesn't add a second copy of the string, the string is
+  /// hashed again before it is added to the pool.
+  ///
+  /// @param[in] s
+  ///     The string to unique.
+  ///
+  /// @param[in] hash
+  ///     The value ConstString::Hash(s) returns.
+  //------------------------------------------------------------------
+  ConstString(const llvm::StringRef &s, uint32_t hash);
+
   //------------------------------------------------------------------
   /// Construct with C String value
   ///
@@ -466,6 +485,42 @@ public:
   //------------------------------------------------------------------
   static size_t StaticMemorySize();
 
+  //------------------------------------------------------------------
+  /// Compute the hash the string pool uses for \a s.
+  ///
+  /// This is the DJB hash that the Apple and DWARF 5 accelerator
+  /// tables also use.
+  //------------------------------------------------------------------
+  static uint32_t Hash(llvm::StringRef s) {
+    uint32_t h = 5381;
+    for (unsigned char c : s)
+      h = ((h << 5) + h) + c;
+    return h;
+  }
+
+  //------------------------------------------------------------------
+  /// Counters describing the global string pool.
+  //------------------------------------------------------------------
+  struct PoolStatistics {
+    /// The number of unique strings in the pool.
+    uint64_t num_strings = 0;
+    /// The number of bytes used by the strings, including their
+    /// per string bookkeeping.
+    uint64_t string_bytes = 0;
+    /// The total number of bytes the pool occupies, including its
+    /// hash tables.
+    uint64_t memory_size = 0;
+    /// The number of lookups that found an existing string.
+    uint64_t num_hits = 0;
+    /// The number of strings that were added to the pool.
+    uint64_t num_inserts = 0;
+    /// The number of times a thread had to wait for another thread
+    /// inserting into the same part of the pool.
+    uint64_t num_contended = 0;
+  };
+
+  static PoolStatistics GetPoolStatistics();
+
 protected:
   //------------------------------------------------------------------
   // Member variables
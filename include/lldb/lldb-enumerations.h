@@ -568,6 +568,7 @@ enum CommandArgumentType {
   eArgTypeWatchType,
   eArgRawInput,
   eArgTypeCommand,
+  eArgTypeSaveCoreStyle,
   eArgTypeLastArg // Always keep this entry as the last entry in this
                   // enumeration!!
 };
@@ -661,6 +662,7 @@ enum SectionType {
   eSectionTypeGoSymtab,
   eSectionTypeAbsoluteAddress, // Dummy section for symbols with absolute
                                // address
+  eSectionTypeDWARFDebugNames, // DWARF v5 .debug_names
   eSectionTypeOther
 };
 
@@ -1128,6 +1130,15 @@ enum TypeSummaryCapping {
   eTypeSummaryUncapped = false
 };
 
+//----------------------------------------------------------------------
+// Which memory regions "process save-core" writes to the core file
+//----------------------------------------------------------------------
+enum SaveCoreStyle {
+  eSaveCoreFull = 0,      // All readable memory
+  eSaveCoreSkipFileBacked // Leave out the contents of read-only mappings of
+                          // files, the debugger reads those from the files
+};
+
 } // namespace lldb
 
 #endif // LLDB_lldb_enumerations_h_
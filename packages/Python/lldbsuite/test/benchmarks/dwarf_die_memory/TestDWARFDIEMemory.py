@@ -0,0 +1,64 @@
+"""Test the memory used by parsed DWARF DIEs and how fast lldb walks them."""
+
+from __future__ import print_function
+
+
+import json
+import resource
+import sys
+import lldb
+from lldbsuite.test import configuration
+from lldbsuite.test import lldbtest_config
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+
+
+class DWARFDIEMemoryBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        # The lldb binary is a large DWARF fixture that is always around.
+        self.exe = lldbtest_config.lldbExec
+        self.count = 5
+
+    @benchmarks_test
+    @no_debug_info_test
+    @skipIfWindows
+    def test_dwarf_die_memory(self):
+        """Test DIE memory use and the time to index (walk) every DIE."""
+        print()
+        self.run_dwarf_die_memory_bench(self.exe, self.count)
+        print("lldb DWARF DIE walk benchmark:", self.stopwatch)
+
+    def get_die_memory(self, target):
+        stream = lldb.SBStream()
+        target.GetStatistics().GetAsJSON(stream)
+        return json.loads(stream.GetData())["totalDebugInfoMemorySize"]
+
+    def run_dwarf_die_memory_bench(self, exe, count):
+        self.stopwatch.reset()
+        for i in range(count):
+            target = self.dbg.CreateTarget(exe)
+            self.assertTrue(target, VALID_TARGET)
+
+            # A regular expression lookup indexes the DWARF, which parses
+            # and walks every DIE of every compile unit.
+            rss_before = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+            with self.stopwatch:
+                target.FindGlobalVariables("^g_", 1, lldb.eMatchTypeRegex)
+            rss_after = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+
+            # Only the first iteration parses the DWARF into a process that
+            # hasn't seen it before, so only its peak RSS is meaningful.
+            if i == 0:
+                print("peak RSS growth while indexing: %d KB" %
+                      (rss_after - rss_before))
+                print("DIE memory after indexing: %d bytes" %
+                      self.get_die_memory(target))
+
+            self.dbg.DeleteTarget(target)
+            # Drop the module from the global module cache so the next
+            # iteration parses the DWARF again.
+            lldb.SBDebugger.MemoryPressureDetected()
@@ -0,0 +1,111 @@
+"""
+Benchmark reading large amounts of inferior memory.
+"""
+
+from __future__ import print_function
+
+
+import os
+import time
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkMemoryRead(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @benchmarks_test
+    @skipIf(hostoslist=no_match(["linux"]))
+    @skipUnlessPlatform(["linux"])
+    def test_run_command(self):
+        """Benchmark large memory reads and a full dump of the process memory"""
+        self.build()
+        self.memory_read_commands()
+
+    def setUp(self):
+        # Call super's setUp().
+        BenchBase.setUp(self)
+        self.chunk_size = 1024 * 1024
+
+    def read_range(self, process, addr, size):
+        """Read [addr, addr + size) in chunks, return the number of bytes read"""
+        total = 0
+        error = lldb.SBError()
+        end = addr + size
+        while addr < end:
+            chunk = min(self.chunk_size, end - addr)
+            data = process.ReadMemory(addr, chunk, error)
+            if error.Fail() or not data:
+                break
+            total += len(data)
+            if len(data) < chunk:
+                break
+            addr += chunk
+        return total
+
+    def memory_read_commands(self):
+        """Benchmark large memory reads and a full dump of the process memory"""
+        self.runCmd("file " + self.getBuildArtifact("a.out"),
+                    CURRENT_EXECUTABLE_SET)
+
+        bkpt = self.target().FindBreakpointByID(
+            lldbutil.run_break_set_by_source_regexp(
+                self, "// break here"))
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+                    substrs=['stopped',
+                             'stop reason = breakpoint'])
+
+        # Measure the debug server and not the memory cache.
+        self.runCmd("settings set target.process.disable-memory-cache true")
+        self.addTearDownHook(
+            lambda: self.runCmd(
+                "settings clear target.process.disable-memory-cache",
+                check=False))
+
+        process = self.process()
+        frame = process.GetSelectedThread().GetSelectedFrame()
+        buffer_addr = frame.FindVariable("buffer").GetValueAsUnsigned()
+        buffer_size = frame.EvaluateExpression(
+            "buffer_size").GetValueAsUnsigned()
+        self.assertTrue(buffer_addr != 0 and buffer_size != 0)
+
+        # Large sequential reads, like a big "memory read".
+        sw = Stopwatch()
+        sw.start()
+        bytes_read = self.read_range(process, buffer_addr, buffer_size)
+        sw.stop()
+        self.assertEqual(bytes_read, buffer_size)
+        print("memory read: %.1f MB/s (%s)" %
+              (bytes_read / (1024.0 * 1024.0) / sw.avg(), sw))
+
+        # A read that runs into the unmapped page after the buffer should
+        # return the readable part.
+        error = lldb.SBError()
+        data = process.ReadMemory(buffer_addr + buffer_size - 100, 200, error)
+        self.assertTrue(data is not None)
+        self.assertEqual(len(data), 100)
+
+        # Read every readable region, like a core file writer would.
+        regions = process.GetMemoryRegions()
+        region = lldb.SBMemoryRegionInfo()
+        sw = Stopwatch()
+        sw.start()
+        bytes_read = 0
+        for i in range(regions.GetSize()):
+            regions.GetMemoryRegionAtIndex(i, region)
+            if not region.IsReadable():
+                continue
+            bytes_read += self.read_range(
+                process, region.GetRegionBase(),
+                region.GetRegionEnd() - region.GetRegionBase())
+        sw.stop()
+        print("process memory dump: %d bytes, %.1f MB/s (%s)" %
+              (bytes_read, bytes_read / (1024.0 * 1024.0) / sw.avg(), sw))
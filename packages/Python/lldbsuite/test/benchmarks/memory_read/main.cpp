@@ -0,0 +1,23 @@
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// A large buffer that is followed by an unmapped page, so that reads
+// which run off the end of the buffer only partially succeed. Making the
+// page PROT_NONE isn't enough, ptrace can still read it.
+static const size_t buffer_size = 64 * 1024 * 1024;
+
+int main()
+{
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+    uint8_t *buffer = (uint8_t *)mmap(NULL, buffer_size + page_size,
+                                      PROT_READ | PROT_WRITE,
+                                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED)
+        return 1;
+    for (size_t i = 0; i < buffer_size; ++i)
+        buffer[i] = (uint8_t)i;
+    munmap(buffer + buffer_size, page_size);
+    return buffer[buffer_size - 1]; // break here
+}
@@ -0,0 +1,76 @@
+"""
+Test that DWARF DIEs that were freed to stay under the memory limit are
+parsed again when they are needed.
+"""
+
+import json
+import time
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class DWARFDIEEvictionTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def get_stats(self, target):
+        stream = lldb.SBStream()
+        target.GetStatistics().GetAsJSON(stream)
+        return json.loads(stream.GetData())
+
+    def wait_for_stat(self, target, key):
+        # DIEs are freed on a background thread.
+        for i in range(100):
+            stats = self.get_stats(target)
+            if stats[key] > 0:
+                return stats
+            time.sleep(0.1)
+        self.fail("%s stayed 0" % key)
+
+    def check_value(self, target, name, children):
+        process = target.GetProcess()
+        frame = process.GetSelectedThread().GetFrameAtIndex(0)
+        value = frame.FindVariable("value")
+        self.assertTrue(value.IsValid(), "no variable in %s" % name)
+        self.assertEqual(value.GetType().GetName(), "struct " + name)
+        self.assertEqual(value.GetNumChildren(), len(children))
+        for idx, expected in enumerate(children):
+            self.assertEqual(value.GetChildAtIndex(idx).GetValueAsSigned(),
+                             expected)
+
+    # The object files of a debug map never free their DIEs.
+    @skipIfDarwin
+    @no_debug_info_test
+    def test_evict_and_reparse(self):
+        """Test that types and variables survive their DIEs being freed."""
+        self.build()
+        self.runCmd("settings set symbols.dwarf-die-memory-limit 1")
+        self.addTearDownHook(
+            lambda: self.runCmd(
+                "settings clear symbols.dwarf-die-memory-limit"))
+
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break in one", lldb.SBFileSpec("one.c"))
+        self.check_value(target, "One", [1, 2])
+        lldbutil.run_break_set_by_source_regexp(
+            self, "// break in two", extra_options="-f two.c")
+        process.Continue()
+        self.check_value(target, "Two", [1, 2, 3])
+
+        # With a limit this small every compile unit that isn't in use gets
+        # its DIEs freed. Looking the types up again parses the DIEs again
+        # and must find the types that were already made from them.
+        self.wait_for_stat(target, "totalDebugInfoEvictions")
+        for name, num_fields in [("One", 2), ("Two", 3)]:
+            types = target.FindTypes(name)
+            self.assertEqual(types.GetSize(), 1)
+            self.assertEqual(types.GetTypeAtIndex(0).GetNumberOfFields(),
+                             num_fields)
+        self.wait_for_stat(target, "totalDebugInfoReparses")
+
+        process.Continue()
+        self.check_value(target, "One", [2, 3])
+        process.Continue()
+        self.check_value(target, "Two", [2, 4, 6])
@@ -0,0 +1,9 @@
+int one(int x);
+int two(int x);
+
+int main(int argc, char const *argv[]) {
+  int total = 0;
+  for (int i = 0; i < 2; ++i)
+    total += one(i + 1) + two(i + 1);
+  return total;
+}
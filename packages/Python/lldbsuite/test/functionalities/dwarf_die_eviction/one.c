@@ -0,0 +1,9 @@
+struct One {
+  int first;
+  int second;
+};
+
+int one(int x) {
+  struct One value = {x, x + 1};
+  return value.first + value.second; // break in one
+}
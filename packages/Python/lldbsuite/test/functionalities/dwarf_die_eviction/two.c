@@ -0,0 +1,10 @@
+struct Two {
+  long first;
+  long second;
+  long third;
+};
+
+int two(int x) {
+  struct Two value = {x, x * 2, x * 3};
+  return value.first + value.second + value.third; // break in two
+}
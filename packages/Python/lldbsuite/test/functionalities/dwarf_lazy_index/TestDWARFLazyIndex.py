@@ -0,0 +1,77 @@
+"""
+Test that lookups work when the DWARF is indexed lazily.
+"""
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class DWARFLazyIndexTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Darwin uses the Apple accelerator tables, which are never indexed.
+    @skipIfDarwin
+    def test_lazy_index(self):
+        """Test function and variable lookups with lazy DWARF indexing."""
+        self.build()
+        self.runCmd("settings set plugin.symbol-file.dwarf.lazy-index true")
+        self.addTearDownHook(
+            lambda: self.runCmd(
+                "settings clear plugin.symbol-file.dwarf.lazy-index"))
+
+        exe = self.getBuildArtifact("a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        bkpt = target.BreakpointCreateByName("foo")
+        self.assertEqual(bkpt.GetNumLocations(), 1)
+        functions = target.FindFunctions("main")
+        self.assertEqual(functions.GetSize(), 1)
+        self.assertTrue(functions[0].GetFunction().IsValid())
+
+        variables = target.FindGlobalVariables("g_foo", 1)
+        self.assertEqual(variables.GetSize(), 1)
+        self.assertEqual(variables[0].GetValueAsSigned(), 12)
+
+        # Lookups that can't be narrowed down use the full index.
+        types = target.FindTypes("int")
+        self.assertTrue(types.GetSize() > 0)
+
+    # Darwin uses the Apple accelerator tables, which are never indexed.
+    @skipIfDarwin
+    def test_background_index(self):
+        """Test that breakpoints are updated when the background index is done."""
+        self.build()
+        self.runCmd("settings set plugin.symbol-file.dwarf.lazy-index true")
+        self.addTearDownHook(
+            lambda: self.runCmd(
+                "settings clear plugin.symbol-file.dwarf.lazy-index"))
+        log_file = self.getBuildArtifact("dwarf-lookups.log")
+        self.runCmd("log enable -f %s dwarf lookups" % log_file)
+        self.addTearDownHook(lambda: self.runCmd("log disable dwarf"))
+
+        exe = self.getBuildArtifact("a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        listener = lldb.SBListener("dwarf-lazy-index")
+        target.GetBroadcaster().AddListener(
+            listener, lldb.SBTarget.eBroadcastBitSymbolsLoaded)
+
+        # The inlined function has no symbol, so the lookup can't find a
+        # compile unit for it and only the background index finds it.
+        bkpt = target.BreakpointCreateByName("inlined_in_bar")
+        event = lldb.SBEvent()
+        self.assertTrue(listener.WaitForEvent(60, event),
+                        "background index didn't finish")
+        self.assertTrue(lldb.SBTarget.EventIsTargetEvent(event))
+        self.assertEqual(bkpt.GetNumLocations(), 1)
+
+        self.runCmd("log disable dwarf")
+        with open(log_file, "r") as f:
+            log = f.read()
+        self.assertIn('(name="inlined_in_bar") indexed 0 of 3 compile units',
+                      log)
+        self.assertIn("finished indexing 3 compile units", log)
@@ -0,0 +1,5 @@
+static inline __attribute__((always_inline)) int inlined_in_bar(int x) {
+  return x * 2;
+}
+
+int bar(int x) { return inlined_in_bar(x) + 1; }
@@ -0,0 +1,3 @@
+int g_foo = 12;
+
+int foo(int x) { return x + g_foo; }
@@ -0,0 +1,8 @@
+int foo(int x);
+int bar(int x);
+
+int g_main = 3;
+
+int main(int argc, char const *argv[]) {
+  return foo(argc + g_main) + bar(argc); // Set a breakpoint here
+}
@@ -65,3 +65,68 @@ class ProcessSaveCoreTestCase(TestBase):
             self.assertTrue(self.dbg.DeleteTarget(target))
             if (os.path.isfile(core)):
                 os.unlink(core)
+
+    @not_remote_testsuite_ready
+    @skipUnlessWindows
+    def test_mini_dump_rejects_style(self):
+        """Test that a mini dump can't leave out file-backed memory."""
+        self.build()
+        exe = self.getBuildArtifact("a.out")
+        core = self.getBuildArtifact("core.dmp")
+        target = self.dbg.CreateTarget(exe)
+        breakpoint = target.BreakpointCreateByName("bar")
+        process = target.LaunchSimple(
+            None, None, self.get_process_working_directory())
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+        self.expect("process save-core -s skip-file-backed " + core,
+                    error=True, substrs=['"full" save-core style'])
+        self.assertFalse(os.path.isfile(core))
+        self.assertTrue(process.Kill().Success())
+
+    @not_remote_testsuite_ready
+    @skipUnlessPlatform(["linux"])
+    @skipIf(archs=no_match(["x86_64"]))
+    def test_save_linux_elf_core(self):
+        """Test that we can save and load a Linux ELF core file."""
+        self.build()
+        exe = self.getBuildArtifact("a.out")
+        core = self.getBuildArtifact("core.elf")
+        small_core = self.getBuildArtifact("core.small.elf")
+        try:
+            target = self.dbg.CreateTarget(exe)
+            breakpoint = target.BreakpointCreateByName("bar")
+            process = target.LaunchSimple(
+                None, None, self.get_process_working_directory())
+            self.assertEqual(process.GetState(), lldb.eStateStopped)
+            num_threads = process.GetNumThreads()
+            self.assertTrue(process.SaveCore(core))
+            self.assertTrue(os.path.isfile(core))
+            self.runCmd("process save-core -s skip-file-backed " + small_core)
+            self.assertTrue(os.path.isfile(small_core))
+            self.assertLess(os.path.getsize(small_core),
+                            os.path.getsize(core))
+            self.assertTrue(process.Kill().Success())
+
+            # Load the core file and check that we see the same threads, the
+            # thread stopped in "bar" and the executable in the module list.
+            for path in [core, small_core]:
+                target = self.dbg.CreateTarget(exe)
+                process = target.LoadCore(path)
+                self.assertTrue(process.IsValid(), PROCESS_IS_VALID)
+                self.assertEqual(process.GetNumThreads(), num_threads)
+                frame = process.GetSelectedThread().GetFrameAtIndex(0)
+                self.assertEqual(frame.GetFunctionName(), "bar")
+                files = [
+                    target.GetModuleAtIndex(i).GetFileSpec() for i in range(
+                        0, target.GetNumModules())]
+                paths = [
+                    os.path.join(
+                        f.GetDirectory(),
+                        f.GetFilename()) for f in files]
+                self.assertTrue(exe in paths)
+                self.assertTrue(self.dbg.DeleteTarget(target))
+
+        finally:
+            for path in [core, small_core]:
+                if (os.path.isfile(path)):
+                    os.unlink(path)
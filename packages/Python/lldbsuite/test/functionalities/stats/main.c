@@ -13,6 +13,8 @@ int main(void) {
   //%self.expect("frame var", substrs=['27'])
   //%self.expect("statistics disable")
   //%self.expect("statistics dump", substrs=['frame var successes : 1', 'frame var failures : 0'])
+  //%self.expect("statistics dump", substrs=['symbol table parse time : ', 'breakpoint resolve time : '])
+  //%self.expect("statistics dump --json", substrs=['"modules"', '"symbolTableParseTime"', '"breakpoints"', '"resolveTime"'])
 
   return 0;
 }
@@ -20,9 +20,35 @@ class TestStatsAPI(TestBase):
         stats = target.GetStatistics()
         stream = lldb.SBStream()
         res = stats.GetAsJSON(stream)
-        stats_json = sorted(json.loads(stream.GetData()))
-        self.assertEqual(len(stats_json), 4)
+        stats_json = json.loads(stream.GetData())
         self.assertTrue("Number of expr evaluation failures" in stats_json)
         self.assertTrue("Number of expr evaluation successes" in stats_json)
         self.assertTrue("Number of frame var failures" in stats_json)
         self.assertTrue("Number of frame var successes" in stats_json)
+
+        # Every module of the target is reported, with its own timings.
+        self.assertTrue("modules" in stats_json)
+        self.assertEqual(len(stats_json["modules"]), target.GetNumModules())
+        for module in stats_json["modules"]:
+            self.assertTrue("path" in module)
+            self.assertTrue("symbolTableParseTime" in module)
+            self.assertTrue("symbolTableIndexTime" in module)
+        self.assertTrue("totalSymbolTableParseTime" in stats_json)
+        self.assertTrue("totalDebugInfoParseTime" in stats_json)
+        self.assertTrue("totalDebugInfoIndexTime" in stats_json)
+        self.assertTrue("totalDebugInfoByteSize" in stats_json)
+        self.assertTrue("totalDebugInfoMemorySize" in stats_json)
+        self.assertTrue("totalDebugInfoEvictions" in stats_json)
+        self.assertTrue("totalDebugInfoReparses" in stats_json)
+        self.assertTrue("constStrings" in stats_json)
+
+        # Breakpoints report how long it took to resolve them.
+        bkpt = target.BreakpointCreateByName("main")
+        stream.Clear()
+        target.GetStatistics().GetAsJSON(stream)
+        stats_json = json.loads(stream.GetData())
+        self.assertEqual(len(stats_json["breakpoints"]), 1)
+        bkpt_stats = stats_json["breakpoints"][0]
+        self.assertEqual(bkpt_stats["id"], bkpt.GetID())
+        self.assertEqual(bkpt_stats["numLocations"], bkpt.GetNumLocations())
+        self.assertTrue("resolveTime" in bkpt_stats)
@@ -0,0 +1,98 @@
+"""
+Test the backtraces of threads that are unwound in parallel.
+"""
+
+from __future__ import print_function
+
+
+import json
+import re
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class ParallelBacktraceTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # The number of threads started by main.cpp.
+    num_threads = 16
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+
+    def launch_and_stop(self):
+        self.build()
+        exe = self.getBuildArtifact("a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+        lldbutil.run_break_set_by_file_and_line(
+            self, "main.cpp", self.line, num_expected_locations=1)
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+                    substrs=["stop reason = breakpoint 1."])
+        return self.dbg.GetSelectedTarget().GetProcess()
+
+    @skipIfWindows
+    def test_backtrace_all(self):
+        """Test that "thread backtrace all" prints every thread in order."""
+        process = self.launch_and_stop()
+
+        result = lldb.SBCommandReturnObject()
+        self.dbg.GetCommandInterpreter().HandleCommand("thread backtrace all",
+                                                       result)
+        self.assertTrue(result.Succeeded())
+        output = result.GetOutput()
+
+        # Every thread is printed once, in thread list order.
+        index_ids = [int(index_id) for index_id in
+                     re.findall(r"^\*? *thread #(\d+)", output, re.MULTILINE)]
+        self.assertEqual(index_ids,
+                         [thread.GetIndexID() for thread in process])
+
+        # Thread number i has i + 1 frames of recurse().
+        depths = [chunk.count("`recurse(") for chunk in
+                  re.split(r"^\*? *thread #", output, flags=re.MULTILINE)]
+        for depth in range(1, self.num_threads + 1):
+            self.assertTrue(depth in depths)
+
+    @skipIfWindows
+    @add_test_categories(['pyapi'])
+    def test_get_all_backtraces(self):
+        """Test SBProcess.GetAllBacktraces."""
+        process = self.launch_and_stop()
+
+        data = process.GetAllBacktraces()
+        self.assertTrue(data.IsValid())
+        stream = lldb.SBStream()
+        data.GetAsJSON(stream)
+        backtraces = json.loads(stream.GetData())
+
+        # The threads are in thread list order and their frames match the
+        # frames of the SBThreads.
+        self.assertEqual(len(backtraces), process.GetNumThreads())
+        depths = []
+        for thread, backtrace in zip(process, backtraces):
+            self.assertEqual(backtrace["tid"], thread.GetThreadID())
+            self.assertEqual(backtrace["index"], thread.GetIndexID())
+            self.assertEqual(len(backtrace["frames"]), thread.GetNumFrames())
+            for frame, frame_dict in zip(thread, backtrace["frames"]):
+                self.assertEqual(frame_dict["index"], frame.GetFrameID())
+                self.assertEqual(frame_dict["pc"], frame.GetPC())
+                if frame.GetFunctionName():
+                    self.assertEqual(frame_dict["function"],
+                                     frame.GetFunctionName())
+            depths.append(len([frame for frame in backtrace["frames"]
+                               if frame.get("function", "").startswith(
+                                   "recurse(")]))
+        for depth in range(1, self.num_threads + 1):
+            self.assertTrue(depth in depths)
+
+        # Ask for fewer frames.
+        stream.Clear()
+        process.GetAllBacktraces(2).GetAsJSON(stream)
+        for backtrace in json.loads(stream.GetData()):
+            self.assertTrue(len(backtrace["frames"]) <= 2)
@@ -0,0 +1,31 @@
+#include "pseudo_barrier.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+pseudo_barrier_t g_barrier;
+
+// Every thread has a different call depth, so that each backtrace is
+// different.
+int recurse(int depth) {
+  if (depth == 0) {
+    pseudo_barrier_wait(g_barrier);
+    while (true)
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+  }
+  return recurse(depth - 1) + 1;
+}
+
+void thread_func(int depth) { recurse(depth); }
+
+int main() {
+  const int num_threads = 16;
+  pseudo_barrier_init(g_barrier, num_threads + 1);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+    threads.push_back(std::thread(thread_func, i));
+
+  pseudo_barrier_wait(g_barrier);
+  return 0; // Set break point at this line.
+}
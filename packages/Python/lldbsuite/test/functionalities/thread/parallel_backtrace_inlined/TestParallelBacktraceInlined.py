@@ -0,0 +1,73 @@
+"""
+Test unwinding many threads in parallel that are stopped in the same inlined
+functions.
+"""
+
+from __future__ import print_function
+
+
+import re
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class ParallelBacktraceInlinedTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # The number of threads started by main.cpp.
+    num_threads = 32
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+
+    @skipIfWindows
+    def test_backtrace_all_inlined(self):
+        """Test that every thread gets the same inlined frames when the
+           blocks of their function are parsed while unwinding in parallel."""
+        self.build()
+        exe = self.getBuildArtifact("a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+        self.runCmd("settings set target.process.parallel-unwind true")
+        lldbutil.run_break_set_by_file_and_line(
+            self, "main.cpp", self.line, num_expected_locations=1)
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+                    substrs=["stop reason = breakpoint 1."])
+        process = self.dbg.GetSelectedTarget().GetProcess()
+
+        # Nothing has looked at the blocks of thread_func() yet, the first
+        # unwind of the worker threads parses them.
+        result = lldb.SBCommandReturnObject()
+        self.dbg.GetCommandInterpreter().HandleCommand("thread backtrace all",
+                                                       result)
+        self.assertTrue(result.Succeeded())
+        chunks = re.split(r"^\*? *thread #", result.GetOutput(),
+                          flags=re.MULTILINE)
+        workers = [chunk for chunk in chunks if "`thread_func" in chunk]
+        self.assertEqual(len(workers), self.num_threads)
+        for chunk in workers:
+            functions = re.findall(r"`(inlined_inner|inlined_outer|"
+                                   r"thread_func)", chunk)
+            self.assertEqual(functions,
+                             ["inlined_inner", "inlined_outer", "thread_func"],
+                             chunk)
+
+        # The SB API sees the same frames.
+        num_workers = 0
+        for thread in process:
+            frames = [frame for frame in thread if frame.GetFunctionName()]
+            names = [frame.GetFunctionName().split("(")[0]
+                     for frame in frames]
+            if "thread_func" not in names:
+                continue
+            num_workers += 1
+            start = names.index("inlined_inner")
+            self.assertEqual(names[start:start + 3],
+                             ["inlined_inner", "inlined_outer", "thread_func"])
+            self.assertTrue(frames[start].IsInlined())
+        self.assertEqual(num_workers, self.num_threads)
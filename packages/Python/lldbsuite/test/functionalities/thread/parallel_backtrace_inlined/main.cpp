@@ -0,0 +1,32 @@
+#include "pseudo_barrier.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+pseudo_barrier_t g_barrier;
+
+// All of the threads stop in the same inlined functions, so unwinding them
+// in parallel makes them all parse the blocks of thread_func() at once.
+static inline __attribute__((always_inline)) void inlined_inner() {
+  pseudo_barrier_wait(g_barrier);
+  while (true)
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+}
+
+static inline __attribute__((always_inline)) void inlined_outer() {
+  inlined_inner();
+}
+
+void thread_func() { inlined_outer(); }
+
+int main() {
+  const int num_threads = 32;
+  pseudo_barrier_init(g_barrier, num_threads + 1);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+    threads.push_back(std::thread(thread_func));
+
+  pseudo_barrier_wait(g_barrier);
+  return 0; // Set break point at this line.
+}
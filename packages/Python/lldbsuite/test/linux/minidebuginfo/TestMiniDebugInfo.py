@@ -0,0 +1,57 @@
+""" Testing symbols from the MiniDebugInfo in the .gnu_debugdata section. """
+import distutils.spawn
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+def xz_is_missing():
+    if distutils.spawn.find_executable("xz") is None:
+        return "xz is needed to build the MiniDebugInfo"
+    return None
+
+
+class TestMiniDebugInfo(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NO_DEBUG_INFO_TESTCASE = True
+
+    @skipUnlessPlatform(['linux'])
+    @skipIfRemote
+    @skipTestIfFn(xz_is_missing)
+    def test_minidebuginfo(self):
+        """Test that a function that is only in .gnu_debugdata is found."""
+        self.build()
+        exe = self.getBuildArtifact("binary")
+        # Without liblzma lldb skips .gnu_debugdata and says so in the log.
+        log_file = self.getBuildArtifact("symbols.log")
+        self.runCmd("log enable -f %s lldb symbol" % log_file)
+        self.addTearDownHook(lambda: self.runCmd("log disable lldb symbol"))
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        target.GetModuleAtIndex(0).GetNumSymbols()
+        self.runCmd("log disable lldb symbol")
+        with open(log_file, "r") as f:
+            if "lldb was built without LZMA support" in f.read():
+                self.skipTest("lldb was built without LZMA support")
+
+        # The symbol isn't in .dynsym, so it can only come from the
+        # compressed symbol table.
+        sc_list = target.FindSymbols("multiplyByThree", lldb.eSymbolTypeCode)
+        self.assertEqual(sc_list.GetSize(), 1)
+        symbol = sc_list.GetContextAtIndex(0).GetSymbol()
+        self.assertTrue(symbol.IsValid())
+        self.assertTrue(symbol.GetStartAddress().GetSection().IsValid())
+
+        # The symbol must resolve to the .text of the binary itself.
+        bkpt = target.BreakpointCreateByName("multiplyByThree")
+        self.assertEqual(bkpt.GetNumLocations(), 1)
+        process = target.LaunchSimple(
+            None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, bkpt)
+        self.assertTrue(thread.IsValid())
+        self.assertEqual(thread.GetFrameAtIndex(0).GetFunctionName(),
+                         "multiplyByThree")
@@ -0,0 +1,9 @@
+// This function is static, so it is only in .symtab, which is stripped from
+// the binary and then added back in the compressed .gnu_debugdata section.
+static int __attribute__((noinline)) multiplyByThree(int num) {
+  return num * 3; // Set a breakpoint here.
+}
+
+int main(int argc, char *argv[]) {
+  return multiplyByThree(argc);
+}
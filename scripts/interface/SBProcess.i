@@ -165,6 +165,14 @@ public:
     lldb::SBThread
     GetSelectedThread () const;
 
+    %feature("autodoc", "
+    Returns the backtraces of all threads, at most max_frames frames each,
+    as an SBStructuredData array with a dictionary for each thread.  The
+    threads are unwound several at a time.
+    ") GetAllBacktraces;
+    lldb::SBStructuredData
+    GetAllBacktraces (uint32_t max_frames = UINT32_MAX);
+
     %feature("autodoc", "
     Lazily create a thread on demand through the current OperatingSystem plug-in, if the current OperatingSystem plug-in supports it.
     ") CreateOSPluginThread;
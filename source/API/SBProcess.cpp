@@ -20,10 +20,12 @@
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Core/StructuredDataImpl.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/SystemRuntime.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
@@ -474,6 +476,68 @@ SBThread SBProcess::GetThreadAtIndex(size_t index) {
   return sb_thread;
 }
 
+SBStructuredData SBProcess::GetAllBacktraces(uint32_t max_frames) {
+  SBStructuredData data;
+  ProcessSP process_sp(GetSP());
+  if (!process_sp || max_frames == 0)
+    return data;
+
+  Process::StopLocker stop_locker;
+  if (!stop_locker.TryLock(&process_sp->GetRunLock()))
+    return data;
+  std::lock_guard<std::recursive_mutex> guard(
+      process_sp->GetTarget().GetAPIMutex());
+  Target &target = process_sp->GetTarget();
+
+  std::vector<ThreadSP> threads;
+  for (ThreadSP thread_sp : process_sp->Threads())
+    threads.push_back(thread_sp);
+  process_sp->PrefetchThreadRegisters(threads);
+  process_sp->UnwindThreads(threads, max_frames);
+
+  // The threads were unwound in parallel, build the backtraces from the
+  // cached frames in thread list order.
+  auto threads_sp = std::make_shared<StructuredData::Array>();
+  for (const ThreadSP &thread_sp : threads) {
+    auto thread_dict_sp = std::make_shared<StructuredData::Dictionary>();
+    thread_dict_sp->AddIntegerItem("tid", thread_sp->GetID());
+    thread_dict_sp->AddIntegerItem("index", thread_sp->GetIndexID());
+    if (const char *name = thread_sp->GetName())
+      thread_dict_sp->AddStringItem("name", name);
+
+    auto frames_sp = std::make_shared<StructuredData::Array>();
+    for (uint32_t idx = 0; idx < max_frames; ++idx) {
+      StackFrameSP frame_sp = thread_sp->GetStackFrameAtIndex(idx);
+      if (!frame_sp)
+        break;
+      auto frame_dict_sp = std::make_shared<StructuredData::Dictionary>();
+      frame_dict_sp->AddIntegerItem("index", idx);
+      frame_dict_sp->AddIntegerItem(
+          "pc", frame_sp->GetFrameCodeAddress().GetLoadAddress(&target));
+      const SymbolContext &sc = frame_sp->GetSymbolContext(
+          eSymbolContextModule | eSymbolContextFunction | eSymbolContextBlock |
+          eSymbolContextSymbol | eSymbolContextLineEntry);
+      if (sc.module_sp)
+        frame_dict_sp->AddStringItem("module",
+                                     sc.module_sp->GetFileSpec().GetPath());
+      ConstString function_name = sc.GetFunctionName();
+      if (function_name)
+        frame_dict_sp->AddStringItem("function",
+                                     function_name.GetStringRef());
+      if (sc.line_entry.IsValid()) {
+        frame_dict_sp->AddStringItem("file", sc.line_entry.file.GetPath());
+        frame_dict_sp->AddIntegerItem("line", sc.line_entry.line);
+      }
+      frames_sp->AddItem(frame_dict_sp);
+    }
+    thread_dict_sp->AddItem("frames", frames_sp);
+    threads_sp->AddItem(thread_dict_sp);
+  }
+
+  data.m_impl_up->SetObjectSP(threads_sp);
+  return data;
+}
+
 uint32_t SBProcess::GetNumQueues() {
   Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_API));
 
@@ -1280,25 +1280,79 @@ protected:
 //-------------------------------------------------------------------------
 #pragma mark CommandObjectProcessSaveCore
 
+static OptionEnumValueElement g_save_core_style[] = {
+    {eSaveCoreFull, "full", "Save all readable memory."},
+    {eSaveCoreSkipFileBacked, "skip-file-backed",
+     "Don't save the contents of read-only mappings of files, the debugger "
+     "reads them from the mapped files when the core file is loaded."},
+    {0, nullptr, nullptr}};
+
+static OptionDefinition g_process_save_core_options[] = {
+    // clang-format off
+  { LLDB_OPT_SET_1, false, "style", 's', OptionParser::eRequiredArgument, nullptr, g_save_core_style, 0, eArgTypeSaveCoreStyle, "Which memory regions to save in the core file, defaults to all of them." },
+    // clang-format on
+};
+
 class CommandObjectProcessSaveCore : public CommandObjectParsed {
 public:
+  class CommandOptions : public Options {
+  public:
+    CommandOptions() : Options() { OptionParsingStarting(nullptr); }
+
+    ~CommandOptions() override = default;
+
+    Status SetOptionValue(uint32_t option_idx, llvm::StringRef option_arg,
+                          ExecutionContext *execution_context) override {
+      Status error;
+      const int short_option = m_getopt_table[option_idx].val;
+
+      switch (short_option) {
+      case 's':
+        m_core_style = (SaveCoreStyle)Args::StringToOptionEnum(
+            option_arg, GetDefinitions()[option_idx].enum_values,
+            eSaveCoreFull, error);
+        break;
+      default:
+        error.SetErrorStringWithFormat("invalid short option character '%c'",
+                                       short_option);
+        break;
+      }
+      return error;
+    }
+
+    void OptionParsingStarting(ExecutionContext *execution_context) override {
+      m_core_style = eSaveCoreFull;
+    }
+
+    llvm::ArrayRef<OptionDefinition> GetDefinitions() override {
+      return llvm::makeArrayRef(g_process_save_core_options);
+    }
+
+    // Instance variables to hold the values for command options.
+    SaveCoreStyle m_core_style;
+  };
+
   CommandObjectProcessSaveCore(CommandInterpreter &interpreter)
       : CommandObjectParsed(interpreter, "process save-core",
                             "Save the current process as a core file using an "
                             "appropriate file type.",
-                            "process save-core FILE",
+                            "process save-core [-s <style>] FILE",
                             eCommandRequiresProcess | eCommandTryTargetAPILock |
-                                eCommandProcessMustBeLaunched) {}
+                                eCommandProcessMustBeLaunched),
+        m_options() {}
 
   ~CommandObjectProcessSaveCore() override = default;
 
+  Options *GetOptions() override { return &m_options; }
+
 protected:
   bool DoExecute(Args &command, CommandReturnObject &result) override {
     ProcessSP process_sp = m_exe_ctx.GetProcessSP();
     if (process_sp) {
       if (command.GetArgumentCount() == 1) {
         FileSpec output_file(command.GetArgumentAtIndex(0), false);
-        Status error = PluginManager::SaveCore(process_sp, output_file);
+        Status error = PluginManager::SaveCore(process_sp, output_file,
+                                               m_options.m_core_style);
         if (error.Success()) {
           result.SetStatus(eReturnStatusSuccessFinishResult);
         } else {
@@ -1319,6 +1373,8 @@ protected:
 
     return result.Succeeded();
   }
+
+  CommandOptions m_options;
 };
 
 //-------------------------------------------------------------------------
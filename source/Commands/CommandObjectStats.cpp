@@ -9,8 +9,11 @@
 
 #include "CommandObjectStats.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/OptionParser.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Interpreter/Options.h"
+#include "lldb/Target/Statistics.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
@@ -66,17 +69,68 @@ protected:
   }
 };
 
+static OptionDefinition g_statistics_dump_options[] = {
+    // clang-format off
+  { LLDB_OPT_SET_1, false, "json", 'j', OptionParser::eNoArgument, nullptr, nullptr, 0, eArgTypeNone, "Dump all of the statistics, including per module and per breakpoint details, as JSON." },
+    // clang-format on
+};
+
 class CommandObjectStatsDump : public CommandObjectParsed {
+  class CommandOptions : public Options {
+  public:
+    CommandOptions() : Options() { OptionParsingStarting(nullptr); }
+
+    ~CommandOptions() override = default;
+
+    Status SetOptionValue(uint32_t option_idx, llvm::StringRef option_arg,
+                          ExecutionContext *execution_context) override {
+      Status error;
+      const int short_option = GetDefinitions()[option_idx].short_option;
+      switch (short_option) {
+      case 'j':
+        m_json = true;
+        break;
+      default:
+        error.SetErrorStringWithFormat("unrecognized short option '%c'",
+                                       short_option);
+        break;
+      }
+      return error;
+    }
+
+    void OptionParsingStarting(ExecutionContext *execution_context) override {
+      m_json = false;
+    }
+
+    llvm::ArrayRef<OptionDefinition> GetDefinitions() override {
+      return llvm::makeArrayRef(g_statistics_dump_options);
+    }
+
+    bool m_json;
+  };
+
 public:
   CommandObjectStatsDump(CommandInterpreter &interpreter)
       : CommandObjectParsed(interpreter, "dump", "Dump statistics results",
-                            nullptr, eCommandProcessMustBePaused) {}
+                            nullptr, eCommandProcessMustBePaused),
+        m_options() {}
 
   ~CommandObjectStatsDump() override = default;
 
+  Options *GetOptions() override { return &m_options; }
+
 protected:
   bool DoExecute(Args &command, CommandReturnObject &result) override {
     Target *target = GetSelectedOrDummyTarget();
+    StructuredData::DictionarySP stats_sp =
+        TargetStats::ReportStatistics(*target);
+
+    if (m_options.m_json) {
+      stats_sp->Dump(result.GetOutputStream());
+      result.GetOutputStream().EOL();
+      result.SetStatus(eReturnStatusSuccessFinishResult);
+      return true;
+    }
 
     uint32_t i = 0;
     for (auto &stat : target->GetStatistics()) {
@@ -87,9 +141,35 @@ protected:
           stat);
       i += 1;
     }
+
+    // Summarize the rest, "--json" has the details.
+    static const char *const g_total_times[][2] = {
+        {"totalSymbolTableParseTime", "symbol table parse time"},
+        {"totalSymbolTableIndexTime", "symbol table index time"},
+        {"totalDebugInfoParseTime", "debug info parse time"},
+        {"totalDebugInfoIndexTime", "debug info index time"},
+        {"totalBreakpointResolveTime", "breakpoint resolve time"}};
+    for (const auto &total : g_total_times) {
+      StructuredData::ObjectSP value_sp = stats_sp->GetValueForKey(total[0]);
+      if (value_sp && value_sp->GetAsFloat())
+        result.AppendMessageWithFormat("%s : %.6fs\n", total[1],
+                                       value_sp->GetAsFloat()->GetValue());
+    }
+    uint64_t debug_info_size = 0;
+    if (stats_sp->GetValueForKeyAsInteger("totalDebugInfoByteSize",
+                                          debug_info_size))
+      result.AppendMessageWithFormat("debug info size : %" PRIu64 "\n",
+                                     debug_info_size);
+    uint64_t debug_info_memory = 0;
+    if (stats_sp->GetValueForKeyAsInteger("totalDebugInfoMemorySize",
+                                          debug_info_memory))
+      result.AppendMessageWithFormat("debug info memory : %" PRIu64 "\n",
+                                     debug_info_memory);
     result.SetStatus(eReturnStatusSuccessFinishResult);
     return true;
   }
+
+  CommandOptions m_options;
 };
 
 CommandObjectStats::CommandObjectStats(CommandInterpreter &interpreter)
@@ -10,9 +10,11 @@
 #include "CommandObjectTarget.h"
 
 // Project includes
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/IOHandler.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
@@ -4364,6 +4366,111 @@ protected:
   OptionGroupBoolean m_current_frame_option;
 };
 
+#pragma mark CommandObjectTargetSymbolsIndexCacheList
+
+//-------------------------------------------------------------------------
+// CommandObjectTargetSymbolsIndexCacheList
+//-------------------------------------------------------------------------
+
+class CommandObjectTargetSymbolsIndexCacheList : public CommandObjectParsed {
+public:
+  CommandObjectTargetSymbolsIndexCacheList(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "target symbols index-cache list",
+                            "List the files in the on-disk symbol index "
+                            "cache.",
+                            "target symbols index-cache list") {}
+
+  ~CommandObjectTargetSymbolsIndexCacheList() override = default;
+
+protected:
+  bool DoExecute(Args &command, CommandReturnObject &result) override {
+    Stream &strm = result.GetOutputStream();
+    const FileSpec cache_dir = DataFileCache::GetIndexCacheDirectory();
+    const bool enabled =
+        ModuleList::GetGlobalModuleListProperties().GetEnableIndexCache();
+    strm.Printf("Index cache: %s (%s)\n", cache_dir.GetPath().c_str(),
+                enabled ? "enabled" : "disabled");
+
+    DataFileCache cache(cache_dir);
+    uint64_t total_size = 0;
+    const size_t num_files = cache.ForEachCacheFile(
+        [&strm, &total_size](const FileSpec &file, uint64_t size) -> bool {
+          strm.Printf("%12" PRIu64 " %s\n", size,
+                      file.GetFilename().AsCString("<unknown>"));
+          total_size += size;
+          return true;
+        });
+    strm.Printf("%" PRIu64 " cache files using %" PRIu64 " bytes.\n",
+                (uint64_t)num_files, total_size);
+    result.SetStatus(eReturnStatusSuccessFinishResult);
+    return result.Succeeded();
+  }
+};
+
+#pragma mark CommandObjectTargetSymbolsIndexCachePurge
+
+//-------------------------------------------------------------------------
+// CommandObjectTargetSymbolsIndexCachePurge
+//-------------------------------------------------------------------------
+
+class CommandObjectTargetSymbolsIndexCachePurge : public CommandObjectParsed {
+public:
+  CommandObjectTargetSymbolsIndexCachePurge(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "target symbols index-cache purge",
+                            "Remove all files from the on-disk symbol index "
+                            "cache.",
+                            "target symbols index-cache purge") {}
+
+  ~CommandObjectTargetSymbolsIndexCachePurge() override = default;
+
+protected:
+  bool DoExecute(Args &command, CommandReturnObject &result) override {
+    const FileSpec cache_dir = DataFileCache::GetIndexCacheDirectory();
+    DataFileCache *cache = DataFileCache::GetIndexCache();
+    DataFileCache disabled_cache(cache_dir);
+    if (cache == nullptr)
+      cache = &disabled_cache;
+    Status error = cache->Purge();
+    if (error.Fail()) {
+      result.AppendErrorWithFormat("failed to purge index cache '%s': %s\n",
+                                   cache_dir.GetPath().c_str(),
+                                   error.AsCString());
+      result.SetStatus(eReturnStatusFailed);
+      return false;
+    }
+    result.SetStatus(eReturnStatusSuccessFinishNoResult);
+    return result.Succeeded();
+  }
+};
+
+#pragma mark CommandObjectTargetSymbolsIndexCache
+
+//-------------------------------------------------------------------------
+// CommandObjectTargetSymbolsIndexCache
+//-------------------------------------------------------------------------
+
+class CommandObjectTargetSymbolsIndexCache : public CommandObjectMultiword {
+public:
+  CommandObjectTargetSymbolsIndexCache(CommandInterpreter &interpreter)
+      : CommandObjectMultiword(
+            interpreter, "target symbols index-cache",
+            "Commands for inspecting and purging the on-disk symbol index "
+            "cache (see \"settings set symbols.enable-index-cache\").",
+            "target symbols index-cache <sub-command> ...") {
+    LoadSubCommand("list", CommandObjectSP(
+                               new CommandObjectTargetSymbolsIndexCacheList(
+                                   interpreter)));
+    LoadSubCommand("purge", CommandObjectSP(
+                                new CommandObjectTargetSymbolsIndexCachePurge(
+                                    interpreter)));
+  }
+
+  ~CommandObjectTargetSymbolsIndexCache() override = default;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(CommandObjectTargetSymbolsIndexCache);
+};
+
 #pragma mark CommandObjectTargetSymbols
 
 //-------------------------------------------------------------------------
@@ -4382,6 +4489,9 @@ public:
             "target symbols <sub-command> ...") {
     LoadSubCommand(
         "add", CommandObjectSP(new CommandObjectTargetSymbolsAdd(interpreter)));
+    LoadSubCommand("index-cache",
+                   CommandObjectSP(
+                       new CommandObjectTargetSymbolsIndexCache(interpreter)));
   }
 
   ~CommandObjectTargetSymbols() override = default;
@@ -110,8 +110,15 @@ public:
     if (all_threads || m_unique_stacks) {
       Process *process = m_exe_ctx.GetProcessPtr();
 
-      for (ThreadSP thread_sp : process->Threads())
+      std::vector<ThreadSP> threads;
+      for (ThreadSP thread_sp : process->Threads()) {
         tids.push_back(thread_sp->GetID());
+        threads.push_back(thread_sp);
+      }
+      // Every thread is about to be unwound, let the process fetch the
+      // registers for all of them at once.
+      process->PrefetchThreadRegisters(threads);
+      WillHandleThreads(threads);
     } else {
       const size_t num_args = command.GetArgumentCount();
       Process *process = m_exe_ctx.GetProcessPtr();
@@ -203,6 +210,11 @@ protected:
 
   virtual bool HandleOneThread(lldb::tid_t, CommandReturnObject &result) = 0;
 
+  // Called with all of the threads of the process before they are handled
+  // for "all" and "unique", so that work that doesn't produce output can be
+  // done for all of the threads at once.
+  virtual void WillHandleThreads(llvm::ArrayRef<lldb::ThreadSP> threads) {}
+
   bool BucketThread(lldb::tid_t tid, std::set<UniqueStack> &unique_stacks,
                     CommandReturnObject &result) {
     // Grab the corresponding thread for the given thread id.
@@ -361,6 +373,17 @@ protected:
     }
   }
 
+  void WillHandleThreads(llvm::ArrayRef<lldb::ThreadSP> threads) override {
+    // Unwind the threads in parallel, the backtraces are then printed one
+    // thread at a time in order from the frames cached in each thread.
+    // Finding unique stacks looks at every frame.
+    uint32_t max_frames = UINT32_MAX;
+    if (!m_unique_stacks && m_options.m_count != UINT32_MAX &&
+        m_options.m_start < UINT32_MAX - m_options.m_count)
+      max_frames = m_options.m_start + m_options.m_count;
+    m_exe_ctx.GetProcessPtr()->UnwindThreads(threads, max_frames);
+  }
+
   bool HandleOneThread(lldb::tid_t tid, CommandReturnObject &result) override {
     ThreadSP thread_sp =
         m_exe_ctx.GetProcessPtr()->GetThreadList().FindThreadByID(tid);
@@ -0,0 +1,237 @@
+//===-- DataFileCache.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/DataFileCache.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Target/Platform.h"
+#include "lldb/Utility/DataBufferLLVM.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Log.h"
+#include "lldb/Utility/Stream.h"
+
+#include "llvm/ADT/Hashing.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <map>
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+const char *kIndexCacheDirName = "index_cache";
+const char *kTempFileModel = "tmp-%%%%%%%%";
+const char *kFSIllegalChars = "\\/:*?\"<>|";
+const uint32_t kUUIDMaxSize = 20;
+} // namespace
+
+CacheSignature::CacheSignature(Module &module) {
+  m_uuid = module.GetUUID();
+  m_mod_time = llvm::sys::toTimeT(module.GetModificationTime());
+  if (module.GetObjectName())
+    m_obj_mod_time = llvm::sys::toTimeT(module.GetObjectModificationTime());
+}
+
+CacheSignature::CacheSignature(ObjectFile &objfile) {
+  objfile.GetUUID(&m_uuid);
+  m_mod_time = llvm::sys::toTimeT(
+      FileSystem::GetModificationTime(objfile.GetFileSpec()));
+}
+
+void CacheSignature::Encode(Stream &strm) const {
+  const uint8_t uuid_size = m_uuid.IsValid() ? m_uuid.GetByteSize() : 0;
+  strm.PutHex8(uuid_size);
+  if (uuid_size)
+    strm.Write(m_uuid.GetBytes(), uuid_size);
+  strm.PutHex64(m_mod_time);
+  strm.PutHex64(m_obj_mod_time);
+}
+
+bool CacheSignature::Decode(const DataExtractor &data,
+                            lldb::offset_t *offset_ptr) {
+  const uint8_t uuid_size = data.GetU8(offset_ptr);
+  if (uuid_size > kUUIDMaxSize)
+    return false;
+  if (uuid_size) {
+    const void *uuid_bytes = data.GetData(offset_ptr, uuid_size);
+    if (uuid_bytes == nullptr)
+      return false;
+    m_uuid.SetBytes(uuid_bytes, uuid_size);
+  } else {
+    m_uuid.Clear();
+  }
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, 2 * sizeof(uint64_t)))
+    return false;
+  m_mod_time = data.GetU64(offset_ptr);
+  m_obj_mod_time = data.GetU64(offset_ptr);
+  return true;
+}
+
+DataFileCache::DataFileCache(const FileSpec &cache_dir)
+    : m_cache_dir(cache_dir), m_mutex() {}
+
+FileSpec DataFileCache::GetIndexCacheDirectory() {
+  FileSpec cache_dir =
+      ModuleList::GetGlobalModuleListProperties().GetIndexCachePath();
+  if (cache_dir)
+    return cache_dir;
+
+  // Default to a directory that lives next to the platform module cache.
+  FileSpec module_cache_dir =
+      Platform::GetGlobalPlatformProperties()->GetModuleCacheDirectory();
+  if (!module_cache_dir)
+    return FileSpec();
+  cache_dir = FileSpec(module_cache_dir.GetDirectory().GetStringRef(), false);
+  cache_dir.AppendPathComponent(kIndexCacheDirName);
+  return cache_dir;
+}
+
+DataFileCache *DataFileCache::GetIndexCache() {
+  static std::mutex g_mutex;
+  // The cache directory is a setting that can change during a session. Keep
+  // one cache per directory alive for the lifetime of the process since
+  // callers don't hold a reference to the cache they were given.
+  static std::map<std::string, std::unique_ptr<DataFileCache>> g_index_caches;
+
+  if (!ModuleList::GetGlobalModuleListProperties().GetEnableIndexCache())
+    return nullptr;
+
+  FileSpec cache_dir = GetIndexCacheDirectory();
+  if (!cache_dir)
+    return nullptr;
+
+  std::lock_guard<std::mutex> guard(g_mutex);
+  std::unique_ptr<DataFileCache> &cache_up =
+      g_index_caches[cache_dir.GetPath()];
+  if (!cache_up)
+    cache_up.reset(new DataFileCache(cache_dir));
+  return cache_up.get();
+}
+
+std::string DataFileCache::GetModuleCacheKey(Module &module,
+                                             llvm::StringRef kind) {
+  std::string key;
+  llvm::raw_string_ostream strm(key);
+  strm << module.GetFileSpec().GetFilename().GetStringRef();
+  if (ConstString object_name = module.GetObjectName())
+    strm << '(' << object_name.GetStringRef() << ')';
+  const UUID &uuid = module.GetUUID();
+  if (uuid.IsValid())
+    strm << '-' << uuid.GetAsString();
+  else
+    strm << '-'
+         << llvm::format_hex_no_prefix(
+                llvm::hash_value(module.GetFileSpec().GetPath()), 16);
+  strm << '-' << kind;
+  strm.flush();
+
+  for (char &ch : key) {
+    if ((ch >= 1 && ch <= 31) || strchr(kFSIllegalChars, ch) != nullptr)
+      ch = '_';
+  }
+  return key;
+}
+
+FileSpec DataFileCache::GetCacheFilePath(llvm::StringRef key) const {
+  FileSpec cache_file(m_cache_dir);
+  cache_file.AppendPathComponent(key);
+  return cache_file;
+}
+
+DataBufferSP DataFileCache::GetCachedData(llvm::StringRef key) {
+  FileSpec cache_file = GetCacheFilePath(key);
+  if (!cache_file.Exists())
+    return DataBufferSP();
+  return DataBufferLLVM::CreateFromPath(cache_file.GetPath());
+}
+
+bool DataFileCache::SetCachedData(llvm::StringRef key,
+                                  llvm::ArrayRef<uint8_t> data) {
+  namespace fs = llvm::sys::fs;
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_MODULES));
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+  if (std::error_code ec = fs::create_directories(m_cache_dir.GetPath(), true,
+                                                  fs::perms::owner_all)) {
+    if (log)
+      log->Printf("DataFileCache: failed to create %s: %s",
+                  m_cache_dir.GetPath().c_str(), ec.message().c_str());
+    return false;
+  }
+
+  // Write to a temporary file first and rename it into place so that other
+  // debug sessions never see a partially written cache file.
+  FileSpec temp_model = GetCacheFilePath(kTempFileModel);
+  int temp_fd = -1;
+  llvm::SmallString<128> temp_path;
+  if (fs::createUniqueFile(temp_model.GetPath(), temp_fd, temp_path))
+    return false;
+  {
+    llvm::raw_fd_ostream temp_file(temp_fd, /*shouldClose=*/true);
+    temp_file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    temp_file.close();
+    if (temp_file.has_error()) {
+      temp_file.clear_error();
+      fs::remove(temp_path);
+      return false;
+    }
+  }
+
+  const std::string cache_path = GetCacheFilePath(key).GetPath();
+  if (std::error_code ec = fs::rename(temp_path, cache_path)) {
+    if (log)
+      log->Printf("DataFileCache: failed to write %s: %s", cache_path.c_str(),
+                  ec.message().c_str());
+    fs::remove(temp_path);
+    return false;
+  }
+  return true;
+}
+
+Status DataFileCache::RemoveCacheFile(llvm::StringRef key) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return Status(llvm::sys::fs::remove(GetCacheFilePath(key).GetPath()));
+}
+
+size_t DataFileCache::ForEachCacheFile(
+    std::function<bool(const FileSpec &file, uint64_t size)> const &callback) {
+  namespace fs = llvm::sys::fs;
+  size_t num_files = 0;
+  std::error_code ec;
+  for (fs::directory_iterator pos(m_cache_dir.GetPath(), ec), end;
+       pos != end && !ec; pos.increment(ec)) {
+    llvm::ErrorOr<fs::basic_file_status> st = pos->status();
+    if (!st || st->type() != fs::file_type::regular_file)
+      continue;
+    ++num_files;
+    if (!callback(FileSpec(pos->path(), false), st->getSize()))
+      break;
+  }
+  return num_files;
+}
+
+Status DataFileCache::Purge() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  Status error;
+  std::vector<std::string> paths;
+  ForEachCacheFile([&paths](const FileSpec &file, uint64_t size) -> bool {
+    paths.push_back(file.GetPath());
+    return true;
+  });
+  for (const std::string &path : paths) {
+    if (std::error_code ec = llvm::sys::fs::remove(path))
+      error = Status(ec);
+  }
+  return error;
+}
@@ -37,6 +37,7 @@
 #include "lldb/Expression/REPL.h"
 #include "lldb/Host/File.h" // for File, File::kInv...
 #include "lldb/Host/HostInfo.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Host/Terminal.h"
 #include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
@@ -360,6 +361,11 @@ static PropertyDefinition g_properties[] = {
      DEFAULT_FRAME_FORMAT_NO_ARGS, nullptr,
      "The default frame format string to use when displaying stack frame"
      "information for threads from thread backtrace unique."},
+    {"task-pool-thread-count", OptionValue::eTypeUInt64, true, 0, nullptr,
+     nullptr,
+     "The number of worker threads LLDB uses for parallel work such as "
+     "indexing debug information. Zero means one thread per hardware "
+     "thread (default: 0)."},
     {nullptr, OptionValue::eTypeInvalid, true, 0, nullptr, nullptr, nullptr}};
 
 enum {
@@ -387,6 +393,7 @@ enum {
   ePropertyTabSize,
   ePropertyEscapeNonPrintables,
   ePropertyFrameFormatUnique,
+  ePropertyTaskPoolThreadCount,
 };
 
 LoadPluginCallbackType Debugger::g_load_plugin_callback = nullptr;
@@ -441,6 +448,9 @@ Status Debugger::SetPropertyValue(const ExecutionContext *exe_ctx,
       }
     } else if (is_escape_non_printables) {
       DataVisualization::ForceUpdate();
+    } else if (property_path ==
+               g_properties[ePropertyTaskPoolThreadCount].name) {
+      TaskPool::SetThreadCount(GetTaskPoolThreadCount());
     }
   }
   return error;
@@ -624,6 +634,12 @@ bool Debugger::SetTabSize(uint32_t tab_size) {
   return m_collection_sp->SetPropertyAtIndexAsUInt64(nullptr, idx, tab_size);
 }
 
+uint32_t Debugger::GetTaskPoolThreadCount() const {
+  const uint32_t idx = ePropertyTaskPoolThreadCount;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_properties[idx].default_uint_value);
+}
+
 #pragma mark Debugger
 
 // const DebuggerPropertiesSP &
@@ -77,9 +77,29 @@ PropertyDefinition g_properties[] = {
     {"clang-modules-cache-path", OptionValue::eTypeFileSpec, true, 0, nullptr,
      nullptr,
      "The path to the clang modules cache directory (-fmodules-cache-path)."},
+    {"enable-index-cache", OptionValue::eTypeBoolean, true, false, nullptr,
+     nullptr,
+     "Cache symbol file indexes on disk, keyed by module UUID and modification "
+     "time, so that later debug sessions can load them instead of re-indexing "
+     "the debug information."},
+    {"index-cache-path", OptionValue::eTypeFileSpec, true, 0, nullptr, nullptr,
+     "The path to the on-disk index cache directory. Defaults to an "
+     "\"index_cache\" directory next to the platform module cache directory."},
+    {"dwarf-die-memory-limit", OptionValue::eTypeUInt64, true, 0, nullptr,
+     nullptr,
+     "The number of bytes of parsed DWARF DIEs to keep in memory for each "
+     "module. Once a module goes over the limit, the DIEs of its least "
+     "recently used compile units are freed and parsed again on demand. A "
+     "value of zero means no limit."},
     {nullptr, OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr}};
 
-enum { ePropertyEnableExternalLookup, ePropertyClangModulesCachePath };
+enum {
+  ePropertyEnableExternalLookup,
+  ePropertyClangModulesCachePath,
+  ePropertyEnableIndexCache,
+  ePropertyIndexCachePath,
+  ePropertyDWARFDIEMemoryLimit
+};
 
 } // namespace
 
@@ -110,6 +130,35 @@ bool ModuleListProperties::SetClangModulesCachePath(llvm::StringRef path) {
       nullptr, ePropertyClangModulesCachePath, path);
 }
 
+bool ModuleListProperties::GetEnableIndexCache() const {
+  const uint32_t idx = ePropertyEnableIndexCache;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool ModuleListProperties::SetEnableIndexCache(bool enable) {
+  return m_collection_sp->SetPropertyAtIndexAsBoolean(
+      nullptr, ePropertyEnableIndexCache, enable);
+}
+
+FileSpec ModuleListProperties::GetIndexCachePath() const {
+  return m_collection_sp
+      ->GetPropertyAtIndexAsOptionValueFileSpec(nullptr, false,
+                                                ePropertyIndexCachePath)
+      ->GetCurrentValue();
+}
+
+bool ModuleListProperties::SetIndexCachePath(llvm::StringRef path) {
+  return m_collection_sp->SetPropertyAtIndexAsString(
+      nullptr, ePropertyIndexCachePath, path);
+}
+
+uint64_t ModuleListProperties::GetDWARFDIEMemoryLimit() const {
+  const uint32_t idx = ePropertyDWARFDIEMemoryLimit;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_properties[idx].default_uint_value);
+}
+
 ModuleList::ModuleList()
     : m_modules(), m_modules_mutex(), m_notifier(nullptr) {}
 
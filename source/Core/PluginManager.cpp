@@ -1115,14 +1115,16 @@ PluginManager::GetObjectFileCreateMemoryCallbackForPluginName(
 }
 
 Status PluginManager::SaveCore(const lldb::ProcessSP &process_sp,
-                               const FileSpec &outfile) {
+                               const FileSpec &outfile,
+                               lldb::SaveCoreStyle core_style) {
   Status error;
   std::lock_guard<std::recursive_mutex> guard(GetObjectFileMutex());
   ObjectFileInstances &instances = GetObjectFileInstances();
 
   ObjectFileInstances::iterator pos, end = instances.end();
   for (pos = instances.begin(); pos != end; ++pos) {
-    if (pos->save_core && pos->save_core(process_sp, outfile, error))
+    if (pos->save_core &&
+        pos->save_core(process_sp, outfile, core_style, error))
       return error;
   }
   error.SetErrorString(
@@ -0,0 +1,148 @@
+//===-- LZMA.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/Config.h"
+#include "lldb/Host/LZMA.h"
+
+#include "llvm/ADT/Twine.h"
+
+#if defined(HAVE_LIBLZMA)
+#include <lzma.h>
+#endif
+
+namespace lldb_private {
+
+namespace lzma {
+
+static llvm::Error createError(const llvm::Twine &message) {
+  return llvm::make_error<llvm::StringError>(message,
+                                             llvm::inconvertibleErrorCode());
+}
+
+#if !defined(HAVE_LIBLZMA)
+
+bool isAvailable() { return false; }
+
+llvm::Expected<uint64_t>
+getUncompressedSize(llvm::ArrayRef<uint8_t> InputBuffer) {
+  return createError("lldb was built without LZMA support");
+}
+
+llvm::Error uncompress(llvm::ArrayRef<uint8_t> InputBuffer,
+                       llvm::SmallVectorImpl<uint8_t> &Uncompressed,
+                       uint64_t MaxUncompressedSize) {
+  return createError("lldb was built without LZMA support");
+}
+
+#else // HAVE_LIBLZMA
+
+static const char *convertLZMACodeToString(lzma_ret code) {
+  switch (code) {
+  case LZMA_STREAM_END:
+    return "lzma_ret: LZMA_STREAM_END";
+  case LZMA_NO_CHECK:
+    return "lzma_ret: LZMA_NO_CHECK";
+  case LZMA_UNSUPPORTED_CHECK:
+    return "lzma_ret: LZMA_UNSUPPORTED_CHECK";
+  case LZMA_GET_CHECK:
+    return "lzma_ret: LZMA_GET_CHECK";
+  case LZMA_MEM_ERROR:
+    return "lzma_ret: LZMA_MEM_ERROR";
+  case LZMA_MEMLIMIT_ERROR:
+    return "lzma_ret: LZMA_MEMLIMIT_ERROR";
+  case LZMA_FORMAT_ERROR:
+    return "lzma_ret: LZMA_FORMAT_ERROR";
+  case LZMA_OPTIONS_ERROR:
+    return "lzma_ret: LZMA_OPTIONS_ERROR";
+  case LZMA_DATA_ERROR:
+    return "lzma_ret: LZMA_DATA_ERROR";
+  case LZMA_BUF_ERROR:
+    return "lzma_ret: LZMA_BUF_ERROR";
+  case LZMA_PROG_ERROR:
+    return "lzma_ret: LZMA_PROG_ERROR";
+  default:
+    return "lzma_ret: unknown";
+  }
+}
+
+// The most memory the decoder may use for the index and the dictionary.
+// xz -9 needs a 64 MiB dictionary, nothing we read should need more.
+static const uint64_t kDecoderMemoryLimit = 128 * 1024 * 1024;
+
+bool isAvailable() { return true; }
+
+llvm::Expected<uint64_t>
+getUncompressedSize(llvm::ArrayRef<uint8_t> InputBuffer) {
+  if (InputBuffer.size() < LZMA_STREAM_HEADER_SIZE)
+    return createError("size of xz compressed data (" +
+                       llvm::Twine(InputBuffer.size()) +
+                       " bytes) is smaller than the xz stream footer");
+
+  // Decode the stream footer, which has the size of the index before it.
+  lzma_stream_flags opts = {};
+  lzma_ret xzerr = lzma_stream_footer_decode(
+      &opts, InputBuffer.take_back(LZMA_STREAM_HEADER_SIZE).data());
+  if (xzerr != LZMA_OK)
+    return createError(
+        llvm::Twine("lzma_stream_footer_decode() failed: ") +
+        convertLZMACodeToString(xzerr));
+  if (InputBuffer.size() < opts.backward_size + LZMA_STREAM_HEADER_SIZE)
+    return createError("xz stream index is larger than the compressed data");
+
+  // Decode the index, which has the uncompressed size of all blocks.
+  lzma_index *xzindex = nullptr;
+  uint64_t memlimit = kDecoderMemoryLimit;
+  size_t inpos = 0;
+  xzerr = lzma_index_buffer_decode(
+      &xzindex, &memlimit, nullptr,
+      InputBuffer.take_back(LZMA_STREAM_HEADER_SIZE + opts.backward_size)
+          .data(),
+      &inpos, opts.backward_size);
+  if (xzerr != LZMA_OK)
+    return createError(llvm::Twine("lzma_index_buffer_decode() failed: ") +
+                       convertLZMACodeToString(xzerr));
+
+  const uint64_t uncompressed_size = lzma_index_uncompressed_size(xzindex);
+  lzma_index_end(xzindex, nullptr);
+  return uncompressed_size;
+}
+
+llvm::Error uncompress(llvm::ArrayRef<uint8_t> InputBuffer,
+                       llvm::SmallVectorImpl<uint8_t> &Uncompressed,
+                       uint64_t MaxUncompressedSize) {
+  llvm::Expected<uint64_t> uncompressed_size = getUncompressedSize(InputBuffer);
+  if (!uncompressed_size)
+    return uncompressed_size.takeError();
+  // The size comes from the file, don't trust it with an allocation.
+  if (*uncompressed_size > MaxUncompressedSize)
+    return createError("xz compressed data claims to uncompress to " +
+                       llvm::Twine(*uncompressed_size) +
+                       " bytes, more than the limit of " +
+                       llvm::Twine(MaxUncompressedSize) + " bytes");
+
+  Uncompressed.resize(*uncompressed_size);
+
+  uint64_t memlimit = kDecoderMemoryLimit;
+  size_t inpos = 0;
+  size_t outpos = 0;
+  lzma_ret ret = lzma_stream_buffer_decode(
+      &memlimit, 0, nullptr, InputBuffer.data(), &inpos, InputBuffer.size(),
+      Uncompressed.data(), &outpos, Uncompressed.size());
+  if (ret != LZMA_OK)
+    return createError(llvm::Twine("lzma_stream_buffer_decode() failed: ") +
+                       convertLZMACodeToString(ret));
+
+  return llvm::Error::success();
+}
+
+#endif // HAVE_LIBLZMA
+
+} // namespace lzma
+
+} // namespace lldb_private
@@ -58,6 +58,25 @@ NativeProcessProtocol::GetMemoryRegionInfo(lldb::addr_t load_addr,
   return Status("not implemented");
 }
 
+Status NativeProcessProtocol::ReadMemoryRangesWithoutTrap(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+    llvm::MutableArrayRef<uint8_t> buffer, std::vector<size_t> &bytes_read) {
+  bytes_read.assign(ranges.size(), 0);
+  size_t offset = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const size_t size = ranges[i].GetByteSize();
+    if (offset + size > buffer.size())
+      return Status("buffer is too small for the memory ranges");
+    size_t range_bytes_read = 0;
+    Status error = ReadMemoryWithoutTrap(ranges[i].GetRangeBase(),
+                                         buffer.data() + offset, size,
+                                         range_bytes_read);
+    bytes_read[i] = std::min(range_bytes_read, size);
+    offset += size;
+  }
+  return Status();
+}
+
 llvm::Optional<WaitStatus> NativeProcessProtocol::GetExitStatus() {
   if (m_state == lldb::eStateExited)
     return m_exit_status;
@@ -10,111 +10,325 @@
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Host/ThreadLauncher.h"
 
-#include <cstdint> // for uint32_t
-#include <queue>   // for queue
-#include <thread>  // for thread
+#include <atomic>             // for atomic
+#include <condition_variable> // for condition_variable
+#include <cstdint>            // for uint32_t
+#include <deque>              // for deque
+#include <thread>             // for thread
+#include <vector>             // for vector
 
 namespace lldb_private {
 
 namespace {
+
+//----------------------------------------------------------------------
+// A work stealing task pool.
+//
+// Every worker thread owns a bounded double ended queue of tasks. Tasks
+// added from a worker thread (i.e. subtasks) go to the back of that
+// worker's own queue and the worker takes tasks from the back, so
+// related work tends to stay on one core. Idle workers steal from the
+// front of the other queues. Tasks added from other threads are spread
+// over the worker queues round robin. When a queue is full the task goes
+// to a shared overflow queue instead.
+//
+// Worker threads are persistent: they are started the first time a task
+// is added and then sleep on a condition variable when there is no work.
+//----------------------------------------------------------------------
 class TaskPoolImpl {
 public:
   static TaskPoolImpl &GetInstance();
 
   void AddTask(std::function<void()> &&task_fn);
 
+  bool RunPendingTask();
+
+  void SetThreadCount(unsigned thread_count);
+
+  unsigned GetThreadCount();
+
 private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  // The number of queued tasks a single worker queue can hold before new
+  // tasks spill over into the shared overflow queue.
+  static const size_t kMaxTasksPerQueue = 4096;
+  // Worker queues are never freed so that other threads can always steal
+  // from them, which puts an upper bound on the number of workers.
+  static const unsigned kMaxThreads = 256;
+
   TaskPoolImpl();
 
-  static lldb::thread_result_t WorkerPtr(void *pool);
+  static lldb::thread_result_t WorkerPtr(void *arg);
+
+  void Worker(unsigned worker_idx);
+
+  void StartWorkersIfNeeded();
+
+  bool PushTask(std::function<void()> &task_fn, WorkerQueue &queue);
 
-  static void Worker(TaskPoolImpl *pool);
+  bool PopTask(std::function<void()> &task_fn, int worker_idx);
 
-  std::queue<std::function<void()>> m_tasks;
-  std::mutex m_tasks_mutex;
-  uint32_t m_thread_count;
+  WorkerQueue m_queues[kMaxThreads];
+  WorkerQueue m_overflow;
+
+  // Protects m_thread_limit, m_threads_started and the condition variable.
+  std::mutex m_pool_mutex;
+  std::condition_variable m_work_cv;
+  unsigned m_thread_limit;
+  unsigned m_threads_started;
+  std::atomic<unsigned> m_num_queues;
+  std::atomic<size_t> m_num_pending;
+  std::atomic<unsigned> m_next_queue;
 };
 
+// The index of the worker queue owned by the current thread, or -1 if the
+// current thread isn't a task pool worker.
+static thread_local int g_worker_idx = -1;
+
 } // end of anonymous namespace
 
 TaskPoolImpl &TaskPoolImpl::GetInstance() {
-  static TaskPoolImpl g_task_pool_impl;
-  return g_task_pool_impl;
+  // Leaked on purpose: worker threads are detached and may still be waiting
+  // for work when static destructors run.
+  static TaskPoolImpl *g_task_pool_impl = new TaskPoolImpl();
+  return *g_task_pool_impl;
 }
 
 void TaskPool::AddTaskImpl(std::function<void()> &&task_fn) {
   TaskPoolImpl::GetInstance().AddTask(std::move(task_fn));
 }
 
-TaskPoolImpl::TaskPoolImpl() : m_thread_count(0) {}
+void TaskPool::SetThreadCount(unsigned thread_count) {
+  TaskPoolImpl::GetInstance().SetThreadCount(thread_count);
+}
+
+unsigned TaskPool::GetThreadCount() {
+  return TaskPoolImpl::GetInstance().GetThreadCount();
+}
+
+TaskPoolImpl::TaskPoolImpl()
+    : m_thread_limit(GetHardwareConcurrencyHint()), m_threads_started(0),
+      m_num_queues(0), m_num_pending(0), m_next_queue(0) {}
 
 unsigned GetHardwareConcurrencyHint() {
   // std::thread::hardware_concurrency may return 0
   // if the value is not well defined or not computable.
-  static const unsigned g_hardware_concurrency = 
+  static const unsigned g_hardware_concurrency =
     std::max(1u, std::thread::hardware_concurrency());
   return g_hardware_concurrency;
 }
 
-void TaskPoolImpl::AddTask(std::function<void()> &&task_fn) {
+void TaskPoolImpl::SetThreadCount(unsigned thread_count) {
+  if (thread_count == 0)
+    thread_count = GetHardwareConcurrencyHint();
+  if (thread_count > kMaxThreads)
+    thread_count = kMaxThreads;
+
+  std::lock_guard<std::mutex> guard(m_pool_mutex);
+  m_thread_limit = thread_count;
+  // Workers above the new limit finish the tasks in their queue and exit.
+  m_work_cv.notify_all();
+}
+
+unsigned TaskPoolImpl::GetThreadCount() {
+  std::lock_guard<std::mutex> guard(m_pool_mutex);
+  return m_thread_limit;
+}
+
+void TaskPoolImpl::StartWorkersIfNeeded() {
   const size_t min_stack_size = 8 * 1024 * 1024;
 
-  std::unique_lock<std::mutex> lock(m_tasks_mutex);
-  m_tasks.emplace(std::move(task_fn));
-  if (m_thread_count < GetHardwareConcurrencyHint()) {
-    m_thread_count++;
-    // Note that this detach call needs to happen with the m_tasks_mutex held.
-    // This prevents the thread
-    // from exiting prematurely and triggering a linux libc bug
-    // (https://sourceware.org/bugzilla/show_bug.cgi?id=19951).
-    lldb_private::ThreadLauncher::LaunchThread("task-pool.worker", WorkerPtr,
-                                               this, nullptr, min_stack_size)
+  std::lock_guard<std::mutex> guard(m_pool_mutex);
+  while (m_threads_started < m_thread_limit) {
+    const unsigned worker_idx = m_threads_started++;
+    if (worker_idx >= m_num_queues)
+      m_num_queues = worker_idx + 1;
+    // Note that this detach call needs to happen with m_pool_mutex held.
+    // This prevents the thread from exiting prematurely and triggering a
+    // linux libc bug (https://sourceware.org/bugzilla/show_bug.cgi?id=19951).
+    lldb_private::ThreadLauncher::LaunchThread(
+        "task-pool.worker", WorkerPtr,
+        reinterpret_cast<void *>(static_cast<uintptr_t>(worker_idx)), nullptr,
+        min_stack_size)
         .Release();
   }
 }
 
-lldb::thread_result_t TaskPoolImpl::WorkerPtr(void *pool) {
-  Worker((TaskPoolImpl *)pool);
-  return 0;
+bool TaskPoolImpl::PushTask(std::function<void()> &task_fn,
+                            WorkerQueue &queue) {
+  std::lock_guard<std::mutex> guard(queue.mutex);
+  if (&queue != &m_overflow && queue.tasks.size() >= kMaxTasksPerQueue)
+    return false;
+  queue.tasks.push_back(std::move(task_fn));
+  return true;
 }
 
-void TaskPoolImpl::Worker(TaskPoolImpl *pool) {
-  while (true) {
-    std::unique_lock<std::mutex> lock(pool->m_tasks_mutex);
-    if (pool->m_tasks.empty()) {
-      pool->m_thread_count--;
-      break;
+void TaskPoolImpl::AddTask(std::function<void()> &&task_fn) {
+  StartWorkersIfNeeded();
+
+  {
+    // Count the task before it is visible in a queue so that a worker that
+    // finds it never sees the pending count drop below zero.
+    std::lock_guard<std::mutex> guard(m_pool_mutex);
+    ++m_num_pending;
+  }
+
+  int queue_idx = g_worker_idx;
+  if (queue_idx < 0)
+    queue_idx = m_next_queue++ % m_num_queues;
+  if (!PushTask(task_fn, m_queues[queue_idx]))
+    PushTask(task_fn, m_overflow);
+
+  m_work_cv.notify_one();
+}
+
+bool TaskPoolImpl::PopTask(std::function<void()> &task_fn, int worker_idx) {
+  // Prefer the newest task in our own queue, it is most likely to touch the
+  // same data as the task that just finished.
+  if (worker_idx >= 0) {
+    WorkerQueue &queue = m_queues[worker_idx];
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task_fn = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
     }
+  }
 
-    std::function<void()> f = std::move(pool->m_tasks.front());
-    pool->m_tasks.pop();
-    lock.unlock();
+  {
+    std::lock_guard<std::mutex> guard(m_overflow.mutex);
+    if (!m_overflow.tasks.empty()) {
+      task_fn = std::move(m_overflow.tasks.front());
+      m_overflow.tasks.pop_front();
+      return true;
+    }
+  }
 
-    f();
+  // Steal the oldest task from another queue, starting after our own queue
+  // so that thieves spread out over the victims.
+  const unsigned num_queues = m_num_queues;
+  for (unsigned i = 1; i <= num_queues; ++i) {
+    const unsigned victim_idx = (worker_idx + i) % num_queues;
+    if ((int)victim_idx == worker_idx)
+      continue;
+    WorkerQueue &victim = m_queues[victim_idx];
+    std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+    if (!lock.owns_lock() || victim.tasks.empty())
+      continue;
+    task_fn = std::move(victim.tasks.front());
+    victim.tasks.pop_front();
+    return true;
   }
+  return false;
 }
 
-void TaskMapOverInt(size_t begin, size_t end,
-                    const llvm::function_ref<void(size_t)> &func) {
-  const size_t num_workers = std::min<size_t>(end, GetHardwareConcurrencyHint());
-  std::atomic<size_t> idx{begin};
-  
-  auto wrapper = [&idx, end, &func]() {
+bool TaskPoolImpl::RunPendingTask() {
+  if (m_num_pending == 0)
+    return false;
+  std::function<void()> task_fn;
+  if (!PopTask(task_fn, g_worker_idx))
+    return false;
+  --m_num_pending;
+  task_fn();
+  return true;
+}
+
+lldb::thread_result_t TaskPoolImpl::WorkerPtr(void *arg) {
+  g_worker_idx = static_cast<int>(reinterpret_cast<uintptr_t>(arg));
+  GetInstance().Worker(g_worker_idx);
+  return 0;
+}
+
+void TaskPoolImpl::Worker(unsigned worker_idx) {
+  while (true) {
+    if (RunPendingTask())
+      continue;
+
+    std::unique_lock<std::mutex> lock(m_pool_mutex);
+    if (worker_idx >= m_thread_limit) {
+      // The pool was shrunk. Only exit once our own queue is drained, and
+      // only if we are the highest numbered worker so that the remaining
+      // workers always occupy the queues [0, m_threads_started).
+      std::lock_guard<std::mutex> guard(m_queues[worker_idx].mutex);
+      if (m_queues[worker_idx].tasks.empty() &&
+          worker_idx + 1 == m_threads_started) {
+        --m_threads_started;
+        m_work_cv.notify_all();
+        break;
+      }
+    }
+    // Tasks that were stolen concurrently can make us miss a wakeup, so
+    // don't sleep forever.
+    m_work_cv.wait_for(lock, std::chrono::milliseconds(100), [this] {
+      return m_num_pending > 0;
+    });
+  }
+}
+
+namespace {
+// The state TaskMapOverInt() shares with its helper tasks. Helper tasks can
+// still be queued after TaskMapOverInt() returned, so it is reference
+// counted and "func" may only be used by helpers that started before "done"
+// was set.
+struct TaskMapState {
+  TaskMapState(size_t begin, size_t end,
+               const llvm::function_ref<void(size_t)> &func)
+      : idx(begin), end(end), func(func) {}
+
+  void Run() {
     while (true) {
       size_t i = idx.fetch_add(1);
       if (i >= end)
         break;
       func(i);
     }
-  };
+  }
 
-  std::vector<std::future<void>> futures;
-  futures.reserve(num_workers);
-  for (size_t i = 0; i < num_workers; i++)
-    futures.push_back(TaskPool::AddTask(wrapper));
-  for (size_t i = 0; i < num_workers; i++)
-    futures[i].wait();
+  std::atomic<size_t> idx;
+  const size_t end;
+  llvm::function_ref<void(size_t)> func;
+  std::mutex mutex;
+  std::condition_variable cv;
+  unsigned num_active = 0;
+  bool done = false;
+};
+} // namespace
+
+void TaskMapOverInt(size_t begin, size_t end,
+                    const llvm::function_ref<void(size_t)> &func) {
+  if (begin >= end)
+    return;
+  const size_t num_threads =
+      std::min<size_t>(end - begin, TaskPool::GetThreadCount());
+  auto state_sp = std::make_shared<TaskMapState>(begin, end, func);
+
+  // The calling thread does its share of the work instead of just blocking,
+  // so only num_threads - 1 helper tasks are needed.
+  for (size_t i = 1; i < num_threads; i++) {
+    TaskPool::AddTask([state_sp]() {
+      {
+        std::lock_guard<std::mutex> guard(state_sp->mutex);
+        if (state_sp->done)
+          return;
+        ++state_sp->num_active;
+      }
+      state_sp->Run();
+      std::lock_guard<std::mutex> guard(state_sp->mutex);
+      if (--state_sp->num_active == 0)
+        state_sp->cv.notify_all();
+    });
+  }
+  state_sp->Run();
+
+  // Every value has been claimed. Helpers that didn't start yet won't do
+  // anything, so only wait for the ones still working on their last value.
+  std::unique_lock<std::mutex> lock(state_sp->mutex);
+  state_sp->done = true;
+  state_sp->cv.wait(lock, [&state_sp] { return state_sp->num_active == 0; });
 }
 
 } // namespace lldb_private
-
@@ -0,0 +1,521 @@
+//===-- ELFCoreWriter.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ELFCoreWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Plugins/Process/Utility/RegisterContextLinux_x86_64.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/RegisterValue.h"
+#include "lldb/Host/File.h"
+#include "lldb/Target/MemoryRegionInfo.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StopInfo.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/Thread.h"
+#include "lldb/Target/UnixSignals.h"
+#include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/FileSpec.h"
+#include "lldb/Utility/Log.h"
+#include "lldb/Utility/Logging.h"
+#include "lldb/Utility/Status.h"
+#include "lldb/Utility/StreamString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Support/MathExtras.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+// The Linux core file note types we write, see RegisterUtilities.h in the
+// elf-core process plug-in for the reading side.
+enum CoreNoteType : uint32_t {
+  eNotePRStatus = 1,
+  eNoteFPRegSet = 2,
+  eNotePRPSInfo = 3,
+  eNoteAuxv = 6,
+  eNoteFile = 0x46494c45 // 'FILE'
+};
+
+const addr_t k_page_size = 0x1000;
+// The amount of memory read from the process and written to the core file
+// at a time.
+const size_t k_chunk_size = 1024 * 1024;
+// The size of the FXSAVE area that NT_FPREGSET contains on x86-64.
+const size_t k_fxsave_size = 512;
+const size_t k_ehdr_size = 64;
+const size_t k_phdr_size = 56;
+const size_t k_shdr_size = 64;
+
+struct CoreRegion {
+  addr_t start;
+  addr_t size;
+  uint32_t permissions; // lldb::Permissions
+  ConstString path;     // The mapped file, if any
+  bool save_contents;
+  addr_t file_offset; // Where the contents go in the core file
+};
+
+bool IsFileBacked(const CoreRegion &region) {
+  return region.path.GetStringRef().startswith("/");
+}
+
+Status GetCoreRegions(Process &process, SaveCoreStyle core_style,
+                      std::vector<CoreRegion> &regions) {
+  MemoryRegionInfo range_info;
+  Status error = process.GetMemoryRegionInfo(0, range_info);
+  if (error.Fail()) {
+    error.SetErrorString("process doesn't support getting memory region info");
+    return error;
+  }
+
+  while (range_info.GetRange().GetRangeBase() != LLDB_INVALID_ADDRESS) {
+    const addr_t addr = range_info.GetRange().GetRangeBase();
+    const addr_t end = range_info.GetRange().GetRangeEnd();
+    if (end <= addr)
+      break;
+
+    if (range_info.GetReadable() == MemoryRegionInfo::eYes) {
+      CoreRegion region;
+      region.start = addr;
+      region.size = end - addr;
+      region.permissions = range_info.GetLLDBPermissions();
+      region.path = range_info.GetName();
+      region.save_contents = true;
+      region.file_offset = 0;
+      regions.push_back(region);
+    }
+
+    if (end == LLDB_INVALID_ADDRESS ||
+        process.GetMemoryRegionInfo(end, range_info).Fail())
+      break;
+  }
+
+  if (core_style == eSaveCoreSkipFileBacked) {
+    // Read-only mappings of files can be read from the files when the core
+    // file is loaded, unless the dynamic loader wrote to them before making
+    // them read-only. Those are the RELRO pages, which hold the dynamic
+    // section and the GOT, and are mapped right before the writable data
+    // of the same file, so keep any read-only mapping that is followed by
+    // a writable one of the same file.
+    for (size_t i = 0; i < regions.size(); ++i) {
+      CoreRegion &region = regions[i];
+      if (!IsFileBacked(region) || (region.permissions & ePermissionsWritable))
+        continue;
+      const bool followed_by_data =
+          i + 1 < regions.size() && regions[i + 1].path == region.path &&
+          regions[i + 1].start == region.start + region.size &&
+          (regions[i + 1].permissions & ePermissionsWritable);
+      if (!followed_by_data)
+        region.save_contents = false;
+    }
+  }
+  return error;
+}
+
+void AppendNote(StreamString &notes, llvm::StringRef name, uint32_t type,
+                llvm::StringRef desc) {
+  const size_t name_size = name.size() + 1; // Include the NULL terminator
+  notes.PutHex32(name_size);
+  notes.PutHex32(desc.size());
+  notes.PutHex32(type);
+  notes.Write(name.data(), name.size());
+  notes.PutNHex8(llvm::alignTo(name_size, 4) - name.size(), 0);
+  notes.Write(desc.data(), desc.size());
+  notes.PutNHex8(llvm::alignTo(desc.size(), 4) - desc.size(), 0);
+}
+
+// The signal a thread would have reported to the kernel for the stop
+// reason the debugger shows for it.
+int GetThreadSignal(Process &process, Thread &thread) {
+  StopInfoSP stop_info_sp = thread.GetStopInfo();
+  if (!stop_info_sp)
+    return 0;
+  switch (stop_info_sp->GetStopReason()) {
+  case eStopReasonSignal:
+    return stop_info_sp->GetValue();
+  case eStopReasonBreakpoint:
+  case eStopReasonWatchpoint:
+  case eStopReasonTrace:
+    return process.GetUnixSignals()->GetSignalNumberFromName("SIGTRAP");
+  default:
+    return 0;
+  }
+}
+
+// Fill in the general purpose registers and the FXSAVE area of a thread
+// the way the kernel lays them out in NT_PRSTATUS and NT_FPREGSET. The
+// register infos used by ProcessElfCore describe that layout, so copy
+// each of their registers from the thread's live register context.
+bool GetThreadRegisters(const ArchSpec &arch, Thread &thread,
+                        std::string &gpregset, std::string &fpregset) {
+  RegisterContextSP reg_ctx_sp = thread.GetRegisterContext();
+  if (!reg_ctx_sp)
+    return false;
+
+  RegisterContextLinux_x86_64 core_layout(arch);
+  const RegisterInfo *core_infos = core_layout.GetRegisterInfo();
+  const uint32_t num_core_infos = core_layout.GetRegisterCount();
+  uint32_t fxsave_offset = UINT32_MAX;
+  for (uint32_t i = 0; i < num_core_infos; ++i) {
+    if (llvm::StringRef(core_infos[i].name) == "fctrl") {
+      fxsave_offset = core_infos[i].byte_offset;
+      break;
+    }
+  }
+
+  gpregset.assign(core_layout.GetGPRSize(), 0);
+  fpregset.assign(k_fxsave_size, 0);
+  for (uint32_t i = 0; i < num_core_infos; ++i) {
+    const RegisterInfo &core_info = core_infos[i];
+    // Skip registers that are part of other registers, like "eax".
+    if (core_info.value_regs)
+      continue;
+
+    char *dst;
+    const uint32_t end = core_info.byte_offset + core_info.byte_size;
+    if (end <= gpregset.size())
+      dst = &gpregset[core_info.byte_offset];
+    else if (core_info.byte_offset >= fxsave_offset &&
+             end - fxsave_offset <= fpregset.size())
+      dst = &fpregset[core_info.byte_offset - fxsave_offset];
+    else
+      continue;
+
+    const RegisterInfo *reg_info =
+        reg_ctx_sp->GetRegisterInfoByName(core_info.name);
+    RegisterValue reg_value;
+    if (!reg_info || !reg_ctx_sp->ReadRegister(reg_info, reg_value))
+      continue;
+    Status error;
+    reg_value.GetAsMemoryData(&core_info, dst, core_info.byte_size,
+                              eByteOrderLittle, error);
+  }
+  return true;
+}
+
+std::string GetPRStatus(Process &process, Thread &thread,
+                        const std::string &gpregset) {
+  ProcessInstanceInfo process_info;
+  process.GetProcessInfo(process_info);
+  const int signo = GetThreadSignal(process, thread);
+
+  StreamString prstatus(Stream::eBinary, 8, eByteOrderLittle);
+  prstatus.PutHex32(signo); // si_signo
+  prstatus.PutHex32(0);     // si_code
+  prstatus.PutHex32(0);     // si_errno
+  prstatus.PutHex16(signo); // pr_cursig
+  prstatus.PutHex16(0);     // padding
+  prstatus.PutHex64(0);     // pr_sigpend
+  prstatus.PutHex64(0);     // pr_sighold
+  prstatus.PutHex32(thread.GetProtocolID());
+  prstatus.PutHex32(process_info.ParentProcessIDIsValid()
+                        ? process_info.GetParentProcessID()
+                        : 0);
+  prstatus.PutHex32(process.GetID()); // pr_pgrp
+  prstatus.PutHex32(0);               // pr_sid
+  prstatus.PutNHex8(4 * 16, 0);       // pr_utime, pr_stime, pr_cutime, pr_cstime
+  prstatus.Write(gpregset.data(), gpregset.size());
+  prstatus.PutHex32(1); // pr_fpvalid
+  prstatus.PutHex32(0); // padding
+  return prstatus.GetString();
+}
+
+std::string GetPRPSInfo(Process &process) {
+  ProcessInstanceInfo process_info;
+  process.GetProcessInfo(process_info);
+  const char *process_name = process_info.GetName();
+  std::string name(process_name ? process_name : "");
+  if (name.empty()) {
+    if (ModuleSP exe_module_sp = process.GetTarget().GetExecutableModule())
+      name = exe_module_sp->GetFileSpec().GetFilename().AsCString("");
+  }
+  std::string args;
+  process_info.GetArguments().GetQuotedCommandString(args);
+
+  StreamString prpsinfo(Stream::eBinary, 8, eByteOrderLittle);
+  prpsinfo.PutHex8(3);   // pr_state, 'T' is the 4th of "RSDTZW"
+  prpsinfo.PutHex8('T'); // pr_sname
+  prpsinfo.PutHex8(0);   // pr_zomb
+  prpsinfo.PutHex8(0);   // pr_nice
+  prpsinfo.PutHex32(0);  // padding
+  prpsinfo.PutHex64(0);  // pr_flag
+  prpsinfo.PutHex32(process_info.UserIDIsValid() ? process_info.GetUserID()
+                                                 : 0);
+  prpsinfo.PutHex32(process_info.GroupIDIsValid() ? process_info.GetGroupID()
+                                                  : 0);
+  prpsinfo.PutHex32(process.GetID());
+  prpsinfo.PutHex32(process_info.ParentProcessIDIsValid()
+                        ? process_info.GetParentProcessID()
+                        : 0);
+  prpsinfo.PutHex32(process.GetID()); // pr_pgrp
+  prpsinfo.PutHex32(0);               // pr_sid
+  // pr_fname and pr_psargs are NULL terminated unless they are full.
+  name.resize(16, '\0');
+  prpsinfo.Write(name.data(), name.size());
+  args.resize(80, '\0');
+  prpsinfo.Write(args.data(), args.size());
+  return prpsinfo.GetString();
+}
+
+// NT_FILE lists the file mappings, with the executable first since that is
+// where ProcessElfCore looks for it.
+std::string GetFileNote(Process &process,
+                        const std::vector<CoreRegion> &regions) {
+  std::vector<const CoreRegion *> file_regions;
+  for (const CoreRegion &region : regions) {
+    if (IsFileBacked(region))
+      file_regions.push_back(&region);
+  }
+  if (ModuleSP exe_module_sp = process.GetTarget().GetExecutableModule()) {
+    FileSpec exe_file = exe_module_sp->GetPlatformFileSpec();
+    if (!exe_file)
+      exe_file = exe_module_sp->GetFileSpec();
+    const ConstString exe_path(exe_file.GetPath());
+    std::stable_partition(file_regions.begin(), file_regions.end(),
+                          [&exe_path](const CoreRegion *region) {
+                            return region->path == exe_path;
+                          });
+  }
+
+  StreamString file_note(Stream::eBinary, 8, eByteOrderLittle);
+  file_note.PutHex64(file_regions.size());
+  file_note.PutHex64(k_page_size);
+  for (const CoreRegion *region : file_regions) {
+    // Memory region infos don't have the offset of a mapping in its file.
+    // ProcessElfCore doesn't use it either, so estimate it from the first
+    // mapping of the same file, which always maps the start of the file.
+    addr_t file_start = region->start;
+    for (const CoreRegion *other : file_regions) {
+      if (other->path == region->path)
+        file_start = std::min(file_start, other->start);
+    }
+    file_note.PutHex64(region->start);
+    file_note.PutHex64(region->start + region->size);
+    file_note.PutHex64((region->start - file_start) / k_page_size);
+  }
+  for (const CoreRegion *region : file_regions) {
+    llvm::StringRef path = region->path.GetStringRef();
+    file_note.Write(path.data(), path.size());
+    file_note.PutHex8(0);
+  }
+  return file_note.GetString();
+}
+
+Status WriteRegionContents(Process &process, File &core_file,
+                           const CoreRegion &region,
+                           std::vector<uint8_t> &buffer) {
+  Status error;
+  addr_t addr = region.start;
+  addr_t bytes_left = region.size;
+  while (bytes_left > 0) {
+    const size_t bytes_to_read = std::min<addr_t>(bytes_left, buffer.size());
+    Status read_error;
+    // Every byte is read exactly once, so bypass the memory cache instead
+    // of filling it with the whole address space.
+    size_t bytes_read = process.ReadMemoryFromInferior(
+        addr, buffer.data(), bytes_to_read, read_error);
+    // Some pages within regions are not readable, read the rest of the
+    // chunk a page at a time and zero fill the pages that can't be read.
+    while (bytes_read < bytes_to_read) {
+      const addr_t page_addr = addr + bytes_read;
+      const size_t page_bytes = std::min<addr_t>(
+          k_page_size - page_addr % k_page_size, bytes_to_read - bytes_read);
+      uint8_t *page = buffer.data() + bytes_read;
+      if (process.ReadMemoryFromInferior(page_addr, page, page_bytes,
+                                         read_error) != page_bytes)
+        memset(page, 0, page_bytes);
+      bytes_read += page_bytes;
+    }
+
+    size_t bytes_written = bytes_to_read;
+    error = core_file.Write(buffer.data(), bytes_written);
+    if (error.Fail())
+      return error;
+    addr += bytes_to_read;
+    bytes_left -= bytes_to_read;
+  }
+  return error;
+}
+
+} // namespace
+
+bool lldb_private::SaveELFCore(const lldb::ProcessSP &process_sp,
+                               const FileSpec &outfile,
+                               lldb::SaveCoreStyle core_style, Status &error) {
+  if (!process_sp)
+    return false;
+  const ArchSpec &arch = process_sp->GetTarget().GetArchitecture();
+  const llvm::Triple &triple = arch.GetTriple();
+  if (triple.getOS() != llvm::Triple::Linux)
+    return false;
+  if (triple.getArch() != llvm::Triple::x86_64) {
+    error.SetErrorStringWithFormat("unsupported core architecture: %s",
+                                   triple.str().c_str());
+    return true;
+  }
+  Process &process = *process_sp;
+
+  std::vector<CoreRegion> regions;
+  error = GetCoreRegions(process, core_style, regions);
+  if (error.Fail())
+    return true;
+
+  // The thread that stopped the process goes first, like the thread that
+  // crashed does in a core file written by the kernel. The first thread
+  // is followed by the notes that describe the whole process.
+  ThreadList &thread_list = process.GetThreadList();
+  std::vector<ThreadSP> threads;
+  if (ThreadSP selected_thread_sp = thread_list.GetSelectedThread())
+    threads.push_back(selected_thread_sp);
+  const uint32_t num_threads = thread_list.GetSize();
+  for (uint32_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+    ThreadSP thread_sp = thread_list.GetThreadAtIndex(thread_idx);
+    if (thread_sp && (threads.empty() || thread_sp != threads.front()))
+      threads.push_back(thread_sp);
+  }
+
+  StreamString notes(Stream::eBinary, 8, eByteOrderLittle);
+  for (const ThreadSP &thread_sp : threads) {
+    std::string gpregset, fpregset;
+    if (!GetThreadRegisters(arch, *thread_sp, gpregset, fpregset))
+      continue;
+    AppendNote(notes, "CORE", eNotePRStatus,
+               GetPRStatus(process, *thread_sp, gpregset));
+    if (thread_sp == threads.front()) {
+      AppendNote(notes, "CORE", eNotePRPSInfo, GetPRPSInfo(process));
+      DataBufferSP auxv_sp = process.GetAuxvData();
+      if (auxv_sp && auxv_sp->GetByteSize() > 0)
+        AppendNote(notes, "CORE", eNoteAuxv,
+                   llvm::StringRef((const char *)auxv_sp->GetBytes(),
+                                   auxv_sp->GetByteSize()));
+      AppendNote(notes, "CORE", eNoteFile, GetFileNote(process, regions));
+    }
+    AppendNote(notes, "CORE", eNoteFPRegSet, fpregset);
+  }
+
+  // Lay out the file: the ELF header, the program headers (one PT_NOTE
+  // and one PT_LOAD per region), the section header that holds the number
+  // of program headers when there are too many for the ELF header, the
+  // notes and then the page aligned contents of the regions.
+  const size_t num_phdrs = regions.size() + 1;
+  const bool extended_numbering = num_phdrs >= 0xFFFF; // PN_XNUM
+  const addr_t shdr_offset = k_ehdr_size + num_phdrs * k_phdr_size;
+  const addr_t notes_offset =
+      shdr_offset + (extended_numbering ? k_shdr_size : 0);
+  addr_t file_offset =
+      llvm::alignTo(notes_offset + notes.GetSize(), k_page_size);
+  for (CoreRegion &region : regions) {
+    region.file_offset = file_offset;
+    if (region.save_contents)
+      file_offset += region.size;
+  }
+
+  StreamString headers(Stream::eBinary, 8, eByteOrderLittle);
+  const uint8_t ident[llvm::ELF::EI_NIDENT] = {
+      0x7f, 'E', 'L', 'F', llvm::ELF::ELFCLASS64, llvm::ELF::ELFDATA2LSB,
+      llvm::ELF::EV_CURRENT, llvm::ELF::ELFOSABI_NONE};
+  headers.Write(ident, sizeof(ident));
+  headers.PutHex16(llvm::ELF::ET_CORE);
+  headers.PutHex16(llvm::ELF::EM_X86_64);
+  headers.PutHex32(llvm::ELF::EV_CURRENT);
+  headers.PutHex64(0);           // e_entry
+  headers.PutHex64(k_ehdr_size); // e_phoff
+  headers.PutHex64(extended_numbering ? shdr_offset : 0);
+  headers.PutHex32(0); // e_flags
+  headers.PutHex16(k_ehdr_size);
+  headers.PutHex16(k_phdr_size);
+  headers.PutHex16(extended_numbering ? 0xFFFF : num_phdrs); // PN_XNUM
+  headers.PutHex16(extended_numbering ? k_shdr_size : 0);
+  headers.PutHex16(extended_numbering ? 1 : 0); // e_shnum
+  headers.PutHex16(0);                          // e_shstrndx
+
+  headers.PutHex32(llvm::ELF::PT_NOTE);
+  headers.PutHex32(0); // p_flags
+  headers.PutHex64(notes_offset);
+  headers.PutHex64(0); // p_vaddr
+  headers.PutHex64(0); // p_paddr
+  headers.PutHex64(notes.GetSize());
+  headers.PutHex64(0); // p_memsz
+  headers.PutHex64(0); // p_align
+  for (const CoreRegion &region : regions) {
+    uint32_t flags = 0;
+    if (region.permissions & ePermissionsReadable)
+      flags |= llvm::ELF::PF_R;
+    if (region.permissions & ePermissionsWritable)
+      flags |= llvm::ELF::PF_W;
+    if (region.permissions & ePermissionsExecutable)
+      flags |= llvm::ELF::PF_X;
+    headers.PutHex32(llvm::ELF::PT_LOAD);
+    headers.PutHex32(flags);
+    headers.PutHex64(region.file_offset);
+    headers.PutHex64(region.start);
+    headers.PutHex64(0); // p_paddr
+    headers.PutHex64(region.save_contents ? region.size : 0);
+    headers.PutHex64(region.size);
+    headers.PutHex64(k_page_size);
+  }
+  if (extended_numbering) {
+    // Section zero, with the number of program headers in sh_info.
+    headers.PutNHex8(44, 0);
+    headers.PutHex32(num_phdrs);
+    headers.PutNHex8(16, 0);
+  }
+  headers.Write(notes.GetData(), notes.GetSize());
+
+  File core_file;
+  const std::string core_file_path(outfile.GetPath());
+  error = core_file.Open(core_file_path.c_str(),
+                         File::eOpenOptionWrite | File::eOpenOptionTruncate |
+                             File::eOpenOptionCanCreate);
+  if (error.Fail())
+    return true;
+  size_t bytes_written = headers.GetSize();
+  error = core_file.Write(headers.GetData(), bytes_written);
+  if (error.Fail())
+    return true;
+
+  const auto start_time = std::chrono::steady_clock::now();
+  uint64_t bytes_saved = 0;
+  std::vector<uint8_t> buffer(k_chunk_size);
+  for (const CoreRegion &region : regions) {
+    if (!region.save_contents)
+      continue;
+    if (core_file.SeekFromStart(region.file_offset) == -1) {
+      error.SetErrorStringWithFormat("unable to seek to offset 0x%" PRIx64
+                                     " in '%s'",
+                                     region.file_offset,
+                                     core_file_path.c_str());
+      return true;
+    }
+    error = WriteRegionContents(process, core_file, region, buffer);
+    if (error.Fail())
+      return true;
+    bytes_saved += region.size;
+  }
+
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+  if (log) {
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start_time)
+                               .count();
+    log->Printf("SaveELFCore saved %" PRIu64 " bytes of memory to '%s' in "
+                "%.3fs (%.1f MB/s)",
+                bytes_saved, core_file_path.c_str(), seconds,
+                seconds > 0 ? bytes_saved / seconds / (1024 * 1024) : 0.0);
+  }
+  return true;
+}
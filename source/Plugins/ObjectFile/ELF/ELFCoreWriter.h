@@ -0,0 +1,35 @@
+//===-- ELFCoreWriter.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ELFCoreWriter_h_
+#define liblldb_ELFCoreWriter_h_
+
+#include "lldb/lldb-private.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// Write a Linux ELF core file for \a process_sp to \a outfile, in the
+/// same format as the kernel, so that ProcessElfCore can load it.
+///
+/// The notes are built in memory, but the memory of the process is
+/// copied to the file a chunk at a time so that saving a large process
+/// doesn't need a copy of its memory in the debugger.
+///
+/// @return
+///     False if the process isn't one this writer can handle, so that
+///     other object file plug-ins can try. True otherwise, with \a error
+///     telling whether the core file was written.
+//----------------------------------------------------------------------
+bool SaveELFCore(const lldb::ProcessSP &process_sp, const FileSpec &outfile,
+                 lldb::SaveCoreStyle core_style, Status &error);
+
+} // namespace lldb_private
+
+#endif // liblldb_ELFCoreWriter_h_
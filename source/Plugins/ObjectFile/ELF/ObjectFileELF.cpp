@@ -13,11 +13,13 @@
 #include <cassert>
 #include <unordered_map>
 
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/Core/FileSpecList.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Host/LZMA.h"
 #include "lldb/Symbol/DWARFCallFrameInfo.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Target/SectionLoadList.h"
@@ -28,6 +30,7 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/Stream.h"
+#include "lldb/Utility/StreamString.h"
 #include "lldb/Utility/Timer.h"
 
 #include "llvm/ADT/PointerUnion.h"
@@ -38,6 +41,8 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/MipsABIFlags.h"
 
+#include "ELFCoreWriter.h"
+
 #define CASE_AND_STREAM(s, def, width)                                         \
   case def:                                                                    \
     s->Printf("%-*s", width, #def);                                            \
@@ -383,7 +388,8 @@ const uint32_t ObjectFileELF::g_core_uuid_magic(0xE210C);
 void ObjectFileELF::Initialize() {
   PluginManager::RegisterPlugin(GetPluginNameStatic(),
                                 GetPluginDescriptionStatic(), CreateInstance,
-                                CreateMemoryInstance, GetModuleSpecifications);
+                                CreateMemoryInstance, GetModuleSpecifications,
+                                SaveCore);
 }
 
 void ObjectFileELF::Terminate() {
@@ -791,6 +797,13 @@ size_t ObjectFileELF::GetModuleSpecifications(
   return specs.GetSize() - initial_count;
 }
 
+bool ObjectFileELF::SaveCore(const lldb::ProcessSP &process_sp,
+                             const lldb_private::FileSpec &outfile,
+                             lldb::SaveCoreStyle core_style,
+                             lldb_private::Status &error) {
+  return SaveELFCore(process_sp, outfile, core_style, error);
+}
+
 //------------------------------------------------------------------
 // PluginInterface protocol
 //------------------------------------------------------------------
@@ -810,7 +823,8 @@ ObjectFileELF::ObjectFileELF(const lldb::ModuleSP &module_sp,
     : ObjectFile(module_sp, file, file_offset, length, data_sp, data_offset),
       m_header(), m_uuid(), m_gnu_debuglink_file(), m_gnu_debuglink_crc(0),
       m_program_headers(), m_section_headers(), m_dynamic_symbols(),
-      m_filespec_ap(), m_entry_point_address(), m_arch_spec() {
+      m_filespec_ap(), m_entry_point_address(), m_arch_spec(),
+      m_gnu_debug_data_object_file_ap(), m_checked_gnu_debug_data(false) {
   if (file)
     m_file = *file;
   ::memset(&m_header, 0, sizeof(m_header));
@@ -823,7 +837,8 @@ ObjectFileELF::ObjectFileELF(const lldb::ModuleSP &module_sp,
     : ObjectFile(module_sp, process_sp, header_addr, header_data_sp),
       m_header(), m_uuid(), m_gnu_debuglink_file(), m_gnu_debuglink_crc(0),
       m_program_headers(), m_section_headers(), m_dynamic_symbols(),
-      m_filespec_ap(), m_entry_point_address(), m_arch_spec() {
+      m_filespec_ap(), m_entry_point_address(), m_arch_spec(),
+      m_gnu_debug_data_object_file_ap(), m_checked_gnu_debug_data(false) {
   ::memset(&m_header, 0, sizeof(m_header));
 }
 
@@ -1843,6 +1858,7 @@ void ObjectFileELF::CreateSections(SectionList &unified_section_list) {
       static ConstString g_sect_name_dwarf_debug_loc(".debug_loc");
       static ConstString g_sect_name_dwarf_debug_macinfo(".debug_macinfo");
       static ConstString g_sect_name_dwarf_debug_macro(".debug_macro");
+      static ConstString g_sect_name_dwarf_debug_names(".debug_names");
       static ConstString g_sect_name_dwarf_debug_pubnames(".debug_pubnames");
       static ConstString g_sect_name_dwarf_debug_pubtypes(".debug_pubtypes");
       static ConstString g_sect_name_dwarf_debug_ranges(".debug_ranges");
@@ -1895,8 +1911,9 @@ void ObjectFileELF::CreateSections(SectionList &unified_section_list) {
       // units
       // .debug_ranges – Address ranges used in DW_AT_ranges attributes
       // .debug_str – String table used in .debug_info
-      // MISSING? .gnu_debugdata - "mini debuginfo / MiniDebugInfo" section,
-      // http://sourceware.org/gdb/onlinedocs/gdb/MiniDebugInfo.html
+      // .gnu_debugdata - "mini debuginfo / MiniDebugInfo" section, see
+      // http://sourceware.org/gdb/onlinedocs/gdb/MiniDebugInfo.html and
+      // GetGnuDebugDataObjectFile()
       // MISSING? .debug-index -
       // http://src.chromium.org/viewvc/chrome/trunk/src/build/gdb-add-index?pathrev=144644
       // MISSING? .debug_types - Type descriptions from DWARF 4? See
@@ -1921,6 +1938,8 @@ void ObjectFileELF::CreateSections(SectionList &unified_section_list) {
         sect_type = eSectionTypeDWARFDebugMacInfo;
       else if (name == g_sect_name_dwarf_debug_macro)
         sect_type = eSectionTypeDWARFDebugMacro;
+      else if (name == g_sect_name_dwarf_debug_names)
+        sect_type = eSectionTypeDWARFDebugNames;
       else if (name == g_sect_name_dwarf_debug_pubnames)
         sect_type = eSectionTypeDWARFDebugPubNames;
       else if (name == g_sect_name_dwarf_debug_pubtypes)
@@ -2038,7 +2057,7 @@ void ObjectFileELF::CreateSections(SectionList &unified_section_list) {
           eSectionTypeDWARFDebugMacInfo,  eSectionTypeDWARFDebugPubNames,
           eSectionTypeDWARFDebugPubTypes, eSectionTypeDWARFDebugRanges,
           eSectionTypeDWARFDebugStr,      eSectionTypeDWARFDebugStrOffsets,
-          eSectionTypeELFSymbolTable,
+          eSectionTypeDWARFDebugNames,    eSectionTypeELFSymbolTable,
       };
       SectionList *elf_section_list = m_sections_ap.get();
       for (size_t idx = 0; idx < sizeof(g_sections) / sizeof(g_sections[0]);
@@ -2352,13 +2371,19 @@ unsigned ObjectFileELF::ParseSymbols(Symtab *symtab, user_id_t start_id,
       // by this symbol will be successfull. This case happens for absolute
       // symbols.
       ConstString fake_section_name(std::string(".absolute.") + symbol_name);
+      // The section can already exist if a symbol table cache entry that
+      // turned out to be unusable was loaded.
       symbol_section_sp =
-          std::make_shared<Section>(module_sp, this, SHN_ABS, fake_section_name,
-                                    eSectionTypeAbsoluteAddress, symbol_value,
-                                    symbol.st_size, 0, 0, 0, SHF_ALLOC);
-
-      module_section_list->AddSection(symbol_section_sp);
-      section_list->AddSection(symbol_section_sp);
+          module_section_list->FindSectionByName(fake_section_name);
+      if (!symbol_section_sp) {
+        symbol_section_sp = std::make_shared<Section>(
+            module_sp, this, SHN_ABS, fake_section_name,
+            eSectionTypeAbsoluteAddress, symbol_value, symbol.st_size, 0, 0, 0,
+            SHF_ALLOC);
+
+        module_section_list->AddSection(symbol_section_sp);
+        section_list->AddSection(symbol_section_sp);
+      }
     }
 
     if (symbol_section_sp &&
@@ -2870,6 +2895,127 @@ unsigned ObjectFileELF::RelocateDebugSections(const ELFSectionHeader *rel_hdr,
   return 0;
 }
 
+static const uint32_t kGnuDebugDataCacheMagic = 0x474E5544; // 'GNUD'
+static const uint32_t kGnuDebugDataCacheVersion = 1;
+// The most the .gnu_debugdata object file may grow when uncompressed.
+static const uint64_t kGnuDebugDataMaxCompressionRatio = 64;
+
+ObjectFileELF *ObjectFileELF::GetGnuDebugDataObjectFile() {
+  if (m_checked_gnu_debug_data)
+    return m_gnu_debug_data_object_file_ap.get();
+  m_checked_gnu_debug_data = true;
+
+  ModuleSP module_sp(GetModule());
+  SectionList *section_list = GetSectionList();
+  if (!module_sp || !section_list)
+    return nullptr;
+  static const ConstString g_sect_name_gnu_debugdata(".gnu_debugdata");
+  SectionSP section_sp =
+      section_list->FindSectionByName(g_sect_name_gnu_debugdata);
+  if (!section_sp || section_sp->GetObjectFile() != this)
+    return nullptr;
+
+  Log *log = lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_SYMBOLS);
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "ObjectFileELF::GetGnuDebugDataObjectFile");
+
+  // The uncompressed object file is kept in the index cache, after a header
+  // that identifies the module it came from, so that starting a new debug
+  // session doesn't have to uncompress it again.
+  DataFileCache *cache = DataFileCache::GetIndexCache();
+  CacheSignature signature(*module_sp);
+  std::string key;
+  if (cache && signature.IsValid())
+    key = DataFileCache::GetModuleCacheKey(*module_sp, "gnu-debugdata");
+
+  DataBufferSP data_sp;
+  lldb::offset_t data_offset = 0;
+  if (!key.empty()) {
+    data_sp = cache->GetCachedData(key);
+    if (data_sp) {
+      DataExtractor data(data_sp, endian::InlHostByteOrder(),
+                         GetAddressByteSize());
+      CacheSignature cached_signature;
+      if (data.GetU32(&data_offset) == kGnuDebugDataCacheMagic &&
+          data.GetU32(&data_offset) == kGnuDebugDataCacheVersion &&
+          cached_signature.Decode(data, &data_offset) &&
+          cached_signature == signature &&
+          MagicBytesMatch(data_sp, data_offset,
+                          data_sp->GetByteSize() - data_offset)) {
+        if (log)
+          log->Printf("ObjectFileELF::GetGnuDebugDataObjectFile: loaded "
+                      "index cache file \"%s\"",
+                      key.c_str());
+      } else {
+        cache->RemoveCacheFile(key);
+        data_sp.reset();
+        data_offset = 0;
+      }
+    }
+  }
+
+  if (!data_sp) {
+    if (!lzma::isAvailable()) {
+      if (log)
+        log->Printf("ObjectFileELF::GetGnuDebugDataObjectFile: skipping "
+                    ".gnu_debugdata of \"%s\", lldb was built without LZMA "
+                    "support",
+                    m_file.GetPath().c_str());
+      return nullptr;
+    }
+
+    DataExtractor compressed_data;
+    if (ReadSectionData(section_sp.get(), compressed_data) == 0)
+      return nullptr;
+    // A symbol table doesn't compress nearly this well, so anything larger
+    // is a corrupt or malicious size in the xz index.
+    const uint64_t max_uncompressed_size =
+        compressed_data.GetByteSize() * kGnuDebugDataMaxCompressionRatio;
+    llvm::SmallVector<uint8_t, 0> uncompressed_data;
+    llvm::Error error = lzma::uncompress(
+        llvm::ArrayRef<uint8_t>(compressed_data.GetDataStart(),
+                                compressed_data.GetByteSize()),
+        uncompressed_data, max_uncompressed_size);
+    if (error) {
+      module_sp->ReportWarning(
+          "an error occurred while decompressing section %s: %s",
+          section_sp->GetName().AsCString(),
+          llvm::toString(std::move(error)).c_str());
+      return nullptr;
+    }
+
+    data_sp.reset(new DataBufferHeap(uncompressed_data.data(),
+                                     uncompressed_data.size()));
+    if (!MagicBytesMatch(data_sp, 0, data_sp->GetByteSize()))
+      return nullptr;
+
+    if (!key.empty()) {
+      StreamString strm(Stream::eBinary, GetAddressByteSize(),
+                        endian::InlHostByteOrder());
+      strm.PutHex32(kGnuDebugDataCacheMagic);
+      strm.PutHex32(kGnuDebugDataCacheVersion);
+      signature.Encode(strm);
+      strm.Write(data_sp->GetBytes(), data_sp->GetByteSize());
+      cache->SetCachedData(
+          key, llvm::ArrayRef<uint8_t>(
+                   reinterpret_cast<const uint8_t *>(strm.GetData()),
+                   strm.GetSize()));
+    }
+  }
+
+  // The embedded object file only holds symbols and the sections they refer
+  // to. ParseSymbols maps its sections onto the sections of this module by
+  // name.
+  const lldb::offset_t length = data_sp->GetByteSize() - data_offset;
+  std::unique_ptr<ObjectFileELF> objfile_ap(
+      new ObjectFileELF(module_sp, data_sp, data_offset, &m_file, 0, length));
+  ArchSpec spec;
+  if (!objfile_ap->GetArchitecture(spec))
+    return nullptr;
+  m_gnu_debug_data_object_file_ap = std::move(objfile_ap);
+  return m_gnu_debug_data_object_file_ap.get();
+}
+
 Symtab *ObjectFileELF::GetSymtab() {
   ModuleSP module_sp(GetModule());
   if (!module_sp)
@@ -2908,11 +3054,47 @@ Symtab *ObjectFileELF::GetSymtab() {
           section_list->FindSectionByType(eSectionTypeELFDynamicSymbols, true)
               .get();
     }
+    // The symbols can come from a separate debug info file, which can change
+    // without this file changing.
+    ObjectFile *symbol_file = symtab ? symtab->GetObjectFile() : this;
+
+    // A symbol table that an earlier debug session parsed can be loaded from
+    // the index cache with its name indexes already built.
+    m_symtab_ap.reset(new Symtab(this));
+    auto decode_cache_data = [&](const DataExtractor &data,
+                                 lldb::offset_t *offset_ptr) {
+      return DecodeSymtabCacheData(data, offset_ptr, *section_list);
+    };
+    if (m_symtab_ap->LoadFromCache(symbol_file, decode_cache_data))
+      return m_symtab_ap.get();
+    m_symtab_ap.reset();
+    m_address_class_map.clear();
+
     if (symtab) {
       m_symtab_ap.reset(new Symtab(symtab->GetObjectFile()));
       symbol_id += ParseSymbolTable(m_symtab_ap.get(), symbol_id, symtab);
     }
 
+    // Stripped binaries can carry a compressed .symtab for their local
+    // functions in the .gnu_debugdata section. Merge it in so backtraces
+    // through those functions have names.
+    if (ObjectFileELF *gdd_objfile = GetGnuDebugDataObjectFile()) {
+      SectionList *gdd_section_list = gdd_objfile->GetSectionList(false);
+      Section *gdd_symtab =
+          gdd_section_list
+              ? gdd_section_list
+                    ->FindSectionByType(eSectionTypeELFSymbolTable, true)
+                    .get()
+              : nullptr;
+      if (gdd_symtab) {
+        if (m_symtab_ap == nullptr)
+          m_symtab_ap.reset(new Symtab(this));
+        symbol_id +=
+            gdd_objfile->ParseSymbolTable(m_symtab_ap.get(), symbol_id,
+                                          gdd_symtab);
+      }
+    }
+
     // DT_JMPREL
     //      If present, this entry's d_ptr member holds the address of
     //      relocation
@@ -2956,11 +3138,80 @@ Symtab *ObjectFileELF::GetSymtab() {
       m_symtab_ap.reset(new Symtab(this));
 
     m_symtab_ap->CalculateSymbolSizes();
+    // GetAddressClass() asks the object file that owns the symbol table for
+    // the address class map, save the map of that one.
+    ObjectFileELF *symtab_objfile =
+        static_cast<ObjectFileELF *>(m_symtab_ap->GetObjectFile());
+    m_symtab_ap->SaveToCache(symbol_file, [&](Stream &strm) {
+      symtab_objfile->EncodeSymtabCacheData(strm, *section_list);
+    });
   }
 
   return m_symtab_ap.get();
 }
 
+void ObjectFileELF::EncodeSymtabCacheData(Stream &strm,
+                                          const SectionList &section_list) {
+  strm.PutHex32(m_address_class_map.size());
+  for (const auto &entry : m_address_class_map) {
+    strm.PutHex64(entry.first);
+    strm.PutHex8(entry.second);
+  }
+
+  std::vector<SectionSP> absolute_sections;
+  const size_t num_sections = section_list.GetSize();
+  for (size_t i = 0; i < num_sections; ++i) {
+    SectionSP section_sp(section_list.GetSectionAtIndex(i));
+    if (section_sp->GetType() == eSectionTypeAbsoluteAddress)
+      absolute_sections.push_back(section_sp);
+  }
+  strm.PutHex32(absolute_sections.size());
+  for (const SectionSP &section_sp : absolute_sections) {
+    strm.PutCString(section_sp->GetName().GetStringRef());
+    strm.PutHex64(section_sp->GetFileAddress());
+    strm.PutHex64(section_sp->GetByteSize());
+  }
+}
+
+bool ObjectFileELF::DecodeSymtabCacheData(const DataExtractor &data,
+                                          lldb::offset_t *offset_ptr,
+                                          SectionList &section_list) {
+  m_address_class_map.clear();
+  const uint32_t num_address_classes = data.GetU32(offset_ptr);
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr,
+                                     num_address_classes * 9ull))
+    return false;
+  for (uint32_t i = 0; i < num_address_classes; ++i) {
+    const addr_t file_addr = data.GetU64(offset_ptr);
+    m_address_class_map[file_addr] =
+        static_cast<AddressClass>(data.GetU8(offset_ptr));
+  }
+
+  // Absolute symbols live in sections ParseSymbols() makes up for them,
+  // make them again so the symbols can be decoded.
+  ModuleSP module_sp(GetModule());
+  SectionList *objfile_section_list = GetSectionList(false);
+  const uint32_t num_absolute_sections = data.GetU32(offset_ptr);
+  for (uint32_t i = 0; i < num_absolute_sections; ++i) {
+    const char *name = data.GetCStr(offset_ptr);
+    if (name == nullptr ||
+        !data.ValidOffsetForDataOfSize(*offset_ptr, 2 * sizeof(uint64_t)))
+      return false;
+    const addr_t file_addr = data.GetU64(offset_ptr);
+    const addr_t byte_size = data.GetU64(offset_ptr);
+    ConstString section_name(name);
+    if (section_list.FindSectionByName(section_name))
+      continue;
+    SectionSP section_sp = std::make_shared<Section>(
+        module_sp, this, SHN_ABS, section_name, eSectionTypeAbsoluteAddress,
+        file_addr, byte_size, 0, 0, 0, SHF_ALLOC);
+    section_list.AddSection(section_sp);
+    if (objfile_section_list && objfile_section_list != &section_list)
+      objfile_section_list->AddSection(section_sp);
+  }
+  return true;
+}
+
 void ObjectFileELF::RelocateSection(lldb_private::Section *section)
 {
   static const char *debug_prefix = ".debug";
@@ -89,6 +89,11 @@ public:
                                         lldb::offset_t length,
                                         lldb_private::ModuleSpecList &specs);
 
+  static bool SaveCore(const lldb::ProcessSP &process_sp,
+                       const lldb_private::FileSpec &outfile,
+                       lldb::SaveCoreStyle core_style,
+                       lldb_private::Status &error);
+
   static bool MagicBytesMatch(lldb::DataBufferSP &data_sp, lldb::addr_t offset,
                               lldb::addr_t length);
 
@@ -225,6 +230,10 @@ private:
   /// The address class for each symbol in the elf file
   FileAddressToAddressClassMap m_address_class_map;
 
+  /// The object file embedded in the .gnu_debugdata section, if any.
+  std::unique_ptr<ObjectFileELF> m_gnu_debug_data_object_file_ap;
+  bool m_checked_gnu_debug_data;
+
   /// Returns a 1 based index of the given section header.
   size_t SectionIndex(const SectionHeaderCollIter &I);
 
@@ -282,6 +291,12 @@ private:
                             lldb::user_id_t start_id,
                             lldb_private::Section *symtab);
 
+  /// Returns the object file that is xz compressed in the .gnu_debugdata
+  /// section ("MiniDebugInfo"), uncompressing it the first time, or
+  /// nullptr if there is none.  The uncompressed object file is kept in the
+  /// index cache when it is enabled, so that it is only uncompressed once.
+  ObjectFileELF *GetGnuDebugDataObjectFile();
+
   /// Helper routine for ParseSymbolTable().
   unsigned ParseSymbols(lldb_private::Symtab *symbol_table,
                         lldb::user_id_t start_id,
@@ -301,6 +316,18 @@ private:
   void ParseUnwindSymbols(lldb_private::Symtab *symbol_table,
                           lldb_private::DWARFCallFrameInfo *eh_frame);
 
+  /// Saves what parsing the symbols computed besides the symbols themselves
+  /// (the address class map and the sections made up for absolute symbols)
+  /// next to the symbol table in the index cache.
+  void EncodeSymtabCacheData(lldb_private::Stream &strm,
+                             const lldb_private::SectionList &section_list);
+
+  /// Restores what EncodeSymtabCacheData() saved into this object file and
+  /// the module's \a section_list.
+  bool DecodeSymtabCacheData(const lldb_private::DataExtractor &data,
+                             lldb::offset_t *offset_ptr,
+                             lldb_private::SectionList &section_list);
+
   /// Relocates debug sections
   unsigned RelocateDebugSections(const elf::ELFSectionHeader *rel_hdr,
                                  lldb::user_id_t rel_id,
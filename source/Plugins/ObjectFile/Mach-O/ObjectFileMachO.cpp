@@ -1214,6 +1214,7 @@ AddressClass ObjectFileMachO::GetAddressClass(lldb::addr_t file_addr) {
           case eSectionTypeDWARFAppleExternalTypes:
           case eSectionTypeDWARFAppleNamespaces:
           case eSectionTypeDWARFAppleObjC:
+          case eSectionTypeDWARFDebugNames:
           case eSectionTypeSwiftModules:
             return eAddressClassDebug;
 
@@ -6250,7 +6251,8 @@ bool ObjectFileMachO::SetLoadAddress(Target &target, lldb::addr_t value,
 }
 
 bool ObjectFileMachO::SaveCore(const lldb::ProcessSP &process_sp,
-                               const FileSpec &outfile, Status &error) {
+                               const FileSpec &outfile,
+                               lldb::SaveCoreStyle core_style, Status &error) {
   if (process_sp) {
     Target &target = process_sp->GetTarget();
     const ArchSpec target_arch = target.GetArchitecture();
@@ -6260,6 +6262,11 @@ bool ObjectFileMachO::SaveCore(const lldb::ProcessSP &process_sp,
          target_triple.getOS() == llvm::Triple::IOS ||
          target_triple.getOS() == llvm::Triple::WatchOS ||
          target_triple.getOS() == llvm::Triple::TvOS)) {
+      if (core_style != eSaveCoreFull) {
+        error.SetErrorString(
+            "Mach-O core files only support the \"full\" save-core style");
+        return true;
+      }
       bool make_core = false;
       switch (target_arch.GetMachine()) {
       case llvm::Triple::aarch64:
@@ -146,7 +146,14 @@ size_t ObjectFilePECOFF::GetModuleSpecifications(
 
 bool ObjectFilePECOFF::SaveCore(const lldb::ProcessSP &process_sp,
                                 const lldb_private::FileSpec &outfile,
+                                lldb::SaveCoreStyle core_style,
                                 lldb_private::Status &error) {
+  if (process_sp && core_style != eSaveCoreFull &&
+      process_sp->GetTarget().GetArchitecture().GetTriple().isOSWindows()) {
+    error.SetErrorString(
+        "minidumps only support the \"full\" save-core style");
+    return true;
+  }
   return SaveMiniDump(process_sp, outfile, error);
 }
 
@@ -11,6 +11,7 @@
 
 // C Includes
 #include <errno.h>
+#include <limits.h>
 #include <stdint.h>
 #include <string.h>
 #include <unistd.h>
@@ -1784,6 +1785,7 @@ NativeProcessLinux::GetCrashReasonForSIGBUS(const siginfo_t *info)
 
 Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
                                       size_t &bytes_read) {
+  bytes_read = 0;
   if (ProcessVmReadvSupported()) {
     // The process_vm_readv path is about 50 times faster than ptrace api. We
     // want to use
@@ -1797,8 +1799,9 @@ Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
     remote_iov.iov_base = reinterpret_cast<void *>(addr);
     remote_iov.iov_len = size;
 
-    bytes_read = process_vm_readv(pid, &local_iov, 1, &remote_iov, 1, 0);
-    const bool success = bytes_read == size;
+    const ssize_t result =
+        process_vm_readv(pid, &local_iov, 1, &remote_iov, 1, 0);
+    const bool success = result == static_cast<ssize_t>(size);
 
     Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
     LLDB_LOG(log,
@@ -1806,12 +1809,122 @@ Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
              "address {1:x}: {2}",
              size, addr, success ? "Success" : llvm::sys::StrError(errno));
 
-    if (success)
+    if (success) {
+      bytes_read = size;
       return Status();
-    // else the call failed for some reason, let's retry the read using ptrace
-    // api.
+    }
+    // Keep whatever the kernel copied before it hit the first page it
+    // couldn't read and read the rest piece by piece below.
+    if (result > 0)
+      bytes_read = result;
+  }
+
+  // Split the rest of the request at memory region boundaries using the
+  // cached /proc/pid/maps layout. Readable regions are read with
+  // process_vm_readv, everything else (and anything process_vm_readv
+  // refuses, like pages the inferior itself can't read) goes through
+  // ptrace. We stop at the first piece that can't be read at all so that
+  // bytes_read always describes a contiguous prefix of the buffer.
+  uint8_t *dst = static_cast<uint8_t *>(buf);
+  Status error;
+  while (bytes_read < size) {
+    const lldb::addr_t piece_addr = addr + bytes_read;
+    size_t piece_size = size - bytes_read;
+    bool use_ptrace = !ProcessVmReadvSupported();
+
+    MemoryRegionInfo region_info;
+    if (GetMemoryRegionInfo(piece_addr, region_info).Success()) {
+      if (region_info.GetMapped() == MemoryRegionInfo::OptionalBool::eNo) {
+        error.SetErrorStringWithFormat(
+            "memory at address 0x%" PRIx64 " is not mapped", piece_addr);
+        break;
+      }
+      const lldb::addr_t region_end = region_info.GetRange().GetRangeEnd();
+      if (region_end > piece_addr && region_end - piece_addr < piece_size)
+        piece_size = region_end - piece_addr;
+      if (region_info.GetReadable() != MemoryRegionInfo::OptionalBool::eYes)
+        use_ptrace = true;
+    }
+
+    size_t piece_bytes_read = 0;
+    if (!use_ptrace)
+      piece_bytes_read = ReadMemoryWithProcessVmReadv(
+          piece_addr, dst + bytes_read, piece_size);
+    if (piece_bytes_read < piece_size) {
+      size_t ptrace_bytes_read = 0;
+      error = ReadMemoryWithPtrace(piece_addr + piece_bytes_read,
+                                   dst + bytes_read + piece_bytes_read,
+                                   piece_size - piece_bytes_read,
+                                   ptrace_bytes_read);
+      piece_bytes_read += ptrace_bytes_read;
+    }
+    bytes_read += piece_bytes_read;
+    if (piece_bytes_read < piece_size)
+      break;
+  }
+
+  // bytes_read still tells the caller how much of the buffer is valid, but
+  // anything short of the whole request is an error.
+  if (bytes_read == size)
+    return Status();
+  if (error.Success())
+    error.SetErrorStringWithFormat("failed to read memory at address 0x%" PRIx64,
+                                   addr + bytes_read);
+  return error;
+}
+
+size_t NativeProcessLinux::ReadMemoryWithProcessVmReadv(lldb::addr_t addr,
+                                                        void *buf,
+                                                        size_t size) {
+  static const size_t page_size = getpagesize();
+
+  Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_MEMORY));
+  const ::pid_t pid = GetID();
+  uint8_t *dst = static_cast<uint8_t *>(buf);
+  std::vector<struct iovec> remote_iov;
+  size_t bytes_read = 0;
+  while (bytes_read < size) {
+    // Give every page its own remote iovec. process_vm_readv only reports
+    // partial transfers at iovec granularity, so this tells us exactly
+    // where the readable memory ends.
+    remote_iov.clear();
+    size_t batch_size = 0;
+    lldb::addr_t page_addr = addr + bytes_read;
+    while (bytes_read + batch_size < size && remote_iov.size() < IOV_MAX) {
+      const size_t page_offset = page_addr & (page_size - 1);
+      const size_t len =
+          std::min(page_size - page_offset, size - bytes_read - batch_size);
+      struct iovec iov;
+      iov.iov_base = reinterpret_cast<void *>(page_addr);
+      iov.iov_len = len;
+      remote_iov.push_back(iov);
+      page_addr += len;
+      batch_size += len;
+    }
+
+    struct iovec local_iov;
+    local_iov.iov_base = dst + bytes_read;
+    local_iov.iov_len = batch_size;
+    const ssize_t result = process_vm_readv(pid, &local_iov, 1,
+                                            remote_iov.data(),
+                                            remote_iov.size(), 0);
+    LLDB_LOG(log,
+             "using process_vm_readv to read {0} bytes in {1} pieces from "
+             "inferior address {2:x}: {3}",
+             batch_size, remote_iov.size(), addr + bytes_read,
+             result < 0 ? llvm::sys::StrError(errno) : "Success");
+    if (result <= 0)
+      break;
+    bytes_read += result;
+    if (static_cast<size_t>(result) < batch_size)
+      break;
   }
+  return bytes_read;
+}
 
+Status NativeProcessLinux::ReadMemoryWithPtrace(lldb::addr_t addr, void *buf,
+                                                size_t size,
+                                                size_t &bytes_read) {
   unsigned char *dst = static_cast<unsigned char *>(buf);
   size_t remainder;
   long data;
@@ -1842,9 +1955,89 @@ Status NativeProcessLinux::ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf,
                                                  size_t size,
                                                  size_t &bytes_read) {
   Status error = ReadMemory(addr, buf, size, bytes_read);
-  if (error.Fail())
-    return error;
-  return m_breakpoint_list.RemoveTrapsFromBuffer(addr, buf, size);
+  if (bytes_read > 0) {
+    Status trap_error =
+        m_breakpoint_list.RemoveTrapsFromBuffer(addr, buf, bytes_read);
+    if (error.Success())
+      error = trap_error;
+  }
+  return error;
+}
+
+Status NativeProcessLinux::ReadMemoryRangesWithoutTrap(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+    llvm::MutableArrayRef<uint8_t> buffer, std::vector<size_t> &bytes_read) {
+  size_t total_size = 0;
+  for (const Range<lldb::addr_t, size_t> &range : ranges)
+    total_size += range.GetByteSize();
+  if (total_size > buffer.size())
+    return Status("buffer is too small for the memory ranges");
+
+  if (!ProcessVmReadvSupported())
+    return NativeProcessProtocol::ReadMemoryRangesWithoutTrap(ranges, buffer,
+                                                              bytes_read);
+
+  Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_MEMORY));
+  const ::pid_t pid = GetID();
+  bytes_read.assign(ranges.size(), 0);
+  std::vector<struct iovec> local_iov;
+  std::vector<struct iovec> remote_iov;
+  size_t idx = 0;
+  size_t offset = 0;
+  while (idx < ranges.size()) {
+    // Read as many ranges as the kernel accepts with a single call.
+    const size_t num_iov = std::min<size_t>(ranges.size() - idx, IOV_MAX);
+    local_iov.resize(num_iov);
+    remote_iov.resize(num_iov);
+    size_t iov_offset = offset;
+    for (size_t i = 0; i < num_iov; ++i) {
+      const Range<lldb::addr_t, size_t> &range = ranges[idx + i];
+      local_iov[i].iov_base = buffer.data() + iov_offset;
+      local_iov[i].iov_len = range.GetByteSize();
+      remote_iov[i].iov_base = reinterpret_cast<void *>(range.GetRangeBase());
+      remote_iov[i].iov_len = range.GetByteSize();
+      iov_offset += range.GetByteSize();
+    }
+
+    const ssize_t result = process_vm_readv(pid, local_iov.data(), num_iov,
+                                            remote_iov.data(), num_iov, 0);
+    LLDB_LOG(log,
+             "using process_vm_readv to read {0} ranges from inferior: {1}",
+             num_iov, result < 0 ? llvm::sys::StrError(errno) : "Success");
+
+    // process_vm_readv stops at the first range it can't read completely.
+    size_t remaining = result < 0 ? 0 : result;
+    const size_t end_idx = idx + num_iov;
+    for (; idx < end_idx; ++idx) {
+      const size_t size = ranges[idx].GetByteSize();
+      if (remaining < size)
+        break;
+      bytes_read[idx] = size;
+      remaining -= size;
+      offset += size;
+    }
+
+    if (idx < end_idx) {
+      // Read the range that stopped process_vm_readv on its own, which
+      // falls back to ptrace.
+      const size_t size = ranges[idx].GetByteSize();
+      size_t range_bytes_read = 0;
+      ReadMemory(ranges[idx].GetRangeBase(), buffer.data() + offset, size,
+                 range_bytes_read);
+      bytes_read[idx] = std::min(range_bytes_read, size);
+      offset += size;
+      ++idx;
+    }
+  }
+
+  offset = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (bytes_read[i] > 0)
+      m_breakpoint_list.RemoveTrapsFromBuffer(
+          ranges[i].GetRangeBase(), buffer.data() + offset, bytes_read[i]);
+    offset += ranges[i].GetByteSize();
+  }
+  return Status();
 }
 
 Status NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf,
@@ -74,6 +74,11 @@ public:
   Status ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size,
                                size_t &bytes_read) override;
 
+  Status ReadMemoryRangesWithoutTrap(
+      llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+      llvm::MutableArrayRef<uint8_t> buffer,
+      std::vector<size_t> &bytes_read) override;
+
   Status WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
                      size_t &bytes_written) override;
 
@@ -243,6 +248,14 @@ private:
 
   Status PopulateMemoryRegionCache();
 
+  // Read memory with process_vm_readv, one iovec per page. Returns the
+  // number of bytes read before the first page that couldn't be read.
+  size_t ReadMemoryWithProcessVmReadv(lldb::addr_t addr, void *buf,
+                                      size_t size);
+
+  Status ReadMemoryWithPtrace(lldb::addr_t addr, void *buf, size_t size,
+                              size_t &bytes_read);
+
   lldb::user_id_t StartTraceGroup(const TraceOptions &config,
                                          Status &error);
 
@@ -174,6 +174,10 @@ Status ProcessElfCore::DoLoadCore() {
 
   SetCanJIT(false);
 
+  // Keep a reference to the file contents so that memory reads don't need
+  // to go through the module. Only the segments that are used are read.
+  core->GetData(0, core->GetByteSize(), m_core_data);
+
   m_thread_data_valid = true;
 
   bool ranges_are_sorted = true;
@@ -185,10 +189,9 @@ Status ProcessElfCore::DoLoadCore() {
     const elf::ELFProgramHeader *header = core->GetProgramHeaderByIndex(i);
     assert(header != NULL);
 
-    DataExtractor data = core->GetSegmentDataByIndex(i);
-
     // Parse thread contexts and auxv structure
     if (header->p_type == llvm::ELF::PT_NOTE) {
+      DataExtractor data = core->GetSegmentDataByIndex(i);
       if (llvm::Error error = ParseThreadContextsFromNoteSegment(header, data))
         return Status(std::move(error));
     }
@@ -344,11 +347,6 @@ Status ProcessElfCore::GetMemoryRegionInfo(lldb::addr_t load_addr,
 
 size_t ProcessElfCore::DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
                                     Status &error) {
-  ObjectFile *core_objfile = m_core_module_sp->GetObjectFile();
-
-  if (core_objfile == NULL)
-    return 0;
-
   // Get the address range
   const VMRangeToFileOffset::Entry *address_range =
       m_core_aranges.FindEntryThatContains(addr);
@@ -387,7 +385,7 @@ size_t ProcessElfCore::DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
   // If there is data available on the core file read it
   if (bytes_to_read)
     bytes_copied =
-        core_objfile->CopyData(offset + file_start, bytes_to_read, buf);
+        m_core_data.CopyData(offset + file_start, bytes_to_read, buf);
 
   assert(zero_fill_size <= size);
   // Pad remaining bytes
@@ -397,6 +395,24 @@ size_t ProcessElfCore::DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
   return bytes_copied + zero_fill_size;
 }
 
+size_t ProcessElfCore::PeekMemory(lldb::addr_t addr, size_t size,
+                                  DataExtractor &data) {
+  const VMRangeToFileOffset::Entry *address_range =
+      m_core_aranges.FindEntryThatContains(addr);
+  if (address_range == NULL)
+    return 0;
+
+  // Only the part of the segment that is in the core file can be shared,
+  // the rest of it reads as zeros.
+  const lldb::addr_t offset = addr - address_range->GetRangeBase();
+  const lldb::addr_t file_size = address_range->data.GetByteSize();
+  if (offset >= file_size)
+    return 0;
+  const lldb::addr_t bytes_left = file_size - offset;
+  return data.SetData(m_core_data, address_range->data.GetRangeBase() + offset,
+                      std::min<lldb::addr_t>(size, bytes_left));
+}
+
 void ProcessElfCore::Clear() {
   m_thread_list.Clear();
 
@@ -109,6 +109,9 @@ public:
   size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
                       lldb_private::Status &error) override;
 
+  size_t PeekMemory(lldb::addr_t addr, size_t size,
+                    lldb_private::DataExtractor &data) override;
+
   lldb_private::Status
   GetMemoryRegionInfo(lldb::addr_t load_addr,
                       lldb_private::MemoryRegionInfo &region_info) override;
@@ -159,6 +162,10 @@ private:
   // AUXV structure found from the NOTE segment
   lldb_private::DataExtractor m_auxv;
 
+  // The contents of the core file, shared with the core object file which
+  // maps the file so that its pages are only read when they are used
+  lldb_private::DataExtractor m_core_data;
+
   // Address ranges found in the core
   VMRangeToFileOffset m_core_aranges;
 
@@ -10,6 +10,7 @@
 #include "GDBRemoteClientBase.h"
 
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/MathExtras.h"
 
 #include "lldb/Target/Process.h"
 #include "lldb/Target/UnixSignals.h"
@@ -24,6 +25,15 @@ using namespace std::chrono;
 
 static const seconds kInterruptTimeout(5);
 
+// The number of packets SendPacketsAndWaitForResponses keeps in flight.
+// Bounding this keeps the stub from blocking on a full socket buffer while
+// we are still busy writing packets it hasn't read yet.
+static const size_t kMaxPacketsInFlight = 16;
+
+// How long SendPacketsAndWaitForResponses waits for each of the replies
+// still in flight after a reply timed out.
+static const seconds kDrainTimeout(1);
+
 /////////////////////////
 // GDBRemoteClientBase //
 /////////////////////////
@@ -179,6 +189,7 @@ GDBRemoteClientBase::SendPacketAndWaitForResponse(
 GDBRemoteCommunication::PacketResult
 GDBRemoteClientBase::SendPacketAndWaitForResponseNoLock(
     llvm::StringRef payload, StringExtractorGDBRemote &response) {
+  const auto start_time = steady_clock::now();
   PacketResult packet_result = SendPacketNoLock(payload);
   if (packet_result != PacketResult::Success)
     return packet_result;
@@ -190,8 +201,11 @@ GDBRemoteClientBase::SendPacketAndWaitForResponseNoLock(
     if (packet_result != PacketResult::Success)
       return packet_result;
     // Make sure our response is valid for the payload that was sent
-    if (response.ValidateResponse())
+    if (response.ValidateResponse()) {
+      UpdatePacketStatistics(payload, response,
+                             steady_clock::now() - start_time);
       return packet_result;
+    }
     // Response says it wasn't valid
     Log *log = ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PACKETS);
     if (log)
@@ -205,6 +219,100 @@ GDBRemoteClientBase::SendPacketAndWaitForResponseNoLock(
   return packet_result;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::SendPacketsAndWaitForResponses(
+    llvm::ArrayRef<std::string> payloads,
+    std::vector<StringExtractorGDBRemote> &responses, bool send_async) {
+  responses.resize(payloads.size());
+  Lock lock(*this, send_async);
+  if (!lock) {
+    if (Log *log =
+            ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PROCESS))
+      log->Printf("GDBRemoteClientBase::%s failed to get mutex, not sending "
+                  "%zu packets (send_async=%d)",
+                  __FUNCTION__, payloads.size(), send_async);
+    return PacketResult::ErrorSendFailed;
+  }
+
+  return SendPacketsAndWaitForResponsesNoLock(payloads, responses);
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::SendPacketsAndWaitForResponsesNoLock(
+    llvm::ArrayRef<std::string> payloads,
+    std::vector<StringExtractorGDBRemote> &responses) {
+  responses.resize(payloads.size());
+
+  // In ack mode every packet waits for its ack before the next one can be
+  // sent, and a reply could be mistaken for an ack, so don't pipeline.
+  if (GetSendAcks()) {
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      PacketResult packet_result =
+          SendPacketAndWaitForResponseNoLock(payloads[i], responses[i]);
+      if (packet_result != PacketResult::Success)
+        return packet_result;
+    }
+    return PacketResult::Success;
+  }
+
+  // The stub handles packets in the order it receives them, so the replies
+  // come back in the order the packets were sent.
+  PacketResult send_result = PacketResult::Success;
+  std::vector<steady_clock::time_point> send_times(payloads.size());
+  size_t num_sent = 0;
+  size_t num_received = 0;
+  while (num_received < num_sent || num_sent < payloads.size()) {
+    while (send_result == PacketResult::Success &&
+           num_sent < payloads.size() &&
+           num_sent - num_received < kMaxPacketsInFlight) {
+      send_times[num_sent] = steady_clock::now();
+      send_result = SendPacketNoLock(payloads[num_sent]);
+      if (send_result == PacketResult::Success)
+        ++num_sent;
+    }
+    if (num_received == num_sent)
+      break;
+
+    StringExtractorGDBRemote &response = responses[num_received];
+    // Syncing up with the stub after a timeout would drop the replies to
+    // the other packets in flight, those are drained below instead.
+    PacketResult packet_result =
+        ReadPacket(response, GetPacketTimeout(), false);
+    if (packet_result != PacketResult::Success) {
+      // The replies still in flight would be taken as the replies to the
+      // next packets we send. Give them a little longer to arrive, and
+      // give up on the connection if they don't.
+      if (packet_result == PacketResult::ErrorReplyTimeout) {
+        StringExtractorGDBRemote late_response;
+        for (; num_received < num_sent; ++num_received) {
+          if (ReadPacket(late_response, kDrainTimeout, false) !=
+              PacketResult::Success) {
+            Disconnect();
+            break;
+          }
+        }
+      }
+      return packet_result;
+    }
+    if (!response.ValidateResponse()) {
+      // We can't wait for another reply like the unpipelined version does,
+      // the next reply belongs to the next packet.
+      Log *log =
+          ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PACKETS);
+      if (log)
+        log->Printf("error: packet with payload \"%s\" got invalid response "
+                    "\"%s\": using invalid response",
+                    payloads[num_received].c_str(),
+                    response.GetStringRef().c_str());
+    } else {
+      UpdatePacketStatistics(payloads[num_received], response,
+                             steady_clock::now() - send_times[num_received]);
+    }
+    ++num_received;
+  }
+  return send_result;
+}
+
 bool GDBRemoteClientBase::SendvContPacket(llvm::StringRef payload,
                                           StringExtractorGDBRemote &response) {
   Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PROCESS));
@@ -232,6 +340,54 @@ bool GDBRemoteClientBase::SendvContPacket(llvm::StringRef payload,
 
   return false;
 }
+llvm::StringRef
+GDBRemoteClientBase::GetPacketStatisticsKey(llvm::StringRef payload) {
+  if (payload.empty())
+    return payload;
+  switch (payload[0]) {
+  case 'q':
+  case 'Q':
+  case 'v':
+  case 'j':
+  case '_':
+    // Named packets, e.g. "qMemoryRegionInfo:1000" or "qRegisterInfo12".
+    return payload.take_front(
+        1 + payload.drop_front().take_while(::isalpha).size());
+  default:
+    return payload.take_front(1);
+  }
+}
+
+void GDBRemoteClientBase::UpdatePacketStatistics(
+    llvm::StringRef payload, const StringExtractorGDBRemote &response,
+    steady_clock::duration elapsed) {
+  const nanoseconds elapsed_ns = duration_cast<nanoseconds>(elapsed);
+  std::lock_guard<std::mutex> guard(m_packet_stats_mutex);
+  PacketStatistics &stats = m_packet_stats[GetPacketStatisticsKey(payload)];
+  ++stats.num_packets;
+  stats.bytes_sent += payload.size();
+  stats.bytes_received += response.GetStringRef().size();
+  stats.total_time += elapsed_ns;
+  stats.max_time = std::max(stats.max_time, elapsed_ns);
+  const uint64_t elapsed_us = duration_cast<microseconds>(elapsed).count();
+  const size_t bucket =
+      elapsed_us ? std::min<size_t>(llvm::Log2_64(elapsed_us),
+                                    PacketStatistics::kNumLatencyBuckets - 1)
+                 : 0;
+  ++stats.latency_buckets[bucket];
+}
+
+GDBRemoteClientBase::PacketStatisticsMap
+GDBRemoteClientBase::GetPacketStatistics() const {
+  std::lock_guard<std::mutex> guard(m_packet_stats_mutex);
+  return m_packet_stats;
+}
+
+void GDBRemoteClientBase::ClearPacketStatistics() {
+  std::lock_guard<std::mutex> guard(m_packet_stats_mutex);
+  m_packet_stats.clear();
+}
+
 bool GDBRemoteClientBase::ShouldStop(const UnixSignals &signals,
                                      StringExtractorGDBRemote &response) {
   std::lock_guard<std::mutex> lock(m_mutex);
@@ -12,7 +12,11 @@
 
 #include "GDBRemoteCommunication.h"
 
+#include <chrono>
 #include <condition_variable>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace lldb_private {
 namespace process_gdb_remote {
@@ -34,6 +38,26 @@ public:
     virtual void HandleAsyncStructuredDataPacket(llvm::StringRef data) = 0;
   };
 
+  //------------------------------------------------------------------
+  /// Counters for all packets of one type that got a response.
+  //------------------------------------------------------------------
+  struct PacketStatistics {
+    uint64_t num_packets = 0;
+    uint64_t bytes_sent = 0;
+    /// Response bytes after decompression.
+    uint64_t bytes_received = 0;
+    /// Time from sending a packet until its response arrived.
+    std::chrono::nanoseconds total_time{0};
+    std::chrono::nanoseconds max_time{0};
+    /// Bucket N counts the packets that took less than 2^(N+1)
+    /// microseconds (and at least 2^N for N > 0). The last bucket also
+    /// counts everything slower than that.
+    static const size_t kNumLatencyBuckets = 16;
+    uint64_t latency_buckets[kNumLatencyBuckets] = {};
+  };
+
+  typedef std::map<std::string, PacketStatistics> PacketStatisticsMap;
+
   GDBRemoteClientBase(const char *comm_name, const char *listener_name);
 
   bool SendAsyncSignal(int signo);
@@ -48,9 +72,45 @@ public:
                                             StringExtractorGDBRemote &response,
                                             bool send_async);
 
+  //------------------------------------------------------------------
+  /// Send several independent packets and wait for all of their
+  /// responses.
+  ///
+  /// When the connection is in no-ack mode several packets are kept in
+  /// flight at once, so the whole batch takes about one round trip
+  /// instead of one round trip per packet. Responses are matched to the
+  /// packets in the order they were sent.
+  ///
+  /// @param[in] payloads
+  ///     The packets to send. None of them may depend on the response to
+  ///     an earlier packet in the batch.
+  ///
+  /// @param[out] responses
+  ///     Resized to the number of packets. responses[i] is the response
+  ///     to payloads[i].
+  ///
+  /// @return
+  ///     PacketResult::Success if every packet got a response.
+  //------------------------------------------------------------------
+  PacketResult SendPacketsAndWaitForResponses(
+      llvm::ArrayRef<std::string> payloads,
+      std::vector<StringExtractorGDBRemote> &responses, bool send_async);
+
   bool SendvContPacket(llvm::StringRef payload,
                        StringExtractorGDBRemote &response);
 
+  //------------------------------------------------------------------
+  /// Get the packet statistics keyed by packet type. The packet type is
+  /// the packet name for "q", "Q", "v", "j" and "_" packets (e.g.
+  /// "qMemoryRegionInfo") and the first character for all others (e.g.
+  /// "x" or "p").
+  //------------------------------------------------------------------
+  PacketStatisticsMap GetPacketStatistics() const;
+
+  void ClearPacketStatistics();
+
+  static llvm::StringRef GetPacketStatisticsKey(llvm::StringRef payload);
+
   class Lock {
   public:
     Lock(GDBRemoteClientBase &comm, bool interrupt);
@@ -76,6 +136,10 @@ protected:
   SendPacketAndWaitForResponseNoLock(llvm::StringRef payload,
                                      StringExtractorGDBRemote &response);
 
+  PacketResult SendPacketsAndWaitForResponsesNoLock(
+      llvm::ArrayRef<std::string> payloads,
+      std::vector<StringExtractorGDBRemote> &responses);
+
   virtual void OnRunPacketSent(bool first);
 
 private:
@@ -117,6 +181,13 @@ private:
   // simple mutex.
   std::recursive_mutex m_async_mutex;
 
+  mutable std::mutex m_packet_stats_mutex;
+  PacketStatisticsMap m_packet_stats;
+
+  void UpdatePacketStatistics(llvm::StringRef payload,
+                              const StringExtractorGDBRemote &response,
+                              std::chrono::steady_clock::duration elapsed);
+
   bool ShouldStop(const UnixSignals &signals,
                   StringExtractorGDBRemote &response);
 
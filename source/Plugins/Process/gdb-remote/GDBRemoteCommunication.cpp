@@ -42,14 +42,6 @@
 #define DEBUGSERVER_BASENAME "lldb-server"
 #endif
 
-#if defined(HAVE_LIBCOMPRESSION)
-#include <compression.h>
-#endif
-
-#if defined(HAVE_LIBZ)
-#include <zlib.h>
-#endif
-
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::process_gdb_remote;
@@ -139,6 +131,9 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
 #endif
       m_echo_number(0), m_supports_qEcho(eLazyBoolCalculate), m_history(512),
       m_send_acks(true), m_compression_type(CompressionType::None),
+      m_send_compression_type(CompressionType::None),
+      m_send_compression_min_size(0), m_num_compressed_packets_received(0),
+      m_compressed_bytes_received(0), m_decompressed_bytes_received(0),
       m_listen_url() {
 }
 
@@ -193,6 +188,12 @@ GDBRemoteCommunication::SendPacketNoLock(llvm::StringRef payload) {
   if (IsConnected()) {
     StreamString packet(0, 4, eByteOrderBig);
 
+    std::string framed_payload;
+    if (m_send_compression_type != CompressionType::None) {
+      CompressPayload(payload, framed_payload);
+      payload = framed_payload;
+    }
+
     packet.PutChar('$');
     packet.Write(payload.data(), payload.size());
     packet.PutChar('#');
@@ -586,90 +587,32 @@ bool GDBRemoteCommunication::DecompressPacket() {
     i++;
   }
 
-  uint8_t *decompressed_buffer = nullptr;
+  std::vector<uint8_t> decompressed_buffer;
   size_t decompressed_bytes = 0;
-
   if (decompressed_bufsize != ULONG_MAX) {
-    decompressed_buffer = (uint8_t *)malloc(decompressed_bufsize + 1);
-    if (decompressed_buffer == nullptr) {
-      m_bytes.erase(0, size_of_first_packet);
-      return false;
-    }
+    decompressed_buffer.resize(decompressed_bufsize);
+    decompressed_bytes = DecompressBuffer(
+        m_compression_type, unescaped_content, decompressed_buffer);
   }
 
-#if defined(HAVE_LIBCOMPRESSION)
-  // libcompression is weak linked so check that compression_decode_buffer() is
-  // available
-  if (m_compression_type == CompressionType::ZlibDeflate ||
-      m_compression_type == CompressionType::LZFSE ||
-      m_compression_type == CompressionType::LZ4) {
-    compression_algorithm compression_type;
-    if (m_compression_type == CompressionType::LZFSE)
-      compression_type = COMPRESSION_LZFSE;
-    else if (m_compression_type == CompressionType::ZlibDeflate)
-      compression_type = COMPRESSION_ZLIB;
-    else if (m_compression_type == CompressionType::LZ4)
-      compression_type = COMPRESSION_LZ4_RAW;
-    else if (m_compression_type == CompressionType::LZMA)
-      compression_type = COMPRESSION_LZMA;
-
-    // If we have the expected size of the decompressed payload, we can allocate
-    // the right-sized buffer and do it.  If we don't have that information,
-    // we'll
-    // need to try decoding into a big buffer and if the buffer wasn't big
-    // enough,
-    // increase it and try again.
-
-    if (decompressed_bufsize != ULONG_MAX && decompressed_buffer != nullptr) {
-      decompressed_bytes = compression_decode_buffer(
-          decompressed_buffer, decompressed_bufsize + 10,
-          (uint8_t *)unescaped_content.data(), unescaped_content.size(), NULL,
-          compression_type);
-    }
-  }
-#endif
-
-#if defined(HAVE_LIBZ)
-  if (decompressed_bytes == 0 && decompressed_bufsize != ULONG_MAX &&
-      decompressed_buffer != nullptr &&
-      m_compression_type == CompressionType::ZlibDeflate) {
-    z_stream stream;
-    memset(&stream, 0, sizeof(z_stream));
-    stream.next_in = (Bytef *)unescaped_content.data();
-    stream.avail_in = (uInt)unescaped_content.size();
-    stream.total_in = 0;
-    stream.next_out = (Bytef *)decompressed_buffer;
-    stream.avail_out = decompressed_bufsize;
-    stream.total_out = 0;
-    stream.zalloc = Z_NULL;
-    stream.zfree = Z_NULL;
-    stream.opaque = Z_NULL;
-
-    if (inflateInit2(&stream, -15) == Z_OK) {
-      int status = inflate(&stream, Z_NO_FLUSH);
-      inflateEnd(&stream);
-      if (status == Z_STREAM_END) {
-        decompressed_bytes = stream.total_out;
-      }
-    }
-  }
-#endif
-
-  if (decompressed_bytes == 0 || decompressed_buffer == nullptr) {
-    if (decompressed_buffer)
-      free(decompressed_buffer);
+  if (decompressed_bytes == 0) {
     m_bytes.erase(0, size_of_first_packet);
     return false;
   }
 
+  ++m_num_compressed_packets_received;
+  m_compressed_bytes_received += size_of_first_packet;
+  m_decompressed_bytes_received += decompressed_bytes;
+
   std::string new_packet;
   new_packet.reserve(decompressed_bytes + 6);
   new_packet.push_back(m_bytes[0]);
-  new_packet.append((const char *)decompressed_buffer, decompressed_bytes);
+  new_packet.append((const char *)decompressed_buffer.data(),
+                    decompressed_bytes);
   new_packet.push_back('#');
   if (GetSendAcks()) {
-    uint8_t decompressed_checksum = CalculcateChecksum(
-        llvm::StringRef((const char *)decompressed_buffer, decompressed_bytes));
+    uint8_t decompressed_checksum = CalculcateChecksum(llvm::StringRef(
+        (const char *)decompressed_buffer.data(), decompressed_bytes));
     char decompressed_checksum_str[3];
     snprintf(decompressed_checksum_str, 3, "%02x", decompressed_checksum);
     new_packet.append(decompressed_checksum_str);
@@ -680,11 +623,47 @@ bool GDBRemoteCommunication::DecompressPacket() {
 
   m_bytes.replace(0, size_of_first_packet, new_packet.data(),
                   new_packet.size());
-
-  free(decompressed_buffer);
   return true;
 }
 
+void GDBRemoteCommunication::CompressPayload(llvm::StringRef payload,
+                                             std::string &framed) {
+  framed.clear();
+  llvm::ArrayRef<uint8_t> payload_bytes(payload.bytes_begin(),
+                                        payload.bytes_end());
+  std::vector<uint8_t> compressed;
+  if (payload.size() >= m_send_compression_min_size &&
+      CompressBuffer(m_send_compression_type, payload_bytes, compressed) &&
+      compressed.size() < payload.size()) {
+    framed.reserve(compressed.size() + compressed.size() / 8 + 24);
+    framed.push_back('C');
+    framed.append(std::to_string(payload.size()));
+    framed.push_back(':');
+    // Escape the compressed bytes with the gdb-remote binary escaping so
+    // that they can't be mistaken for the end of the packet.
+    for (uint8_t byte : compressed) {
+      if (byte == '#' || byte == '$' || byte == '}' || byte == '*') {
+        framed.push_back('}');
+        framed.push_back(byte ^ 0x20);
+      } else {
+        framed.push_back(byte);
+      }
+    }
+    return;
+  }
+  framed.reserve(payload.size() + 1);
+  framed.push_back('N');
+  framed.append(payload.data(), payload.size());
+}
+
+void GDBRemoteCommunication::GetCompressionStatistics(
+    uint64_t &num_packets, uint64_t &compressed_bytes,
+    uint64_t &decompressed_bytes) const {
+  num_packets = m_num_compressed_packets_received;
+  compressed_bytes = m_compressed_bytes_received;
+  decompressed_bytes = m_decompressed_bytes_received;
+}
+
 GDBRemoteCommunication::PacketType
 GDBRemoteCommunication::CheckForPacket(const uint8_t *src, size_t src_len,
                                        StringExtractorGDBRemote &packet) {
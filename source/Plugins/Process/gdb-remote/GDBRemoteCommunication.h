@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -27,6 +28,7 @@
 #include "lldb/Interpreter/Args.h"
 #include "lldb/lldb-public.h"
 
+#include "GDBRemoteCompression.h"
 #include "Utility/StringExtractorGDBRemote.h"
 
 namespace lldb_private {
@@ -41,16 +43,6 @@ typedef enum {
   eWatchpointReadWrite
 } GDBStoppointType;
 
-enum class CompressionType {
-  None = 0,    // no compression
-  ZlibDeflate, // zlib's deflate compression scheme, requires zlib or Apple's
-               // libcompression
-  LZFSE,       // an Apple compression scheme, requires Apple's libcompression
-  LZ4, // lz compression - called "lz4 raw" in libcompression terms, compat with
-       // https://code.google.com/p/lz4/
-  LZMA, // Lempel–Ziv–Markov chain algorithm
-};
-
 class ProcessGDBRemote;
 
 class GDBRemoteCommunication : public Communication {
@@ -141,6 +133,14 @@ public:
 
   void DumpHistory(Stream &strm);
 
+  //------------------------------------------------------------------
+  /// Get the number of compressed packets that were received and their
+  /// total size before and after decompression.
+  //------------------------------------------------------------------
+  void GetCompressionStatistics(uint64_t &num_packets,
+                                uint64_t &compressed_bytes,
+                                uint64_t &decompressed_bytes) const;
+
 protected:
   class History {
   public:
@@ -225,7 +225,15 @@ protected:
                       // false if this class represents a debug session for
                       // a single process
 
-  CompressionType m_compression_type;
+  CompressionType m_compression_type; // Compression of received packets
+  // Compression of sent packets, used by stubs once the client sent a
+  // QEnableCompression packet. Payloads smaller than
+  // m_send_compression_min_size are always sent uncompressed.
+  CompressionType m_send_compression_type;
+  size_t m_send_compression_min_size;
+  std::atomic<uint64_t> m_num_compressed_packets_received;
+  std::atomic<uint64_t> m_compressed_bytes_received;
+  std::atomic<uint64_t> m_decompressed_bytes_received;
 
   PacketResult SendPacketNoLock(llvm::StringRef payload);
 
@@ -255,6 +263,11 @@ protected:
   // on m_bytes.  The checksum was for the compressed packet.
   bool DecompressPacket();
 
+  // Frame payload for sending as either "N<payload>" or, if
+  // m_send_compression_type is set and compression pays off,
+  // "C<payload size>:<escaped compressed payload>".
+  void CompressPayload(llvm::StringRef payload, std::string &framed);
+
   Status StartListenThread(const char *hostname = "127.0.0.1",
                            uint16_t port = 0);
 
@@ -14,6 +14,7 @@
 #include <sys/stat.h>
 
 // C++ Includes
+#include <algorithm>
 #include <numeric>
 #include <sstream>
 
@@ -40,10 +41,6 @@
 
 #include "llvm/ADT/StringSwitch.h"
 
-#if defined(HAVE_LIBCOMPRESSION)
-#include <compression.h>
-#endif
-
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::process_gdb_remote;
@@ -78,6 +75,7 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_avoid_g_packets(eLazyBoolCalculate),
       m_supports_QSaveRegisterState(eLazyBoolCalculate),
       m_supports_qXfer_auxv_read(eLazyBoolCalculate),
+      m_supports_multi_mem_read(eLazyBoolCalculate),
       m_supports_qXfer_libraries_read(eLazyBoolCalculate),
       m_supports_qXfer_libraries_svr4_read(eLazyBoolCalculate),
       m_supports_qXfer_features_read(eLazyBoolCalculate),
@@ -95,6 +93,7 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_supports_QEnvironmentHexEncoded(true), m_supports_qSymbol(true),
       m_qSymbol_requests_done(false), m_supports_qModuleInfo(true),
       m_supports_jThreadsInfo(true), m_supports_jModulesInfo(true),
+      m_packet_compression_enabled(false),
       m_curr_pid(LLDB_INVALID_PROCESS_ID), m_curr_tid(LLDB_INVALID_THREAD_ID),
       m_curr_tid_run(LLDB_INVALID_THREAD_ID),
       m_num_supported_hardware_watchpoints(0), m_host_arch(), m_process_arch(),
@@ -185,6 +184,13 @@ bool GDBRemoteCommunicationClient::GetQXferAuxvReadSupported() {
   return m_supports_qXfer_auxv_read == eLazyBoolYes;
 }
 
+bool GDBRemoteCommunicationClient::GetMultiMemReadSupported() {
+  if (m_supports_multi_mem_read == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_multi_mem_read == eLazyBoolYes;
+}
+
 bool GDBRemoteCommunicationClient::GetQXferFeaturesReadSupported() {
   if (m_supports_qXfer_features_read == eLazyBoolCalculate) {
     GetRemoteQSupported();
@@ -293,6 +299,7 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
     m_attach_or_wait_reply = eLazyBoolCalculate;
     m_avoid_g_packets = eLazyBoolCalculate;
     m_supports_qXfer_auxv_read = eLazyBoolCalculate;
+    m_supports_multi_mem_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
     m_supports_qXfer_features_read = eLazyBoolCalculate;
@@ -338,6 +345,7 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
 void GDBRemoteCommunicationClient::GetRemoteQSupported() {
   // Clear out any capabilities we expect to see in the qSupported response
   m_supports_qXfer_auxv_read = eLazyBoolNo;
+  m_supports_multi_mem_read = eLazyBoolNo;
   m_supports_qXfer_libraries_read = eLazyBoolNo;
   m_supports_qXfer_libraries_svr4_read = eLazyBoolNo;
   m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
@@ -377,47 +385,46 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
       m_supports_qXfer_libraries_read = eLazyBoolYes;
     if (::strstr(response_cstr, "qXfer:features:read+"))
       m_supports_qXfer_features_read = eLazyBoolYes;
+    if (::strstr(response_cstr, "MultiMemRead+"))
+      m_supports_multi_mem_read = eLazyBoolYes;
 
     // Look for a list of compressions in the features list e.g.
     // qXfer:features:read+;PacketSize=20000;qEcho+;SupportedCompressions=zlib-deflate,lzma
-    const char *features_list = ::strstr(response_cstr, "qXfer:features:");
-    if (features_list) {
-      const char *compressions =
-          ::strstr(features_list, "SupportedCompressions=");
-      if (compressions) {
-        std::vector<std::string> supported_compressions;
-        compressions += sizeof("SupportedCompressions=") - 1;
-        const char *end_of_compressions = strchr(compressions, ';');
-        if (end_of_compressions == NULL) {
-          end_of_compressions = strchr(compressions, '\0');
+    const char *compressions =
+        ::strstr(response_cstr, "SupportedCompressions=");
+    if (compressions) {
+      std::vector<std::string> supported_compressions;
+      compressions += sizeof("SupportedCompressions=") - 1;
+      const char *end_of_compressions = strchr(compressions, ';');
+      if (end_of_compressions == NULL) {
+        end_of_compressions = strchr(compressions, '\0');
+      }
+      const char *current_compression = compressions;
+      while (current_compression < end_of_compressions) {
+        const char *next_compression_name = strchr(current_compression, ',');
+        const char *end_of_this_word = next_compression_name;
+        if (next_compression_name == NULL ||
+            end_of_compressions < next_compression_name) {
+          end_of_this_word = end_of_compressions;
         }
-        const char *current_compression = compressions;
-        while (current_compression < end_of_compressions) {
-          const char *next_compression_name = strchr(current_compression, ',');
-          const char *end_of_this_word = next_compression_name;
-          if (next_compression_name == NULL ||
-              end_of_compressions < next_compression_name) {
-            end_of_this_word = end_of_compressions;
-          }
 
-          if (end_of_this_word) {
-            if (end_of_this_word == current_compression) {
-              current_compression++;
-            } else {
-              std::string this_compression(
-                  current_compression, end_of_this_word - current_compression);
-              supported_compressions.push_back(this_compression);
-              current_compression = end_of_this_word + 1;
-            }
+        if (end_of_this_word) {
+          if (end_of_this_word == current_compression) {
+            current_compression++;
           } else {
-            supported_compressions.push_back(current_compression);
-            current_compression = end_of_compressions;
+            std::string this_compression(
+                current_compression, end_of_this_word - current_compression);
+            supported_compressions.push_back(this_compression);
+            current_compression = end_of_this_word + 1;
           }
+        } else {
+          supported_compressions.push_back(current_compression);
+          current_compression = end_of_compressions;
         }
+      }
 
-        if (supported_compressions.size() > 0) {
-          MaybeEnableCompression(supported_compressions);
-        }
+      if (m_packet_compression_enabled && supported_compressions.size() > 0) {
+        MaybeEnableCompression(supported_compressions);
       }
     }
 
@@ -1018,68 +1025,25 @@ bool GDBRemoteCommunicationClient::GetGDBServerVersion() {
 
 void GDBRemoteCommunicationClient::MaybeEnableCompression(
     std::vector<std::string> supported_compressions) {
+  // The compression types we can use, from most to least preferred. lz4 is
+  // always available, the others depend on zlib or Apple's libcompression.
+  static const CompressionType g_preferred_types[] = {
+      CompressionType::LZFSE, CompressionType::ZlibDeflate,
+      CompressionType::LZ4, CompressionType::LZMA};
+
   CompressionType avail_type = CompressionType::None;
   std::string avail_name;
-
-#if defined(HAVE_LIBCOMPRESSION)
-  if (avail_type == CompressionType::None) {
-    for (auto compression : supported_compressions) {
-      if (compression == "lzfse") {
-        avail_type = CompressionType::LZFSE;
-        avail_name = compression;
-        break;
-      }
-    }
-  }
-#endif
-
-#if defined(HAVE_LIBCOMPRESSION)
-  if (avail_type == CompressionType::None) {
-    for (auto compression : supported_compressions) {
-      if (compression == "zlib-deflate") {
-        avail_type = CompressionType::ZlibDeflate;
-        avail_name = compression;
-        break;
-      }
-    }
-  }
-#endif
-
-#if defined(HAVE_LIBZ)
-  if (avail_type == CompressionType::None) {
-    for (auto compression : supported_compressions) {
-      if (compression == "zlib-deflate") {
-        avail_type = CompressionType::ZlibDeflate;
-        avail_name = compression;
-        break;
-      }
-    }
-  }
-#endif
-
-#if defined(HAVE_LIBCOMPRESSION)
-  if (avail_type == CompressionType::None) {
-    for (auto compression : supported_compressions) {
-      if (compression == "lz4") {
-        avail_type = CompressionType::LZ4;
-        avail_name = compression;
-        break;
-      }
-    }
-  }
-#endif
-
-#if defined(HAVE_LIBCOMPRESSION)
-  if (avail_type == CompressionType::None) {
-    for (auto compression : supported_compressions) {
-      if (compression == "lzma") {
-        avail_type = CompressionType::LZMA;
-        avail_name = compression;
-        break;
-      }
+  for (CompressionType type : g_preferred_types) {
+    if (!CompressionTypeIsSupported(type))
+      continue;
+    const std::string name = GetCompressionName(type);
+    if (std::find(supported_compressions.begin(), supported_compressions.end(),
+                  name) != supported_compressions.end()) {
+      avail_type = type;
+      avail_name = name;
+      break;
     }
   }
-#endif
 
   if (avail_type != CompressionType::None) {
     StringExtractorGDBRemote response;
@@ -3068,6 +3032,63 @@ DataBufferSP GDBRemoteCommunicationClient::ReadAllRegisters(lldb::tid_t tid) {
   return buffer_sp;
 }
 
+std::vector<DataBufferSP> GDBRemoteCommunicationClient::ReadRegisters(
+    llvm::ArrayRef<std::pair<lldb::tid_t, uint32_t>> regs) {
+  std::vector<lldb::tid_t> tids;
+  std::vector<std::string> payloads;
+  for (const std::pair<lldb::tid_t, uint32_t> &reg : regs) {
+    StreamString payload;
+    payload.Printf("p%x", reg.second);
+    tids.push_back(reg.first);
+    payloads.push_back(payload.GetString());
+  }
+  return SendThreadSpecificPacketsAndReadData(tids, payloads);
+}
+
+std::vector<DataBufferSP>
+GDBRemoteCommunicationClient::ReadAllRegisters(llvm::ArrayRef<lldb::tid_t> tids) {
+  std::vector<std::string> payloads(tids.size(), "g");
+  return SendThreadSpecificPacketsAndReadData(tids, payloads);
+}
+
+std::vector<DataBufferSP>
+GDBRemoteCommunicationClient::SendThreadSpecificPacketsAndReadData(
+    llvm::ArrayRef<lldb::tid_t> tids, llvm::ArrayRef<std::string> payloads) {
+  std::vector<DataBufferSP> buffers(payloads.size());
+  std::vector<StringExtractorGDBRemote> responses(payloads.size());
+  if (GetThreadSuffixSupported()) {
+    std::vector<std::string> suffixed_payloads;
+    suffixed_payloads.reserve(payloads.size());
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      StreamString payload;
+      payload.Printf("%s;thread:%4.4" PRIx64 ";", payloads[i].c_str(),
+                     tids[i]);
+      suffixed_payloads.push_back(payload.GetString());
+    }
+    if (SendPacketsAndWaitForResponses(suffixed_payloads, responses, false) !=
+        PacketResult::Success)
+      return buffers;
+  } else {
+    // Without thread suffixes each packet has to be preceded by a packet
+    // that selects the thread, so there is nothing to pipeline.
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      StreamString payload;
+      payload.PutCString(payloads[i]);
+      SendThreadSpecificPacketAndWaitForResponse(tids[i], std::move(payload),
+                                                 responses[i], false);
+    }
+  }
+
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    StringExtractorGDBRemote &response = responses[i];
+    if (!response.IsNormalResponse())
+      continue;
+    buffers[i].reset(new DataBufferHeap(response.GetStringRef().size() / 2, 0));
+    response.GetHexBytes(buffers[i]->GetData(), '\xcc');
+  }
+  return buffers;
+}
+
 bool GDBRemoteCommunicationClient::WriteRegister(lldb::tid_t tid,
                                                  uint32_t reg_num,
                                                  llvm::ArrayRef<uint8_t> data) {
@@ -3521,6 +3542,64 @@ GDBRemoteCommunicationClient::GetModulesInfo(
   return result;
 }
 
+std::vector<size_t> GDBRemoteCommunicationClient::MultiMemRead(
+    llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+    llvm::MutableArrayRef<uint8_t> buffer, Status &error) {
+  std::vector<size_t> bytes_read(ranges.size(), 0);
+
+  // MultiMemRead:ranges:<addr>,<size>[,<addr>,<size>]...;
+  StreamString packet;
+  packet.PutCString("MultiMemRead:ranges:");
+  for (size_t i = 0; i < ranges.size(); ++i)
+    packet.Printf("%s%" PRIx64 ",%" PRIx64, i == 0 ? "" : ",",
+                  (uint64_t)ranges[i].GetRangeBase(),
+                  (uint64_t)ranges[i].GetByteSize());
+  packet.PutChar(';');
+
+  StringExtractorGDBRemote response;
+  if (SendPacketAndWaitForResponse(packet.GetString(), response, true) !=
+      PacketResult::Success) {
+    error.SetErrorString("failed to send MultiMemRead packet");
+    return bytes_read;
+  }
+  if (response.IsUnsupportedResponse()) {
+    m_supports_multi_mem_read = eLazyBoolNo;
+    error.SetErrorString("MultiMemRead packet isn't supported");
+    return bytes_read;
+  }
+  if (response.IsErrorResponse()) {
+    error = response.GetStatus();
+    return bytes_read;
+  }
+
+  // The response is the number of bytes read for each range followed by
+  // the binary data of all ranges: <size>[,<size>]...;<data>
+  size_t total_size = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (i > 0 && response.GetChar() != ',')
+      break;
+    const uint64_t size = response.GetHexMaxU64(false, UINT64_MAX);
+    if (size > ranges[i].GetByteSize())
+      break;
+    bytes_read[i] = size;
+    total_size += size;
+  }
+  if (response.GetChar() != ';' || response.GetBytesLeft() != total_size) {
+    error.SetErrorString("invalid MultiMemRead response");
+    return std::vector<size_t>(ranges.size(), 0);
+  }
+
+  const char *data = response.Peek();
+  size_t offset = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (bytes_read[i] > 0)
+      memcpy(buffer.data() + offset, data, bytes_read[i]);
+    data += bytes_read[i];
+    offset += ranges[i].GetByteSize();
+  }
+  return bytes_read;
+}
+
 // query the target remote for extended information using the qXfer packet
 //
 // example: object='features', annex='target.xml', out=<xml output>
@@ -3531,62 +3610,79 @@ bool GDBRemoteCommunicationClient::ReadExtFeature(
     const lldb_private::ConstString annex, std::string &out,
     lldb_private::Status &err) {
 
-  std::stringstream output;
-  StringExtractorGDBRemote chunk;
+  std::string output;
+  std::vector<std::string> packets;
+  std::vector<StringExtractorGDBRemote> chunks;
 
   uint64_t size = GetRemoteMaxPacketSize();
   if (size == 0)
     size = 0x1000;
   size = size - 1; // Leave space for the 'm' or 'l' character in the response
-  int offset = 0;
+  uint64_t offset = 0;
+  size_t num_chunks = 1;
   bool active = true;
 
   // loop until all data has been read
   while (active) {
 
-    // send query extended feature packet
-    std::stringstream packet;
-    packet << "qXfer:" << object.AsCString("")
-           << ":read:" << annex.AsCString("") << ":" << std::hex << offset
-           << "," << std::hex << size;
+    // Ask for the next few chunks at once, assuming every chunk but the
+    // last one comes back full. Documents that fit into a single chunk
+    // still take a single packet and larger ones double the number of
+    // chunks requested per round trip.
+    packets.clear();
+    for (size_t i = 0; i < num_chunks; ++i) {
+      std::stringstream packet;
+      packet << "qXfer:" << object.AsCString("")
+             << ":read:" << annex.AsCString("") << ":" << std::hex
+             << offset + i * size << "," << std::hex << size;
+      packets.push_back(packet.str());
+    }
+    num_chunks = std::min<size_t>(num_chunks * 2, 16);
 
     GDBRemoteCommunication::PacketResult res =
-        SendPacketAndWaitForResponse(packet.str(), chunk, false);
+        SendPacketsAndWaitForResponses(packets, chunks, false);
 
     if (res != GDBRemoteCommunication::PacketResult::Success) {
       err.SetErrorString("Error sending $qXfer packet");
       return false;
     }
 
-    const std::string &str = chunk.GetStringRef();
-    if (str.length() == 0) {
-      // should have some data in chunk
-      err.SetErrorString("Empty response from $qXfer packet");
-      return false;
-    }
+    for (const StringExtractorGDBRemote &chunk : chunks) {
+      const std::string &str = chunk.GetStringRef();
+      if (str.length() == 0) {
+        // should have some data in chunk
+        err.SetErrorString("Empty response from $qXfer packet");
+        return false;
+      }
 
-    // check packet code
-    switch (str[0]) {
-    // last chunk
-    case ('l'):
-      active = false;
-      LLVM_FALLTHROUGH;
+      // check packet code
+      switch (str[0]) {
+      // last chunk
+      case ('l'):
+        active = false;
+        LLVM_FALLTHROUGH;
+
+      // more chunks
+      case ('m'):
+        output.append(str, 1, std::string::npos);
+        offset += str.length() - 1;
+        break;
 
-    // more chunks
-    case ('m'):
-      if (str.length() > 1)
-        output << &str[1];
-      offset += size;
-      break;
+      // unknown chunk
+      default:
+        err.SetErrorString("Invalid continuation code from $qXfer packet");
+        return false;
+      }
 
-    // unknown chunk
-    default:
-      err.SetErrorString("Invalid continuation code from $qXfer packet");
-      return false;
+      // The chunks after a short one were requested at the wrong offsets
+      // (or past the end of the data), drop them and continue from where
+      // the data ended.
+      if (!active || str.length() - 1 != size)
+        break;
     }
   }
 
-  out = output.str();
+  out = std::move(output);
   err.Success();
   return true;
 }
@@ -75,6 +75,16 @@ public:
 
   void GetListThreadsInStopReplySupported();
 
+  //------------------------------------------------------------------
+  /// Ask the remote stub to compress its replies if it offers a
+  /// compression type we support. Compression only pays off on slow
+  /// links, so it is off unless this is called before the qSupported
+  /// packet is sent.
+  //------------------------------------------------------------------
+  void SetPacketCompressionEnabled(bool enabled) {
+    m_packet_compression_enabled = enabled;
+  }
+
   lldb::pid_t GetCurrentProcessID(bool allow_lazy = true);
 
   bool GetLaunchSuccess(std::string &error_str);
@@ -338,6 +348,8 @@ public:
 
   bool GetQXferAuxvReadSupported();
 
+  bool GetMultiMemReadSupported();
+
   void EnableErrorStringInPacket();
 
   bool GetQXferLibrariesReadSupported();
@@ -413,6 +425,27 @@ public:
 
   lldb::DataBufferSP ReadAllRegisters(lldb::tid_t tid);
 
+  //------------------------------------------------------------------
+  /// Read several registers, possibly of different threads, with one
+  /// batch of pipelined 'p' packets.
+  ///
+  /// @param[in] regs
+  ///     Pairs of thread ID and remote register number.
+  ///
+  /// @return
+  ///     One buffer per entry in \a regs. The buffer is empty for
+  ///     registers that couldn't be read.
+  //------------------------------------------------------------------
+  std::vector<lldb::DataBufferSP>
+  ReadRegisters(llvm::ArrayRef<std::pair<lldb::tid_t, uint32_t>> regs);
+
+  //------------------------------------------------------------------
+  /// Read all registers of several threads with one batch of pipelined
+  /// 'g' packets.
+  //------------------------------------------------------------------
+  std::vector<lldb::DataBufferSP>
+  ReadAllRegisters(llvm::ArrayRef<lldb::tid_t> tids);
+
   bool
   WriteRegister(lldb::tid_t tid,
                 uint32_t reg_num, // eRegisterKindProcessPlugin register number
@@ -447,6 +480,20 @@ public:
   GetModulesInfo(llvm::ArrayRef<FileSpec> module_file_specs,
                  const llvm::Triple &triple);
 
+  //------------------------------------------------------------------
+  /// Read several ranges of memory with a single MultiMemRead packet.
+  ///
+  /// The caller is responsible for keeping the total size of the
+  /// ranges below what fits into a single packet.
+  ///
+  /// @return
+  ///     The number of bytes read for each range. The bytes of each
+  ///     range are stored in \a buffer, back to back.
+  //------------------------------------------------------------------
+  std::vector<size_t>
+  MultiMemRead(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+               llvm::MutableArrayRef<uint8_t> buffer, Status &error);
+
   bool ReadExtFeature(const lldb_private::ConstString object,
                       const lldb_private::ConstString annex, std::string &out,
                       lldb_private::Status &err);
@@ -541,6 +588,7 @@ protected:
   LazyBool m_avoid_g_packets;
   LazyBool m_supports_QSaveRegisterState;
   LazyBool m_supports_qXfer_auxv_read;
+  LazyBool m_supports_multi_mem_read;
   LazyBool m_supports_qXfer_libraries_read;
   LazyBool m_supports_qXfer_libraries_svr4_read;
   LazyBool m_supports_qXfer_features_read;
@@ -558,7 +606,7 @@ protected:
       m_supports_QEnvironment : 1, m_supports_QEnvironmentHexEncoded : 1,
       m_supports_qSymbol : 1, m_qSymbol_requests_done : 1,
       m_supports_qModuleInfo : 1, m_supports_jThreadsInfo : 1,
-      m_supports_jModulesInfo : 1;
+      m_supports_jModulesInfo : 1, m_packet_compression_enabled : 1;
 
   lldb::pid_t m_curr_pid;
   lldb::tid_t m_curr_tid; // Current gdb remote protocol thread index for all
@@ -604,6 +652,12 @@ protected:
       lldb::tid_t tid, StreamString &&payload,
       StringExtractorGDBRemote &response, bool send_async);
 
+  // Send payloads[i] to thread tids[i] for every i and decode the hex
+  // data in the normal responses.
+  std::vector<lldb::DataBufferSP>
+  SendThreadSpecificPacketsAndReadData(llvm::ArrayRef<lldb::tid_t> tids,
+                                       llvm::ArrayRef<std::string> payloads);
+
   Status SendGetTraceDataPacket(StreamGDBRemote &packet, lldb::user_id_t uid,
                                 lldb::tid_t thread_id,
                                 llvm::MutableArrayRef<uint8_t> &buffer,
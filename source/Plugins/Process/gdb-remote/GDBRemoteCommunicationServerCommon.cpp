@@ -60,6 +60,10 @@ const static uint32_t g_default_packet_timeout_sec = 20; // seconds
 const static uint32_t g_default_packet_timeout_sec = 0; // not specified
 #endif
 
+// Packets smaller than this are sent uncompressed unless the client asks
+// for a different "minsize" in QEnableCompression.
+const static size_t g_default_compression_min_size = 384;
+
 //----------------------------------------------------------------------
 // GDBRemoteCommunicationServerCommon constructor
 //----------------------------------------------------------------------
@@ -86,6 +90,9 @@ GDBRemoteCommunicationServerCommon::GDBRemoteCommunicationServerCommon(
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qHostInfo,
       &GDBRemoteCommunicationServerCommon::Handle_qHostInfo);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_QEnableCompression,
+      &GDBRemoteCommunicationServerCommon::Handle_QEnableCompression);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_QLaunchArch,
       &GDBRemoteCommunicationServerCommon::Handle_QLaunchArch);
@@ -838,14 +845,56 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported(
   response.PutCString(";QThreadSuffixSupported+");
   response.PutCString(";QListThreadsInStopReply+");
   response.PutCString(";qEcho+");
+
+  std::string compressions;
+  for (CompressionType type :
+       {CompressionType::LZ4, CompressionType::ZlibDeflate}) {
+    if (!CompressionTypeIsSupported(type))
+      continue;
+    if (!compressions.empty())
+      compressions += ',';
+    compressions += GetCompressionName(type);
+  }
+  if (!compressions.empty()) {
+    response.Printf(";SupportedCompressions=%s", compressions.c_str());
+    response.Printf(";DefaultCompressionMinSize=%" PRIu64,
+                    (uint64_t)g_default_compression_min_size);
+  }
 #if defined(__linux__) || defined(__NetBSD__)
   response.PutCString(";QPassSignals+");
   response.PutCString(";qXfer:auxv:read+");
+  response.PutCString(";MultiMemRead+");
 #endif
 
   return SendPacketNoLock(response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerCommon::Handle_QEnableCompression(
+    StringExtractorGDBRemote &packet) {
+  // QEnableCompression:type:<name>;[minsize:<size>;]
+  packet.SetFilePos(::strlen("QEnableCompression:"));
+  CompressionType type = CompressionType::None;
+  size_t min_size = g_default_compression_min_size;
+  llvm::StringRef key, value;
+  while (packet.GetNameColonValue(key, value)) {
+    if (key == "type")
+      type = GetCompressionTypeFromName(value);
+    else if (key == "minsize" && value.getAsInteger(10, min_size))
+      return SendIllFormedResponse(packet,
+                                   "Invalid minsize in QEnableCompression");
+  }
+
+  if (!CompressionTypeIsSupported(type))
+    return SendErrorResponse(0x16);
+
+  // The reply to this packet is the last one that is sent uncompressed.
+  PacketResult result = SendOKResponse();
+  m_send_compression_type = type;
+  m_send_compression_min_size = min_size;
+  return result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QThreadSuffixSupported(
     StringExtractorGDBRemote &packet) {
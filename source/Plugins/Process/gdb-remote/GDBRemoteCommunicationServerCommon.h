@@ -96,6 +96,8 @@ protected:
 
   PacketResult Handle_qSupported(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_QEnableCompression(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_QThreadSuffixSupported(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_QListThreadsInStopReply(StringExtractorGDBRemote &packet);
@@ -101,6 +101,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_M,
                                 &GDBRemoteCommunicationServerLLGS::Handle_M);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_MultiMemRead,
+      &GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_p,
                                 &GDBRemoteCommunicationServerLLGS::Handle_p);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_P,
@@ -2258,7 +2261,9 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(
   size_t bytes_read = 0;
   Status error = m_debugged_process_up->ReadMemoryWithoutTrap(
       read_addr, &buf[0], byte_count, bytes_read);
-  if (error.Fail()) {
+  // A read that runs into unreadable memory still returns the bytes before
+  // it, the error is only reported when nothing could be read.
+  if (error.Fail() && bytes_read == 0) {
     if (log)
       log->Printf("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64
                   " mem 0x%" PRIx64 ": failed to read. Error: %s",
@@ -2280,7 +2285,7 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(
   packet.SetFilePos(0);
   char kind = packet.GetChar('?');
   if (kind == 'x')
-    response.PutEscapedBytes(buf.data(), byte_count);
+    response.PutEscapedBytes(buf.data(), bytes_read);
   else {
     assert(kind == 'm');
     for (size_t i = 0; i < bytes_read; ++i)
@@ -2290,6 +2295,70 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(
   return SendPacketNoLock(response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead(
+    StringExtractorGDBRemote &packet) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    if (log)
+      log->Printf(
+          "GDBRemoteCommunicationServerLLGS::%s failed, no process available",
+          __FUNCTION__);
+    return SendErrorResponse(0x15);
+  }
+
+  // MultiMemRead:ranges:<addr>,<size>[,<addr>,<size>]...;
+  packet.SetFilePos(strlen("MultiMemRead:"));
+  if (!packet.ConsumeFront("ranges:"))
+    return SendIllFormedResponse(packet, "Missing ranges in MultiMemRead");
+
+  // Bound the response so it fits into the packet size we advertise.
+  const uint64_t max_total_size = 128 * 1024;
+  std::vector<Range<lldb::addr_t, size_t>> ranges;
+  uint64_t total_size = 0;
+  while (packet.GetBytesLeft() > 0 && packet.PeekChar() != ';') {
+    if (!ranges.empty() && packet.GetChar() != ',')
+      return SendIllFormedResponse(packet, "Comma sep missing in MultiMemRead");
+    const lldb::addr_t addr = packet.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+    if (packet.GetChar() != ',')
+      return SendIllFormedResponse(packet, "Comma sep missing in MultiMemRead");
+    const uint64_t size = packet.GetHexMaxU64(false, UINT64_MAX);
+    if (!packet.IsGood() || size > max_total_size - total_size)
+      return SendIllFormedResponse(packet, "Invalid range in MultiMemRead");
+    ranges.push_back(Range<lldb::addr_t, size_t>(addr, size));
+    total_size += size;
+  }
+  if (packet.GetChar() != ';')
+    return SendIllFormedResponse(packet, "Missing ; in MultiMemRead");
+
+  std::vector<uint8_t> buffer(total_size);
+  std::vector<size_t> bytes_read;
+  Status error = m_debugged_process_up->ReadMemoryRangesWithoutTrap(
+      ranges, buffer, bytes_read);
+  if (error.Fail()) {
+    if (log)
+      log->Printf("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64
+                  ": failed to read %" PRIu64 " ranges. Error: %s",
+                  __FUNCTION__, m_debugged_process_up->GetID(),
+                  (uint64_t)ranges.size(), error.AsCString());
+    return SendErrorResponse(0x08);
+  }
+
+  // <size>[,<size>]...;<binary data>
+  StreamGDBRemote response;
+  for (size_t i = 0; i < ranges.size(); ++i)
+    response.Printf("%s%" PRIx64, i == 0 ? "" : ",", (uint64_t)bytes_read[i]);
+  response.PutChar(';');
+  size_t offset = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    response.PutEscapedBytes(buffer.data() + offset, bytes_read[i]);
+    offset += ranges[i].GetByteSize();
+  }
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_M(StringExtractorGDBRemote &packet) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
@@ -0,0 +1,342 @@
+//===-- GDBRemoteCompression.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "GDBRemoteCompression.h"
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+#include "llvm/ADT/StringSwitch.h"
+
+// Project includes
+#include "lldb/Host/Config.h"
+
+#if defined(HAVE_LIBCOMPRESSION)
+#include <compression.h>
+#endif
+
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+//----------------------------------------------------------------------
+// A portable implementation of the LZ4 block format ("lz4 raw" in
+// libcompression terms) so that lz4 compression is available on every
+// host, not just the ones with libcompression.
+//
+// A block is a list of sequences. Each sequence starts with a token whose
+// high nibble is the number of literal bytes and whose low nibble is the
+// match length minus 4 (a nibble value of 15 means more length bytes
+// follow, each adding up to 255). The literals follow, then a 2 byte
+// little endian offset back into the output for the match. The last
+// sequence only has literals.
+//----------------------------------------------------------------------
+namespace {
+
+const size_t kLZ4MinMatch = 4;
+// The last match must start this many bytes before the end of the block
+// and the last kLZ4LastLiterals bytes are always literals.
+const size_t kLZ4MatchStartLimit = 12;
+const size_t kLZ4LastLiterals = 5;
+const size_t kLZ4MaxOffset = 65535;
+const unsigned kLZ4HashLog = 12;
+
+uint32_t ReadU32(const uint8_t *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint32_t LZ4Hash(uint32_t sequence) {
+  return (sequence * 2654435761U) >> (32 - kLZ4HashLog);
+}
+
+void LZ4PutLength(std::vector<uint8_t> &dst, size_t length) {
+  for (; length >= 255; length -= 255)
+    dst.push_back(255);
+  dst.push_back(length);
+}
+
+void LZ4PutSequence(std::vector<uint8_t> &dst, const uint8_t *literals,
+                    size_t num_literals, size_t offset, size_t match_length) {
+  const size_t literal_code = std::min<size_t>(num_literals, 15);
+  const size_t match_code =
+      match_length ? std::min<size_t>(match_length - kLZ4MinMatch, 15) : 0;
+  dst.push_back((literal_code << 4) | match_code);
+  if (literal_code == 15)
+    LZ4PutLength(dst, num_literals - 15);
+  dst.insert(dst.end(), literals, literals + num_literals);
+  if (match_length == 0)
+    return;
+  dst.push_back(offset & 0xff);
+  dst.push_back(offset >> 8);
+  if (match_code == 15)
+    LZ4PutLength(dst, match_length - kLZ4MinMatch - 15);
+}
+
+void LZ4Compress(llvm::ArrayRef<uint8_t> src, std::vector<uint8_t> &dst) {
+  const uint8_t *data = src.data();
+  const size_t size = src.size();
+  dst.clear();
+  dst.reserve(size + size / 255 + 16);
+
+  size_t anchor = 0;
+  if (size > kLZ4MatchStartLimit) {
+    std::vector<uint32_t> table(1u << kLZ4HashLog, UINT32_MAX);
+    const size_t match_start_limit = size - kLZ4MatchStartLimit;
+    const size_t match_end_limit = size - kLZ4LastLiterals;
+    size_t pos = 0;
+    while (pos < match_start_limit) {
+      const uint32_t sequence = ReadU32(data + pos);
+      uint32_t &entry = table[LZ4Hash(sequence)];
+      const size_t ref = entry;
+      entry = pos;
+      if (ref == UINT32_MAX || pos - ref > kLZ4MaxOffset ||
+          ReadU32(data + ref) != sequence) {
+        ++pos;
+        continue;
+      }
+
+      size_t match_length = kLZ4MinMatch;
+      while (pos + match_length < match_end_limit &&
+             data[ref + match_length] == data[pos + match_length])
+        ++match_length;
+      LZ4PutSequence(dst, data + anchor, pos - anchor, pos - ref,
+                     match_length);
+      pos += match_length;
+      anchor = pos;
+    }
+  }
+  LZ4PutSequence(dst, data + anchor, size - anchor, 0, 0);
+}
+
+bool LZ4GetLength(llvm::ArrayRef<uint8_t> src, size_t &pos, size_t &length) {
+  uint8_t byte;
+  do {
+    if (pos >= src.size())
+      return false;
+    byte = src[pos++];
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+size_t LZ4Decompress(llvm::ArrayRef<uint8_t> src,
+                     llvm::MutableArrayRef<uint8_t> dst) {
+  size_t src_pos = 0;
+  size_t dst_pos = 0;
+  while (src_pos < src.size()) {
+    const uint8_t token = src[src_pos++];
+
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !LZ4GetLength(src, src_pos, num_literals))
+      return 0;
+    if (num_literals > src.size() - src_pos ||
+        num_literals > dst.size() - dst_pos)
+      return 0;
+    memcpy(dst.data() + dst_pos, src.data() + src_pos, num_literals);
+    src_pos += num_literals;
+    dst_pos += num_literals;
+
+    // The last sequence has no match.
+    if (src_pos == src.size())
+      break;
+
+    if (src.size() - src_pos < 2)
+      return 0;
+    const size_t offset = src[src_pos] | (src[src_pos + 1] << 8);
+    src_pos += 2;
+    if (offset == 0 || offset > dst_pos)
+      return 0;
+
+    size_t match_length = token & 15;
+    if (match_length == 15 && !LZ4GetLength(src, src_pos, match_length))
+      return 0;
+    match_length += kLZ4MinMatch;
+    if (match_length > dst.size() - dst_pos)
+      return 0;
+    // The match may overlap the bytes it produces, so copy byte by byte.
+    const uint8_t *match = dst.data() + dst_pos - offset;
+    for (size_t i = 0; i < match_length; ++i)
+      dst[dst_pos + i] = match[i];
+    dst_pos += match_length;
+  }
+  return dst_pos;
+}
+
+#if defined(HAVE_LIBCOMPRESSION)
+bool GetLibCompressionAlgorithm(CompressionType type,
+                                compression_algorithm &algorithm) {
+  switch (type) {
+  case CompressionType::ZlibDeflate:
+    algorithm = COMPRESSION_ZLIB;
+    return true;
+  case CompressionType::LZFSE:
+    algorithm = COMPRESSION_LZFSE;
+    return true;
+  case CompressionType::LZ4:
+    algorithm = COMPRESSION_LZ4_RAW;
+    return true;
+  case CompressionType::LZMA:
+    algorithm = COMPRESSION_LZMA;
+    return true;
+  case CompressionType::None:
+    break;
+  }
+  return false;
+}
+#endif
+
+} // namespace
+
+llvm::StringRef
+lldb_private::process_gdb_remote::GetCompressionName(CompressionType type) {
+  switch (type) {
+  case CompressionType::ZlibDeflate:
+    return "zlib-deflate";
+  case CompressionType::LZFSE:
+    return "lzfse";
+  case CompressionType::LZ4:
+    return "lz4";
+  case CompressionType::LZMA:
+    return "lzma";
+  case CompressionType::None:
+    break;
+  }
+  return "none";
+}
+
+CompressionType lldb_private::process_gdb_remote::GetCompressionTypeFromName(
+    llvm::StringRef name) {
+  return llvm::StringSwitch<CompressionType>(name)
+      .Case("zlib-deflate", CompressionType::ZlibDeflate)
+      .Case("lzfse", CompressionType::LZFSE)
+      .Case("lz4", CompressionType::LZ4)
+      .Case("lzma", CompressionType::LZMA)
+      .Default(CompressionType::None);
+}
+
+bool lldb_private::process_gdb_remote::CompressionTypeIsSupported(
+    CompressionType type) {
+  switch (type) {
+  case CompressionType::LZ4:
+    return true;
+  case CompressionType::ZlibDeflate:
+#if defined(HAVE_LIBCOMPRESSION) || defined(HAVE_LIBZ)
+    return true;
+#else
+    return false;
+#endif
+  case CompressionType::LZFSE:
+  case CompressionType::LZMA:
+#if defined(HAVE_LIBCOMPRESSION)
+    return true;
+#else
+    return false;
+#endif
+  case CompressionType::None:
+    break;
+  }
+  return false;
+}
+
+bool lldb_private::process_gdb_remote::CompressBuffer(
+    CompressionType type, llvm::ArrayRef<uint8_t> src,
+    std::vector<uint8_t> &dst) {
+  if (type == CompressionType::LZ4) {
+    LZ4Compress(src, dst);
+    return true;
+  }
+
+#if defined(HAVE_LIBCOMPRESSION)
+  compression_algorithm algorithm;
+  if (GetLibCompressionAlgorithm(type, algorithm)) {
+    // Incompressible data can grow a little, leave some room for that.
+    dst.resize(src.size() + src.size() / 16 + 64);
+    const size_t compressed_size =
+        compression_encode_buffer(dst.data(), dst.size(), src.data(),
+                                  src.size(), NULL, algorithm);
+    dst.resize(compressed_size);
+    if (compressed_size > 0)
+      return true;
+  }
+#endif
+
+#if defined(HAVE_LIBZ)
+  if (type == CompressionType::ZlibDeflate) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    // A negative window size selects a raw deflate stream without the zlib
+    // header, which is what the decoder on the other side expects.
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+      return false;
+    dst.resize(deflateBound(&stream, src.size()));
+    stream.next_in = const_cast<Bytef *>(src.data());
+    stream.avail_in = (uInt)src.size();
+    stream.next_out = (Bytef *)dst.data();
+    stream.avail_out = (uInt)dst.size();
+    const int status = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (status != Z_STREAM_END)
+      return false;
+    dst.resize(stream.total_out);
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+size_t lldb_private::process_gdb_remote::DecompressBuffer(
+    CompressionType type, llvm::ArrayRef<uint8_t> src,
+    llvm::MutableArrayRef<uint8_t> dst) {
+#if defined(HAVE_LIBCOMPRESSION)
+  // libcompression is weak linked so check that compression_decode_buffer() is
+  // available
+  compression_algorithm algorithm;
+  if (compression_decode_buffer != NULL &&
+      GetLibCompressionAlgorithm(type, algorithm)) {
+    const size_t decompressed_size = compression_decode_buffer(
+        dst.data(), dst.size(), src.data(), src.size(), NULL, algorithm);
+    if (decompressed_size > 0)
+      return decompressed_size;
+  }
+#endif
+
+  if (type == CompressionType::LZ4)
+    return LZ4Decompress(src, dst);
+
+#if defined(HAVE_LIBZ)
+  if (type == CompressionType::ZlibDeflate) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(z_stream));
+    stream.next_in = const_cast<Bytef *>(src.data());
+    stream.avail_in = (uInt)src.size();
+    stream.next_out = (Bytef *)dst.data();
+    stream.avail_out = (uInt)dst.size();
+
+    if (inflateInit2(&stream, -15) == Z_OK) {
+      int status = inflate(&stream, Z_NO_FLUSH);
+      inflateEnd(&stream);
+      if (status == Z_STREAM_END)
+        return stream.total_out;
+    }
+  }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+//===-- GDBRemoteCompression.h ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_GDBRemoteCompression_h_
+#define liblldb_GDBRemoteCompression_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+
+// Project includes
+
+namespace lldb_private {
+namespace process_gdb_remote {
+
+enum class CompressionType {
+  None = 0,    // no compression
+  ZlibDeflate, // zlib's deflate compression scheme, requires zlib or Apple's
+               // libcompression
+  LZFSE,       // an Apple compression scheme, requires Apple's libcompression
+  LZ4, // lz compression - called "lz4 raw" in libcompression terms, compat with
+       // https://code.google.com/p/lz4/
+  LZMA, // Lempel–Ziv–Markov chain algorithm
+};
+
+//----------------------------------------------------------------------
+/// Get the name used for \a type in the qSupported
+/// "SupportedCompressions=" list and in QEnableCompression packets.
+//----------------------------------------------------------------------
+llvm::StringRef GetCompressionName(CompressionType type);
+
+CompressionType GetCompressionTypeFromName(llvm::StringRef name);
+
+//----------------------------------------------------------------------
+/// Whether this build can both compress and decompress \a type.
+//----------------------------------------------------------------------
+bool CompressionTypeIsSupported(CompressionType type);
+
+//----------------------------------------------------------------------
+/// Compress \a src into \a dst.
+///
+/// @return
+///     False if \a type isn't supported by this build or compressing
+///     failed.
+//----------------------------------------------------------------------
+bool CompressBuffer(CompressionType type, llvm::ArrayRef<uint8_t> src,
+                    std::vector<uint8_t> &dst);
+
+//----------------------------------------------------------------------
+/// Decompress \a src into \a dst.
+///
+/// @return
+///     The number of bytes written to \a dst, or zero if \a type isn't
+///     supported by this build or \a src is not valid compressed data
+///     that fits into \a dst.
+//----------------------------------------------------------------------
+size_t DecompressBuffer(CompressionType type, llvm::ArrayRef<uint8_t> src,
+                        llvm::MutableArrayRef<uint8_t> dst);
+
+} // namespace process_gdb_remote
+} // namespace lldb_private
+
+#endif // liblldb_GDBRemoteCompression_h_
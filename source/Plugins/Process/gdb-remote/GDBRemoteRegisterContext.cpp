@@ -126,6 +126,40 @@ bool GDBRemoteRegisterContext::PrivateSetRegisterValue(
   return success;
 }
 
+bool GDBRemoteRegisterContext::PrivateSetAllRegisterValues(
+    llvm::ArrayRef<uint8_t> data) {
+  // Invalidate if needed
+  InvalidateIfNeeded(false);
+
+  memcpy(const_cast<uint8_t *>(m_reg_data.GetDataStart()), data.data(),
+         std::min<size_t>(data.size(), m_reg_data.GetByteSize()));
+  if (data.size() < m_reg_data.GetByteSize())
+    return false;
+  SetAllRegisterValid(true);
+  return true;
+}
+
+void GDBRemoteRegisterContext::GetUnwindRegistersToFetch(
+    std::vector<const RegisterInfo *> &reg_infos) {
+  // Invalidate if needed
+  InvalidateIfNeeded(false);
+
+  static const uint32_t g_generic_regs[] = {
+      LLDB_REGNUM_GENERIC_PC, LLDB_REGNUM_GENERIC_SP, LLDB_REGNUM_GENERIC_FP,
+      LLDB_REGNUM_GENERIC_RA, LLDB_REGNUM_GENERIC_FLAGS};
+  for (uint32_t generic_reg : g_generic_regs) {
+    const uint32_t reg =
+        ConvertRegisterKindToRegisterNumber(eRegisterKindGeneric, generic_reg);
+    if (reg == LLDB_INVALID_REGNUM || GetRegisterIsValid(reg))
+      continue;
+    // Composite registers are read through their primordial registers.
+    const RegisterInfo *reg_info = GetRegisterInfoAtIndex(reg);
+    if (reg_info == NULL || reg_info->value_regs)
+      continue;
+    reg_infos.push_back(reg_info);
+  }
+}
+
 bool GDBRemoteRegisterContext::PrivateSetRegisterValue(uint32_t reg,
                                                        uint64_t new_reg_val) {
   const RegisterInfo *reg_info = GetRegisterInfoAtIndex(reg);
@@ -206,15 +240,9 @@ bool GDBRemoteRegisterContext::ReadRegisterBytes(const RegisterInfo *reg_info,
   if (!GetRegisterIsValid(reg)) {
     if (m_read_all_at_once) {
       if (DataBufferSP buffer_sp =
-              gdb_comm.ReadAllRegisters(m_thread.GetProtocolID())) {
-        memcpy(const_cast<uint8_t *>(m_reg_data.GetDataStart()),
-               buffer_sp->GetBytes(),
-               std::min(buffer_sp->GetByteSize(), m_reg_data.GetByteSize()));
-        if (buffer_sp->GetByteSize() >= m_reg_data.GetByteSize()) {
-          SetAllRegisterValid(true);
-          return true;
-        }
-      }
+              gdb_comm.ReadAllRegisters(m_thread.GetProtocolID()))
+        return PrivateSetAllRegisterValues(llvm::ArrayRef<uint8_t>(
+            buffer_sp->GetBytes(), buffer_sp->GetByteSize()));
       return false;
     }
     if (reg_info->value_regs) {
@@ -80,6 +80,7 @@ public:
 
 protected:
   friend class ThreadGDBRemote;
+  friend class ProcessGDBRemote;
 
   bool ReadRegisterBytes(const RegisterInfo *reg_info, DataExtractor &data);
 
@@ -90,6 +91,13 @@ protected:
 
   bool PrivateSetRegisterValue(uint32_t reg, uint64_t val);
 
+  // Store the response to a 'g' packet.
+  bool PrivateSetAllRegisterValues(llvm::ArrayRef<uint8_t> data);
+
+  // Add the registers unwinding starts from that haven't been read yet
+  // to reg_infos.
+  void GetUnwindRegistersToFetch(std::vector<const RegisterInfo *> &reg_infos);
+
   void SetAllRegisterValid(bool b);
 
   bool GetRegisterIsValid(uint32_t reg) const {
@@ -59,6 +59,7 @@
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/DynamicLoader.h"
+#include "lldb/Target/Statistics.h"
 #include "lldb/Target/SystemRuntime.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/TargetList.h"
@@ -112,9 +113,17 @@ static PropertyDefinition g_properties[] = {
      "Specify the default packet timeout in seconds."},
     {"target-definition-file", OptionValue::eTypeFileSpec, true, 0, NULL, NULL,
      "The file that provides the description for remote target registers."},
+    {"packet-compression", OptionValue::eTypeBoolean, true, false, NULL, NULL,
+     "Ask the remote stub to compress the packets it sends if it supports "
+     "compression. This helps on slow links, like USB or remote network "
+     "connections, and costs time on fast ones."},
     {NULL, OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL}};
 
-enum { ePropertyPacketTimeout, ePropertyTargetDefinitionFile };
+enum {
+  ePropertyPacketTimeout,
+  ePropertyTargetDefinitionFile,
+  ePropertyPacketCompression
+};
 
 class PluginProperties : public Properties {
 public:
@@ -144,6 +153,12 @@ public:
     const uint32_t idx = ePropertyTargetDefinitionFile;
     return m_collection_sp->GetPropertyAtIndexAsFileSpec(NULL, idx);
   }
+
+  bool GetPacketCompression() const {
+    const uint32_t idx = ePropertyPacketCompression;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        NULL, idx, g_properties[idx].default_uint_value != 0);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> ProcessKDPPropertiesSP;
@@ -195,6 +210,7 @@ const char *ProcessGDBRemote::GetPluginDescriptionStatic() {
 
 void ProcessGDBRemote::Terminate() {
   PluginManager::UnregisterPlugin(ProcessGDBRemote::CreateInstance);
+  TargetStats::UnregisterCallback(GetPluginNameStatic().GetStringRef());
 }
 
 lldb::ProcessSP
@@ -291,6 +307,9 @@ ProcessGDBRemote::ProcessGDBRemote(lldb::TargetSP target_sp,
       GetGlobalPluginProperties()->GetPacketTimeout();
   if (timeout_seconds > 0)
     m_gdb_comm.SetPacketTimeout(std::chrono::seconds(timeout_seconds));
+
+  m_gdb_comm.SetPacketCompressionEnabled(
+      GetGlobalPluginProperties()->GetPacketCompression());
 }
 
 //----------------------------------------------------------------------
@@ -1690,6 +1709,71 @@ bool ProcessGDBRemote::UpdateThreadList(ThreadList &old_thread_list,
   return true;
 }
 
+void ProcessGDBRemote::PrefetchThreadRegisters(
+    llvm::ArrayRef<ThreadSP> threads) {
+  // Threads whose registers are read with 'g' packets.
+  std::vector<lldb::tid_t> all_reg_tids;
+  std::vector<GDBRemoteRegisterContext *> all_reg_contexts;
+  // Registers that are read with 'p' packets.
+  std::vector<std::pair<lldb::tid_t, uint32_t>> remote_regs;
+  std::vector<std::pair<GDBRemoteRegisterContext *, uint32_t>> regs;
+
+  std::vector<const RegisterInfo *> reg_infos;
+  for (const ThreadSP &thread_sp : threads) {
+    if (!thread_sp)
+      continue;
+    // Threads from an OS plug-in are backed by the real threads.
+    ThreadSP real_thread_sp = m_thread_list_real.FindThreadByProtocolID(
+        thread_sp->GetProtocolID(), false);
+    if (!real_thread_sp)
+      continue;
+    GDBRemoteRegisterContext *reg_ctx = static_cast<GDBRemoteRegisterContext *>(
+        real_thread_sp->GetRegisterContext().get());
+    if (!reg_ctx)
+      continue;
+
+    reg_infos.clear();
+    reg_ctx->GetUnwindRegistersToFetch(reg_infos);
+    if (reg_infos.empty())
+      continue;
+    const lldb::tid_t tid = real_thread_sp->GetProtocolID();
+    if (reg_ctx->m_read_all_at_once) {
+      all_reg_tids.push_back(tid);
+      all_reg_contexts.push_back(reg_ctx);
+      continue;
+    }
+    for (const RegisterInfo *reg_info : reg_infos) {
+      remote_regs.emplace_back(tid, reg_info->kinds[eRegisterKindProcessPlugin]);
+      regs.emplace_back(reg_ctx, reg_info->kinds[eRegisterKindLLDB]);
+    }
+  }
+
+  Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_THREAD));
+  LLDB_LOG(log, "prefetching {0} registers and {1} register sets",
+           remote_regs.size(), all_reg_tids.size());
+
+  if (!all_reg_tids.empty()) {
+    std::vector<DataBufferSP> buffers =
+        m_gdb_comm.ReadAllRegisters(all_reg_tids);
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      if (buffers[i])
+        all_reg_contexts[i]->PrivateSetAllRegisterValues(
+            llvm::ArrayRef<uint8_t>(buffers[i]->GetBytes(),
+                                    buffers[i]->GetByteSize()));
+    }
+  }
+
+  if (!remote_regs.empty()) {
+    std::vector<DataBufferSP> buffers = m_gdb_comm.ReadRegisters(remote_regs);
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      if (buffers[i])
+        regs[i].first->PrivateSetRegisterValue(
+            regs[i].second, llvm::ArrayRef<uint8_t>(buffers[i]->GetBytes(),
+                                                    buffers[i]->GetByteSize()));
+    }
+  }
+}
+
 void ProcessGDBRemote::SetThreadPc(const ThreadSP &thread_sp, uint64_t index) {
   if (m_thread_ids.size() == m_thread_pcs.size() && thread_sp.get() &&
       GetByteOrder() != eByteOrderInvalid) {
@@ -2806,6 +2890,80 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   return 0;
 }
 
+std::vector<size_t> ProcessGDBRemote::DoReadMemoryRanges(
+    llvm::ArrayRef<Range<addr_t, size_t>> ranges,
+    llvm::MutableArrayRef<uint8_t> buffer, Status &error) {
+  if (!m_gdb_comm.GetMultiMemReadSupported())
+    return Process::DoReadMemoryRanges(ranges, buffer, error);
+
+  GetMaxMemorySize();
+  // Each range adds at most "<addr>,<size>," to the request packet and
+  // "<size>," to the response packet.
+  const size_t max_range_request_size = 16 + 1 + 16 + 1;
+  const size_t max_range_response_size = 16 + 1;
+
+  std::vector<size_t> bytes_read;
+  bytes_read.reserve(ranges.size());
+  size_t offset = 0;
+  size_t idx = 0;
+  while (idx < ranges.size()) {
+    // Send as many ranges as fit into a single packet.
+    size_t batch_end = idx;
+    size_t request_size = 0;
+    size_t response_size = 0;
+    size_t batch_size = 0;
+    while (batch_end < ranges.size()) {
+      const size_t size = ranges[batch_end].GetByteSize();
+      if (request_size + max_range_request_size > m_max_memory_size ||
+          response_size + max_range_response_size + size > m_max_memory_size)
+        break;
+      request_size += max_range_request_size;
+      response_size += max_range_response_size + size;
+      batch_size += size;
+      ++batch_end;
+    }
+
+    if (batch_end == idx) {
+      // The range doesn't fit into one packet on its own. DoReadMemory
+      // will split it up.
+      std::vector<size_t> range_bytes_read = Process::DoReadMemoryRanges(
+          ranges.slice(idx, 1), buffer.slice(offset), error);
+      bytes_read.push_back(range_bytes_read[0]);
+      offset += ranges[idx].GetByteSize();
+      ++idx;
+      continue;
+    }
+
+    Status batch_error;
+    std::vector<size_t> batch_bytes_read = m_gdb_comm.MultiMemRead(
+        ranges.slice(idx, batch_end - idx), buffer.slice(offset, batch_size),
+        batch_error);
+    if (batch_error.Fail() && !m_gdb_comm.GetMultiMemReadSupported()) {
+      // The stub rejected the packet, read the rest one range at a time.
+      std::vector<size_t> rest = Process::DoReadMemoryRanges(
+          ranges.slice(idx), buffer.slice(offset), error);
+      bytes_read.insert(bytes_read.end(), rest.begin(), rest.end());
+      return bytes_read;
+    }
+
+    for (size_t i = idx; i < batch_end; ++i) {
+      const size_t range_bytes_read = batch_bytes_read[i - idx];
+      if (range_bytes_read < ranges[i].GetByteSize() && error.Success()) {
+        if (batch_error.Fail())
+          error = batch_error;
+        else
+          error.SetErrorStringWithFormat(
+              "memory read failed for 0x%" PRIx64,
+              (uint64_t)(ranges[i].GetRangeBase() + range_bytes_read));
+      }
+      bytes_read.push_back(range_bytes_read);
+    }
+    offset += batch_size;
+    idx = batch_end;
+  }
+  return bytes_read;
+}
+
 size_t ProcessGDBRemote::DoWriteMemory(addr_t addr, const void *buf,
                                        size_t size, Status &error) {
   GetMaxMemorySize();
@@ -3446,6 +3604,49 @@ void ProcessGDBRemote::KillDebugserverProcess() {
   }
 }
 
+//----------------------------------------------------------------------
+// Adds the packet statistics of the target's process to the output of
+// "statistics dump" if it is a gdb-remote process.
+//----------------------------------------------------------------------
+static void ReportGDBRemoteStatistics(Target &target,
+                                      StructuredData::Dictionary &stats) {
+  ProcessSP process_sp = target.GetProcessSP();
+  if (!process_sp ||
+      process_sp->GetPluginName() != ProcessGDBRemote::GetPluginNameStatic())
+    return;
+  GDBRemoteCommunicationClient &gdb_comm =
+      static_cast<ProcessGDBRemote *>(process_sp.get())->GetGDBRemote();
+
+  auto packets_sp = std::make_shared<StructuredData::Dictionary>();
+  for (const auto &entry : gdb_comm.GetPacketStatistics()) {
+    const GDBRemoteClientBase::PacketStatistics &packet_stats = entry.second;
+    auto packet_sp = std::make_shared<StructuredData::Dictionary>();
+    packet_sp->AddIntegerItem("count", packet_stats.num_packets);
+    packet_sp->AddIntegerItem("bytesSent", packet_stats.bytes_sent);
+    packet_sp->AddIntegerItem("bytesReceived", packet_stats.bytes_received);
+    packet_sp->AddFloatItem(
+        "totalTime",
+        std::chrono::duration<double>(packet_stats.total_time).count());
+    packet_sp->AddFloatItem(
+        "maxTime", std::chrono::duration<double>(packet_stats.max_time).count());
+    auto histogram_sp = std::make_shared<StructuredData::Array>();
+    for (uint64_t count : packet_stats.latency_buckets)
+      histogram_sp->AddItem(std::make_shared<StructuredData::Integer>(count));
+    packet_sp->AddItem("latencyHistogram", histogram_sp);
+    packets_sp->AddItem(entry.first, packet_sp);
+  }
+  stats.AddItem("packets", packets_sp);
+
+  uint64_t num_compressed = 0;
+  uint64_t compressed_bytes = 0;
+  uint64_t decompressed_bytes = 0;
+  gdb_comm.GetCompressionStatistics(num_compressed, compressed_bytes,
+                                    decompressed_bytes);
+  stats.AddIntegerItem("compressedPackets", num_compressed);
+  stats.AddIntegerItem("compressedBytes", compressed_bytes);
+  stats.AddIntegerItem("decompressedBytes", decompressed_bytes);
+}
+
 void ProcessGDBRemote::Initialize() {
   static std::once_flag g_once_flag;
 
@@ -3453,6 +3654,8 @@ void ProcessGDBRemote::Initialize() {
     PluginManager::RegisterPlugin(GetPluginNameStatic(),
                                   GetPluginDescriptionStatic(), CreateInstance,
                                   DebuggerInitialize);
+    TargetStats::RegisterCallback(GetPluginNameStatic().GetStringRef(),
+                                  ReportGDBRemoteStatistics);
   });
 }
 
@@ -5040,6 +5243,68 @@ public:
   }
 };
 
+class CommandObjectProcessGDBRemotePacketStatistics
+    : public CommandObjectParsed {
+private:
+public:
+  CommandObjectProcessGDBRemotePacketStatistics(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "process plugin packet statistics",
+                            "Dumps the number of packets of each type that "
+                            "were sent, their sizes and response times.",
+                            NULL) {}
+
+  ~CommandObjectProcessGDBRemotePacketStatistics() {}
+
+  bool DoExecute(Args &command, CommandReturnObject &result) override {
+    const size_t argc = command.GetArgumentCount();
+    if (argc != 0) {
+      result.AppendErrorWithFormat("'%s' takes no arguments",
+                                   m_cmd_name.c_str());
+      result.SetStatus(eReturnStatusFailed);
+      return false;
+    }
+
+    ProcessGDBRemote *process =
+        (ProcessGDBRemote *)m_interpreter.GetExecutionContext().GetProcessPtr();
+    if (!process) {
+      result.SetStatus(eReturnStatusFailed);
+      return false;
+    }
+
+    GDBRemoteCommunicationClient &gdb_comm = process->GetGDBRemote();
+    Stream &strm = result.GetOutputStream();
+    strm.Printf("%-24s %10s %14s %14s %12s %12s\n", "packet", "count",
+                "bytes sent", "bytes recv", "avg usec", "max usec");
+    for (const auto &entry : gdb_comm.GetPacketStatistics()) {
+      const GDBRemoteClientBase::PacketStatistics &stats = entry.second;
+      const uint64_t total_usec =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              stats.total_time)
+              .count();
+      const uint64_t max_usec =
+          std::chrono::duration_cast<std::chrono::microseconds>(stats.max_time)
+              .count();
+      strm.Printf("%-24s %10" PRIu64 " %14" PRIu64 " %14" PRIu64 " %12" PRIu64
+                  " %12" PRIu64 "\n",
+                  entry.first.c_str(), stats.num_packets, stats.bytes_sent,
+                  stats.bytes_received, total_usec / stats.num_packets,
+                  max_usec);
+    }
+
+    uint64_t num_compressed = 0;
+    uint64_t compressed_bytes = 0;
+    uint64_t decompressed_bytes = 0;
+    gdb_comm.GetCompressionStatistics(num_compressed, compressed_bytes,
+                                      decompressed_bytes);
+    if (num_compressed > 0)
+      strm.Printf("%" PRIu64 " compressed packets, %" PRIu64
+                  " bytes on the wire, %" PRIu64 " bytes decompressed\n",
+                  num_compressed, compressed_bytes, decompressed_bytes);
+    result.SetStatus(eReturnStatusSuccessFinishResult);
+    return true;
+  }
+};
+
 class CommandObjectProcessGDBRemotePacketXferSize : public CommandObjectParsed {
 private:
 public:
@@ -5202,6 +5467,10 @@ public:
     LoadSubCommand("speed-test",
                    CommandObjectSP(new CommandObjectProcessGDBRemoteSpeedTest(
                        interpreter)));
+    LoadSubCommand(
+        "statistics",
+        CommandObjectSP(
+            new CommandObjectProcessGDBRemotePacketStatistics(interpreter)));
   }
 
   ~CommandObjectProcessGDBRemotePacket() {}
@@ -138,12 +138,19 @@ public:
 
   void WillPublicStop() override;
 
+  void PrefetchThreadRegisters(llvm::ArrayRef<lldb::ThreadSP> threads) override;
+
   //------------------------------------------------------------------
   // Process Memory
   //------------------------------------------------------------------
   size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
                       Status &error) override;
 
+  std::vector<size_t>
+  DoReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, size_t>> ranges,
+                     llvm::MutableArrayRef<uint8_t> buffer,
+                     Status &error) override;
+
   size_t DoWriteMemory(lldb::addr_t addr, const void *buf, size_t size,
                        Status &error) override;
 
@@ -17,6 +17,7 @@
 
 // C includes
 // C++ includes
+#include <algorithm>
 #include <map>
 
 using namespace lldb_private;
@@ -67,6 +68,85 @@ MinidumpParser::MinidumpParser(
     const lldb::DataBufferSP &data_buf_sp, const MinidumpHeader *header,
     llvm::DenseMap<uint32_t, MinidumpLocationDescriptor> &&directory_map)
     : m_data_sp(data_buf_sp), m_header(header), m_directory_map(directory_map) {
+  IndexMemory();
+}
+
+void MinidumpParser::IndexMemory() {
+  const uint64_t data_size = GetData().size();
+
+  llvm::ArrayRef<uint8_t> data = GetStream(MinidumpStreamType::MemoryList);
+  if (!data.empty()) {
+    for (const auto &memory_desc :
+         MinidumpMemoryDescriptor::ParseMemoryList(data)) {
+      const MinidumpLocationDescriptor &loc_desc = memory_desc.memory;
+      if (loc_desc.data_size == 0 ||
+          uint64_t(loc_desc.rva) + loc_desc.data_size > data_size)
+        continue;
+      m_memory_ranges.push_back(
+          minidump::Range(memory_desc.start_of_memory_range,
+                          GetData().slice(loc_desc.rva, loc_desc.data_size)));
+    }
+  }
+
+  // Some Minidumps have a Memory64ListStream that captures all the heap
+  // memory (full-memory Minidumps). The contents of its ranges are stored
+  // back to back, starting at a single base rva.
+  llvm::ArrayRef<uint8_t> data64 = GetStream(MinidumpStreamType::Memory64List);
+  if (!data64.empty()) {
+    llvm::ArrayRef<MinidumpMemoryDescriptor64> memory64_list;
+    uint64_t base_rva;
+    std::tie(memory64_list, base_rva) =
+        MinidumpMemoryDescriptor64::ParseMemory64List(data64);
+
+    for (const auto &memory_desc64 : memory64_list) {
+      const uint64_t range_size = memory_desc64.data_size;
+      if (base_rva > data_size || range_size > data_size - base_rva)
+        break;
+      if (range_size > 0)
+        m_memory_ranges.push_back(
+            minidump::Range(memory_desc64.start_of_memory_range,
+                            GetData().slice(base_rva, range_size)));
+      base_rva += range_size;
+    }
+  }
+
+  std::stable_sort(m_memory_ranges.begin(), m_memory_ranges.end(),
+                   [](const minidump::Range &lhs, const minidump::Range &rhs) {
+                     return lhs.start < rhs.start;
+                   });
+
+  // The ranges of the two lists can overlap. Cut the overlapping part off
+  // the range that starts later, or off the one from the Memory64List if
+  // they start at the same address, so that FindMemoryRange only needs to
+  // look at the last range that starts at or before an address.
+  size_t num_ranges = 0;
+  for (minidump::Range &range : m_memory_ranges) {
+    if (num_ranges > 0) {
+      const minidump::Range &prev = m_memory_ranges[num_ranges - 1];
+      const lldb::addr_t prev_end = prev.start + prev.range_ref.size();
+      if (range.start < prev_end) {
+        const uint64_t overlap = prev_end - range.start;
+        if (overlap >= range.range_ref.size())
+          continue;
+        range.start = prev_end;
+        range.range_ref = range.range_ref.drop_front(overlap);
+      }
+    }
+    m_memory_ranges[num_ranges++] = range;
+  }
+  m_memory_ranges.erase(m_memory_ranges.begin() + num_ranges,
+                        m_memory_ranges.end());
+
+  llvm::ArrayRef<uint8_t> info_data =
+      GetStream(MinidumpStreamType::MemoryInfoList);
+  if (!info_data.empty()) {
+    m_memory_infos = MinidumpMemoryInfo::ParseMemoryInfoList(info_data);
+    std::stable_sort(
+        m_memory_infos.begin(), m_memory_infos.end(),
+        [](const MinidumpMemoryInfo *lhs, const MinidumpMemoryInfo *rhs) {
+          return lhs->base_address < rhs->base_address;
+        });
+  }
 }
 
 llvm::ArrayRef<uint8_t> MinidumpParser::GetData() {
@@ -306,72 +386,22 @@ const MinidumpExceptionStream *MinidumpParser::GetExceptionStream() {
 
 llvm::Optional<minidump::Range>
 MinidumpParser::FindMemoryRange(lldb::addr_t addr) {
-  llvm::ArrayRef<uint8_t> data = GetStream(MinidumpStreamType::MemoryList);
-  llvm::ArrayRef<uint8_t> data64 = GetStream(MinidumpStreamType::Memory64List);
-
-  if (data.empty() && data64.empty())
+  // Find the last range that starts at or before addr.
+  auto pos = std::upper_bound(
+      m_memory_ranges.begin(), m_memory_ranges.end(), addr,
+      [](lldb::addr_t addr, const minidump::Range &range) {
+        return addr < range.start;
+      });
+  if (pos == m_memory_ranges.begin())
     return llvm::None;
-
-  if (!data.empty()) {
-    llvm::ArrayRef<MinidumpMemoryDescriptor> memory_list =
-        MinidumpMemoryDescriptor::ParseMemoryList(data);
-
-    if (memory_list.empty())
-      return llvm::None;
-
-    for (const auto &memory_desc : memory_list) {
-      const MinidumpLocationDescriptor &loc_desc = memory_desc.memory;
-      const lldb::addr_t range_start = memory_desc.start_of_memory_range;
-      const size_t range_size = loc_desc.data_size;
-
-      if (loc_desc.rva + loc_desc.data_size > GetData().size())
-        return llvm::None;
-
-      if (range_start <= addr && addr < range_start + range_size) {
-        return minidump::Range(range_start,
-                               GetData().slice(loc_desc.rva, range_size));
-      }
-    }
-  }
-
-  // Some Minidumps have a Memory64ListStream that captures all the heap
-  // memory (full-memory Minidumps).  We can't exactly use the same loop as
-  // above, because the Minidump uses slightly different data structures to
-  // describe those
-
-  if (!data64.empty()) {
-    llvm::ArrayRef<MinidumpMemoryDescriptor64> memory64_list;
-    uint64_t base_rva;
-    std::tie(memory64_list, base_rva) =
-        MinidumpMemoryDescriptor64::ParseMemory64List(data64);
-
-    if (memory64_list.empty())
-      return llvm::None;
-
-    for (const auto &memory_desc64 : memory64_list) {
-      const lldb::addr_t range_start = memory_desc64.start_of_memory_range;
-      const size_t range_size = memory_desc64.data_size;
-
-      if (base_rva + range_size > GetData().size())
-        return llvm::None;
-
-      if (range_start <= addr && addr < range_start + range_size) {
-        return minidump::Range(range_start,
-                               GetData().slice(base_rva, range_size));
-      }
-      base_rva += range_size;
-    }
-  }
-
+  --pos;
+  if (addr - pos->start < pos->range_ref.size())
+    return *pos;
   return llvm::None;
 }
 
 llvm::ArrayRef<uint8_t> MinidumpParser::GetMemory(lldb::addr_t addr,
                                                   size_t size) {
-  // I don't have a sense of how frequently this is called or how many memory
-  // ranges a Minidump typically has, so I'm not sure if searching for the
-  // appropriate range linearly each time is stupid.  Perhaps we should build
-  // an index for faster lookups.
   llvm::Optional<minidump::Range> range = FindMemoryRange(addr);
   if (!range)
     return {};
@@ -392,24 +422,27 @@ llvm::ArrayRef<uint8_t> MinidumpParser::GetMemory(lldb::addr_t addr,
 llvm::Optional<MemoryRegionInfo>
 MinidumpParser::GetMemoryRegionInfo(lldb::addr_t load_addr) {
   MemoryRegionInfo info;
-  llvm::ArrayRef<uint8_t> data = GetStream(MinidumpStreamType::MemoryInfoList);
-  if (data.empty())
-    return llvm::None;
-
-  std::vector<const MinidumpMemoryInfo *> mem_info_list =
-      MinidumpMemoryInfo::ParseMemoryInfoList(data);
-  if (mem_info_list.empty())
+  if (m_memory_infos.empty())
     return llvm::None;
 
   const auto yes = MemoryRegionInfo::eYes;
   const auto no = MemoryRegionInfo::eNo;
 
-  const MinidumpMemoryInfo *next_entry = nullptr;
-  for (const auto &entry : mem_info_list) {
+  // Find the first region that starts after load_addr, the region before it
+  // is the only one that can contain load_addr.
+  auto pos = std::upper_bound(
+      m_memory_infos.begin(), m_memory_infos.end(), load_addr,
+      [](lldb::addr_t addr, const MinidumpMemoryInfo *entry) {
+        return addr < entry->base_address;
+      });
+  const MinidumpMemoryInfo *next_entry =
+      pos != m_memory_infos.end() ? *pos : nullptr;
+  if (pos != m_memory_infos.begin()) {
+    const MinidumpMemoryInfo *entry = *std::prev(pos);
     const auto head = entry->base_address;
     const auto tail = head + entry->region_size;
 
-    if (head <= load_addr && load_addr < tail) {
+    if (load_addr < tail) {
       info.GetRange().SetRangeBase(
           (entry->state != uint32_t(MinidumpMemoryInfoState::MemFree))
               ? head
@@ -433,11 +466,6 @@ MinidumpParser::GetMemoryRegionInfo(lldb::addr_t load_addr) {
       info.SetMapped((entry->state != MemFree) ? yes : no);
 
       return info;
-    } else if (head > load_addr &&
-               (next_entry == nullptr || head < next_entry->base_address)) {
-      // In case there is no region containing load_addr keep track of the
-      // nearest region after load_addr so we can return the distance to it.
-      next_entry = entry;
     }
   }
 
@@ -91,6 +91,15 @@ private:
   const MinidumpHeader *m_header;
   llvm::DenseMap<uint32_t, MinidumpLocationDescriptor> m_directory_map;
 
+  // The memory ranges of the MemoryList and Memory64List streams and the
+  // entries of the MemoryInfoList stream, sorted by address so that full
+  // memory minidumps with many regions can be searched quickly. The memory
+  // ranges are cut so that they don't overlap.
+  std::vector<Range> m_memory_ranges;
+  std::vector<const MinidumpMemoryInfo *> m_memory_infos;
+
+  void IndexMemory();
+
   MinidumpParser(
       const lldb::DataBufferSP &data_buf_sp, const MinidumpHeader *header,
       llvm::DenseMap<uint32_t, MinidumpLocationDescriptor> &&directory_map);
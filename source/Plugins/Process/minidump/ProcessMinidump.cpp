@@ -17,6 +17,7 @@
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Target/DynamicLoader.h"
 #include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Target.h"
@@ -253,6 +254,29 @@ void ProcessMinidump::ReadModuleList() {
   std::vector<const MinidumpModule *> filtered_modules =
       m_minidump_parser.GetFilteredModuleList();
 
+  // Getting the modules and preloading their symbols is what takes the time
+  // for minidumps with many modules, so do that for all of them in parallel
+  // first. The lookup is the one Target::GetSharedModule() uses below, which
+  // then finds the same modules in the shared module list with their
+  // symbols already loaded. The vector keeps them alive until then. The
+  // modules are added to the target in order below.
+  std::vector<lldb::ModuleSP> preloaded_modules(filtered_modules.size());
+  if (GetTarget().GetPreloadSymbols() && filtered_modules.size() > 1) {
+    TaskMapOverInt(0, filtered_modules.size(), [&](size_t i) {
+      llvm::Optional<std::string> name = m_minidump_parser.GetMinidumpString(
+          filtered_modules[i]->module_name_rva);
+      if (!name)
+        return;
+      ModuleSpec module_spec(FileSpec(name.getValue(), true));
+      lldb::ModuleSP module_sp;
+      Status error = GetTarget().FindSharedModule(module_spec, module_sp);
+      if (module_sp && error.Success()) {
+        module_sp->PreloadSymbols();
+        preloaded_modules[i] = module_sp;
+      }
+    });
+  }
+
   for (auto module : filtered_modules) {
     llvm::Optional<std::string> name =
         m_minidump_parser.GetMinidumpString(module->module_name_rva);
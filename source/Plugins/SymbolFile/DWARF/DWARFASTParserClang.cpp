@@ -195,7 +195,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWO(const DWARFDIE &die, Log *log) {
       &dwo_type_sp->GetDeclaration(), type, Type::eResolveStateForward));
 
   dwarf->GetTypeList()->Insert(type_sp);
-  dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+  dwarf->GetDIEToType()[die.GetID()] = type_sp.get();
   clang::TagDecl *tag_decl = ClangASTContext::GetAsTagDecl(type);
   if (tag_decl)
     LinkDeclContextToDIE(tag_decl, die);
@@ -268,7 +268,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
     //
     //        }
 
-    Type *type_ptr = dwarf->GetDIEToType().lookup(die.GetDIE());
+    Type *type_ptr = dwarf->GetDIEToType().lookup(die.GetID());
     TypeList *type_list = dwarf->GetTypeList();
     if (type_ptr == NULL) {
       if (type_is_new_ptr)
@@ -301,7 +301,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
       case DW_TAG_volatile_type:
       case DW_TAG_unspecified_type: {
         // Set a bit that lets us know that we are currently parsing this
-        dwarf->GetDIEToType()[die.GetDIE()] = DIE_IS_BEING_PARSED;
+        dwarf->GetDIEToType()[die.GetID()] = DIE_IS_BEING_PARSED;
 
         const size_t num_attributes = die.GetAttributes(attributes);
         uint32_t encoding = 0;
@@ -553,7 +553,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
                      DIERef(encoding_uid).GetUID(dwarf), encoding_data_type,
                      &decl, clang_type, resolve_state));
 
-        dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+        dwarf->GetDIEToType()[die.GetID()] = type_sp.get();
 
         //                  Type* encoding_type =
         //                  GetUniquedTypeForDIEOffset(encoding_uid, type_sp,
@@ -571,7 +571,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
       case DW_TAG_union_type:
       case DW_TAG_class_type: {
         // Set a bit that lets us know that we are currently parsing this
-        dwarf->GetDIEToType()[die.GetDIE()] = DIE_IS_BEING_PARSED;
+        dwarf->GetDIEToType()[die.GetID()] = DIE_IS_BEING_PARSED;
         bool byte_size_valid = false;
 
         LanguageType class_language = eLanguageTypeUnknown;
@@ -681,7 +681,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
                   byte_size_valid ? byte_size : -1, *unique_ast_entry_ap)) {
             type_sp = unique_ast_entry_ap->m_type_sp;
             if (type_sp) {
-              dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+              dwarf->GetDIEToType()[die.GetID()] = type_sp.get();
               return type_sp;
             }
           }
@@ -758,7 +758,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
               // We found a real definition for this type elsewhere
               // so lets use it and cache the fact that we found
               // a complete type for this die
-              dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+              dwarf->GetDIEToType()[die.GetID()] = type_sp.get();
               return type_sp;
             }
           }
@@ -816,7 +816,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
             // We found a real definition for this type elsewhere
             // so lets use it and cache the fact that we found
             // a complete type for this die
-            dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+            dwarf->GetDIEToType()[die.GetID()] = type_sp.get();
             clang::DeclContext *defn_decl_ctx = GetCachedClangDeclContextForDIE(
                 dwarf->DebugInfo()->GetDIE(DIERef(type_sp->GetID(), dwarf)));
             if (defn_decl_ctx)
@@ -827,7 +827,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
         assert(tag_decl_kind != -1);
         bool clang_type_was_created = false;
         clang_type.SetCompilerType(
-            &m_ast, dwarf->GetForwardDeclDieToClangType().lookup(die.GetDIE()));
+            &m_ast, dwarf->GetForwardDeclDieToClangType().lookup(die.GetID()));
         if (!clang_type) {
           clang::DeclContext *decl_ctx =
               GetClangDeclContextContainingDIE(die, nullptr);
@@ -909,7 +909,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
         // end up creating many copies of the same type over
         // and over in the ASTContext for our module
         unique_ast_entry_ap->m_type_sp = type_sp;
-        unique_ast_entry_ap->m_die = die;
+        unique_ast_entry_ap->SetDIE(die);
         unique_ast_entry_ap->m_declaration = unique_decl;
         unique_ast_entry_ap->m_byte_size = byte_size;
         dwarf->GetUniqueDWARFASTTypeMap().Insert(unique_typename,
@@ -998,7 +998,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
             // Can't assume m_ast.GetSymbolFile() is actually a SymbolFileDWARF,
             // it can be a
             // SymbolFileDWARFDebugMap for Apple binaries.
-            dwarf->GetForwardDeclDieToClangType()[die.GetDIE()] =
+            dwarf->GetForwardDeclDieToClangType()[die.GetID()] =
                 clang_type.GetOpaqueQualType();
             dwarf->GetForwardDeclClangTypeToDie()
                 [ClangUtil::RemoveFastQualifiers(clang_type)
@@ -1024,7 +1024,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
 
       case DW_TAG_enumeration_type: {
         // Set a bit that lets us know that we are currently parsing this
-        dwarf->GetDIEToType()[die.GetDIE()] = DIE_IS_BEING_PARSED;
+        dwarf->GetDIEToType()[die.GetID()] = DIE_IS_BEING_PARSED;
 
         bool is_scoped = false;
         DWARFFormValue encoding_form;
@@ -1119,7 +1119,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
               // We found a real definition for this type elsewhere
               // so lets use it and cache the fact that we found
               // a complete type for this die
-              dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+              dwarf->GetDIEToType()[die.GetID()] = type_sp.get();
               clang::DeclContext *defn_decl_ctx =
                   GetCachedClangDeclContextForDIE(dwarf->DebugInfo()->GetDIE(
                       DIERef(type_sp->GetID(), dwarf)));
@@ -1134,7 +1134,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
           CompilerType enumerator_clang_type;
           clang_type.SetCompilerType(
               &m_ast,
-              dwarf->GetForwardDeclDieToClangType().lookup(die.GetDIE()));
+              dwarf->GetForwardDeclDieToClangType().lookup(die.GetID()));
           if (!clang_type) {
             if (encoding_form.IsValid()) {
               Type *enumerator_type =
@@ -1192,7 +1192,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
       case DW_TAG_subprogram:
       case DW_TAG_subroutine_type: {
         // Set a bit that lets us know that we are currently parsing this
-        dwarf->GetDIEToType()[die.GetDIE()] = DIE_IS_BEING_PARSED;
+        dwarf->GetDIEToType()[die.GetID()] = DIE_IS_BEING_PARSED;
 
         DWARFFormValue type_die_form;
         bool is_variadic = false;
@@ -1475,7 +1475,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
                     // are
                     // complete...
 
-                    type_ptr = dwarf->GetDIEToType()[die.GetDIE()];
+                    type_ptr = dwarf->GetDIEToType()[die.GetID()];
                     if (type_ptr && type_ptr != DIE_IS_BEING_PARSED) {
                       type_sp = type_ptr->shared_from_this();
                       break;
@@ -1641,7 +1641,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
                       // we need to modify the dwarf->GetDIEToType() so it
                       // doesn't think we are
                       // trying to parse this DIE anymore...
-                      dwarf->GetDIEToType()[die.GetDIE()] = NULL;
+                      dwarf->GetDIEToType()[die.GetID()] = NULL;
 
                       // Now we get the full type to force our class type to
                       // complete itself
@@ -1653,7 +1653,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
 
                       // The type for this DIE should have been filled in the
                       // function call above
-                      type_ptr = dwarf->GetDIEToType()[die.GetDIE()];
+                      type_ptr = dwarf->GetDIEToType()[die.GetID()];
                       if (type_ptr && type_ptr != DIE_IS_BEING_PARSED) {
                         type_sp = type_ptr->shared_from_this();
                         break;
@@ -1743,7 +1743,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
 
       case DW_TAG_array_type: {
         // Set a bit that lets us know that we are currently parsing this
-        dwarf->GetDIEToType()[die.GetDIE()] = DIE_IS_BEING_PARSED;
+        dwarf->GetDIEToType()[die.GetID()] = DIE_IS_BEING_PARSED;
 
         DWARFFormValue type_die_form;
         int64_t first_index = 0;
@@ -1970,7 +1970,7 @@ TypeSP DWARFASTParserClang::ParseTypeFromDWARF(const SymbolContext &sc,
         // level
         type_list->Insert(type_sp);
 
-        dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+        dwarf->GetDIEToType()[die.GetID()] = type_sp.get();
       }
     } else if (type_ptr != DIE_IS_BEING_PARSED) {
       type_sp = type_ptr->shared_from_this();
@@ -2590,7 +2590,7 @@ std::vector<DWARFDIE> DWARFASTParserClang::GetDIEForDeclContext(
   for (auto it = m_decl_ctx_to_die.find(
            (clang::DeclContext *)decl_context.GetOpaqueDeclContext());
        it != m_decl_ctx_to_die.end(); it++)
-    result.push_back(it->second);
+    result.push_back(it->second.first->GetDIE(it->second.second));
   return result;
 }
 
@@ -2825,7 +2825,7 @@ Function *DWARFASTParserClang::ParseFunctionFromDWARF(const SymbolContext &sc,
 
       SymbolFileDWARF *dwarf = die.GetDWARF();
       // Supply the type _only_ if it has already been parsed
-      Type *func_type = dwarf->GetDIEToType().lookup(die.GetDIE());
+      Type *func_type = dwarf->GetDIEToType().lookup(die.GetID());
 
       assert(func_type == NULL || func_type != DIE_IS_BEING_PARSED);
 
@@ -3792,22 +3792,22 @@ clang::Decl *DWARFASTParserClang::GetClangDeclForDIE(const DWARFDIE &die) {
     return nullptr;
   }
 
-  DIEToDeclMap::iterator cache_pos = m_die_to_decl.find(die.GetDIE());
+  DIEToDeclMap::iterator cache_pos = m_die_to_decl.find(die.GetID());
   if (cache_pos != m_die_to_decl.end())
     return cache_pos->second;
 
   if (DWARFDIE spec_die = die.GetReferencedDIE(DW_AT_specification)) {
     clang::Decl *decl = GetClangDeclForDIE(spec_die);
-    m_die_to_decl[die.GetDIE()] = decl;
-    m_decl_to_die[decl].insert(die.GetDIE());
+    m_die_to_decl[die.GetID()] = decl;
+    m_decl_to_die[decl].insert(die.GetID());
     return decl;
   }
 
   if (DWARFDIE abstract_origin_die =
           die.GetReferencedDIE(DW_AT_abstract_origin)) {
     clang::Decl *decl = GetClangDeclForDIE(abstract_origin_die);
-    m_die_to_decl[die.GetDIE()] = decl;
-    m_decl_to_die[decl].insert(die.GetDIE());
+    m_die_to_decl[die.GetID()] = decl;
+    m_decl_to_die[decl].insert(die.GetID());
     return decl;
   }
 
@@ -3869,8 +3869,8 @@ clang::Decl *DWARFASTParserClang::GetClangDeclForDIE(const DWARFDIE &die) {
     break;
   }
 
-  m_die_to_decl[die.GetDIE()] = decl;
-  m_decl_to_die[decl].insert(die.GetDIE());
+  m_die_to_decl[die.GetID()] = decl;
+  m_decl_to_die[decl].insert(die.GetID());
 
   return decl;
 }
@@ -3983,7 +3983,7 @@ DWARFASTParserClang::GetDeclContextForBlock(const DWARFDIE &die) {
 clang::BlockDecl *DWARFASTParserClang::ResolveBlockDIE(const DWARFDIE &die) {
   if (die && die.Tag() == DW_TAG_lexical_block) {
     clang::BlockDecl *decl =
-        llvm::cast_or_null<clang::BlockDecl>(m_die_to_decl_ctx[die.GetDIE()]);
+        llvm::cast_or_null<clang::BlockDecl>(m_die_to_decl_ctx[die.GetID()]);
 
     if (!decl) {
       DWARFDIE decl_context_die;
@@ -4006,7 +4006,7 @@ DWARFASTParserClang::ResolveNamespaceDIE(const DWARFDIE &die) {
     // See if we already parsed this namespace DIE and associated it with a
     // uniqued namespace declaration
     clang::NamespaceDecl *namespace_decl =
-        static_cast<clang::NamespaceDecl *>(m_die_to_decl_ctx[die.GetDIE()]);
+        static_cast<clang::NamespaceDecl *>(m_die_to_decl_ctx[die.GetID()]);
     if (namespace_decl)
       return namespace_decl;
     else {
@@ -4067,7 +4067,7 @@ clang::DeclContext *DWARFASTParserClang::GetClangDeclContextContainingDIE(
 clang::DeclContext *
 DWARFASTParserClang::GetCachedClangDeclContextForDIE(const DWARFDIE &die) {
   if (die) {
-    DIEToDeclContextMap::iterator pos = m_die_to_decl_ctx.find(die.GetDIE());
+    DIEToDeclContextMap::iterator pos = m_die_to_decl_ctx.find(die.GetID());
     if (pos != m_die_to_decl_ctx.end())
       return pos->second;
   }
@@ -4076,10 +4076,10 @@ DWARFASTParserClang::GetCachedClangDeclContextForDIE(const DWARFDIE &die) {
 
 void DWARFASTParserClang::LinkDeclContextToDIE(clang::DeclContext *decl_ctx,
                                                const DWARFDIE &die) {
-  m_die_to_decl_ctx[die.GetDIE()] = decl_ctx;
+  m_die_to_decl_ctx[die.GetID()] = decl_ctx;
   // There can be many DIEs for a single decl context
-  // m_decl_ctx_to_die[decl_ctx].insert(die.GetDIE());
-  m_decl_ctx_to_die.insert(std::make_pair(decl_ctx, die));
+  m_decl_ctx_to_die.insert(std::make_pair(
+      decl_ctx, std::make_pair(die.GetCU(), die.GetOffset())));
 }
 
 bool DWARFASTParserClang::CopyUniqueClassMethodTypes(
@@ -4208,7 +4208,7 @@ bool DWARFASTParserClang::CopyUniqueClassMethodTypes(
       dst_die = dst_name_to_die.GetValueAtIndexUnchecked(idx);
 
       clang::DeclContext *src_decl_ctx =
-          src_dwarf_ast_parser->m_die_to_decl_ctx[src_die.GetDIE()];
+          src_dwarf_ast_parser->m_die_to_decl_ctx[src_die.GetID()];
       if (src_decl_ctx) {
         if (log)
           log->Printf("uniquing decl context %p from 0x%8.8x for 0x%8.8x",
@@ -4223,14 +4223,14 @@ bool DWARFASTParserClang::CopyUniqueClassMethodTypes(
       }
 
       Type *src_child_type =
-          dst_die.GetDWARF()->GetDIEToType()[src_die.GetDIE()];
+          dst_die.GetDWARF()->GetDIEToType()[src_die.GetID()];
       if (src_child_type) {
         if (log)
           log->Printf(
               "uniquing type %p (uid=0x%" PRIx64 ") from 0x%8.8x for 0x%8.8x",
               static_cast<void *>(src_child_type), src_child_type->GetID(),
               src_die.GetOffset(), dst_die.GetOffset());
-        dst_die.GetDWARF()->GetDIEToType()[dst_die.GetDIE()] = src_child_type;
+        dst_die.GetDWARF()->GetDIEToType()[dst_die.GetID()] = src_child_type;
       } else {
         if (log)
           log->Printf("warning: tried to unique lldb_private::Type from "
@@ -4253,7 +4253,7 @@ bool DWARFASTParserClang::CopyUniqueClassMethodTypes(
 
         if (src_die && (src_die.Tag() == dst_die.Tag())) {
           clang::DeclContext *src_decl_ctx =
-              src_dwarf_ast_parser->m_die_to_decl_ctx[src_die.GetDIE()];
+              src_dwarf_ast_parser->m_die_to_decl_ctx[src_die.GetID()];
           if (src_decl_ctx) {
             if (log)
               log->Printf("uniquing decl context %p from 0x%8.8x for 0x%8.8x",
@@ -4268,7 +4268,7 @@ bool DWARFASTParserClang::CopyUniqueClassMethodTypes(
           }
 
           Type *src_child_type =
-              dst_die.GetDWARF()->GetDIEToType()[src_die.GetDIE()];
+              dst_die.GetDWARF()->GetDIEToType()[src_die.GetID()];
           if (src_child_type) {
             if (log)
               log->Printf("uniquing type %p (uid=0x%" PRIx64
@@ -4276,7 +4276,7 @@ bool DWARFASTParserClang::CopyUniqueClassMethodTypes(
                           static_cast<void *>(src_child_type),
                           src_child_type->GetID(), src_die.GetOffset(),
                           dst_die.GetOffset());
-            dst_die.GetDWARF()->GetDIEToType()[dst_die.GetDIE()] =
+            dst_die.GetDWARF()->GetDIEToType()[dst_die.GetID()] =
                 src_child_type;
           } else {
             if (log)
@@ -4311,7 +4311,7 @@ bool DWARFASTParserClang::CopyUniqueClassMethodTypes(
       if (dst_die) {
         // Both classes have the artificial types, link them
         clang::DeclContext *src_decl_ctx =
-            src_dwarf_ast_parser->m_die_to_decl_ctx[src_die.GetDIE()];
+            src_dwarf_ast_parser->m_die_to_decl_ctx[src_die.GetID()];
         if (src_decl_ctx) {
           if (log)
             log->Printf("uniquing decl context %p from 0x%8.8x for 0x%8.8x",
@@ -4326,14 +4326,14 @@ bool DWARFASTParserClang::CopyUniqueClassMethodTypes(
         }
 
         Type *src_child_type =
-            dst_die.GetDWARF()->GetDIEToType()[src_die.GetDIE()];
+            dst_die.GetDWARF()->GetDIEToType()[src_die.GetID()];
         if (src_child_type) {
           if (log)
             log->Printf(
                 "uniquing type %p (uid=0x%" PRIx64 ") from 0x%8.8x for 0x%8.8x",
                 static_cast<void *>(src_child_type), src_child_type->GetID(),
                 src_die.GetOffset(), dst_die.GetOffset());
-          dst_die.GetDWARF()->GetDIEToType()[dst_die.GetDIE()] = src_child_type;
+          dst_die.GetDWARF()->GetDIEToType()[dst_die.GetID()] = src_child_type;
         } else {
           if (log)
             log->Printf("warning: tried to unique lldb_private::Type from "
@@ -16,6 +16,7 @@
 #include "clang/AST/CharUnits.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
 
 // Project includes
@@ -26,6 +27,7 @@
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/ClangASTImporter.h"
 
+class DWARFCompileUnit;
 class DWARFDebugInfoEntry;
 class DWARFDIECollection;
 
@@ -139,16 +141,16 @@ protected:
   //----------------------------------------------------------------------
   lldb::ModuleSP GetModuleForType(const DWARFDIE &die);
 
-  typedef llvm::SmallPtrSet<const DWARFDebugInfoEntry *, 4> DIEPointerSet;
-  typedef llvm::DenseMap<const DWARFDebugInfoEntry *, clang::DeclContext *>
+  // DIEs are identified by their user ID and never by their address: the
+  // DIEs of a compile unit can be freed and parsed again at any time.
+  typedef llvm::SmallSet<lldb::user_id_t, 4> DIEUIDSet;
+  typedef llvm::DenseMap<lldb::user_id_t, clang::DeclContext *>
       DIEToDeclContextMap;
-  // typedef llvm::DenseMap<const clang::DeclContext *, DIEPointerSet>
-  // DeclContextToDIEMap;
-  typedef std::multimap<const clang::DeclContext *, const DWARFDIE>
+  typedef std::multimap<const clang::DeclContext *,
+                        std::pair<DWARFCompileUnit *, dw_offset_t>>
       DeclContextToDIEMap;
-  typedef llvm::DenseMap<const DWARFDebugInfoEntry *, clang::Decl *>
-      DIEToDeclMap;
-  typedef llvm::DenseMap<const clang::Decl *, DIEPointerSet> DeclToDIEMap;
+  typedef llvm::DenseMap<lldb::user_id_t, clang::Decl *> DIEToDeclMap;
+  typedef llvm::DenseMap<const clang::Decl *, DIEUIDSet> DeclToDIEMap;
 
   lldb_private::ClangASTContext &m_ast;
   DIEToDeclMap m_die_to_decl;
@@ -65,7 +65,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
           die.GetOffset(), DW_TAG_value_to_name(die.Tag()), die.GetName());
     }
 
-    Type *type_ptr = dwarf->m_die_to_type.lookup(die.GetDIE());
+    Type *type_ptr = dwarf->m_die_to_type.lookup(die.GetID());
     TypeList *type_list = dwarf->GetTypeList();
     if (type_ptr == NULL) {
       if (type_is_new_ptr)
@@ -94,7 +94,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
       case DW_TAG_typedef:
       case DW_TAG_unspecified_type: {
         // Set a bit that lets us know that we are currently parsing this
-        dwarf->m_die_to_type[die.GetDIE()] = DIE_IS_BEING_PARSED;
+        dwarf->m_die_to_type[die.GetID()] = DIE_IS_BEING_PARSED;
 
         const size_t num_attributes = die.GetAttributes(attributes);
         lldb::user_id_t encoding_uid = LLDB_INVALID_UID;
@@ -159,7 +159,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
           if (type) {
             if (go_kind == 0 && type->GetName() == type_name_const_str) {
               // Go emits extra typedefs as a forward declaration. Ignore these.
-              dwarf->m_die_to_type[die.GetDIE()] = type;
+              dwarf->m_die_to_type[die.GetID()] = type;
               return type->shared_from_this();
             }
             impl = type->GetForwardCompilerType();
@@ -174,12 +174,12 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
                                encoding_data_type, &decl, compiler_type,
                                resolve_state));
 
-        dwarf->m_die_to_type[die.GetDIE()] = type_sp.get();
+        dwarf->m_die_to_type[die.GetID()] = type_sp.get();
       } break;
 
       case DW_TAG_structure_type: {
         // Set a bit that lets us know that we are currently parsing this
-        dwarf->m_die_to_type[die.GetDIE()] = DIE_IS_BEING_PARSED;
+        dwarf->m_die_to_type[die.GetID()] = DIE_IS_BEING_PARSED;
         bool byte_size_valid = false;
 
         const size_t num_attributes = die.GetAttributes(attributes);
@@ -232,7 +232,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
           // unit.
           type_sp = unique_ast_entry_ap->m_type_sp;
           if (type_sp) {
-            dwarf->m_die_to_type[die.GetDIE()] = type_sp.get();
+            dwarf->m_die_to_type[die.GetID()] = type_sp.get();
             return type_sp;
           }
         }
@@ -243,7 +243,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
         bool compiler_type_was_created = false;
         compiler_type.SetCompilerType(
             &m_ast,
-            dwarf->m_forward_decl_die_to_clang_type.lookup(die.GetDIE()));
+            dwarf->m_forward_decl_die_to_clang_type.lookup(die.GetID()));
         if (!compiler_type) {
           compiler_type_was_created = true;
           compiler_type =
@@ -259,7 +259,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
         // end up creating many copies of the same type over
         // and over in the ASTContext for our module
         unique_ast_entry_ap->m_type_sp = type_sp;
-        unique_ast_entry_ap->m_die = die;
+        unique_ast_entry_ap->SetDIE(die);
         unique_ast_entry_ap->m_declaration = decl;
         unique_ast_entry_ap->m_byte_size = byte_size;
         dwarf->GetUniqueDWARFASTTypeMap().Insert(type_name_const_str,
@@ -279,7 +279,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
             // will automatically call the SymbolFile virtual function
             // "SymbolFileDWARF::CompleteType(Type *)"
             // When the definition needs to be defined.
-            dwarf->m_forward_decl_die_to_clang_type[die.GetDIE()] =
+            dwarf->m_forward_decl_die_to_clang_type[die.GetID()] =
                 compiler_type.GetOpaqueQualType();
             dwarf->m_forward_decl_clang_type_to_die[compiler_type
                                                         .GetOpaqueQualType()] =
@@ -292,7 +292,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
       case DW_TAG_subprogram:
       case DW_TAG_subroutine_type: {
         // Set a bit that lets us know that we are currently parsing this
-        dwarf->m_die_to_type[die.GetDIE()] = DIE_IS_BEING_PARSED;
+        dwarf->m_die_to_type[die.GetID()] = DIE_IS_BEING_PARSED;
 
         bool is_variadic = false;
         clang::StorageClass storage =
@@ -352,7 +352,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
 
       case DW_TAG_array_type: {
         // Set a bit that lets us know that we are currently parsing this
-        dwarf->m_die_to_type[die.GetDIE()] = DIE_IS_BEING_PARSED;
+        dwarf->m_die_to_type[die.GetID()] = DIE_IS_BEING_PARSED;
 
         lldb::user_id_t type_die_offset = DW_INVALID_OFFSET;
         int64_t first_index = 0;
@@ -449,7 +449,7 @@ TypeSP DWARFASTParserGo::ParseTypeFromDWARF(
         // level
         type_list->Insert(type_sp);
 
-        dwarf->m_die_to_type[die.GetDIE()] = type_sp.get();
+        dwarf->m_die_to_type[die.GetID()] = type_sp.get();
       }
     } else if (type_ptr != DIE_IS_BEING_PARSED) {
       type_sp = type_ptr->shared_from_this();
@@ -749,7 +749,7 @@ Function *DWARFASTParserGo::ParseFunctionFromDWARF(const SymbolContext &sc,
 
       SymbolFileDWARF *dwarf = die.GetDWARF();
       // Supply the type _only_ if it has already been parsed
-      Type *func_type = dwarf->m_die_to_type.lookup(die.GetDIE());
+      Type *func_type = dwarf->m_die_to_type.lookup(die.GetID());
 
       assert(func_type == NULL || func_type != DIE_IS_BEING_PARSED);
 
@@ -29,7 +29,7 @@ DWARFASTParserJava::~DWARFASTParserJava() {}
 
 TypeSP DWARFASTParserJava::ParseBaseTypeFromDIE(const DWARFDIE &die) {
   SymbolFileDWARF *dwarf = die.GetDWARF();
-  dwarf->m_die_to_type[die.GetDIE()] = DIE_IS_BEING_PARSED;
+  dwarf->m_die_to_type[die.GetID()] = DIE_IS_BEING_PARSED;
 
   ConstString type_name;
   uint64_t byte_size = 0;
@@ -64,7 +64,7 @@ TypeSP DWARFASTParserJava::ParseBaseTypeFromDIE(const DWARFDIE &die) {
 
 TypeSP DWARFASTParserJava::ParseArrayTypeFromDIE(const DWARFDIE &die) {
   SymbolFileDWARF *dwarf = die.GetDWARF();
-  dwarf->m_die_to_type[die.GetDIE()] = DIE_IS_BEING_PARSED;
+  dwarf->m_die_to_type[die.GetID()] = DIE_IS_BEING_PARSED;
 
   ConstString linkage_name;
   DWARFFormValue type_attr_value;
@@ -142,7 +142,7 @@ TypeSP DWARFASTParserJava::ParseArrayTypeFromDIE(const DWARFDIE &die) {
 
 TypeSP DWARFASTParserJava::ParseReferenceTypeFromDIE(const DWARFDIE &die) {
   SymbolFileDWARF *dwarf = die.GetDWARF();
-  dwarf->m_die_to_type[die.GetDIE()] = DIE_IS_BEING_PARSED;
+  dwarf->m_die_to_type[die.GetID()] = DIE_IS_BEING_PARSED;
 
   Declaration decl;
   DWARFFormValue type_attr_value;
@@ -182,7 +182,7 @@ TypeSP DWARFASTParserJava::ParseReferenceTypeFromDIE(const DWARFDIE &die) {
 lldb::TypeSP DWARFASTParserJava::ParseClassTypeFromDIE(const DWARFDIE &die,
                                                        bool &is_new_type) {
   SymbolFileDWARF *dwarf = die.GetDWARF();
-  dwarf->m_die_to_type[die.GetDIE()] = DIE_IS_BEING_PARSED;
+  dwarf->m_die_to_type[die.GetID()] = DIE_IS_BEING_PARSED;
 
   Declaration decl;
   ConstString name;
@@ -223,7 +223,7 @@ lldb::TypeSP DWARFASTParserJava::ParseClassTypeFromDIE(const DWARFDIE &die,
       if (dwarf->GetUniqueDWARFASTTypeMap().Find(name, die, Declaration(), -1,
                                                  unique_ast_entry)) {
         if (unique_ast_entry.m_type_sp) {
-          dwarf->GetDIEToType()[die.GetDIE()] =
+          dwarf->GetDIEToType()[die.GetID()] =
               unique_ast_entry.m_type_sp.get();
           is_new_type = false;
           return unique_ast_entry.m_type_sp;
@@ -239,14 +239,14 @@ lldb::TypeSP DWARFASTParserJava::ParseClassTypeFromDIE(const DWARFDIE &die,
     TypeSP type_sp = dwarf->FindDefinitionTypeForDWARFDeclContext(die_decl_ctx);
     if (type_sp) {
       // We found a real definition for this type elsewhere so lets use it
-      dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+      dwarf->GetDIEToType()[die.GetID()] = type_sp.get();
       is_new_type = false;
       return type_sp;
     }
   }
 
   CompilerType compiler_type(
-      &m_ast, dwarf->GetForwardDeclDieToClangType().lookup(die.GetDIE()));
+      &m_ast, dwarf->GetForwardDeclDieToClangType().lookup(die.GetID()));
   if (!compiler_type)
     compiler_type = m_ast.CreateObjectType(name, linkage_name, byte_size);
 
@@ -258,7 +258,7 @@ lldb::TypeSP DWARFASTParserJava::ParseClassTypeFromDIE(const DWARFDIE &die,
 
   // Add our type to the unique type map
   unique_ast_entry.m_type_sp = type_sp;
-  unique_ast_entry.m_die = die;
+  unique_ast_entry.SetDIE(die);
   unique_ast_entry.m_declaration = decl;
   unique_ast_entry.m_byte_size = -1;
   dwarf->GetUniqueDWARFASTTypeMap().Insert(name, unique_ast_entry);
@@ -266,7 +266,7 @@ lldb::TypeSP DWARFASTParserJava::ParseClassTypeFromDIE(const DWARFDIE &die,
   if (!is_forward_declaration) {
     // Leave this as a forward declaration until we need to know the details of
     // the type
-    dwarf->GetForwardDeclDieToClangType()[die.GetDIE()] =
+    dwarf->GetForwardDeclDieToClangType()[die.GetID()] =
         compiler_type.GetOpaqueQualType();
     dwarf->GetForwardDeclClangTypeToDie()[compiler_type.GetOpaqueQualType()] =
         die.GetDIERef();
@@ -285,7 +285,7 @@ lldb::TypeSP DWARFASTParserJava::ParseTypeFromDWARF(
 
   SymbolFileDWARF *dwarf = die.GetDWARF();
 
-  Type *type_ptr = dwarf->m_die_to_type.lookup(die.GetDIE());
+  Type *type_ptr = dwarf->m_die_to_type.lookup(die.GetID());
   if (type_ptr == DIE_IS_BEING_PARSED)
     return nullptr;
   if (type_ptr != nullptr)
@@ -337,7 +337,7 @@ lldb::TypeSP DWARFASTParserJava::ParseTypeFromDWARF(
     type_sp->SetSymbolContextScope(symbol_context_scope);
 
   dwarf->GetTypeList()->Insert(type_sp);
-  dwarf->m_die_to_type[die.GetDIE()] = type_sp.get();
+  dwarf->m_die_to_type[die.GetID()] = type_sp.get();
 
   return type_sp;
 }
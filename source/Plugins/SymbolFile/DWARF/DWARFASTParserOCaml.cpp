@@ -20,7 +20,7 @@ DWARFASTParserOCaml::~DWARFASTParserOCaml() {}
 
 TypeSP DWARFASTParserOCaml::ParseBaseTypeFromDIE(const DWARFDIE &die) {
   SymbolFileDWARF *dwarf = die.GetDWARF();
-  dwarf->m_die_to_type[die.GetDIE()] = DIE_IS_BEING_PARSED;
+  dwarf->m_die_to_type[die.GetID()] = DIE_IS_BEING_PARSED;
 
   ConstString type_name;
   uint64_t byte_size = 0;
@@ -65,7 +65,7 @@ lldb::TypeSP DWARFASTParserOCaml::ParseTypeFromDWARF(const SymbolContext &sc,
 
   SymbolFileDWARF *dwarf = die.GetDWARF();
 
-  Type *type_ptr = dwarf->m_die_to_type.lookup(die.GetDIE());
+  Type *type_ptr = dwarf->m_die_to_type.lookup(die.GetID());
   if (type_ptr == DIE_IS_BEING_PARSED)
     return nullptr;
   if (type_ptr != nullptr)
@@ -111,7 +111,7 @@ lldb::TypeSP DWARFASTParserOCaml::ParseTypeFromDWARF(const SymbolContext &sc,
     type_sp->SetSymbolContextScope(symbol_context_scope);
 
   dwarf->GetTypeList()->Insert(type_sp);
-  dwarf->m_die_to_type[die.GetDIE()] = type_sp.get();
+  dwarf->m_die_to_type[die.GetID()] = type_sp.get();
 
   return type_sp;
 }
@@ -174,7 +174,7 @@ Function *DWARFASTParserOCaml::ParseFunctionFromDWARF(const SymbolContext &sc,
             decl_line, decl_column));
 
       SymbolFileDWARF *dwarf = die.GetDWARF();
-      Type *func_type = dwarf->m_die_to_type.lookup(die.GetDIE());
+      Type *func_type = dwarf->m_die_to_type.lookup(die.GetID());
 
       assert(func_type == NULL || func_type != DIE_IS_BEING_PARSED);
 
@@ -38,6 +38,10 @@ using namespace std;
 
 extern int g_verbose;
 
+// Incremented every time a compile unit's DIEs are used, see
+// DWARFCompileUnit::GetLastDIEUse().
+static std::atomic<uint32_t> g_die_use_generation{0};
+
 DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF *dwarf2Data)
     : m_dwarf2Data(dwarf2Data) {}
 
@@ -111,6 +115,9 @@ void DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die) {
 // done.
 //----------------------------------------------------------------------
 size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
+  if (!cu_die_only)
+    m_last_die_use = ++g_die_use_generation;
+
   const size_t initial_die_array_size = m_die_array.size();
   if ((cu_die_only && initial_die_array_size > 0) || initial_die_array_size > 1)
     return 0; // Already parsed
@@ -120,11 +127,14 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
       func_cat,
       "%8.8x: DWARFCompileUnit::ExtractDIEsIfNeeded( cu_die_only = %i )",
       m_offset, cu_die_only);
+  ElapsedTime elapsed(m_dwarf2Data->GetDebugInfoParseTimeRef());
 
   // Set the offset to that of the first DIE and calculate the start of the
   // next compilation unit header.
   lldb::offset_t offset = GetFirstDIEOffset();
   lldb::offset_t next_cu_offset = GetNextCompileUnitOffset();
+  if (!cu_die_only)
+    m_dwarf2Data->AddDebugInfoBytesParsed(next_cu_offset - m_offset);
 
   DWARFDebugInfoEntry die;
   // Keep a flat array of the DIE for binary lookup by DIE offset
@@ -139,6 +149,16 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
     }
   }
 
+  // The average bytes per DIE entry has been seen to be around 14-20 so
+  // lets pre-reserve for 24 bytes per DIE since we are stripping the NULL
+  // tags. Only do this when we are parsing all the DIEs: the compile
+  // unit DIE of every compile unit is extracted on its own when indexing
+  // or building the address ranges, and reserving room for all the DIEs
+  // then would keep a mostly unused array alive for every compile unit.
+  if (!cu_die_only)
+    m_die_array.reserve(
+        std::max<size_t>(m_die_array.size(), (next_cu_offset - offset) / 24));
+
   uint32_t depth = 0;
   // We are in our compile unit, parse starting at the offset
   // we were told to parse
@@ -238,6 +258,10 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
                                                          m_die_array.end());
     exact_size_die_array.swap(m_die_array);
   }
+  m_dwarf2Data->DIEsWereExtracted(m_die_array.capacity() *
+                                      sizeof(DWARFDebugInfoEntry),
+                                  m_dies_evicted.exchange(false));
+
   Log *log(LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO));
   if (log && log->GetVerbose()) {
     StreamString strm;
@@ -258,6 +282,20 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
          1; // We have 2 CU die, but we want to count it only as one
 }
 
+size_t DWARFCompileUnit::GetDIEMemorySize() const {
+  size_t size = m_die_array.capacity() * sizeof(DWARFDebugInfoEntry);
+  if (m_dwo_symbol_file)
+    size += m_dwo_symbol_file->GetCompileUnit()->GetDIEMemorySize();
+  return size;
+}
+
+bool DWARFCompileUnit::GetDIEsInUse() const {
+  if (m_die_users > 0)
+    return true;
+  return m_dwo_symbol_file &&
+         m_dwo_symbol_file->GetCompileUnit()->GetDIEsInUse();
+}
+
 void DWARFCompileUnit::AddCompileUnitDIE(DWARFDebugInfoEntry &die) {
   assert(m_die_array.empty() && "Compile unit DIE already added");
   AddDIE(die);
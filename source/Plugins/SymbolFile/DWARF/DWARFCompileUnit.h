@@ -10,6 +10,8 @@
 #ifndef SymbolFileDWARF_DWARFCompileUnit_h_
 #define SymbolFileDWARF_DWARFCompileUnit_h_
 
+#include <atomic>
+
 #include "DWARFDIE.h"
 #include "DWARFDebugInfoEntry.h"
 #include "lldb/lldb-enumerations.h"
@@ -88,25 +90,55 @@ public:
   DWARFDIE
   DIE() { return DWARFDIE(this, DIEPtr()); }
 
-  void AddDIE(DWARFDebugInfoEntry &die) {
-    // The average bytes per DIE entry has been seen to be
-    // around 14-20 so lets pre-reserve half of that since
-    // we are now stripping the NULL tags.
-
-    // Only reserve the memory if we are adding children of
-    // the main compile unit DIE. The compile unit DIE is always
-    // the first entry, so if our size is 1, then we are adding
-    // the first compile unit child DIE and should reserve
-    // the memory.
-    if (m_die_array.empty())
-      m_die_array.reserve(GetDebugInfoSize() / 24);
-    m_die_array.push_back(die);
-  }
+  void AddDIE(DWARFDebugInfoEntry &die) { m_die_array.push_back(die); }
 
   void AddCompileUnitDIE(DWARFDebugInfoEntry &die);
 
   bool HasDIEsParsed() const { return m_die_array.size() > 1; }
 
+  //------------------------------------------------------------------
+  /// The number of bytes allocated for the parsed DIEs of this compile
+  /// unit, including the DIEs of its DWO compile unit.
+  //------------------------------------------------------------------
+  size_t GetDIEMemorySize() const;
+
+  //------------------------------------------------------------------
+  /// Keeps DWARFDebugInfo::EvictDIEs() from freeing the DIEs of a
+  /// compile unit for as long as it exists, for code that holds on to
+  /// DWARFDIE objects of the compile unit while parsing.
+  //------------------------------------------------------------------
+  class ScopedDIEUse {
+  public:
+    ScopedDIEUse(DWARFCompileUnit *cu) : m_cu(cu) {
+      if (m_cu)
+        ++m_cu->m_die_users;
+    }
+
+    ~ScopedDIEUse() {
+      if (m_cu)
+        --m_cu->m_die_users;
+    }
+
+  private:
+    DWARFCompileUnit *m_cu;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedDIEUse);
+  };
+
+  //------------------------------------------------------------------
+  /// Returns true if a ScopedDIEUse exists for this compile unit or its
+  /// DWO compile unit.
+  //------------------------------------------------------------------
+  bool GetDIEsInUse() const;
+
+  //------------------------------------------------------------------
+  /// A stamp that orders the compile units by when their DIEs were last
+  /// used, larger values being more recent.
+  //------------------------------------------------------------------
+  uint32_t GetLastDIEUse() const { return m_last_die_use; }
+
+  void SetDIEsEvicted() { m_dies_evicted = true; }
+
   DWARFDIE
   GetDIE(dw_offset_t die_offset);
 
@@ -190,6 +222,11 @@ protected:
   // If this is a dwo compile unit this is the offset of the base compile unit
   // in the main object file
   dw_offset_t m_base_obj_offset = DW_INVALID_OFFSET;
+  std::atomic<uint32_t> m_last_die_use{0};
+  std::atomic<uint32_t> m_die_users{0};
+  // Set when the DIEs were freed to save memory, so parsing them again can
+  // be counted as a re-parse.
+  std::atomic<bool> m_dies_evicted{false};
 
   void ParseProducerInfo();
 
@@ -119,6 +119,47 @@ DWARFCompileUnit *DWARFDebugInfo::GetCompileUnitAtIndex(uint32_t idx) {
   return cu;
 }
 
+size_t DWARFDebugInfo::EvictDIEs(uint64_t memory_limit) {
+  uint64_t memory_size = 0;
+  std::vector<DWARFCompileUnit *> candidates;
+  for (const DWARFCompileUnitSP &cu_sp : m_compile_units) {
+    const size_t cu_memory_size = cu_sp->GetDIEMemorySize();
+    memory_size += cu_memory_size;
+    if (cu_memory_size > sizeof(DWARFDebugInfoEntry) &&
+        !cu_sp->GetDIEsInUse())
+      candidates.push_back(cu_sp.get());
+  }
+  if (memory_size <= memory_limit)
+    return 0;
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const DWARFCompileUnit *lhs, const DWARFCompileUnit *rhs) {
+              return lhs->GetLastDIEUse() < rhs->GetLastDIEUse();
+            });
+
+  size_t num_evicted = 0;
+  for (DWARFCompileUnit *cu : candidates) {
+    if (memory_size <= memory_limit)
+      break;
+    if (cu->GetDIEsInUse())
+      continue;
+    const size_t cu_memory_size = cu->GetDIEMemorySize();
+    cu->ClearDIEs(true);
+    cu->SetDIEsEvicted();
+    memory_size -= cu_memory_size - cu->GetDIEMemorySize();
+    ++num_evicted;
+  }
+
+  m_num_die_evictions += num_evicted;
+  Log *log(LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO));
+  if (log)
+    log->Printf("DWARFDebugInfo::EvictDIEs (%" PRIu64
+                ") freed the DIEs of %" PRIu64 " compile units, %" PRIu64
+                " bytes remain",
+                memory_limit, (uint64_t)num_evicted, memory_size);
+  return num_evicted;
+}
+
 bool DWARFDebugInfo::ContainsCompileUnit(const DWARFCompileUnit *cu) const {
   // Not a verify efficient function, but it is handy for use in assertions
   // to make sure that a compile unit comes from a debug information file.
@@ -10,6 +10,7 @@
 #ifndef SymbolFileDWARF_DWARFDebugInfo_h_
 #define SymbolFileDWARF_DWARFDebugInfo_h_
 
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -60,6 +61,24 @@ public:
 
   DWARFDebugAranges &GetCompileUnitAranges();
 
+  //----------------------------------------------------------------------
+  /// Free the parsed DIEs of the least recently used compile units until
+  /// the DIEs of all compile units use at most \a memory_limit bytes.
+  /// Compile units whose DIEs are in use, see
+  /// DWARFCompileUnit::ScopedDIEUse, are skipped. Freed DIEs are parsed
+  /// again the next time they are needed.
+  ///
+  /// @return
+  ///     The number of compile units whose DIEs were freed.
+  //----------------------------------------------------------------------
+  size_t EvictDIEs(uint64_t memory_limit);
+
+  uint64_t GetNumDIEEvictions() const { return m_num_die_evictions; }
+
+  uint64_t GetNumDIEReparses() const { return m_num_die_reparses; }
+
+  void DIEsWereReparsed() { ++m_num_die_reparses; }
+
 protected:
   static bool OffsetLessThanCompileUnitOffset(dw_offset_t offset,
                                               const DWARFCompileUnitSP &cu_sp);
@@ -73,6 +92,8 @@ protected:
   CompileUnitColl m_compile_units;
   std::unique_ptr<DWARFDebugAranges>
       m_cu_aranges_ap; // A quick address to compile unit table
+  std::atomic<uint64_t> m_num_die_evictions{0};
+  std::atomic<uint64_t> m_num_die_reparses{0};
 
 private:
   // All parsing needs to be done partially any managed by this class as
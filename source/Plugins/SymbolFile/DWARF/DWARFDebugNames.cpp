@@ -0,0 +1,259 @@
+//===-- DWARFDebugNames.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFDebugNames.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+DWARFDebugNames::DWARFDebugNames(const DWARFDataExtractor &data,
+                                 const DWARFDataExtractor &string_table)
+    : m_data(data), m_string_table(string_table), m_name_indexes() {
+  lldb::offset_t offset = 0;
+  while (m_data.ValidOffsetForDataOfSize(offset, 4)) {
+    uint8_t offset_size = 4;
+    uint64_t unit_length = m_data.GetU32(&offset);
+    if (unit_length == 0xffffffff) {
+      offset_size = 8;
+      unit_length = m_data.GetU64(&offset);
+    } else if (unit_length >= 0xfffffff0) {
+      break; // Reserved values
+    }
+    if (unit_length == 0 ||
+        !m_data.ValidOffsetForDataOfSize(offset, unit_length))
+      break;
+    const lldb::offset_t end = offset + unit_length;
+
+    NameIndex index;
+    if (ParseNameIndex(offset, end, offset_size, index))
+      m_name_indexes.push_back(std::move(index));
+    offset = end;
+  }
+}
+
+bool DWARFDebugNames::ParseNameIndex(lldb::offset_t offset, lldb::offset_t end,
+                                     uint8_t offset_size,
+                                     NameIndex &index) const {
+  const uint16_t version = m_data.GetU16(&offset);
+  if (version != 5)
+    return false;
+  m_data.GetU16(&offset); // Padding
+  const uint32_t cu_count = m_data.GetU32(&offset);
+  const uint32_t local_tu_count = m_data.GetU32(&offset);
+  const uint32_t foreign_tu_count = m_data.GetU32(&offset);
+  index.bucket_count = m_data.GetU32(&offset);
+  index.name_count = m_data.GetU32(&offset);
+  const uint32_t abbrev_table_size = m_data.GetU32(&offset);
+  const uint32_t augmentation_size = m_data.GetU32(&offset);
+  // The augmentation string is already padded to a multiple of 4 bytes.
+  offset += augmentation_size;
+  index.offset_size = offset_size;
+
+  // Make sure all the tables fit before reading any of them.
+  const uint64_t tables_size =
+      ((uint64_t)cu_count + local_tu_count) * offset_size +
+      (uint64_t)foreign_tu_count * 8 + (uint64_t)index.bucket_count * 4 +
+      (index.bucket_count ? (uint64_t)index.name_count * 4 : 0) +
+      (uint64_t)index.name_count * offset_size * 2 + abbrev_table_size;
+  if (offset > end || tables_size > end - offset)
+    return false;
+
+  index.cu_offsets.reserve(cu_count);
+  for (uint32_t i = 0; i < cu_count; ++i)
+    index.cu_offsets.push_back(m_data.GetMaxU64(&offset, offset_size));
+  // Type units aren't supported, skip their lists.
+  offset += local_tu_count * offset_size + foreign_tu_count * 8;
+
+  index.buckets_offset = offset;
+  offset += index.bucket_count * 4;
+  index.hashes_offset = offset;
+  if (index.bucket_count)
+    offset += index.name_count * 4;
+  index.string_offsets_offset = offset;
+  offset += index.name_count * offset_size;
+  index.entry_offsets_offset = offset;
+  offset += index.name_count * offset_size;
+
+  index.entry_pool_offset = offset + abbrev_table_size;
+  while (offset < index.entry_pool_offset) {
+    const uint64_t code = m_data.GetULEB128(&offset);
+    if (code == 0)
+      break;
+    Abbrev &abbrev = index.abbrevs[code];
+    abbrev.tag = m_data.GetULEB128(&offset);
+    while (offset < index.entry_pool_offset) {
+      const uint16_t index_attr = m_data.GetULEB128(&offset);
+      const dw_form_t form = m_data.GetULEB128(&offset);
+      if (index_attr == 0 && form == 0)
+        break;
+      abbrev.attributes.push_back(std::make_pair(index_attr, form));
+    }
+  }
+  return !index.abbrevs.empty();
+}
+
+void DWARFDebugNames::GetCompileUnitOffsets(
+    std::vector<dw_offset_t> &cu_offsets) const {
+  for (const NameIndex &index : m_name_indexes)
+    cu_offsets.insert(cu_offsets.end(), index.cu_offsets.begin(),
+                      index.cu_offsets.end());
+}
+
+uint32_t DWARFDebugNames::HashName(llvm::StringRef name) {
+  uint32_t h = 5381;
+  for (unsigned char c : name) {
+    if (c >= 'A' && c <= 'Z')
+      c = c - 'A' + 'a';
+    h = ((h << 5) + h) + c;
+  }
+  return h;
+}
+
+size_t DWARFDebugNames::FindByName(llvm::StringRef name,
+                                   EntryArray &entries) const {
+  if (name.empty())
+    return 0;
+
+  // Only ASCII is folded by HashName(). Names with other characters are
+  // rare enough that we just compare them against all names.
+  bool use_hash_table = true;
+  for (unsigned char c : name) {
+    if (c > 0x7f) {
+      use_hash_table = false;
+      break;
+    }
+  }
+  const uint32_t hash = HashName(name);
+
+  const size_t old_size = entries.size();
+  for (const NameIndex &index : m_name_indexes) {
+    if (!use_hash_table || index.bucket_count == 0) {
+      for (uint32_t name_idx = 1; name_idx <= index.name_count; ++name_idx)
+        if (GetName(index, name_idx) == name)
+          AppendEntries(index, name_idx, entries);
+      continue;
+    }
+
+    const uint32_t bucket = hash % index.bucket_count;
+    lldb::offset_t offset = index.buckets_offset + bucket * 4;
+    // Names are numbered from one, zero means the bucket is empty.
+    const uint32_t first_name_idx = m_data.GetU32(&offset);
+    if (first_name_idx == 0)
+      continue;
+    // All names in a bucket are next to each other in the hash and name
+    // tables.
+    for (uint32_t name_idx = first_name_idx; name_idx <= index.name_count;
+         ++name_idx) {
+      offset = index.hashes_offset + (name_idx - 1) * 4;
+      const uint32_t name_hash = m_data.GetU32(&offset);
+      if (name_hash % index.bucket_count != bucket)
+        break;
+      if (name_hash == hash && GetName(index, name_idx) == name)
+        AppendEntries(index, name_idx, entries);
+    }
+  }
+  return entries.size() - old_size;
+}
+
+llvm::StringRef DWARFDebugNames::GetName(const NameIndex &index,
+                                         uint32_t name_idx) const {
+  lldb::offset_t offset =
+      index.string_offsets_offset + (name_idx - 1) * index.offset_size;
+  const char *name =
+      m_string_table.PeekCStr(m_data.GetMaxU64(&offset, index.offset_size));
+  return name ? llvm::StringRef(name) : llvm::StringRef();
+}
+
+void DWARFDebugNames::AppendEntries(const NameIndex &index, uint32_t name_idx,
+                                    EntryArray &entries) const {
+  lldb::offset_t offset =
+      index.entry_offsets_offset + (name_idx - 1) * index.offset_size;
+  offset = index.entry_pool_offset +
+           m_data.GetMaxU64(&offset, index.offset_size);
+
+  // The entries of a name end with a zero abbreviation code.
+  while (m_data.ValidOffset(offset)) {
+    const uint64_t code = m_data.GetULEB128(&offset);
+    if (code == 0)
+      break;
+    auto pos = index.abbrevs.find(code);
+    if (pos == index.abbrevs.end())
+      break; // Corrupt entry pool, we can't tell how large the entry is
+
+    const Abbrev &abbrev = pos->second;
+    // The compile unit index can be left out if there is only one.
+    uint64_t cu_idx = index.cu_offsets.size() == 1 ? 0 : UINT64_MAX;
+    uint64_t die_offset = UINT64_MAX;
+    bool in_type_unit = false;
+    for (const auto &attribute : abbrev.attributes) {
+      uint64_t value = 0;
+      if (!ReadFormValue(attribute.second, &offset, value))
+        return;
+      switch (attribute.first) {
+      case eIndexCompileUnit:
+        cu_idx = value;
+        break;
+      case eIndexTypeUnit:
+        in_type_unit = true;
+        break;
+      case eIndexDIEOffset:
+        die_offset = value;
+        break;
+      default:
+        break;
+      }
+    }
+    if (in_type_unit || cu_idx >= index.cu_offsets.size() ||
+        die_offset == UINT64_MAX)
+      continue;
+
+    Entry entry;
+    entry.cu_offset = index.cu_offsets[cu_idx];
+    entry.die_offset = die_offset;
+    entry.tag = abbrev.tag;
+    entries.push_back(entry);
+  }
+}
+
+bool DWARFDebugNames::ReadFormValue(dw_form_t form, lldb::offset_t *offset_ptr,
+                                    uint64_t &value) const {
+  switch (form) {
+  case DW_FORM_flag_present:
+    value = 1;
+    return true;
+  case DW_FORM_flag:
+  case DW_FORM_data1:
+  case DW_FORM_ref1:
+    value = m_data.GetU8(offset_ptr);
+    return true;
+  case DW_FORM_data2:
+  case DW_FORM_ref2:
+    value = m_data.GetU16(offset_ptr);
+    return true;
+  case DW_FORM_data4:
+  case DW_FORM_ref4:
+    value = m_data.GetU32(offset_ptr);
+    return true;
+  case DW_FORM_data8:
+  case DW_FORM_ref8:
+  case DW_FORM_ref_sig8:
+    value = m_data.GetU64(offset_ptr);
+    return true;
+  case DW_FORM_udata:
+  case DW_FORM_ref_udata:
+    value = m_data.GetULEB128(offset_ptr);
+    return true;
+  case DW_FORM_sdata:
+    value = m_data.GetSLEB128(offset_ptr);
+    return true;
+  default:
+    // No other forms are allowed for index attributes.
+    return false;
+  }
+}
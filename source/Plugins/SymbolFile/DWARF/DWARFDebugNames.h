@@ -0,0 +1,115 @@
+//===-- DWARFDebugNames.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFDebugNames_h_
+#define SymbolFileDWARF_DWARFDebugNames_h_
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "lldb/Core/dwarf.h"
+#include "lldb/lldb-defines.h"
+#include "llvm/ADT/StringRef.h"
+
+#include "DWARFDataExtractor.h"
+
+//----------------------------------------------------------------------
+// DWARFDebugNames
+//
+// A reader for the DWARF 5 .debug_names name index. The section holds
+// one or more name indexes (linkers that don't merge them leave one per
+// object file), each with its own compile unit list, hash table, name
+// table, abbreviation table and entry pool. Looking up a name only reads
+// the index and the string table, not the .debug_info of the compile
+// units.
+//----------------------------------------------------------------------
+class DWARFDebugNames {
+public:
+  // The DW_IDX_xxx index attributes.
+  enum IndexAttribute : uint16_t {
+    eIndexCompileUnit = 1u, // Index of the compile unit in the CU list
+    eIndexTypeUnit = 2u,    // Index of the type unit in the TU lists
+    eIndexDIEOffset = 3u,   // DIE offset relative to the start of the unit
+    eIndexParent = 4u,      // Entry of the parent DIE in the entry pool
+    eIndexTypeHash = 5u     // Hash of the type signature
+  };
+
+  struct Entry {
+    dw_offset_t cu_offset;  // .debug_info offset of the compile unit header
+    dw_offset_t die_offset; // DIE offset relative to the compile unit
+    dw_tag_t tag;
+  };
+
+  typedef std::vector<Entry> EntryArray;
+
+  DWARFDebugNames(const lldb_private::DWARFDataExtractor &data,
+                  const lldb_private::DWARFDataExtractor &string_table);
+
+  bool IsValid() const { return !m_name_indexes.empty(); }
+
+  //------------------------------------------------------------------
+  /// Append the .debug_info offsets of all the compile units that are
+  /// covered by the name indexes.
+  //------------------------------------------------------------------
+  void GetCompileUnitOffsets(std::vector<dw_offset_t> &cu_offsets) const;
+
+  //------------------------------------------------------------------
+  /// Append the entries for all DIEs named \a name in compile units to
+  /// \a entries. Entries for DIEs in type units are skipped.
+  ///
+  /// @return
+  ///     The number of entries that were appended.
+  //------------------------------------------------------------------
+  size_t FindByName(llvm::StringRef name, EntryArray &entries) const;
+
+  //------------------------------------------------------------------
+  /// The case folding DJB hash that .debug_names uses.
+  //------------------------------------------------------------------
+  static uint32_t HashName(llvm::StringRef name);
+
+protected:
+  struct Abbrev {
+    dw_tag_t tag;
+    std::vector<std::pair<uint16_t, dw_form_t>> attributes;
+  };
+
+  struct NameIndex {
+    uint8_t offset_size; // 4 for 32 bit DWARF, 8 for 64 bit DWARF
+    std::vector<dw_offset_t> cu_offsets;
+    uint32_t bucket_count;
+    uint32_t name_count;
+    lldb::offset_t buckets_offset;
+    lldb::offset_t hashes_offset;
+    lldb::offset_t string_offsets_offset;
+    lldb::offset_t entry_offsets_offset;
+    lldb::offset_t entry_pool_offset;
+    std::map<uint64_t, Abbrev> abbrevs;
+  };
+
+  bool ParseNameIndex(lldb::offset_t offset, lldb::offset_t end,
+                      uint8_t offset_size, NameIndex &index) const;
+
+  llvm::StringRef GetName(const NameIndex &index, uint32_t name_idx) const;
+
+  void AppendEntries(const NameIndex &index, uint32_t name_idx,
+                     EntryArray &entries) const;
+
+  bool ReadFormValue(dw_form_t form, lldb::offset_t *offset_ptr,
+                     uint64_t &value) const;
+
+  const lldb_private::DWARFDataExtractor &m_data;
+  const lldb_private::DWARFDataExtractor &m_string_table;
+  std::vector<NameIndex> m_name_indexes;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DWARFDebugNames);
+};
+
+#endif // SymbolFileDWARF_DWARFDebugNames_h_
@@ -10,6 +10,7 @@
 #include "NameToDIE.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
@@ -80,3 +81,49 @@ void NameToDIE::Append(const NameToDIE &other) {
                  other.m_map.GetValueAtIndexUnchecked(i));
   }
 }
+
+void NameToDIE::Encode(Stream &strm) const {
+  const uint32_t size = m_map.GetSize();
+  uint32_t num_names = 0;
+  for (uint32_t i = 0; i < size; ++i) {
+    if (i == 0 || m_map.GetCStringAtIndexUnchecked(i) !=
+                      m_map.GetCStringAtIndexUnchecked(i - 1))
+      ++num_names;
+  }
+  strm.PutHex32(num_names);
+
+  uint32_t i = 0;
+  while (i < size) {
+    ConstString name = m_map.GetCStringAtIndexUnchecked(i);
+    uint32_t end = i + 1;
+    while (end < size && m_map.GetCStringAtIndexUnchecked(end) == name)
+      ++end;
+    strm.PutCString(name.GetStringRef());
+    strm.PutHex32(end - i);
+    for (; i < end; ++i) {
+      const DIERef &die_ref = m_map.GetValueRefAtIndexUnchecked(i);
+      strm.PutHex32(die_ref.cu_offset);
+      strm.PutHex32(die_ref.die_offset);
+    }
+  }
+}
+
+bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr) {
+  const uint32_t num_names = data.GetU32(offset_ptr);
+  for (uint32_t i = 0; i < num_names; ++i) {
+    const char *cstr = data.GetCStr(offset_ptr);
+    if (cstr == nullptr)
+      return false;
+    ConstString name(cstr);
+    const uint32_t num_refs = data.GetU32(offset_ptr);
+    if (!data.ValidOffsetForDataOfSize(*offset_ptr,
+                                       num_refs * 2 * sizeof(uint32_t)))
+      return false;
+    for (uint32_t j = 0; j < num_refs; ++j) {
+      const dw_offset_t cu_offset = data.GetU32(offset_ptr);
+      const dw_offset_t die_offset = data.GetU32(offset_ptr);
+      m_map.Append(name, DIERef(cu_offset, die_offset));
+    }
+  }
+  return true;
+}
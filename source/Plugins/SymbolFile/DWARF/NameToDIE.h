@@ -19,6 +19,10 @@
 
 class SymbolFileDWARF;
 
+namespace lldb_private {
+class DataExtractor;
+}
+
 class NameToDIE {
 public:
   NameToDIE() : m_map() {}
@@ -33,6 +37,8 @@ public:
 
   void Finalize();
 
+  void Clear() { m_map.Clear(); }
+
   size_t Find(const lldb_private::ConstString &name,
               DIEArray &info_array) const;
 
@@ -47,6 +53,21 @@ public:
                              const DIERef &die_ref)> const
               &callback) const;
 
+  //------------------------------------------------------------------
+  // Serialize a finalized map so that it can be saved in the index
+  // cache. Entries are grouped by name so each unique name is only
+  // written once.
+  //------------------------------------------------------------------
+  void Encode(lldb_private::Stream &strm) const;
+
+  //------------------------------------------------------------------
+  // Append the entries from data produced by Encode(). Finalize() must
+  // be called after decoding since the sort order of ConstString values
+  // differs between debug sessions.
+  //------------------------------------------------------------------
+  bool Decode(const lldb_private::DataExtractor &data,
+              lldb::offset_t *offset_ptr);
+
 protected:
   lldb_private::UniqueCStringMap<DIERef> m_map;
 };
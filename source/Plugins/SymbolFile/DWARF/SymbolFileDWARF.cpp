@@ -13,6 +13,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/Threading.h"
 
+#include "lldb/Core/Debugger.h"
 #include "lldb/Core/Mangled.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleList.h"
@@ -23,6 +24,8 @@
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/Value.h"
 #include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Endian.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/StreamString.h"
 #include "lldb/Utility/Timer.h"
@@ -31,6 +34,8 @@
 
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/HostThread.h"
+#include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Host/Symbols.h"
 
 #include "lldb/Interpreter/OptionValueFileSpecList.h"
@@ -46,7 +51,9 @@
 #include "lldb/Symbol/DebugMacros.h"
 #include "lldb/Symbol/LineTable.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolVendor.h"
+#include "lldb/Symbol/Symtab.h"
 #include "lldb/Symbol/TypeMap.h"
 #include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Symbol/VariableList.h"
@@ -55,6 +62,8 @@
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 
 #include "lldb/Target/Language.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/TargetList.h"
 
 #include "lldb/Host/TaskPool.h"
 
@@ -67,6 +76,7 @@
 #include "DWARFDebugInfo.h"
 #include "DWARFDebugLine.h"
 #include "DWARFDebugMacro.h"
+#include "DWARFDebugNames.h"
 #include "DWARFDebugPubnames.h"
 #include "DWARFDebugRanges.h"
 #include "DWARFDeclContext.h"
@@ -78,7 +88,11 @@
 
 #include "llvm/Support/FileSystem.h"
 
+#include <algorithm>
+#include <chrono>
 #include <map>
+#include <set>
+#include <thread>
 
 #include <ctype.h>
 #include <string.h>
@@ -119,9 +133,16 @@ PropertyDefinition g_properties[] = {
     {"comp-dir-symlink-paths", OptionValue::eTypeFileSpecList, true, 0, nullptr,
      nullptr, "If the DW_AT_comp_dir matches any of these paths the symbolic "
               "links will be resolved at DWARF parse time."},
+    {"lazy-index", OptionValue::eTypeBoolean, true, false, nullptr, nullptr,
+     "If there are no accelerator tables, look up functions and global "
+     "variables by indexing only the compile units that the symbol table, "
+     ".debug_aranges and .debug_pubnames point to, and index the rest of "
+     "the DWARF on a background thread. Until the background index "
+     "completes, lookups can miss inlined functions and variables that have "
+     "no symbol. Breakpoints are updated when it completes."},
     {nullptr, OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr}};
 
-enum { ePropertySymLinkPaths };
+enum { ePropertySymLinkPaths, ePropertyLazyIndex };
 
 class PluginProperties : public Properties {
 public:
@@ -141,6 +162,12 @@ public:
     assert(option_value);
     return option_value->GetCurrentValue();
   }
+
+  bool GetLazyIndex() const {
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        nullptr, ePropertyLazyIndex,
+        g_properties[ePropertyLazyIndex].default_uint_value != 0);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> SymbolFileDWARFPropertiesSP;
@@ -414,11 +441,31 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile *objfile)
       m_objc_class_selectors_index(), m_global_index(), m_type_index(),
       m_namespace_index(), m_indexed(false), m_using_apple_tables(false),
       m_initialized_swift_modules(false), m_reported_missing_sdk(false),
-      m_fetched_external_modules(false),
+      m_fetched_external_modules(false), m_background_index_started(false),
+      m_cu_indexed(),
       m_supports_DW_AT_APPLE_objc_complete_type(eLazyBoolCalculate), m_ranges(),
-      m_unique_ast_type_map() {}
-
-SymbolFileDWARF::~SymbolFileDWARF() {}
+      m_unique_ast_type_map(),
+      m_die_eviction_state(std::make_shared<DIEEvictionState>()) {}
+
+SymbolFileDWARF::~SymbolFileDWARF() {
+  m_background_index_cancel = true;
+  {
+    std::lock_guard<std::mutex> guard(m_die_eviction_state->mutex);
+    m_die_eviction_state->cancel = true;
+  }
+  m_die_eviction_state->cond.notify_all();
+  // The background threads may drop the last reference to the module,
+  // which destroys us on that thread.
+  for (HostThread *thread :
+       {&m_background_index_thread, &m_die_eviction_thread}) {
+    if (!thread->IsJoinable())
+      continue;
+    if (thread->EqualsThread(Host::GetCurrentThread()))
+      thread->Release();
+    else
+      thread->Join(nullptr);
+  }
+}
 
 static const ConstString &GetDWARFMachOSegmentName() {
   static ConstString g_dwarf_section_name("__DWARF");
@@ -505,6 +552,97 @@ void SymbolFileDWARF::InitializeObject() {
     else
       m_apple_objc_ap.reset();
   }
+
+  // The Apple tables are preferred if there are any. A .debug_names index
+  // that doesn't cover all compile units is ignored, we would have to
+  // index the remaining ones manually anyway.
+  if (!m_using_apple_tables) {
+    get_debug_names_data();
+    if (m_data_debug_names.m_data.GetByteSize() > 0) {
+      m_debug_names_ap.reset(new DWARFDebugNames(m_data_debug_names.m_data,
+                                                 get_debug_str_data()));
+      if (!m_debug_names_ap->IsValid() || !DebugNamesCoversAllCompileUnits())
+        m_debug_names_ap.reset();
+    }
+  }
+}
+
+bool SymbolFileDWARF::DebugNamesCoversAllCompileUnits() {
+  DWARFDebugInfo *debug_info = DebugInfo();
+  if (!debug_info)
+    return false;
+  const size_t num_compile_units = debug_info->GetNumCompileUnits();
+  if (num_compile_units == 0)
+    return false;
+
+  std::vector<dw_offset_t> cu_offsets;
+  m_debug_names_ap->GetCompileUnitOffsets(cu_offsets);
+  std::sort(cu_offsets.begin(), cu_offsets.end());
+  for (size_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx) {
+    DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+    if (!dwarf_cu || !std::binary_search(cu_offsets.begin(), cu_offsets.end(),
+                                         dwarf_cu->GetOffset()))
+      return false;
+  }
+  return true;
+}
+
+// The DIE tags that each kind of lookup in the .debug_names index wants,
+// these match the tags that Index() puts in the corresponding indexes.
+static bool IsFunctionTag(dw_tag_t tag) {
+  return tag == DW_TAG_subprogram || tag == DW_TAG_inlined_subroutine;
+}
+
+static bool IsVariableTag(dw_tag_t tag) { return tag == DW_TAG_variable; }
+
+static bool IsNamespaceTag(dw_tag_t tag) { return tag == DW_TAG_namespace; }
+
+static bool IsTypeTag(dw_tag_t tag) {
+  switch (tag) {
+  case DW_TAG_array_type:
+  case DW_TAG_base_type:
+  case DW_TAG_class_type:
+  case DW_TAG_constant:
+  case DW_TAG_enumeration_type:
+  case DW_TAG_string_type:
+  case DW_TAG_structure_type:
+  case DW_TAG_subroutine_type:
+  case DW_TAG_typedef:
+  case DW_TAG_union_type:
+  case DW_TAG_unspecified_type:
+    return true;
+  default:
+    return false;
+  }
+}
+
+size_t
+SymbolFileDWARF::FindInDebugNames(llvm::StringRef name,
+                                  llvm::function_ref<bool(dw_tag_t)> tag_filter,
+                                  DIEArray &die_offsets) {
+  DWARFDebugInfo *debug_info = DebugInfo();
+  if (!m_debug_names_ap || !debug_info)
+    return 0;
+
+  DWARFDebugNames::EntryArray entries;
+  m_debug_names_ap->FindByName(name, entries);
+  const size_t old_size = die_offsets.size();
+  for (const DWARFDebugNames::Entry &entry : entries) {
+    if (!tag_filter(entry.tag))
+      continue;
+    DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnit(entry.cu_offset);
+    if (!dwarf_cu)
+      continue;
+    // With split DWARF the DIE offset is relative to the compile unit in
+    // the .dwo file. Only the compile unit DIE is needed to find that.
+    dw_offset_t die_base_offset = entry.cu_offset;
+    dwarf_cu->ExtractDIEsIfNeeded(true);
+    if (SymbolFileDWARFDwo *dwo_symbol_file = dwarf_cu->GetDwoSymbolFile())
+      die_base_offset = dwo_symbol_file->GetCompileUnit()->GetOffset();
+    die_offsets.push_back(
+        DIERef(entry.cu_offset, die_base_offset + entry.die_offset));
+  }
+  return die_offsets.size() - old_size;
 }
 
 bool SymbolFileDWARF::SupportedVersion(uint16_t version) {
@@ -704,6 +842,15 @@ const DWARFDataExtractor &SymbolFileDWARF::get_apple_objc_data() {
   return GetCachedSectionData(eSectionTypeDWARFAppleObjC, m_data_apple_objc);
 }
 
+const DWARFDataExtractor &SymbolFileDWARF::get_debug_names_data() {
+  return GetCachedSectionData(eSectionTypeDWARFDebugNames, m_data_debug_names);
+}
+
+const DWARFDataExtractor &SymbolFileDWARF::get_debug_pubnames_data() {
+  return GetCachedSectionData(eSectionTypeDWARFDebugPubNames,
+                              m_data_debug_pubnames);
+}
+
 DWARFDebugAbbrev *SymbolFileDWARF::DebugAbbrev() {
   if (m_abbr.get() == NULL) {
     const DWARFDataExtractor &debug_abbrev_data = get_debug_abbrev_data();
@@ -876,6 +1023,7 @@ CompUnitSP SymbolFileDWARF::ParseCompileUnitAtIndex(uint32_t cu_idx) {
 Function *SymbolFileDWARF::ParseCompileUnitFunction(const SymbolContext &sc,
                                                     const DWARFDIE &die) {
   if (die.IsValid()) {
+    DWARFCompileUnit::ScopedDIEUse die_use(die.GetCU());
     TypeSystem *type_system =
         GetTypeSystemForLanguage(die.GetCU()->GetLanguageType());
 
@@ -1522,6 +1670,7 @@ bool SymbolFileDWARF::CompleteType(CompilerType &compiler_type) {
 
   DWARFDIE dwarf_die = GetDIE(die_it->getSecond());
   if (dwarf_die) {
+    DWARFCompileUnit::ScopedDIEUse die_use(dwarf_die.GetCU());
     // Once we start resolving this type, remove it from the forward declaration
     // map in case anyone child members or other types require this type to get
     // resolved.
@@ -1530,7 +1679,7 @@ bool SymbolFileDWARF::CompleteType(CompilerType &compiler_type) {
     // are done.
     GetForwardDeclClangTypeToDie().erase(die_it);
 
-    Type *type = GetDIEToType().lookup(dwarf_die.GetDIE());
+    Type *type = GetDIEToType().lookup(dwarf_die.GetID());
 
     Log *log(LogChannelDWARF::GetLogIfAny(DWARF_LOG_DEBUG_INFO |
                                           DWARF_LOG_TYPE_COMPLETION));
@@ -1541,8 +1690,10 @@ bool SymbolFileDWARF::CompleteType(CompilerType &compiler_type) {
           type->GetName().AsCString());
     assert(compiler_type);
     DWARFASTParser *dwarf_ast = dwarf_die.GetDWARFParser();
-    if (dwarf_ast)
+    if (dwarf_ast) {
+      ++m_num_types_completed;
       return dwarf_ast->CompleteTypeFromDWARF(dwarf_die, type, compiler_type);
+    }
   }
   return false;
 }
@@ -2089,6 +2240,131 @@ SymbolFileDWARF::ResolveTypeFromAttribute(const DWARFFormValue &type_attr) {
   return lldb::TypeSP();
 }
 
+static uint64_t GetDWARFSectionsSize(const SectionList &section_list) {
+  uint64_t size = 0;
+  const size_t num_sections = section_list.GetSize();
+  for (size_t idx = 0; idx < num_sections; ++idx) {
+    SectionSP section_sp = section_list.GetSectionAtIndex(idx);
+    const SectionType section_type = section_sp->GetType();
+    if ((section_type >= eSectionTypeDWARFDebugAbbrev &&
+         section_type <= eSectionTypeDWARFAppleObjC) ||
+        section_type == eSectionTypeDWARFDebugNames)
+      size += section_sp->GetFileSize();
+    size += GetDWARFSectionsSize(section_sp->GetChildren());
+  }
+  return size;
+}
+
+uint64_t SymbolFileDWARF::GetDebugInfoSize() {
+  ObjectFile *obj_file = GetObjectFile();
+  if (!obj_file)
+    return 0;
+  SectionList *section_list = obj_file->GetSectionList();
+  if (!section_list)
+    return 0;
+  return GetDWARFSectionsSize(*section_list);
+}
+
+uint64_t SymbolFileDWARF::GetDebugInfoMemorySize() {
+  // Don't parse the compile unit headers just to report that nothing was
+  // parsed.
+  if (!m_info)
+    return 0;
+  std::lock_guard<std::recursive_mutex> guard(
+      GetObjectFile()->GetModule()->GetMutex());
+  uint64_t size = 0;
+  const size_t num_compile_units = m_info->GetNumCompileUnits();
+  for (size_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx) {
+    if (DWARFCompileUnit *dwarf_cu = m_info->GetCompileUnitAtIndex(cu_idx))
+      size += dwarf_cu->GetDIEMemorySize();
+  }
+  return size;
+}
+
+uint64_t SymbolFileDWARF::GetNumDebugInfoEvictions() {
+  return m_info ? m_info->GetNumDIEEvictions() : 0;
+}
+
+uint64_t SymbolFileDWARF::GetNumDebugInfoReparses() {
+  return m_info ? m_info->GetNumDIEReparses() : 0;
+}
+
+void SymbolFileDWARF::DIEsWereExtracted(uint64_t num_bytes, bool reparsed) {
+  if (reparsed && m_info)
+    m_info->DIEsWereReparsed();
+
+  // The debug map symbol file locks the executable module, not the object
+  // file module we would lock to free DIEs.
+  if (m_debug_map_symfile)
+    return;
+  const uint64_t memory_limit =
+      ModuleList::GetGlobalModuleListProperties().GetDWARFDIEMemoryLimit();
+  if (memory_limit == 0)
+    return;
+  // Walking all the compile units isn't free, so only check the limit
+  // again once a good part of it has been parsed since the last check.
+  if ((m_die_bytes_since_eviction += num_bytes) < memory_limit / 4)
+    return;
+  m_die_bytes_since_eviction = 0;
+
+  // DIEs are being parsed on this thread right now, possibly by a caller
+  // that holds DWARFDIE objects, so free them later from the eviction
+  // thread once the module lock is available.
+  std::lock_guard<std::mutex> guard(m_die_eviction_state->mutex);
+  m_die_eviction_state->pending = true;
+  if (m_die_eviction_thread.IsJoinable()) {
+    m_die_eviction_state->cond.notify_one();
+    return;
+  }
+  m_die_eviction_state->module_wp = m_obj_file->GetModule();
+  auto state_sp = new DIEEvictionStateSP(m_die_eviction_state);
+  m_die_eviction_thread = ThreadLauncher::LaunchThread(
+      "<lldb.dwarf.evict>", DIEEvictionThread, state_sp, nullptr);
+  if (!m_die_eviction_thread.IsJoinable())
+    delete state_sp;
+}
+
+void SymbolFileDWARF::EvictDIEs() {
+  const uint64_t memory_limit =
+      ModuleList::GetGlobalModuleListProperties().GetDWARFDIEMemoryLimit();
+  if (memory_limit == 0 || !m_info)
+    return;
+  m_info->EvictDIEs(memory_limit);
+}
+
+lldb::thread_result_t
+SymbolFileDWARF::DIEEvictionThread(lldb::thread_arg_t arg) {
+  std::unique_ptr<DIEEvictionStateSP> state_up(
+      static_cast<DIEEvictionStateSP *>(arg));
+  DIEEvictionStateSP state = *state_up;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->cond.wait(lock,
+                       [&state] { return state->pending || state->cancel; });
+      if (state->cancel)
+        return NULL;
+      state->pending = false;
+    }
+
+    ModuleSP module_sp(state->module_wp.lock());
+    if (!module_sp)
+      return NULL;
+    // The destructor may hold the module lock while waiting for us.
+    std::unique_lock<std::recursive_mutex> module_lock(module_sp->GetMutex(),
+                                                       std::defer_lock);
+    while (!module_lock.try_lock()) {
+      if (state->cancel)
+        return NULL;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    SymbolVendor *sym_vendor = module_sp->GetSymbolVendor(false);
+    SymbolFile *sym_file = sym_vendor ? sym_vendor->GetSymbolFile() : nullptr;
+    if (sym_file && sym_file->GetPluginName() == GetPluginNameStatic())
+      static_cast<SymbolFileDWARF *>(sym_file)->EvictDIEs();
+  }
+}
+
 void SymbolFileDWARF::PreloadSymbols() {
   std::lock_guard<std::recursive_mutex> guard(
       GetObjectFile()->GetModule()->GetMutex());
@@ -2099,113 +2375,31 @@ void SymbolFileDWARF::Index() {
   if (m_indexed)
     return;
   m_indexed = true;
+  ElapsedTime elapsed(m_index_time);
   static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
   Timer scoped_timer(
       func_cat, "SymbolFileDWARF::Index (%s)",
       GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"));
 
+  // The cached index covers all compile units, it can't be merged with
+  // the compile units that lazy lookups already indexed.
+  if (m_cu_indexed.empty() && LoadIndexFromCache())
+    return;
+
   DWARFDebugInfo *debug_info = DebugInfo();
   if (debug_info) {
     const uint32_t num_compile_units = GetNumCompileUnits();
     if (num_compile_units == 0)
       return;
 
-    std::vector<NameToDIE> function_basename_index(num_compile_units);
-    std::vector<NameToDIE> function_fullname_index(num_compile_units);
-    std::vector<NameToDIE> function_method_index(num_compile_units);
-    std::vector<NameToDIE> function_selector_index(num_compile_units);
-    std::vector<NameToDIE> objc_class_selectors_index(num_compile_units);
-    std::vector<NameToDIE> global_index(num_compile_units);
-    std::vector<NameToDIE> type_index(num_compile_units);
-    std::vector<NameToDIE> namespace_index(num_compile_units);
-
-    // std::vector<bool> might be implemented using bit test-and-set, so use
-    // uint8_t instead.
-    std::vector<uint8_t> clear_cu_dies(num_compile_units, false);
-    auto parser_fn = [debug_info, &function_basename_index,
-                      &function_fullname_index, &function_method_index,
-                      &function_selector_index, &objc_class_selectors_index,
-                      &global_index, &type_index,
-                      &namespace_index](size_t cu_idx) {
-      DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-      if (dwarf_cu) {
-        dwarf_cu->Index(
-            function_basename_index[cu_idx], function_fullname_index[cu_idx],
-            function_method_index[cu_idx], function_selector_index[cu_idx],
-            objc_class_selectors_index[cu_idx], global_index[cu_idx],
-            type_index[cu_idx], namespace_index[cu_idx]);
-      }
-    };
-
-    auto extract_fn = [debug_info, &clear_cu_dies](size_t cu_idx) {
-      DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-      if (dwarf_cu) {
-        // dwarf_cu->ExtractDIEsIfNeeded(false) will return zero if the
-        // DIEs for a compile unit have already been parsed.
-        if (dwarf_cu->ExtractDIEsIfNeeded(false) > 1)
-          clear_cu_dies[cu_idx] = true;
-      }
-    };
-
-    // Create a task runner that extracts dies for each DWARF compile unit in a
-    // separate thread
-    //----------------------------------------------------------------------
-    // First figure out which compile units didn't have their DIEs already
-    // parsed and remember this.  If no DIEs were parsed prior to this index
-    // function call, we are going to want to clear the CU dies after we
-    // are done indexing to make sure we don't pull in all DWARF dies, but
-    // we need to wait until all compile units have been indexed in case
-    // a DIE in one compile unit refers to another and the indexes accesses
-    // those DIEs.
-    //----------------------------------------------------------------------
-    // If we end up here holding the module lock, the bellow parallel
-    // processing will hang if it needs the same lock. For example, when
-    // calling into GetDwoSymbolFileForCompileUnit() it will try to take
-    // the module lock. rdar://problem/38461035
-    // Disable parallel processing for now.
-    // TaskMapOverInt(0, num_compile_units, extract_fn);
-    for (int i=0; i<num_compile_units; ++i) {
-      extract_fn(i);
-    }
-
-    // Now create a task runner that can index each DWARF compile unit in a
-    // separate
-    // thread so we can index quickly.
-
-    TaskMapOverInt(0, num_compile_units, parser_fn);
-
-    auto finalize_fn = [](NameToDIE &index, std::vector<NameToDIE> &srcs) {
-      for (auto &src : srcs)
-        index.Append(src);
-      index.Finalize();
-    };
-
-    TaskPool::RunTasks(
-        [&]() {
-          finalize_fn(m_function_basename_index, function_basename_index);
-        },
-        [&]() {
-          finalize_fn(m_function_fullname_index, function_fullname_index);
-        },
-        [&]() { finalize_fn(m_function_method_index, function_method_index); },
-        [&]() {
-          finalize_fn(m_function_selector_index, function_selector_index);
-        },
-        [&]() {
-          finalize_fn(m_objc_class_selectors_index, objc_class_selectors_index);
-        },
-        [&]() { finalize_fn(m_global_index, global_index); },
-        [&]() { finalize_fn(m_type_index, type_index); },
-        [&]() { finalize_fn(m_namespace_index, namespace_index); });
-
-    //----------------------------------------------------------------------
-    // Keep memory down by clearing DIEs for any compile units if indexing
-    // caused us to load the compile unit's DIEs.
-    //----------------------------------------------------------------------
+    std::vector<uint32_t> cu_indexes;
     for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx) {
-      if (clear_cu_dies[cu_idx])
-        debug_info->GetCompileUnitAtIndex(cu_idx)->ClearDIEs(true);
+      if (cu_idx >= m_cu_indexed.size() || !m_cu_indexed[cu_idx])
+        cu_indexes.push_back(cu_idx);
     }
+    IndexCompileUnits(cu_indexes);
+
+    SaveIndexToCache();
 
 #if defined(ENABLE_DEBUG_PRINTF)
     StreamFile s(stdout, false);
@@ -2231,6 +2425,464 @@ void SymbolFileDWARF::Index() {
   }
 }
 
+void SymbolFileDWARF::IndexCompileUnits(
+    const std::vector<uint32_t> &cu_indexes) {
+  CompileUnitNames names;
+  ParseCompileUnitNames(cu_indexes, names);
+  AddCompileUnitNames(names);
+}
+
+void SymbolFileDWARF::ParseCompileUnitNames(
+    const std::vector<uint32_t> &cu_indexes, CompileUnitNames &names) {
+  DWARFDebugInfo *debug_info = DebugInfo();
+  const size_t num_units = cu_indexes.size();
+  if (!debug_info || num_units == 0)
+    return;
+
+  const size_t first = names.cu_indexes.size();
+  names.cu_indexes.insert(names.cu_indexes.end(), cu_indexes.begin(),
+                          cu_indexes.end());
+  names.function_basename_index.resize(first + num_units);
+  names.function_fullname_index.resize(first + num_units);
+  names.function_method_index.resize(first + num_units);
+  names.function_selector_index.resize(first + num_units);
+  names.objc_class_selectors_index.resize(first + num_units);
+  names.global_index.resize(first + num_units);
+  names.type_index.resize(first + num_units);
+  names.namespace_index.resize(first + num_units);
+
+  // std::vector<bool> might be implemented using bit test-and-set, so use
+  // uint8_t instead.
+  std::vector<uint8_t> clear_cu_dies(num_units, false);
+  auto parser_fn = [debug_info, &cu_indexes, &names, first](size_t i) {
+    DWARFCompileUnit *dwarf_cu =
+        debug_info->GetCompileUnitAtIndex(cu_indexes[i]);
+    if (dwarf_cu) {
+      const size_t idx = first + i;
+      dwarf_cu->Index(names.function_basename_index[idx],
+                      names.function_fullname_index[idx],
+                      names.function_method_index[idx],
+                      names.function_selector_index[idx],
+                      names.objc_class_selectors_index[idx],
+                      names.global_index[idx], names.type_index[idx],
+                      names.namespace_index[idx]);
+    }
+  };
+
+  auto extract_fn = [debug_info, &cu_indexes, &clear_cu_dies](size_t i) {
+    DWARFCompileUnit *dwarf_cu =
+        debug_info->GetCompileUnitAtIndex(cu_indexes[i]);
+    if (dwarf_cu) {
+      // dwarf_cu->ExtractDIEsIfNeeded(false) will return zero if the
+      // DIEs for a compile unit have already been parsed.
+      if (dwarf_cu->ExtractDIEsIfNeeded(false) > 1)
+        clear_cu_dies[i] = true;
+    }
+  };
+
+  //----------------------------------------------------------------------
+  // Extract the compile unit DIE of every compile unit on this thread
+  // before going parallel. For split DWARF this is where the .dwo (or
+  // .dwp) file for each compile unit gets located and opened, which may
+  // need the module lock that our caller is often already holding. If a
+  // worker thread had to do this it would block on the lock while we
+  // wait for the worker. Once every DWO is open, extracting the rest of
+  // the DIEs only touches per compile unit state and needs no locks.
+  //----------------------------------------------------------------------
+  for (uint32_t cu_idx : cu_indexes) {
+    DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+    if (dwarf_cu)
+      dwarf_cu->ExtractDIEsIfNeeded(true);
+  }
+
+  //----------------------------------------------------------------------
+  // Now create a task runner that extracts the remaining DIEs for each
+  // DWARF compile unit in a separate thread. Remember which compile units
+  // didn't have their DIEs already parsed. If no DIEs were parsed prior
+  // to this index function call, we are going to want to clear the CU
+  // dies after we are done indexing to make sure we don't pull in all
+  // DWARF dies, but we need to wait until all compile units have been
+  // indexed in case a DIE in one compile unit refers to another and the
+  // indexes accesses those DIEs.
+  //----------------------------------------------------------------------
+  TaskMapOverInt(0, num_units, extract_fn);
+
+  // Now create a task runner that can index each DWARF compile unit in a
+  // separate
+  // thread so we can index quickly.
+
+  TaskMapOverInt(0, num_units, parser_fn);
+
+  //----------------------------------------------------------------------
+  // Keep memory down by clearing DIEs for any compile units if indexing
+  // caused us to load the compile unit's DIEs.
+  //----------------------------------------------------------------------
+  for (size_t i = 0; i < num_units; ++i) {
+    if (clear_cu_dies[i])
+      debug_info->GetCompileUnitAtIndex(cu_indexes[i])->ClearDIEs(true);
+  }
+}
+
+void SymbolFileDWARF::AddCompileUnitNames(CompileUnitNames &names) {
+  const size_t num_units = names.cu_indexes.size();
+  if (num_units == 0)
+    return;
+
+  // std::vector<bool> might be implemented using bit test-and-set, so use
+  // uint8_t instead.
+  std::vector<uint8_t> skip(num_units, false);
+  if (!m_cu_indexed.empty()) {
+    for (size_t i = 0; i < num_units; ++i)
+      skip[i] = m_cu_indexed[names.cu_indexes[i]];
+  }
+
+  auto finalize_fn = [&skip](NameToDIE &index, std::vector<NameToDIE> &srcs) {
+    for (size_t i = 0; i < srcs.size(); ++i) {
+      if (!skip[i])
+        index.Append(srcs[i]);
+    }
+    index.Finalize();
+  };
+
+  TaskPool::RunTasks(
+      [&]() {
+        finalize_fn(m_function_basename_index, names.function_basename_index);
+      },
+      [&]() {
+        finalize_fn(m_function_fullname_index, names.function_fullname_index);
+      },
+      [&]() {
+        finalize_fn(m_function_method_index, names.function_method_index);
+      },
+      [&]() {
+        finalize_fn(m_function_selector_index, names.function_selector_index);
+      },
+      [&]() {
+        finalize_fn(m_objc_class_selectors_index,
+                    names.objc_class_selectors_index);
+      },
+      [&]() { finalize_fn(m_global_index, names.global_index); },
+      [&]() { finalize_fn(m_type_index, names.type_index); },
+      [&]() { finalize_fn(m_namespace_index, names.namespace_index); });
+
+  if (!m_cu_indexed.empty()) {
+    for (uint32_t cu_idx : names.cu_indexes)
+      m_cu_indexed[cu_idx] = true;
+  }
+}
+
+bool SymbolFileDWARF::IndexCompileUnitsForName(const ConstString &name,
+                                               uint32_t name_type_mask,
+                                               lldb::SymbolType symbol_type) {
+  if (m_indexed)
+    return true;
+  // The symbol table of a debug map object file doesn't describe its
+  // DWARF, and the background index couldn't take the right module lock.
+  if (!GetGlobalPluginProperties()->GetLazyIndex() || GetDebugMapSymfile())
+    return false;
+  DWARFDebugInfo *debug_info = DebugInfo();
+  ModuleSP module_sp(m_obj_file->GetModule());
+  if (!debug_info || !module_sp)
+    return false;
+  const uint32_t num_compile_units = GetNumCompileUnits();
+  if (num_compile_units == 0)
+    return false;
+
+  if (m_cu_indexed.empty()) {
+    // Loading a cached index is cheaper than any lazy lookup.
+    if (LoadIndexFromCache()) {
+      m_indexed = true;
+      return true;
+    }
+    m_cu_indexed.resize(num_compile_units, false);
+
+    get_debug_pubnames_data();
+    if (m_data_debug_pubnames.m_data.GetByteSize() > 0) {
+      m_pubnames_ap.reset(new DWARFDebugPubnames());
+      if (!m_pubnames_ap->Extract(m_data_debug_pubnames.m_data))
+        m_pubnames_ap.reset();
+    }
+  }
+
+  std::set<dw_offset_t> cu_offsets;
+
+  // Map the addresses of the symbols with this name to compile units.
+  SymbolVendor *sym_vendor = module_sp->GetSymbolVendor();
+  Symtab *symtab = sym_vendor ? sym_vendor->GetSymtab() : nullptr;
+  if (symtab) {
+    std::vector<Symbol *> symbols;
+    if (symbol_type == eSymbolTypeCode) {
+      SymbolContextList sc_list;
+      symtab->FindFunctionSymbols(name, name_type_mask, sc_list);
+      SymbolContext sc;
+      for (uint32_t i = 0; i < sc_list.GetSize(); ++i) {
+        if (sc_list.GetContextAtIndex(i, sc) && sc.symbol)
+          symbols.push_back(sc.symbol);
+      }
+    } else {
+      std::vector<uint32_t> symbol_indexes;
+      symtab->FindAllSymbolsWithNameAndType(name, symbol_type, symbol_indexes);
+      for (uint32_t symbol_idx : symbol_indexes)
+        symbols.push_back(symtab->SymbolAtIndex(symbol_idx));
+    }
+    DWARFDebugAranges &cu_aranges = debug_info->GetCompileUnitAranges();
+    for (Symbol *symbol : symbols) {
+      if (!symbol || !symbol->ValueIsAddress())
+        continue;
+      const dw_offset_t cu_offset =
+          cu_aranges.FindAddress(symbol->GetAddressRef().GetFileAddress());
+      if (cu_offset != DW_INVALID_OFFSET)
+        cu_offsets.insert(cu_offset);
+    }
+  }
+
+  // .debug_pubnames also has the compile units of inlined functions and
+  // of variables without a symbol.
+  if (m_pubnames_ap) {
+    std::vector<dw_offset_t> die_offsets;
+    m_pubnames_ap->Find(name.GetCString(), false, die_offsets);
+    for (dw_offset_t die_offset : die_offsets) {
+      DWARFCompileUnit *dwarf_cu =
+          debug_info->GetCompileUnitContainingDIEOffset(die_offset);
+      if (dwarf_cu)
+        cu_offsets.insert(dwarf_cu->GetOffset());
+    }
+  }
+
+  std::vector<uint32_t> cu_indexes;
+  for (dw_offset_t cu_offset : cu_offsets) {
+    uint32_t cu_idx = UINT32_MAX;
+    if (debug_info->GetCompileUnit(cu_offset, &cu_idx) &&
+        cu_idx < num_compile_units && !m_cu_indexed[cu_idx])
+      cu_indexes.push_back(cu_idx);
+  }
+  if (!cu_indexes.empty()) {
+    ElapsedTime elapsed(m_index_time);
+    IndexCompileUnits(cu_indexes);
+  }
+
+  Log *log(LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS));
+  if (log)
+    log->Printf("SymbolFileDWARF::IndexCompileUnitsForName (name=\"%s\") "
+                "indexed %zu of %u compile units",
+                name.GetCString(), cu_indexes.size(), num_compile_units);
+
+  StartBackgroundIndex();
+  return true;
+}
+
+void SymbolFileDWARF::StartBackgroundIndex() {
+  if (m_background_index_started)
+    return;
+  m_background_index_started = true;
+  m_background_index_thread = ThreadLauncher::LaunchThread(
+      "<lldb.dwarf.index>", BackgroundIndexThread, this, nullptr);
+}
+
+lldb::thread_result_t
+SymbolFileDWARF::BackgroundIndexThread(lldb::thread_arg_t arg) {
+  static_cast<SymbolFileDWARF *>(arg)->BackgroundIndex();
+  return NULL;
+}
+
+bool SymbolFileDWARF::LockForBackgroundIndex(
+    std::unique_lock<std::recursive_mutex> &lock) {
+  while (!lock.try_lock()) {
+    if (m_background_index_cancel)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+void SymbolFileDWARF::BackgroundIndex() {
+  Log *log(LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS));
+
+  // The destructor waits for this thread, so the symbol file stays around
+  // as long as the module does. Only a weak reference to the module is kept
+  // between the batches below, so that a module nobody uses anymore is not
+  // kept alive just to index it. If this thread drops the last reference,
+  // nothing may be touched afterwards.
+  std::weak_ptr<Module> module_wp = m_obj_file->GetModule();
+
+  // Index a few compile units at a time and only hold the module lock while
+  // doing so, lookups on other threads can run in between. The names are
+  // kept aside and only added to the manual indexes at the end, so lookups
+  // never see compile units that are only partly in the indexes.
+  const uint32_t batch_size = std::max<uint32_t>(TaskPool::GetThreadCount(), 1);
+  CompileUnitNames names;
+  uint32_t next_cu_idx = 0;
+  while (true) {
+    ModuleSP module_sp = module_wp.lock();
+    if (!module_sp)
+      return;
+    std::unique_lock<std::recursive_mutex> lock(module_sp->GetMutex(),
+                                                std::defer_lock);
+    if (!LockForBackgroundIndex(lock))
+      return;
+    // A lookup that couldn't be narrowed down indexed everything.
+    if (m_indexed)
+      return;
+
+    std::vector<uint32_t> cu_indexes;
+    for (; next_cu_idx < m_cu_indexed.size() && cu_indexes.size() < batch_size;
+         ++next_cu_idx) {
+      if (!m_cu_indexed[next_cu_idx])
+        cu_indexes.push_back(next_cu_idx);
+    }
+    ElapsedTime elapsed(m_index_time);
+    if (!cu_indexes.empty()) {
+      ParseCompileUnitNames(cu_indexes, names);
+      continue;
+    }
+
+    AddCompileUnitNames(names);
+    m_indexed = true;
+    SaveIndexToCache();
+    if (log)
+      log->Printf("SymbolFileDWARF::BackgroundIndex (%s) finished indexing "
+                  "%zu compile units",
+                  m_obj_file->GetFileSpec().GetFilename().AsCString(""),
+                  names.cu_indexes.size());
+    lock.unlock();
+
+    // Lookups that ran before the index completed may have missed inlined
+    // functions, so let the targets using this module resolve their
+    // breakpoints again, the same way they do when symbols are added.
+    ModuleList module_list;
+    module_list.Append(module_sp);
+    const size_t num_debuggers = Debugger::GetNumDebuggers();
+    for (size_t debugger_idx = 0; debugger_idx < num_debuggers;
+         ++debugger_idx) {
+      DebuggerSP debugger_sp = Debugger::GetDebuggerAtIndex(debugger_idx);
+      if (!debugger_sp)
+        continue;
+      TargetList &target_list = debugger_sp->GetTargetList();
+      const size_t num_targets = target_list.GetNumTargets();
+      for (size_t target_idx = 0; target_idx < num_targets; ++target_idx) {
+        TargetSP target_sp = target_list.GetTargetAtIndex(target_idx);
+        if (!target_sp || !target_sp->GetImages().FindModule(module_sp.get()))
+          continue;
+        std::unique_lock<std::recursive_mutex> api_lock(
+            target_sp->GetAPIMutex(), std::defer_lock);
+        if (!LockForBackgroundIndex(api_lock))
+          return;
+        target_sp->SymbolsDidLoad(module_list);
+      }
+    }
+    return;
+  }
+}
+
+static const uint32_t kIndexCacheMagic = 0x44574958; // 'DWIX'
+static const uint32_t kIndexCacheVersion = 1;
+
+std::vector<NameToDIE *> SymbolFileDWARF::GetManualIndexes() {
+  return {&m_function_basename_index, &m_function_fullname_index,
+          &m_function_method_index,   &m_function_selector_index,
+          &m_objc_class_selectors_index, &m_global_index,
+          &m_type_index,              &m_namespace_index};
+}
+
+std::string SymbolFileDWARF::GetIndexCacheKey() {
+  ModuleSP module_sp(m_obj_file->GetModule());
+  if (!module_sp)
+    return std::string();
+  return DataFileCache::GetModuleCacheKey(*module_sp, "dwarf-index");
+}
+
+CacheSignature SymbolFileDWARF::GetIndexCacheSignature() {
+  ModuleSP module_sp(m_obj_file->GetModule());
+  if (!module_sp)
+    return CacheSignature();
+  CacheSignature signature(*module_sp);
+  // If the DWARF lives in a separate symbol file (a dSYM or a .debug file),
+  // the index must also be invalidated when that file changes.
+  if (m_obj_file != module_sp->GetObjectFile() &&
+      !module_sp->GetObjectName())
+    signature.m_obj_mod_time = llvm::sys::toTimeT(
+        FileSystem::GetModificationTime(m_obj_file->GetFileSpec()));
+  return signature;
+}
+
+bool SymbolFileDWARF::LoadIndexFromCache() {
+  // DWO files are indexed as part of their base symbol file.
+  if (GetBaseCompileUnit())
+    return false;
+  DataFileCache *cache = DataFileCache::GetIndexCache();
+  if (cache == nullptr)
+    return false;
+  const std::string key = GetIndexCacheKey();
+  if (key.empty())
+    return false;
+  DataBufferSP data_sp = cache->GetCachedData(key);
+  if (!data_sp)
+    return false;
+
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "SymbolFileDWARF::LoadIndexFromCache (%s)",
+                     key.c_str());
+
+  DataExtractor data(data_sp, endian::InlHostByteOrder(),
+                     m_obj_file->GetAddressByteSize());
+  lldb::offset_t offset = 0;
+  CacheSignature signature;
+  bool valid = data.GetU32(&offset) == kIndexCacheMagic &&
+               data.GetU32(&offset) == kIndexCacheVersion &&
+               signature.Decode(data, &offset) &&
+               signature == GetIndexCacheSignature();
+
+  std::vector<NameToDIE *> indexes = GetManualIndexes();
+  for (size_t i = 0; valid && i < indexes.size(); ++i)
+    valid = indexes[i]->Decode(data, &offset);
+
+  Log *log(LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS));
+  if (!valid) {
+    // The cache file is stale or corrupt. Remove it so that a fresh one is
+    // written once we are done indexing.
+    if (log)
+      log->Printf("SymbolFileDWARF::LoadIndexFromCache: discarding stale "
+                  "index cache file \"%s\"",
+                  key.c_str());
+    for (NameToDIE *index : indexes)
+      index->Clear();
+    cache->RemoveCacheFile(key);
+    return false;
+  }
+
+  TaskMapOverInt(0, indexes.size(),
+                 [&indexes](size_t idx) { indexes[idx]->Finalize(); });
+  if (log)
+    log->Printf("SymbolFileDWARF::LoadIndexFromCache: loaded index cache file "
+                "\"%s\"",
+                key.c_str());
+  return true;
+}
+
+void SymbolFileDWARF::SaveIndexToCache() {
+  if (GetBaseCompileUnit())
+    return;
+  DataFileCache *cache = DataFileCache::GetIndexCache();
+  if (cache == nullptr)
+    return;
+  CacheSignature signature = GetIndexCacheSignature();
+  const std::string key = GetIndexCacheKey();
+  if (!signature.IsValid() || key.empty())
+    return;
+
+  StreamString strm(Stream::eBinary, m_obj_file->GetAddressByteSize(),
+                    endian::InlHostByteOrder());
+  strm.PutHex32(kIndexCacheMagic);
+  strm.PutHex32(kIndexCacheVersion);
+  signature.Encode(strm);
+  for (NameToDIE *index : GetManualIndexes())
+    index->Encode(strm);
+  cache->SetCachedData(
+      key, llvm::ArrayRef<uint8_t>(
+               reinterpret_cast<const uint8_t *>(strm.GetData()),
+               strm.GetSize()));
+}
+
 bool SymbolFileDWARF::DeclContextMatchesThisSymbolFile(
     const lldb_private::CompilerDeclContext *decl_ctx) {
   if (decl_ctx == nullptr || !decl_ctx->IsValid()) {
@@ -2304,9 +2956,18 @@ uint32_t SymbolFileDWARF::FindGlobalVariables(
 
       m_apple_names_ap->FindByName(basename.data(), die_offsets);
     }
+  } else if (m_debug_names_ap) {
+    llvm::StringRef basename;
+    llvm::StringRef context;
+    if (!CPlusPlusLanguage::ExtractContextAndIdentifier(name.GetCString(),
+                                                        context, basename))
+      basename = name.GetStringRef();
+
+    FindInDebugNames(basename, IsVariableTag, die_offsets);
   } else {
     // Index the DWARF if we haven't already
-    if (!m_indexed)
+    if (!m_indexed &&
+        !IndexCompileUnitsForName(name, eFunctionNameTypeNone, eSymbolTypeData))
       Index();
 
     m_global_index.Find(name, die_offsets);
@@ -2617,8 +3278,15 @@ SymbolFileDWARF::FindFunctions(const ConstString &name,
     return 0;
 
   std::set<const DWARFDebugInfoEntry *> resolved_dies;
-  if (m_using_apple_tables) {
-    if (m_apple_names_ap.get()) {
+  if (m_using_apple_tables || m_debug_names_ap) {
+    if (m_apple_names_ap.get() || m_debug_names_ap) {
+      // Like .apple_names, .debug_names has the names, linkage names and
+      // the base names of C++ methods of all functions.
+      auto find_by_name = [this, name_cstr](DIEArray &die_offsets) -> size_t {
+        if (m_apple_names_ap.get())
+          return m_apple_names_ap->FindByName(name_cstr, die_offsets);
+        return FindInDebugNames(name_cstr, IsFunctionTag, die_offsets);
+      };
 
       DIEArray die_offsets;
 
@@ -2630,7 +3298,7 @@ SymbolFileDWARF::FindFunctions(const ConstString &name,
         // want to canonicalize this (strip double spaces, etc.  For now, we
         // just add all the
         // dies that we find by exact match.
-        num_matches = m_apple_names_ap->FindByName(name_cstr, die_offsets);
+        num_matches = find_by_name(die_offsets);
         for (uint32_t i = 0; i < num_matches; i++) {
           const DIERef &die_ref = die_offsets[i];
           DWARFDIE die = info->GetDIE(die_ref);
@@ -2655,7 +3323,7 @@ SymbolFileDWARF::FindFunctions(const ConstString &name,
         if (parent_decl_ctx && parent_decl_ctx->IsValid())
           return 0; // no selectors in namespaces
 
-        num_matches = m_apple_names_ap->FindByName(name_cstr, die_offsets);
+        num_matches = find_by_name(die_offsets);
         // Now make sure these are actually ObjC methods.  In this case we can
         // simply look up the name,
         // and if it is an ObjC method name, we're good.
@@ -2691,7 +3359,7 @@ SymbolFileDWARF::FindFunctions(const ConstString &name,
 
         // FIXME: Arrange the logic above so that we don't calculate the base
         // name twice:
-        num_matches = m_apple_names_ap->FindByName(name_cstr, die_offsets);
+        num_matches = find_by_name(die_offsets);
 
         for (uint32_t i = 0; i < num_matches; i++) {
           const DIERef &die_ref = die_offsets[i];
@@ -2754,7 +3422,8 @@ SymbolFileDWARF::FindFunctions(const ConstString &name,
   } else {
 
     // Index the DWARF if we haven't already
-    if (!m_indexed)
+    if (!m_indexed &&
+        !IndexCompileUnitsForName(name, name_type_mask, eSymbolTypeCode))
       Index();
 
     if (name_type_mask & eFunctionNameTypeFull) {
@@ -2972,6 +3641,8 @@ uint32_t SymbolFileDWARF::FindTypes(
       const char *name_cstr = name.GetCString();
       m_apple_types_ap->FindByName(name_cstr, die_offsets);
     }
+  } else if (m_debug_names_ap) {
+    FindInDebugNames(name.GetStringRef(), IsTypeTag, die_offsets);
   } else {
     if (!m_indexed)
       Index();
@@ -3066,6 +3737,8 @@ size_t SymbolFileDWARF::FindTypes(const std::vector<CompilerContext> &context,
       const char *name_cstr = name.GetCString();
       m_apple_types_ap->FindByName(name_cstr, die_offsets);
     }
+  } else if (m_debug_names_ap) {
+    FindInDebugNames(name.GetStringRef(), IsTypeTag, die_offsets);
   } else {
     if (!m_indexed)
       Index();
@@ -3135,6 +3808,8 @@ SymbolFileDWARF::FindNamespace(const SymbolContext &sc, const ConstString &name,
         const char *name_cstr = name.GetCString();
         m_apple_namespaces_ap->FindByName(name_cstr, die_offsets);
       }
+    } else if (m_debug_names_ap) {
+      FindInDebugNames(name.GetStringRef(), IsNamespaceTag, die_offsets);
     } else {
       if (!m_indexed)
         Index();
@@ -3187,7 +3862,7 @@ TypeSP SymbolFileDWARF::GetTypeForDIE(const DWARFDIE &die,
                                       bool resolve_function_context) {
   TypeSP type_sp;
   if (die) {
-    Type *type_ptr = GetDIEToType().lookup(die.GetDIE());
+    Type *type_ptr = GetDIEToType().lookup(die.GetID());
     if (type_ptr == NULL) {
       CompileUnit *lldb_cu = GetCompUnitForDWARFCompUnit(die.GetCU());
       assert(lldb_cu);
@@ -3376,7 +4051,7 @@ TypeSP SymbolFileDWARF::FindCompleteObjCDefinitionTypeForDIE(
                            type_die.GetID(), type_cu->GetID());
 
               if (die)
-                GetDIEToType()[die.GetDIE()] = resolved_type;
+                GetDIEToType()[die.GetID()] = resolved_type;
               type_sp = resolved_type->shared_from_this();
               break;
             }
@@ -3534,6 +4209,8 @@ TypeSP SymbolFileDWARF::FindDefinitionTypeForDWARFDeclContext(
             m_apple_types_ap->FindByName(type_name.GetCString(), die_offsets);
           }
         }
+      } else if (m_debug_names_ap) {
+        FindInDebugNames(type_name.GetStringRef(), IsTypeTag, die_offsets);
       } else {
         if (!m_indexed)
           Index();
@@ -3653,6 +4330,7 @@ TypeSP SymbolFileDWARF::ParseType(const SymbolContext &sc, const DWARFDIE &die,
   TypeSP type_sp;
 
   if (die) {
+    DWARFCompileUnit::ScopedDIEUse die_use(die.GetCU());
     TypeSystem *type_system =
         GetTypeSystemForLanguage(die.GetCU()->GetLanguageType());
 
@@ -3981,7 +4659,8 @@ VariableSP SymbolFileDWARF::ParseVariableDIE(const SymbolContext &sc,
   if (!die)
     return var_sp;
 
-  var_sp = GetDIEToVariable()[die.GetDIE()];
+  DWARFCompileUnit::ScopedDIEUse die_use(die.GetCU());
+  var_sp = GetDIEToVariable()[die.GetID()];
   if (var_sp)
     return var_sp; // Already been parsed!
 
@@ -4403,9 +5082,9 @@ VariableSP SymbolFileDWARF::ParseVariableDIE(const SymbolContext &sc,
     // was missing vital information to be able to be displayed in the debugger
     // (missing location due to optimization, etc)) so we don't re-parse
     // this DIE over and over later...
-    GetDIEToVariable()[die.GetDIE()] = var_sp;
+    GetDIEToVariable()[die.GetID()] = var_sp;
     if (spec_die)
-      GetDIEToVariable()[spec_die.GetDIE()] = var_sp;
+      GetDIEToVariable()[spec_die.GetID()] = var_sp;
   }
   return var_sp;
 }
@@ -4462,6 +5141,7 @@ size_t SymbolFileDWARF::ParseVariables(const SymbolContext &sc,
   if (!orig_die)
     return 0;
 
+  DWARFCompileUnit::ScopedDIEUse die_use(orig_die.GetCU());
   VariableListSP variable_list_sp;
 
   size_t vars_added = 0;
@@ -4470,7 +5150,7 @@ size_t SymbolFileDWARF::ParseVariables(const SymbolContext &sc,
     dw_tag_t tag = die.Tag();
 
     // Check to see if we have already parsed this variable or constant?
-    VariableSP var_sp = GetDIEToVariable()[die.GetDIE()];
+    VariableSP var_sp = GetDIEToVariable()[die.GetID()];
     if (var_sp) {
       if (cc_variable_list)
         cc_variable_list->AddVariableIfUnique(var_sp);
@@ -4582,6 +5262,7 @@ void SymbolFileDWARF::DumpIndexes() {
       "DWARF index for (%s) '%s':",
       GetObjectFile()->GetModule()->GetArchitecture().GetArchitectureName(),
       GetObjectFile()->GetFileSpec().GetPath().c_str());
+  s.Printf("\nParsed DIEs: %" PRIu64 " bytes\n", GetDebugInfoMemorySize());
   s.Printf("\nFunction basenames:\n");
   m_function_basename_index.Dump(&s);
   s.Printf("\nFunction fullnames:\n");
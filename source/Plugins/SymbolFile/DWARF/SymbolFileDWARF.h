@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
+#include <condition_variable>
 #include <list>
 #include <map>
 #include <mutex>
@@ -21,14 +23,17 @@
 
 // Other libraries and framework includes
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Threading.h"
 
 #include "lldb/Utility/Flags.h"
 
 #include "lldb/Core/RangeMap.h"
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Core/dwarf.h"
 #include "lldb/Expression/DWARFExpression.h"
+#include "lldb/Host/HostThread.h"
 #include "lldb/Symbol/DebugMacros.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/SymbolFile.h"
@@ -37,6 +42,7 @@
 
 // Project includes
 #include "DWARFDataExtractor.h"
+#include "DWARFDebugNames.h"
 #include "DWARFDefines.h"
 #include "HashedNameToDIE.h"
 #include "NameToDIE.h"
@@ -239,6 +245,28 @@ public:
 
   void PreloadSymbols() override;
 
+  lldb_private::StatsDuration::Duration GetDebugInfoParseTime() override {
+    return m_debug_info_parse_time.get();
+  }
+
+  lldb_private::StatsDuration::Duration GetDebugInfoIndexTime() override {
+    return m_index_time.get();
+  }
+
+  uint64_t GetDebugInfoSize() override;
+
+  uint64_t GetDebugInfoBytesParsed() override {
+    return m_debug_info_bytes_parsed;
+  }
+
+  uint64_t GetNumTypesCompleted() override { return m_num_types_completed; }
+
+  uint64_t GetDebugInfoMemorySize() override;
+
+  uint64_t GetNumDebugInfoEvictions() override;
+
+  uint64_t GetNumDebugInfoReparses() override;
+
   //------------------------------------------------------------------
   // PluginInterface protocol
   //------------------------------------------------------------------
@@ -262,6 +290,8 @@ public:
   const lldb_private::DWARFDataExtractor &get_apple_exttypes_data();
   const lldb_private::DWARFDataExtractor &get_apple_namespaces_data();
   const lldb_private::DWARFDataExtractor &get_apple_objc_data();
+  const lldb_private::DWARFDataExtractor &get_debug_names_data();
+  const lldb_private::DWARFDataExtractor &get_debug_pubnames_data();
 
   DWARFDebugAbbrev *DebugAbbrev();
 
@@ -323,13 +353,32 @@ public:
   // the method returns a pointer to the base compile unit.
   virtual DWARFCompileUnit *GetBaseCompileUnit();
 
+  //------------------------------------------------------------------
+  // Used by the compile units to account for the DIEs they extract.
+  //------------------------------------------------------------------
+  lldb_private::StatsDuration &GetDebugInfoParseTimeRef() {
+    return m_debug_info_parse_time;
+  }
+
+  void AddDebugInfoBytesParsed(uint64_t num_bytes) {
+    m_debug_info_bytes_parsed += num_bytes;
+  }
+
+  //------------------------------------------------------------------
+  // Called by a compile unit after parsing all of its DIEs, which
+  // take \a num_bytes of memory. \a reparsed is true if the DIEs had
+  // been freed by an earlier call to EvictDIEs(). Schedules freeing the
+  // least recently used DIEs when the "dwarf-die-memory-limit" setting
+  // is exceeded.
+  //------------------------------------------------------------------
+  virtual void DIEsWereExtracted(uint64_t num_bytes, bool reparsed);
+
 protected:
-  typedef llvm::DenseMap<const DWARFDebugInfoEntry *, lldb_private::Type *>
-      DIEToTypePtr;
-  typedef llvm::DenseMap<const DWARFDebugInfoEntry *, lldb::VariableSP>
-      DIEToVariableSP;
-  typedef llvm::DenseMap<const DWARFDebugInfoEntry *,
-                         lldb::opaque_compiler_type_t>
+  // These are keyed by DIE user ID, as the DIEs of a compile unit can be
+  // freed and parsed again at a different address.
+  typedef llvm::DenseMap<lldb::user_id_t, lldb_private::Type *> DIEToTypePtr;
+  typedef llvm::DenseMap<lldb::user_id_t, lldb::VariableSP> DIEToVariableSP;
+  typedef llvm::DenseMap<lldb::user_id_t, lldb::opaque_compiler_type_t>
       DIEToClangType;
   typedef llvm::DenseMap<lldb::opaque_compiler_type_t, DIERef> ClangTypeToDIE;
 
@@ -431,6 +480,116 @@ protected:
 
   void Index();
 
+  //------------------------------------------------------------------
+  // The names found in some compile units, with one NameToDIE per
+  // compile unit for each of the manual indexes.
+  //------------------------------------------------------------------
+  struct CompileUnitNames {
+    std::vector<uint32_t> cu_indexes;
+    std::vector<NameToDIE> function_basename_index;
+    std::vector<NameToDIE> function_fullname_index;
+    std::vector<NameToDIE> function_method_index;
+    std::vector<NameToDIE> function_selector_index;
+    std::vector<NameToDIE> objc_class_selectors_index;
+    std::vector<NameToDIE> global_index;
+    std::vector<NameToDIE> type_index;
+    std::vector<NameToDIE> namespace_index;
+  };
+
+  //------------------------------------------------------------------
+  // Index the compile units at \a cu_indexes and add them to the
+  // manual indexes. Compile units that were already indexed by an
+  // earlier call must not be passed again.
+  //------------------------------------------------------------------
+  void IndexCompileUnits(const std::vector<uint32_t> &cu_indexes);
+
+  //------------------------------------------------------------------
+  // Append the names of the compile units at \a cu_indexes to \a names
+  // without adding them to the manual indexes.
+  //------------------------------------------------------------------
+  void ParseCompileUnitNames(const std::vector<uint32_t> &cu_indexes,
+                             CompileUnitNames &names);
+
+  //------------------------------------------------------------------
+  // Add \a names to the manual indexes, except for the compile units
+  // that have been indexed since they were parsed.
+  //------------------------------------------------------------------
+  void AddCompileUnitNames(CompileUnitNames &names);
+
+  //------------------------------------------------------------------
+  // Used instead of Index() by function and global variable lookups
+  // when the "lazy-index" setting is on. Indexes only the compile units
+  // that the symbol table, .debug_aranges and .debug_pubnames say can
+  // define \a name and starts indexing the rest in the background.
+  // Returns false if the caller needs to call Index() instead.
+  //------------------------------------------------------------------
+  bool IndexCompileUnitsForName(const lldb_private::ConstString &name,
+                                uint32_t name_type_mask,
+                                lldb::SymbolType symbol_type);
+
+  void StartBackgroundIndex();
+
+  static lldb::thread_result_t BackgroundIndexThread(lldb::thread_arg_t arg);
+
+  void BackgroundIndex();
+
+  //------------------------------------------------------------------
+  // Lock \a mutex for the background index thread. Returns false
+  // without the lock if the symbol file is being destroyed, whose
+  // destructor may hold it while waiting for the thread.
+  //------------------------------------------------------------------
+  bool LockForBackgroundIndex(std::unique_lock<std::recursive_mutex> &lock);
+
+  //------------------------------------------------------------------
+  // Free the DIEs of the least recently used compile units until the
+  // parsed DIEs fit in the "dwarf-die-memory-limit" setting. The caller
+  // must hold the module lock.
+  //------------------------------------------------------------------
+  void EvictDIEs();
+
+  // Shared by the symbol file and its DIE eviction thread, which only
+  // touches the symbol file through the module while holding its lock.
+  struct DIEEvictionState {
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool pending = false;
+    bool cancel = false;
+    std::weak_ptr<lldb_private::Module> module_wp;
+  };
+  typedef std::shared_ptr<DIEEvictionState> DIEEvictionStateSP;
+
+  static lldb::thread_result_t DIEEvictionThread(lldb::thread_arg_t arg);
+
+  //------------------------------------------------------------------
+  // Returns true if the .debug_names name index lists every compile
+  // unit in .debug_info, so lookups can use it instead of Index().
+  //------------------------------------------------------------------
+  bool DebugNamesCoversAllCompileUnits();
+
+  //------------------------------------------------------------------
+  // Look up \a name in the .debug_names name index and append the DIEs
+  // whose tag is accepted by \a tag_filter to \a die_offsets. Returns
+  // the number of DIEs that were appended.
+  //------------------------------------------------------------------
+  size_t FindInDebugNames(llvm::StringRef name,
+                          llvm::function_ref<bool(dw_tag_t)> tag_filter,
+                          DIEArray &die_offsets);
+
+  //------------------------------------------------------------------
+  // Load the manual indexes from the on-disk index cache. Returns true
+  // if a cache file matching this symbol file was found and decoded.
+  //------------------------------------------------------------------
+  bool LoadIndexFromCache();
+
+  void SaveIndexToCache();
+
+  std::string GetIndexCacheKey();
+
+  lldb_private::CacheSignature GetIndexCacheSignature();
+
+  // The manual indexes in the order they are stored in the index cache.
+  std::vector<NameToDIE *> GetManualIndexes();
+
   void DumpIndexes();
 
   void SetDebugMapModule(const lldb::ModuleSP &module_sp) {
@@ -517,6 +676,8 @@ protected:
   DWARFDataSegment m_data_apple_exttypes;
   DWARFDataSegment m_data_apple_namespaces;
   DWARFDataSegment m_data_apple_objc;
+  DWARFDataSegment m_data_debug_names;
+  DWARFDataSegment m_data_debug_pubnames;
 
   // The unique pointer items below are generated on demand if and when someone
   // accesses
@@ -529,6 +690,8 @@ protected:
   std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_exttypes_ap;
   std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_namespaces_ap;
   std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_objc_ap;
+  std::unique_ptr<DWARFDebugNames> m_debug_names_ap;
+  std::unique_ptr<DWARFDebugPubnames> m_pubnames_ap;
   std::unique_ptr<GlobalVariableMap> m_global_aranges_ap;
   std::unique_ptr<lldb_private::ClangASTImporter> m_clang_ast_importer_ap;
 
@@ -547,8 +710,17 @@ protected:
   NameToDIE m_global_index;               // Global and static variables
   NameToDIE m_type_index;                 // All type DIE offsets
   NameToDIE m_namespace_index;            // All type DIE offsets
-  bool m_indexed : 1, m_using_apple_tables : 1, m_initialized_swift_modules : 1,
-      m_reported_missing_sdk : 1, m_fetched_external_modules : 1;
+  // Not a bit field, the background index sets it while other threads
+  // may be updating the flags below.
+  bool m_indexed;
+  bool m_using_apple_tables : 1, m_initialized_swift_modules : 1,
+      m_reported_missing_sdk : 1, m_fetched_external_modules : 1,
+      m_background_index_started : 1;
+  // Which compile units have been added to the manual indexes so far by
+  // lazy lookups. Empty until the first lazy lookup.
+  std::vector<uint8_t> m_cu_indexed;
+  lldb_private::HostThread m_background_index_thread;
+  std::atomic<bool> m_background_index_cancel{false};
   lldb_private::LazyBool m_supports_DW_AT_APPLE_objc_complete_type;
 
   typedef std::shared_ptr<std::set<DIERef>> DIERefSetSP;
@@ -560,6 +732,15 @@ protected:
   DIEToVariableSP m_die_to_variable_sp;
   DIEToClangType m_forward_decl_die_to_clang_type;
   ClangTypeToDIE m_forward_decl_clang_type_to_die;
+  lldb_private::StatsDuration m_debug_info_parse_time;
+  lldb_private::StatsDuration m_index_time;
+  std::atomic<uint64_t> m_debug_info_bytes_parsed{0};
+  std::atomic<uint64_t> m_num_types_completed{0};
+  // Bytes of DIEs parsed since the memory limit was last checked.
+  std::atomic<uint64_t> m_die_bytes_since_eviction{0};
+  DIEEvictionStateSP m_die_eviction_state;
+  // Started by the first eviction request and joined by the destructor.
+  lldb_private::HostThread m_die_eviction_thread;
 };
 
 #endif // SymbolFileDWARF_SymbolFileDWARF_h_
@@ -126,6 +126,10 @@ DWARFCompileUnit *SymbolFileDWARFDwo::GetBaseCompileUnit() {
   return m_base_dwarf_cu;
 }
 
+void SymbolFileDWARFDwo::DIEsWereExtracted(uint64_t num_bytes, bool reparsed) {
+  GetBaseSymbolFile()->DIEsWereExtracted(num_bytes, reparsed);
+}
+
 SymbolFileDWARF *SymbolFileDWARFDwo::GetBaseSymbolFile() {
   return m_base_dwarf_cu->GetSymbolFileDWARF();
 }
@@ -50,6 +50,8 @@ public:
 
   DWARFCompileUnit *GetBaseCompileUnit() override;
 
+  void DIEsWereExtracted(uint64_t num_bytes, bool reparsed) override;
+
 protected:
   void LoadSectionData(lldb::SectionType sect_type,
                        lldb_private::DWARFDataExtractor &data) override;
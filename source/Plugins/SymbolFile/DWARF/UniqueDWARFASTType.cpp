@@ -13,15 +13,21 @@
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "DWARFCompileUnit.h"
 #include "lldb/Symbol/Declaration.h"
 
+DWARFDIE UniqueDWARFASTType::GetDIE() const {
+  return m_cu ? m_cu->GetDIE(m_die_offset) : DWARFDIE();
+}
+
 bool UniqueDWARFASTTypeList::Find(const DWARFDIE &die,
                                   const lldb_private::Declaration &decl,
                                   const int32_t byte_size,
                                   UniqueDWARFASTType &entry) const {
   for (const UniqueDWARFASTType &udt : m_collection) {
+    const DWARFDIE udt_die = udt.GetDIE();
     // Make sure the tags match
-    if (udt.m_die.Tag() == die.Tag()) {
+    if (udt_die.Tag() == die.Tag()) {
       // Validate byte sizes of both types only if both are valid.
       if (udt.m_byte_size < 0 || byte_size < 0 ||
           udt.m_byte_size == byte_size) {
@@ -30,7 +36,7 @@ bool UniqueDWARFASTTypeList::Find(const DWARFDIE &die,
           // The type has the same name, and was defined on the same
           // file and line. Now verify all of the parent DIEs match.
           DWARFDIE parent_arg_die = die.GetParent();
-          DWARFDIE parent_pos_die = udt.m_die.GetParent();
+          DWARFDIE parent_pos_die = udt_die.GetParent();
           bool match = true;
           bool done = false;
           while (!done && match && parent_arg_die && parent_pos_die) {
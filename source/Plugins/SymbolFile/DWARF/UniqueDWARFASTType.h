@@ -27,34 +27,47 @@ public:
   // Constructors and Destructors
   //------------------------------------------------------------------
   UniqueDWARFASTType()
-      : m_type_sp(), m_die(), m_declaration(),
+      : m_type_sp(), m_cu(nullptr), m_die_offset(DW_INVALID_OFFSET),
+        m_declaration(),
         m_byte_size(
             -1) // Set to negative value to make sure we have a valid value
   {}
 
   UniqueDWARFASTType(lldb::TypeSP &type_sp, const DWARFDIE &die,
                      const lldb_private::Declaration &decl, int32_t byte_size)
-      : m_type_sp(type_sp), m_die(die), m_declaration(decl),
-        m_byte_size(byte_size) {}
+      : m_type_sp(type_sp), m_cu(die.GetCU()), m_die_offset(die.GetOffset()),
+        m_declaration(decl), m_byte_size(byte_size) {}
 
   UniqueDWARFASTType(const UniqueDWARFASTType &rhs)
-      : m_type_sp(rhs.m_type_sp), m_die(rhs.m_die),
-        m_declaration(rhs.m_declaration), m_byte_size(rhs.m_byte_size) {}
+      : m_type_sp(rhs.m_type_sp), m_cu(rhs.m_cu),
+        m_die_offset(rhs.m_die_offset), m_declaration(rhs.m_declaration),
+        m_byte_size(rhs.m_byte_size) {}
 
   ~UniqueDWARFASTType() {}
 
   UniqueDWARFASTType &operator=(const UniqueDWARFASTType &rhs) {
     if (this != &rhs) {
       m_type_sp = rhs.m_type_sp;
-      m_die = rhs.m_die;
+      m_cu = rhs.m_cu;
+      m_die_offset = rhs.m_die_offset;
       m_declaration = rhs.m_declaration;
       m_byte_size = rhs.m_byte_size;
     }
     return *this;
   }
 
+  DWARFDIE GetDIE() const;
+
+  void SetDIE(const DWARFDIE &die) {
+    m_cu = die.GetCU();
+    m_die_offset = die.GetOffset();
+  }
+
   lldb::TypeSP m_type_sp;
-  DWARFDIE m_die;
+  // The DIE is kept as its compile unit and offset, because the DIEs of
+  // the compile unit can be freed and parsed again at another address.
+  DWARFCompileUnit *m_cu;
+  dw_offset_t m_die_offset;
   lldb_private::Declaration m_declaration;
   int32_t m_byte_size;
 };
@@ -175,15 +175,11 @@ bool DWARFCallFrameInfo::GetAddressRange(Address addr, AddressRange &range) {
       module_sp->GetObjectFile() != &m_objfile)
     return false;
 
-  if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
-    return false;
-  GetFDEIndex();
-  FDEEntryMap::Entry *fde_entry =
-      m_fde_index.FindEntryThatContains(addr.GetFileAddress());
-  if (!fde_entry)
+  FDEEntryMap::Entry fde_entry;
+  if (!GetFDEEntryByFileAddress(addr.GetFileAddress(), fde_entry))
     return false;
 
-  range = AddressRange(fde_entry->base, fde_entry->size,
+  range = AddressRange(fde_entry.base, fde_entry.size,
                        m_objfile.GetSectionList());
   return true;
 }
@@ -193,6 +189,9 @@ bool DWARFCallFrameInfo::GetFDEEntryByFileAddress(
   if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
     return false;
 
+  if (UseEHFrameHdr())
+    return GetFDEEntryFromEHFrameHdr(file_addr, fde_entry);
+
   GetFDEIndex();
 
   if (m_fde_index.IsEmpty())
@@ -209,34 +208,33 @@ bool DWARFCallFrameInfo::GetFDEEntryByFileAddress(
 
 void DWARFCallFrameInfo::GetFunctionAddressAndSizeVector(
     FunctionAddressAndSizeVector &function_info) {
-  GetFDEIndex();
-  const size_t count = m_fde_index.GetSize();
   function_info.Clear();
-  if (count > 0)
-    function_info.Reserve(count);
-  for (size_t i = 0; i < count; ++i) {
-    const FDEEntryMap::Entry *func_offset_data_entry =
-        m_fde_index.GetEntryAtIndex(i);
-    if (func_offset_data_entry) {
-      FunctionAddressAndSizeVector::Entry function_offset_entry(
-          func_offset_data_entry->base, func_offset_data_entry->size);
-      function_info.Append(function_offset_entry);
-    }
-  }
+  ForEachFDEEntries([&function_info](lldb::addr_t base, uint32_t size,
+                                     dw_offset_t) {
+    function_info.Append(FunctionAddressAndSizeVector::Entry(base, size));
+    return true;
+  });
 }
 
 const DWARFCallFrameInfo::CIE *
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset) {
+  std::lock_guard<std::mutex> guard(m_cie_map_mutex);
   cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
-  if (pos != m_cie_map.end()) {
-    // Parse and cache the CIE
-    if (pos->second.get() == nullptr)
-      pos->second = ParseCIE(cie_offset);
-
-    return pos->second.get();
+  if (pos == m_cie_map.end()) {
+    // The section isn't scanned when FDEs are found with the .eh_frame_hdr
+    // table, so CIEs are parsed the first time an FDE refers to them.
+    if (m_eh_frame_hdr_fde_count == 0 ||
+        !m_cfi_data.ValidOffsetForDataOfSize(cie_offset, CFI_HEADER_SIZE))
+      return nullptr;
+    pos = m_cie_map.insert(std::make_pair(cie_offset, CIESP())).first;
   }
-  return nullptr;
+
+  // Parse and cache the CIE
+  if (pos->second.get() == nullptr)
+    pos->second = ParseCIE(cie_offset);
+
+  return pos->second.get();
 }
 
 DWARFCallFrameInfo::CIESP
@@ -481,7 +479,10 @@ void DWARFCallFrameInfo::GetFDEIndex() {
         return;
       }
 
-      m_cie_map[current_entry] = std::move(cie_sp);
+      {
+        std::lock_guard<std::mutex> cie_guard(m_cie_map_mutex);
+        m_cie_map[current_entry] = std::move(cie_sp);
+      }
       offset = next_entry;
       continue;
     }
@@ -530,6 +531,181 @@ void DWARFCallFrameInfo::GetFDEIndex() {
   m_fde_index_initialized = true;
 }
 
+// Most ELF files have an .eh_frame_hdr section with a table of the start
+// address and the location of every FDE in .eh_frame, sorted by address.
+// Binary searching it avoids scanning the whole .eh_frame section to build
+// m_fde_index, which takes a long time for large binaries.
+
+bool DWARFCallFrameInfo::UseEHFrameHdr() {
+  if (!m_eh_frame_hdr_initialized) {
+    std::lock_guard<std::mutex> guard(m_fde_index_mutex);
+    if (!m_eh_frame_hdr_initialized) { // if two threads hit the locker
+      ParseEHFrameHdr();
+      m_eh_frame_hdr_initialized = true;
+    }
+  }
+  return m_eh_frame_hdr_fde_count > 0;
+}
+
+void DWARFCallFrameInfo::ParseEHFrameHdr() {
+  if (m_type != EH || m_section_sp.get() == nullptr ||
+      m_section_sp->IsEncrypted())
+    return;
+
+  SectionList *section_list = m_objfile.GetSectionList();
+  if (section_list == nullptr)
+    return;
+  static ConstString g_sect_name_eh_frame_hdr(".eh_frame_hdr");
+  SectionSP hdr_sp = section_list->FindSectionByName(g_sect_name_eh_frame_hdr);
+  if (!hdr_sp || hdr_sp->IsEncrypted())
+    return;
+
+  DataExtractor hdr_data;
+  if (m_objfile.ReadSectionData(hdr_sp.get(), hdr_data) < 4)
+    return;
+  const lldb::addr_t hdr_addr = hdr_sp->GetFileAddress();
+
+  lldb::offset_t offset = 0;
+  const uint8_t version = hdr_data.GetU8(&offset);
+  const uint8_t eh_frame_ptr_enc = hdr_data.GetU8(&offset);
+  const uint8_t fde_count_enc = hdr_data.GetU8(&offset);
+  const uint8_t table_enc = hdr_data.GetU8(&offset);
+  if (version != 1 || fde_count_enc == DW_EH_PE_omit)
+    return;
+
+  // Only tables with fixed size entries can be binary searched.
+  uint32_t value_size = 0;
+  switch (table_enc & DW_EH_PE_MASK_ENCODING) {
+  case DW_EH_PE_absptr:
+    value_size = hdr_data.GetAddressByteSize();
+    break;
+  case DW_EH_PE_udata4:
+  case DW_EH_PE_sdata4:
+    value_size = 4;
+    break;
+  case DW_EH_PE_udata8:
+  case DW_EH_PE_sdata8:
+    value_size = 8;
+    break;
+  default:
+    return;
+  }
+  if ((table_enc & 0x70) != DW_EH_PE_absptr &&
+      (table_enc & 0x70) != DW_EH_PE_datarel)
+    return;
+  if (table_enc & 0x80) // DW_EH_PE_indirect
+    return;
+
+  const lldb::addr_t eh_frame_addr =
+      GetGNUEHPointer(hdr_data, &offset, eh_frame_ptr_enc, hdr_addr,
+                      LLDB_INVALID_ADDRESS, hdr_addr);
+  const uint64_t fde_count =
+      GetGNUEHPointer(hdr_data, &offset, fde_count_enc, hdr_addr,
+                      LLDB_INVALID_ADDRESS, hdr_addr);
+  // Make sure the table describes our .eh_frame section and fits in the
+  // .eh_frame_hdr section.
+  if (eh_frame_addr != m_section_sp->GetFileAddress() || fde_count == 0 ||
+      fde_count > UINT32_MAX ||
+      !hdr_data.ValidOffsetForDataOfSize(offset, fde_count * 2 * value_size))
+    return;
+
+  ArchSpec arch;
+  if (m_objfile.GetArchitecture(arch)) {
+    if (arch.GetTriple().getArch() == llvm::Triple::arm ||
+        arch.GetTriple().getArch() == llvm::Triple::thumb)
+      m_clear_address_zeroth_bit = true;
+  }
+
+  if (m_cfi_data_initialized == false)
+    GetCFIData();
+
+  m_eh_frame_hdr_data = hdr_data;
+  m_eh_frame_hdr_addr = hdr_addr;
+  m_eh_frame_hdr_table_offset = offset;
+  m_eh_frame_hdr_value_size = value_size;
+  m_eh_frame_hdr_table_enc = table_enc;
+  m_eh_frame_hdr_fde_count = fde_count;
+}
+
+// Read the initial location (field 0) or the FDE address (field 1) of an
+// entry in the .eh_frame_hdr table.
+lldb::addr_t DWARFCallFrameInfo::GetEHFrameHdrTableValue(uint32_t index,
+                                                         uint32_t field) {
+  lldb::offset_t offset =
+      m_eh_frame_hdr_table_offset +
+      (2 * (lldb::offset_t)index + field) * m_eh_frame_hdr_value_size;
+  return GetGNUEHPointer(m_eh_frame_hdr_data, &offset,
+                         m_eh_frame_hdr_table_enc, m_eh_frame_hdr_addr,
+                         LLDB_INVALID_ADDRESS, m_eh_frame_hdr_addr);
+}
+
+// The table doesn't have the size of the functions, read the address range
+// from the FDE itself.
+bool DWARFCallFrameInfo::GetEHFrameHdrFDEEntry(uint32_t index,
+                                               FDEEntryMap::Entry &fde_entry) {
+  const lldb::addr_t fde_addr = GetEHFrameHdrTableValue(index, 1);
+  const lldb::addr_t eh_frame_addr = m_section_sp->GetFileAddress();
+  if (fde_addr < eh_frame_addr)
+    return false;
+  const dw_offset_t current_entry = fde_addr - eh_frame_addr;
+  lldb::offset_t offset = current_entry;
+  if (!m_cfi_data.ValidOffsetForDataOfSize(offset, CFI_HEADER_SIZE))
+    return false;
+
+  uint32_t len = m_cfi_data.GetU32(&offset);
+  dw_offset_t cie_id, cie_offset;
+  if (len == UINT32_MAX) {
+    len = m_cfi_data.GetU64(&offset);
+    cie_id = m_cfi_data.GetU64(&offset);
+    cie_offset = current_entry + 12 - cie_id;
+  } else {
+    cie_id = m_cfi_data.GetU32(&offset);
+    cie_offset = current_entry + 4 - cie_id;
+  }
+  // The table should only point at FDEs, not at CIEs.
+  if (len == 0 || cie_id == 0 || cie_offset > m_cfi_data.GetByteSize())
+    return false;
+
+  const CIE *cie = GetCIE(cie_offset);
+  if (cie == nullptr)
+    return false;
+
+  const lldb::addr_t pc_rel_addr = eh_frame_addr;
+  const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
+  const lldb::addr_t data_addr = LLDB_INVALID_ADDRESS;
+  lldb::addr_t addr =
+      GetGNUEHPointer(m_cfi_data, &offset, cie->ptr_encoding, pc_rel_addr,
+                      text_addr, data_addr);
+  if (m_clear_address_zeroth_bit)
+    addr &= ~1ull;
+  lldb::addr_t length = GetGNUEHPointer(
+      m_cfi_data, &offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING,
+      pc_rel_addr, text_addr, data_addr);
+  fde_entry = FDEEntryMap::Entry(addr, length, current_entry);
+  return true;
+}
+
+bool DWARFCallFrameInfo::GetFDEEntryFromEHFrameHdr(
+    addr_t file_addr, FDEEntryMap::Entry &fde_entry) {
+  // Find the last entry that starts at or before file_addr.
+  uint32_t low = 0;
+  uint32_t high = m_eh_frame_hdr_fde_count;
+  while (low < high) {
+    const uint32_t mid = low + (high - low) / 2;
+    lldb::addr_t start = GetEHFrameHdrTableValue(mid, 0);
+    if (m_clear_address_zeroth_bit)
+      start &= ~1ull;
+    if (start <= file_addr)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  if (low == 0)
+    return false;
+  return GetEHFrameHdrFDEEntry(low - 1, fde_entry) &&
+         fde_entry.Contains(file_addr);
+}
+
 bool DWARFCallFrameInfo::FDEToUnwindPlan(dw_offset_t dwarf_offset,
                                          Address startaddr,
                                          UnwindPlan &unwind_plan) {
@@ -1079,6 +1255,19 @@ bool DWARFCallFrameInfo::HandleCommonDwarfOpcode(uint8_t primary_opcode,
 
 void DWARFCallFrameInfo::ForEachFDEEntries(
     const std::function<bool(lldb::addr_t, uint32_t, dw_offset_t)> &callback) {
+  if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
+    return;
+
+  if (UseEHFrameHdr()) {
+    for (uint32_t i = 0; i < m_eh_frame_hdr_fde_count; ++i) {
+      FDEEntryMap::Entry entry;
+      if (GetEHFrameHdrFDEEntry(i, entry) &&
+          !callback(entry.base, entry.size, entry.data))
+        break;
+    }
+    return;
+  }
+
   GetFDEIndex();
 
   for (size_t i = 0, c = m_fde_index.GetSize(); i < c; ++i) {
@@ -1087,3 +1276,19 @@ void DWARFCallFrameInfo::ForEachFDEEntries(
       break;
   }
 }
+
+bool DWARFCallFrameInfo::ForEachEHFrameHdrFunctionStart(
+    const std::function<bool(lldb::addr_t)> &callback) {
+  if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted() ||
+      !UseEHFrameHdr())
+    return false;
+
+  for (uint32_t i = 0; i < m_eh_frame_hdr_fde_count; ++i) {
+    lldb::addr_t start = GetEHFrameHdrTableValue(i, 0);
+    if (m_clear_address_zeroth_bit)
+      start &= ~1ull;
+    if (!callback(start))
+      break;
+  }
+  return true;
+}
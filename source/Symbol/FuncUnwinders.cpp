@@ -187,6 +187,12 @@ UnwindPlanSP FuncUnwinders::GetEHFrameAugmentedUnwindPlan(Target &target,
 
   m_tried_unwind_plan_eh_frame_augmented = true;
 
+  const addr_t func_file_addr = m_range.GetBaseAddress().GetFileAddress();
+  m_unwind_plan_eh_frame_augmented_sp = m_unwind_table.GetCachedUnwindPlan(
+      UnwindTable::eCachedUnwindPlanEHFrameAugmented, func_file_addr);
+  if (m_unwind_plan_eh_frame_augmented_sp)
+    return m_unwind_plan_eh_frame_augmented_sp;
+
   UnwindPlanSP eh_frame_plan = GetEHFrameUnwindPlan(target, current_offset);
   if (!eh_frame_plan)
     return m_unwind_plan_eh_frame_augmented_sp;
@@ -206,6 +212,10 @@ UnwindPlanSP FuncUnwinders::GetEHFrameAugmentedUnwindPlan(Target &target,
   } else {
     m_unwind_plan_eh_frame_augmented_sp.reset();
   }
+  if (m_unwind_plan_eh_frame_augmented_sp)
+    m_unwind_table.CacheUnwindPlan(
+        UnwindTable::eCachedUnwindPlanEHFrameAugmented, func_file_addr,
+        *m_unwind_plan_eh_frame_augmented_sp);
   return m_unwind_plan_eh_frame_augmented_sp;
 }
 
@@ -229,6 +239,12 @@ FuncUnwinders::GetDebugFrameAugmentedUnwindPlan(Target &target, Thread &thread,
 
   m_tried_unwind_plan_debug_frame_augmented = true;
 
+  const addr_t func_file_addr = m_range.GetBaseAddress().GetFileAddress();
+  m_unwind_plan_debug_frame_augmented_sp = m_unwind_table.GetCachedUnwindPlan(
+      UnwindTable::eCachedUnwindPlanDebugFrameAugmented, func_file_addr);
+  if (m_unwind_plan_debug_frame_augmented_sp)
+    return m_unwind_plan_debug_frame_augmented_sp;
+
   UnwindPlanSP debug_frame_plan =
       GetDebugFrameUnwindPlan(target, current_offset);
   if (!debug_frame_plan)
@@ -248,6 +264,10 @@ FuncUnwinders::GetDebugFrameAugmentedUnwindPlan(Target &target, Thread &thread,
     }
   } else
     m_unwind_plan_debug_frame_augmented_sp.reset();
+  if (m_unwind_plan_debug_frame_augmented_sp)
+    m_unwind_table.CacheUnwindPlan(
+        UnwindTable::eCachedUnwindPlanDebugFrameAugmented, func_file_addr,
+        *m_unwind_plan_debug_frame_augmented_sp);
   return m_unwind_plan_debug_frame_augmented_sp;
 }
 
@@ -262,6 +282,14 @@ UnwindPlanSP FuncUnwinders::GetAssemblyUnwindPlan(Target &target,
 
   m_tried_unwind_plan_assembly = true;
 
+  // Profiling the assembly is expensive, use the plan that an earlier debug
+  // session saved in the cache if there is one.
+  const addr_t func_file_addr = m_range.GetBaseAddress().GetFileAddress();
+  m_unwind_plan_assembly_sp = m_unwind_table.GetCachedUnwindPlan(
+      UnwindTable::eCachedUnwindPlanAssembly, func_file_addr);
+  if (m_unwind_plan_assembly_sp)
+    return m_unwind_plan_assembly_sp;
+
   UnwindAssemblySP assembly_profiler_sp(GetUnwindAssemblyProfiler(target));
   if (assembly_profiler_sp) {
     m_unwind_plan_assembly_sp.reset(new UnwindPlan(lldb::eRegisterKindGeneric));
@@ -270,6 +298,9 @@ UnwindPlanSP FuncUnwinders::GetAssemblyUnwindPlan(Target &target,
       m_unwind_plan_assembly_sp.reset();
     }
   }
+  if (m_unwind_plan_assembly_sp)
+    m_unwind_table.CacheUnwindPlan(UnwindTable::eCachedUnwindPlanAssembly,
+                                   func_file_addr, *m_unwind_plan_assembly_sp);
   return m_unwind_plan_assembly_sp;
 }
 
@@ -137,7 +137,8 @@ Function::Function(CompileUnit *comp_unit, lldb::user_id_t func_uid,
                    const AddressRange &range, bool canThrow)
     : UserID(func_uid), m_comp_unit(comp_unit), m_type_uid(type_uid),
       m_type(type), m_mangled(mangled), m_block(func_uid), m_range(range),
-      m_frame_base(nullptr), m_flags(), m_prologue_byte_size(0) {
+      m_frame_base(nullptr), m_flags(), m_prologue_byte_size(0),
+      m_block_parsed(false) {
   m_block.SetParentScope(this);
   if (canThrow)
     m_flags.Set(flagsFunctionCanThrow);
@@ -151,7 +152,7 @@ Function::Function(CompileUnit *comp_unit, lldb::user_id_t func_uid,
     : UserID(func_uid), m_comp_unit(comp_unit), m_type_uid(type_uid),
       m_type(type), m_mangled(ConstString(mangled), true), m_block(func_uid),
       m_range(range), m_frame_base(nullptr), m_flags(),
-      m_prologue_byte_size(0) {
+      m_prologue_byte_size(0), m_block_parsed(false) {
   m_block.SetParentScope(this);
 
   if (canThrow)
@@ -213,18 +214,28 @@ void Function::GetEndLineSourceInfo(FileSpec &source_file, uint32_t &line_no) {
 }
 
 Block &Function::GetBlock(bool can_create) {
-  if (!m_block.BlockInfoHasBeenParsed() && can_create) {
+  if (!m_block_parsed.load(std::memory_order_acquire) && can_create) {
     SymbolContext sc;
     CalculateSymbolContext(&sc);
     if (sc.module_sp) {
+      // Parsing the blocks takes the module's mutex anyway, use it to make
+      // sure only one thread parses them. A mutex of our own could deadlock
+      // with a thread that resolves a symbol context with the module's mutex
+      // held.
+      std::lock_guard<std::recursive_mutex> guard(sc.module_sp->GetMutex());
+      if (m_block_parsed.load(std::memory_order_relaxed))
+        return m_block;
       sc.module_sp->GetSymbolVendor()->ParseFunctionBlocks(sc);
+      m_block.SetBlockInfoHasBeenParsed(true, true);
+      m_block_parsed.store(true, std::memory_order_release);
     } else {
       Host::SystemLog(Host::eSystemLogError, "error: unable to find module "
                                              "shared pointer for function '%s' "
                                              "in %s\n",
                       GetName().GetCString(), m_comp_unit->GetPath().c_str());
+      m_block.SetBlockInfoHasBeenParsed(true, true);
+      m_block_parsed.store(true, std::memory_order_release);
     }
-    m_block.SetBlockInfoHasBeenParsed(true, true);
   }
   return m_block;
 }
@@ -267,7 +278,7 @@ void Function::Dump(Stream *s, bool show_context) const {
 
   s->EOL();
   // Dump the root object
-  if (m_block.BlockInfoHasBeenParsed())
+  if (m_block_parsed.load(std::memory_order_acquire))
     m_block.Dump(s, m_range.GetBaseAddress().GetFileAddress(), INT_MAX,
                  show_context);
 }
@@ -366,6 +366,7 @@ AddressClass ObjectFile::GetAddressClass(addr_t file_addr) {
           case eSectionTypeDWARFAppleExternalTypes:
           case eSectionTypeDWARFAppleNamespaces:
           case eSectionTypeDWARFAppleObjC:
+          case eSectionTypeDWARFDebugNames:
           case eSectionTypeSwiftModules:
             return eAddressClassDebug;
           case eSectionTypeEHFrame:
@@ -551,8 +552,18 @@ size_t ObjectFile::ReadSectionData(Section *section,
       const addr_t base_load_addr =
           section->GetLoadBaseAddress(&process_sp->GetTarget());
       if (base_load_addr != LLDB_INVALID_ADDRESS) {
+        // Share the memory of processes that have it mapped, like core
+        // files, instead of copying it.
+        const size_t section_size = section->GetByteSize();
+        if (section_size > 0 &&
+            process_sp->PeekMemory(base_load_addr, section_size,
+                                   section_data) == section_size) {
+          section_data.SetByteOrder(process_sp->GetByteOrder());
+          section_data.SetAddressByteSize(process_sp->GetAddressByteSize());
+          return section_data.GetByteSize();
+        }
         DataBufferSP data_sp(
-            ReadMemory(process_sp, base_load_addr, section->GetByteSize()));
+            ReadMemory(process_sp, base_load_addr, section_size));
         if (data_sp) {
           section_data.SetData(data_sp, 0, data_sp->GetByteSize());
           section_data.SetByteOrder(process_sp->GetByteOrder());
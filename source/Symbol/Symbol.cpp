@@ -18,6 +18,7 @@
 #include "lldb/Symbol/Symtab.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Stream.h"
 
 using namespace lldb;
@@ -416,6 +417,111 @@ void Symbol::DumpSymbolContext(Stream *s) {
 
 lldb::addr_t Symbol::GetByteSize() const { return m_addr_range.GetByteSize(); }
 
+// The section ID that Encode() saves for sections of absolute symbols.
+static const lldb::user_id_t kAbsoluteSectionID = LLDB_INVALID_UID - 1;
+
+void Symbol::Encode(Stream &strm) const {
+  strm.PutHex32(m_uid);
+  strm.PutHex16(m_type_data);
+  strm.PutHex16(m_type_data_resolved | m_is_synthetic << 1 | m_is_debug << 2 |
+                m_is_external << 3 | m_size_is_sibling << 4 |
+                m_size_is_synthesized << 5 | m_size_is_valid << 6 |
+                m_demangled_is_synthesized << 7 |
+                m_contains_linker_annotations << 8);
+  strm.PutHex8(m_type);
+  strm.PutHex32(m_flags);
+  // Save the demangled name too so that loading the symbol doesn't have to
+  // demangle it again.
+  strm.PutCString(m_mangled.GetMangledName().GetStringRef());
+  strm.PutCString(m_mangled.GetDemangledName(GetLanguage()).GetStringRef());
+  const Address &addr = m_addr_range.GetBaseAddress();
+  SectionSP section_sp(addr.GetSection());
+  if (section_sp && section_sp->GetType() == eSectionTypeAbsoluteAddress) {
+    // Sections that were made up for absolute symbols all share the same ID,
+    // save the address of the section instead.
+    strm.PutHex64(kAbsoluteSectionID);
+    strm.PutHex64(section_sp->GetFileAddress());
+  } else {
+    strm.PutHex64(section_sp ? section_sp->GetID() : LLDB_INVALID_UID);
+  }
+  strm.PutHex64(addr.GetOffset());
+  strm.PutHex64(m_addr_range.GetByteSize());
+}
+
+static SectionSP FindAbsoluteSection(const SectionList &section_list,
+                                     lldb::addr_t file_addr) {
+  const size_t num_sections = section_list.GetSize();
+  for (size_t i = 0; i < num_sections; ++i) {
+    SectionSP section_sp(section_list.GetSectionAtIndex(i));
+    if (section_sp->GetType() == eSectionTypeAbsoluteAddress &&
+        section_sp->GetFileAddress() == file_addr)
+      return section_sp;
+  }
+  return SectionSP();
+}
+
+bool Symbol::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+                    const SectionList *section_list) {
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, 13))
+    return false;
+  m_uid = data.GetU32(offset_ptr);
+  m_type_data = data.GetU16(offset_ptr);
+  const uint16_t bits = data.GetU16(offset_ptr);
+  m_type_data_resolved = (bits & (1u << 0)) != 0;
+  m_is_synthetic = (bits & (1u << 1)) != 0;
+  m_is_debug = (bits & (1u << 2)) != 0;
+  m_is_external = (bits & (1u << 3)) != 0;
+  m_size_is_sibling = (bits & (1u << 4)) != 0;
+  m_size_is_synthesized = (bits & (1u << 5)) != 0;
+  m_size_is_valid = (bits & (1u << 6)) != 0;
+  m_demangled_is_synthesized = (bits & (1u << 7)) != 0;
+  m_contains_linker_annotations = (bits & (1u << 8)) != 0;
+  m_type = data.GetU8(offset_ptr);
+  m_flags = data.GetU32(offset_ptr);
+
+  const char *mangled = data.GetCStr(offset_ptr);
+  const char *demangled = data.GetCStr(offset_ptr);
+  if (mangled == nullptr || demangled == nullptr)
+    return false;
+  m_mangled.Clear();
+  m_mangled.SetMangledName(ConstString(mangled));
+  if (demangled[0]) {
+    if (m_mangled.GetMangledName()) {
+      ConstString demangled_name;
+      demangled_name.SetCStringWithMangledCounterpart(
+          demangled, m_mangled.GetMangledName());
+      m_mangled.SetDemangledName(demangled_name);
+    } else {
+      m_mangled.SetDemangledName(ConstString(demangled));
+    }
+  }
+
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, 3 * sizeof(uint64_t)))
+    return false;
+  const lldb::user_id_t section_id = data.GetU64(offset_ptr);
+  lldb::addr_t section_addr = LLDB_INVALID_ADDRESS;
+  if (section_id == kAbsoluteSectionID) {
+    if (!data.ValidOffsetForDataOfSize(*offset_ptr, 3 * sizeof(uint64_t)))
+      return false;
+    section_addr = data.GetU64(offset_ptr);
+  }
+  const lldb::addr_t offset = data.GetU64(offset_ptr);
+  const lldb::addr_t byte_size = data.GetU64(offset_ptr);
+  if (section_id == LLDB_INVALID_UID) {
+    m_addr_range = AddressRange(Address(offset), byte_size);
+  } else {
+    SectionSP section_sp;
+    if (section_list && section_id == kAbsoluteSectionID)
+      section_sp = FindAbsoluteSection(*section_list, section_addr);
+    else if (section_list)
+      section_sp = section_list->FindSectionByID(section_id);
+    if (!section_sp)
+      return false;
+    m_addr_range = AddressRange(section_sp, offset, byte_size);
+  }
+  return true;
+}
+
 Symbol *Symbol::ResolveReExportedSymbolInModuleSpec(
     Target &target, ConstString &reexport_name, ModuleSpec &module_spec,
     ModuleList &seen_modules) const {
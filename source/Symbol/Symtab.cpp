@@ -12,17 +12,24 @@
 
 #include "Plugins/Language/CPlusPlus/CPlusPlusLanguage.h"
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/STLUtils.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/Symtab.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Log.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
+#include "lldb/Utility/StreamString.h"
 #include "lldb/Utility/Timer.h"
 
+#include "llvm/ADT/Optional.h"
+
 
 #include "lldb/Target/SwiftLanguageRuntime.h"
 
@@ -218,6 +225,37 @@ const Symbol *Symtab::SymbolAtIndex(size_t idx) const {
   return nullptr;
 }
 
+namespace {
+//----------------------------------------------------------------------
+// The names of a range of symbols, collected on one thread by
+// Symtab::InitNameIndexes() before they are merged into the name indexes.
+//----------------------------------------------------------------------
+struct NameIndexChunk {
+  typedef std::vector<Symtab::NameToIndexMap::Entry> EntryCollection;
+
+  EntryCollection name_to_index;
+  EntryCollection basename_to_index;
+  EntryCollection method_to_index;
+  EntryCollection selector_to_index;
+  // C++ functions with a context that might or might not be a class. They
+  // are sorted out once the class contexts of all the symbols are known.
+  EntryCollection mangled_name_to_index;
+  // The "const char *" in "class_contexts" must come from a
+  // ConstString::GetCString()
+  std::set<const char *> class_contexts;
+};
+
+// Demangling dominates the time it takes to index a symbol table, so large
+// symbol tables are indexed in chunks of this many symbols on the task pool.
+const size_t g_symbols_per_chunk = 16 * 1024;
+} // namespace
+
+static void AppendEntries(const NameIndexChunk::EntryCollection &entries,
+                          Symtab::NameToIndexMap &map) {
+  for (const Symtab::NameToIndexMap::Entry &entry : entries)
+    map.Append(entry);
+}
+
 //----------------------------------------------------------------------
 // InitNameIndexes
 //----------------------------------------------------------------------
@@ -227,37 +265,22 @@ void Symtab::InitNameIndexes() {
     m_name_indexes_computed = true;
     static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
     Timer scoped_timer(func_cat, "%s", LLVM_PRETTY_FUNCTION);
+    ModuleSP module_sp(m_objfile ? m_objfile->GetModule() : ModuleSP());
+    llvm::Optional<ElapsedTime> elapsed;
+    if (module_sp)
+      elapsed.emplace(module_sp->GetSymtabIndexTime());
     // Create the name index vector to be able to quickly search by name
     const size_t num_symbols = m_symbols.size();
-#if 1
-    m_name_to_index.Reserve(num_symbols);
-#else
-    // TODO: benchmark this to see if we save any memory. Otherwise we
-    // will always keep the memory reserved in the vector unless we pull
-    // some STL swap magic and then recopy...
-    uint32_t actual_count = 0;
-    for (const_iterator pos = m_symbols.begin(), end = m_symbols.end();
-         pos != end; ++pos) {
-      const Mangled &mangled = pos->GetMangled();
-      if (mangled.GetMangledName())
-        ++actual_count;
-
-      if (mangled.GetDemangledName())
-        ++actual_count;
-    }
-
-    m_name_to_index.Reserve(actual_count);
-#endif
-
-    NameToIndexMap::Entry entry;
-
-    // The "const char *" in "class_contexts" must come from a
-    // ConstString::GetCString()
-    std::set<const char *> class_contexts;
-    UniqueCStringMap<uint32_t> mangled_name_to_index;
+    const size_t num_chunks =
+        (num_symbols + g_symbols_per_chunk - 1) / g_symbols_per_chunk;
+    std::vector<NameIndexChunk> chunks(num_chunks);
+    // Each chunk only sets the contexts of its own symbols.
     std::vector<const char *> symbol_contexts(num_symbols, nullptr);
 
-    for (entry.value = 0; entry.value < num_symbols; ++entry.value) {
+    auto add_symbol_names = [this, &symbol_contexts](uint32_t value,
+                                                     NameIndexChunk &chunk) {
+      NameToIndexMap::Entry entry;
+      entry.value = value;
       const Symbol *symbol = &m_symbols[entry.value];
 
       // Don't let trampolines get into the lookup by name map
@@ -266,12 +289,12 @@ void Symtab::InitNameIndexes() {
       // Symtab functions that lookup symbols by name to indicate if they
       // want trampolines.
       if (symbol->IsTrampoline())
-        continue;
+        return;
 
       const Mangled &mangled = symbol->GetMangled();
       entry.cstring = mangled.GetMangledName();
       if (entry.cstring) {
-        m_name_to_index.Append(entry);
+        chunk.name_to_index.push_back(entry);
 
         // Now try and figure out the basename and figure out if the
         // basename is a method, function, etc and put that in the
@@ -282,7 +305,7 @@ void Symtab::InitNameIndexes() {
           // the annotations.
           entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(
                                         entry.cstring.GetStringRef()));
-          m_name_to_index.Append(entry);
+          chunk.name_to_index.push_back(entry);
         }
 
         const SymbolType symbol_type = symbol->GetType();
@@ -311,11 +334,11 @@ void Symtab::InitNameIndexes() {
 
               if (!const_context || const_context[0] == 0) {
                 // No context for this function so this has to be a basename
-                m_basename_to_index.Append(entry);
+                chunk.basename_to_index.push_back(entry);
                 // If there is no context (no namespaces or class scopes that
                 // come before the function name) then this also could be a
                 // fullname.
-                m_name_to_index.Append(entry);
+                chunk.name_to_index.push_back(entry);
               } else {
                 entry_ref = entry.cstring.GetStringRef();
                 if (entry_ref[0] == '~' ||
@@ -323,26 +346,15 @@ void Symtab::InitNameIndexes() {
                   // The first character of the demangled basename is '~' which
                   // means we have a class destructor. We can use this information
                   // to help us know what is a class and what isn't.
-                  if (class_contexts.find(const_context) == class_contexts.end())
-                    class_contexts.insert(const_context);
-                  m_method_to_index.Append(entry);
+                  chunk.class_contexts.insert(const_context);
+                  chunk.method_to_index.push_back(entry);
                 } else {
-                  if (class_contexts.find(const_context) !=
-                      class_contexts.end()) {
-                    // The current decl context is in our "class_contexts" which
-                    // means
-                    // this is a method on a class
-                    m_method_to_index.Append(entry);
-                  } else {
-                    // We don't know if this is a function basename or a method,
-                    // so put it into a temporary collection so once we are done
-                    // we can look in class_contexts to see if each entry is a
-                    // class
-                    // or just a function and will put any remaining items into
-                    // m_method_to_index or m_basename_to_index as needed
-                    mangled_name_to_index.Append(entry);
-                    symbol_contexts[entry.value] = const_context;
-                  }
+                  // We don't know if this is a function basename or a method
+                  // until the class contexts of all the symbols are known, so
+                  // put it into a temporary collection for now and put it into
+                  // m_method_to_index or m_basename_to_index once we are done.
+                  chunk.mangled_name_to_index.push_back(entry);
+                  symbol_contexts[entry.value] = const_context;
                 }
               }
             }
@@ -356,9 +368,9 @@ void Symtab::InitNameIndexes() {
               if (basename && basename != mangled_name) {
                 entry.cstring = basename;
                 if (is_method)
-                  m_method_to_index.Append(entry);
+                  chunk.method_to_index.push_back(entry);
                 else
-                  m_basename_to_index.Append(entry);
+                  chunk.basename_to_index.push_back(entry);
               }
             }
           }
@@ -367,14 +379,14 @@ void Symtab::InitNameIndexes() {
 
       entry.cstring = mangled.GetDemangledName(symbol->GetLanguage());
       if (entry.cstring) {
-        m_name_to_index.Append(entry);
+        chunk.name_to_index.push_back(entry);
 
         if (symbol->ContainsLinkerAnnotations()) {
           // If the symbol has linker annotations, also add the version without
           // the annotations.
           entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(
                                         entry.cstring.GetStringRef()));
-          m_name_to_index.Append(entry);
+          chunk.name_to_index.push_back(entry);
         }
       }
 
@@ -384,45 +396,75 @@ void Symtab::InitNameIndexes() {
       ObjCLanguage::MethodName objc_method(entry.cstring.GetStringRef(), true);
       if (objc_method.IsValid(true)) {
         entry.cstring = objc_method.GetSelector();
-        m_selector_to_index.Append(entry);
+        chunk.selector_to_index.push_back(entry);
 
         ConstString objc_method_no_category(
             objc_method.GetFullNameWithoutCategory(true));
         if (objc_method_no_category) {
           entry.cstring = objc_method_no_category;
-          m_name_to_index.Append(entry);
+          chunk.name_to_index.push_back(entry);
         }
       }
+    };
+
+    TaskMapOverInt(0, num_chunks, [&](size_t chunk_idx) {
+      const uint32_t begin = chunk_idx * g_symbols_per_chunk;
+      const uint32_t end =
+          std::min<size_t>(begin + g_symbols_per_chunk, num_symbols);
+      for (uint32_t value = begin; value < end; ++value)
+        add_symbol_names(value, chunks[chunk_idx]);
+    });
+
+    // Merge the chunks in symbol order.
+    size_t num_names = 0;
+    size_t num_basenames = 0;
+    size_t num_methods = 0;
+    size_t num_selectors = 0;
+    std::set<const char *> class_contexts;
+    for (const NameIndexChunk &chunk : chunks) {
+      num_names += chunk.name_to_index.size();
+      num_basenames +=
+          chunk.basename_to_index.size() + chunk.mangled_name_to_index.size();
+      num_methods +=
+          chunk.method_to_index.size() + chunk.mangled_name_to_index.size();
+      num_selectors += chunk.selector_to_index.size();
+      class_contexts.insert(chunk.class_contexts.begin(),
+                            chunk.class_contexts.end());
+    }
+    m_name_to_index.Reserve(num_names);
+    m_basename_to_index.Reserve(num_basenames);
+    m_method_to_index.Reserve(num_methods);
+    m_selector_to_index.Reserve(num_selectors);
+    for (const NameIndexChunk &chunk : chunks) {
+      AppendEntries(chunk.name_to_index, m_name_to_index);
+      AppendEntries(chunk.basename_to_index, m_basename_to_index);
+      AppendEntries(chunk.method_to_index, m_method_to_index);
+      AppendEntries(chunk.selector_to_index, m_selector_to_index);
     }
 
-    size_t count;
-    if (!mangled_name_to_index.IsEmpty()) {
-      count = mangled_name_to_index.GetSize();
-      for (size_t i = 0; i < count; ++i) {
-        if (mangled_name_to_index.GetValueAtIndex(i, entry.value)) {
-          entry.cstring = mangled_name_to_index.GetCStringAtIndex(i);
-          if (symbol_contexts[entry.value] &&
-              class_contexts.find(symbol_contexts[entry.value]) !=
-                  class_contexts.end()) {
-            m_method_to_index.Append(entry);
-          } else {
-            // If we got here, we have something that had a context (was inside
-            // a namespace or class)
-            // yet we don't know if the entry
-            m_method_to_index.Append(entry);
-            m_basename_to_index.Append(entry);
-          }
+    for (const NameIndexChunk &chunk : chunks) {
+      for (const NameToIndexMap::Entry &entry : chunk.mangled_name_to_index) {
+        if (symbol_contexts[entry.value] &&
+            class_contexts.find(symbol_contexts[entry.value]) !=
+                class_contexts.end()) {
+          m_method_to_index.Append(entry);
+        } else {
+          // If we got here, we have something that had a context (was inside
+          // a namespace or class)
+          // yet we don't know if the entry
+          m_method_to_index.Append(entry);
+          m_basename_to_index.Append(entry);
         }
       }
     }
-    m_name_to_index.Sort();
-    m_name_to_index.SizeToFit();
-    m_selector_to_index.Sort();
-    m_selector_to_index.SizeToFit();
-    m_basename_to_index.Sort();
-    m_basename_to_index.SizeToFit();
-    m_method_to_index.Sort();
-    m_method_to_index.SizeToFit();
+    chunks.clear();
+
+    NameToIndexMap *maps[] = {&m_name_to_index, &m_selector_to_index,
+                              &m_basename_to_index, &m_method_to_index};
+    TaskMapOverInt(0, llvm::array_lengthof(maps), [&maps](size_t idx) {
+      maps[idx]->Sort();
+      maps[idx]->SizeToFit();
+    });
   }
 }
 
@@ -431,6 +473,203 @@ void Symtab::PreloadSymbols() {
   InitNameIndexes();
 }
 
+static const uint32_t kSymtabCacheMagic = 0x53594D54; // 'SYMT'
+static const uint32_t kSymtabCacheVersion = 2;
+
+static void EncodeNameToIndexMap(Stream &strm,
+                                 const Symtab::NameToIndexMap &map) {
+  const uint32_t size = map.GetSize();
+  uint32_t num_names = 0;
+  for (uint32_t i = 0; i < size; ++i) {
+    if (i == 0 || map.GetCStringAtIndexUnchecked(i) !=
+                      map.GetCStringAtIndexUnchecked(i - 1))
+      ++num_names;
+  }
+  strm.PutHex32(num_names);
+
+  uint32_t i = 0;
+  while (i < size) {
+    ConstString name = map.GetCStringAtIndexUnchecked(i);
+    uint32_t end = i + 1;
+    while (end < size && map.GetCStringAtIndexUnchecked(end) == name)
+      ++end;
+    strm.PutCString(name.GetStringRef());
+    strm.PutHex32(end - i);
+    for (; i < end; ++i)
+      strm.PutHex32(map.GetValueRefAtIndexUnchecked(i));
+  }
+}
+
+static bool DecodeNameToIndexMap(const DataExtractor &data,
+                                 lldb::offset_t *offset_ptr,
+                                 uint32_t num_symbols,
+                                 Symtab::NameToIndexMap &map) {
+  const uint32_t num_names = data.GetU32(offset_ptr);
+  for (uint32_t i = 0; i < num_names; ++i) {
+    const char *cstr = data.GetCStr(offset_ptr);
+    if (cstr == nullptr)
+      return false;
+    ConstString name(cstr);
+    const uint32_t num_indexes = data.GetU32(offset_ptr);
+    if (!data.ValidOffsetForDataOfSize(*offset_ptr,
+                                       num_indexes * sizeof(uint32_t)))
+      return false;
+    for (uint32_t j = 0; j < num_indexes; ++j) {
+      const uint32_t symbol_idx = data.GetU32(offset_ptr);
+      if (symbol_idx >= num_symbols)
+        return false;
+      map.Append(name, symbol_idx);
+    }
+  }
+  // The map is sorted by string pool pointer, which is different in every
+  // process.
+  map.Sort();
+  map.SizeToFit();
+  return true;
+}
+
+void Symtab::Encode(Stream &strm) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  InitNameIndexes();
+
+  strm.PutHex32(m_symbols.size());
+  for (const Symbol &symbol : m_symbols)
+    symbol.Encode(strm);
+  EncodeNameToIndexMap(strm, m_name_to_index);
+  EncodeNameToIndexMap(strm, m_basename_to_index);
+  EncodeNameToIndexMap(strm, m_method_to_index);
+  EncodeNameToIndexMap(strm, m_selector_to_index);
+}
+
+bool Symtab::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  m_symbols.clear();
+  m_file_addr_to_index.Clear();
+  m_file_addr_to_index_computed = false;
+  m_name_to_index.Clear();
+  m_basename_to_index.Clear();
+  m_method_to_index.Clear();
+  m_selector_to_index.Clear();
+  m_name_indexes_computed = false;
+
+  ModuleSP module_sp(m_objfile ? m_objfile->GetModule() : ModuleSP());
+  const SectionList *section_list =
+      module_sp ? module_sp->GetSectionList()
+                : (m_objfile ? m_objfile->GetSectionList() : nullptr);
+
+  const uint32_t num_symbols = data.GetU32(offset_ptr);
+  // Every symbol takes more than 13 bytes, don't trust a corrupt count.
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, num_symbols * 13ull))
+    return false;
+  m_symbols.resize(num_symbols);
+  bool success = true;
+  for (uint32_t i = 0; success && i < num_symbols; ++i)
+    success = m_symbols[i].Decode(data, offset_ptr, section_list);
+  success = success &&
+            DecodeNameToIndexMap(data, offset_ptr, num_symbols,
+                                 m_name_to_index) &&
+            DecodeNameToIndexMap(data, offset_ptr, num_symbols,
+                                 m_basename_to_index) &&
+            DecodeNameToIndexMap(data, offset_ptr, num_symbols,
+                                 m_method_to_index) &&
+            DecodeNameToIndexMap(data, offset_ptr, num_symbols,
+                                 m_selector_to_index);
+  if (!success) {
+    m_symbols.clear();
+    m_name_to_index.Clear();
+    m_basename_to_index.Clear();
+    m_method_to_index.Clear();
+    m_selector_to_index.Clear();
+    return false;
+  }
+  m_name_indexes_computed = true;
+  return true;
+}
+
+// The signature of the object file the symbols were read from, if that
+// isn't the main object file of the module.
+static CacheSignature GetSymbolFileSignature(Module &module,
+                                             ObjectFile *symbol_file) {
+  if (symbol_file == nullptr || symbol_file == module.GetObjectFile())
+    return CacheSignature();
+  return CacheSignature(*symbol_file);
+}
+
+bool Symtab::LoadFromCache(
+    ObjectFile *symbol_file,
+    llvm::function_ref<bool(const DataExtractor &, lldb::offset_t *)>
+        decode_object_file_data) {
+  DataFileCache *cache = DataFileCache::GetIndexCache();
+  ModuleSP module_sp(m_objfile ? m_objfile->GetModule() : ModuleSP());
+  if (cache == nullptr || !module_sp)
+    return false;
+  const std::string key =
+      DataFileCache::GetModuleCacheKey(*module_sp, "symtab");
+  DataBufferSP data_sp = cache->GetCachedData(key);
+  if (!data_sp)
+    return false;
+
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "Symtab::LoadFromCache (%s)", key.c_str());
+
+  DataExtractor data(data_sp, endian::InlHostByteOrder(),
+                     m_objfile->GetAddressByteSize());
+  lldb::offset_t offset = 0;
+  CacheSignature signature;
+  CacheSignature symbol_file_signature;
+  const bool valid =
+      data.GetU32(&offset) == kSymtabCacheMagic &&
+      data.GetU32(&offset) == kSymtabCacheVersion &&
+      signature.Decode(data, &offset) &&
+      signature == CacheSignature(*module_sp) &&
+      symbol_file_signature.Decode(data, &offset) &&
+      symbol_file_signature ==
+          GetSymbolFileSignature(*module_sp, symbol_file) &&
+      decode_object_file_data(data, &offset) && Decode(data, &offset);
+
+  Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_SYMBOLS));
+  if (!valid) {
+    if (log)
+      log->Printf("Symtab::LoadFromCache: discarding stale symbol table "
+                  "cache file \"%s\"",
+                  key.c_str());
+    cache->RemoveCacheFile(key);
+    return false;
+  }
+  if (log)
+    log->Printf("Symtab::LoadFromCache: loaded %zu symbols from cache file "
+                "\"%s\"",
+                m_symbols.size(), key.c_str());
+  return true;
+}
+
+void Symtab::SaveToCache(
+    ObjectFile *symbol_file,
+    llvm::function_ref<void(Stream &)> encode_object_file_data) {
+  DataFileCache *cache = DataFileCache::GetIndexCache();
+  ModuleSP module_sp(m_objfile ? m_objfile->GetModule() : ModuleSP());
+  if (cache == nullptr || !module_sp)
+    return;
+  CacheSignature signature(*module_sp);
+  if (!signature.IsValid())
+    return;
+  const std::string key =
+      DataFileCache::GetModuleCacheKey(*module_sp, "symtab");
+
+  StreamString strm(Stream::eBinary, m_objfile->GetAddressByteSize(),
+                    endian::InlHostByteOrder());
+  strm.PutHex32(kSymtabCacheMagic);
+  strm.PutHex32(kSymtabCacheVersion);
+  signature.Encode(strm);
+  GetSymbolFileSignature(*module_sp, symbol_file).Encode(strm);
+  encode_object_file_data(strm);
+  Encode(strm);
+  cache->SetCachedData(
+      key, llvm::ArrayRef<uint8_t>(
+               reinterpret_cast<const uint8_t *>(strm.GetData()),
+               strm.GetSize()));
+}
+
 void Symtab::AppendSymbolNamesToMap(const IndexCollection &indexes,
                                     bool add_demangled, bool add_mangled,
                                     NameToIndexMap &name_to_index_map) const {
@@ -1065,7 +1304,8 @@ void Symtab::SymbolIndicesToSymbolContextList(
   size_t num_indices = symbol_indexes.size();
   if (num_indices > 0) {
     SymbolContext sc;
-    sc.module_sp = m_objfile->GetModule();
+    if (m_objfile)
+      sc.module_sp = m_objfile->GetModule();
     for (size_t i = 0; i < num_indices; i++) {
       sc.symbol = SymbolAtIndex(symbol_indexes[i]);
       if (sc.symbol)
@@ -9,10 +9,12 @@
 
 #include "lldb/Symbol/UnwindPlan.h"
 
+#include "lldb/Core/Section.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Log.h"
 
 using namespace lldb;
@@ -302,6 +304,111 @@ bool UnwindPlan::Row::operator==(const UnwindPlan::Row &rhs) const {
          m_register_locations == rhs.m_register_locations;
 }
 
+bool UnwindPlan::Row::Encode(Stream &strm) const {
+  strm.PutHex64(m_offset);
+
+  // CFA value: type, register number, offset.
+  switch (m_cfa_value.GetValueType()) {
+  case CFAValue::unspecified:
+    strm.PutHex8(CFAValue::unspecified);
+    strm.PutHex32(LLDB_INVALID_REGNUM);
+    strm.PutHex32(0);
+    break;
+  case CFAValue::isRegisterPlusOffset:
+  case CFAValue::isRegisterDereferenced:
+    strm.PutHex8(m_cfa_value.GetValueType());
+    strm.PutHex32(m_cfa_value.GetRegisterNumber());
+    strm.PutHex32(m_cfa_value.GetOffset());
+    break;
+  case CFAValue::isDWARFExpression:
+    return false;
+  }
+
+  // Register locations: register number, type, offset or other register.
+  strm.PutHex32(m_register_locations.size());
+  for (const auto &pos : m_register_locations) {
+    const RegisterLocation &loc = pos.second;
+    uint32_t value = 0;
+    switch (loc.GetLocationType()) {
+    case RegisterLocation::unspecified:
+    case RegisterLocation::undefined:
+    case RegisterLocation::same:
+      break;
+    case RegisterLocation::atCFAPlusOffset:
+    case RegisterLocation::isCFAPlusOffset:
+      value = loc.GetOffset();
+      break;
+    case RegisterLocation::inOtherRegister:
+      value = loc.GetRegisterNumber();
+      break;
+    case RegisterLocation::atDWARFExpression:
+    case RegisterLocation::isDWARFExpression:
+      return false;
+    }
+    strm.PutHex32(pos.first);
+    strm.PutHex8(loc.GetLocationType());
+    strm.PutHex32(value);
+  }
+  return true;
+}
+
+bool UnwindPlan::Row::Decode(const DataExtractor &data,
+                             lldb::offset_t *offset_ptr) {
+  Clear();
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, 21))
+    return false;
+  m_offset = data.GetU64(offset_ptr);
+
+  const uint8_t cfa_type = data.GetU8(offset_ptr);
+  const uint32_t cfa_reg_num = data.GetU32(offset_ptr);
+  const int32_t cfa_offset = data.GetU32(offset_ptr);
+  switch (cfa_type) {
+  case CFAValue::unspecified:
+    break;
+  case CFAValue::isRegisterPlusOffset:
+    m_cfa_value.SetIsRegisterPlusOffset(cfa_reg_num, cfa_offset);
+    break;
+  case CFAValue::isRegisterDereferenced:
+    m_cfa_value.SetIsRegisterDereferenced(cfa_reg_num);
+    break;
+  default:
+    return false;
+  }
+
+  const uint32_t num_locations = data.GetU32(offset_ptr);
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, num_locations * 9ull))
+    return false;
+  for (uint32_t i = 0; i < num_locations; ++i) {
+    const uint32_t reg_num = data.GetU32(offset_ptr);
+    const uint8_t type = data.GetU8(offset_ptr);
+    const uint32_t value = data.GetU32(offset_ptr);
+    RegisterLocation loc;
+    switch (type) {
+    case RegisterLocation::unspecified:
+      break;
+    case RegisterLocation::undefined:
+      loc.SetUndefined();
+      break;
+    case RegisterLocation::same:
+      loc.SetSame();
+      break;
+    case RegisterLocation::atCFAPlusOffset:
+      loc.SetAtCFAPlusOffset(static_cast<int32_t>(value));
+      break;
+    case RegisterLocation::isCFAPlusOffset:
+      loc.SetIsCFAPlusOffset(static_cast<int32_t>(value));
+      break;
+    case RegisterLocation::inOtherRegister:
+      loc.SetInRegister(value);
+      break;
+    default:
+      return false;
+    }
+    m_register_locations[reg_num] = loc;
+  }
+  return true;
+}
+
 void UnwindPlan::AppendRow(const UnwindPlan::RowSP &row_sp) {
   if (m_row_list.empty() ||
       m_row_list.back()->GetOffset() != row_sp->GetOffset())
@@ -377,6 +484,68 @@ void UnwindPlan::SetPlanValidAddressRange(const AddressRange &range) {
     m_plan_valid_address_range = range;
 }
 
+bool UnwindPlan::Encode(Stream &strm) const {
+  strm.PutHex32(m_register_kind);
+  strm.PutHex32(m_return_addr_register);
+  strm.PutCString(m_source_name.GetStringRef());
+  strm.PutHex8(m_plan_is_sourced_from_compiler);
+  strm.PutHex8(m_plan_is_valid_at_all_instruction_locations);
+  strm.PutHex64(m_plan_valid_address_range.GetBaseAddress().GetFileAddress());
+  strm.PutHex64(m_plan_valid_address_range.GetByteSize());
+  strm.PutHex64(m_lsda_address.GetFileAddress());
+  strm.PutHex64(m_personality_func_addr.GetFileAddress());
+  strm.PutHex32(m_row_list.size());
+  for (const RowSP &row_sp : m_row_list) {
+    if (!row_sp->Encode(strm))
+      return false;
+  }
+  return true;
+}
+
+bool UnwindPlan::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+                        const SectionList *section_list) {
+  Clear();
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, 8))
+    return false;
+  m_register_kind = static_cast<RegisterKind>(data.GetU32(offset_ptr));
+  m_return_addr_register = data.GetU32(offset_ptr);
+  const char *source_name = data.GetCStr(offset_ptr);
+  if (source_name == nullptr ||
+      !data.ValidOffsetForDataOfSize(*offset_ptr, 38))
+    return false;
+  m_source_name.SetCString(source_name);
+  m_plan_is_sourced_from_compiler =
+      static_cast<LazyBool>(static_cast<int8_t>(data.GetU8(offset_ptr)));
+  m_plan_is_valid_at_all_instruction_locations =
+      static_cast<LazyBool>(static_cast<int8_t>(data.GetU8(offset_ptr)));
+
+  auto decode_address = [&data, offset_ptr, section_list]() {
+    const addr_t file_addr = data.GetU64(offset_ptr);
+    return file_addr == LLDB_INVALID_ADDRESS
+               ? Address()
+               : Address(file_addr, section_list);
+  };
+  const Address range_base = decode_address();
+  const addr_t range_size = data.GetU64(offset_ptr);
+  SetPlanValidAddressRange(AddressRange(range_base, range_size));
+  m_lsda_address = decode_address();
+  m_personality_func_addr = decode_address();
+
+  const uint32_t num_rows = data.GetU32(offset_ptr);
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, num_rows * 21ull))
+    return false;
+  m_row_list.reserve(num_rows);
+  for (uint32_t i = 0; i < num_rows; ++i) {
+    RowSP row_sp(new Row());
+    if (!row_sp->Decode(data, offset_ptr)) {
+      m_row_list.clear();
+      return false;
+    }
+    m_row_list.push_back(row_sp);
+  }
+  return true;
+}
+
 bool UnwindPlan::PlanValidAtAddress(Address addr) {
   // If this UnwindPlan has no rows, it is an invalid UnwindPlan.
   if (GetRowCount() == 0) {
@@ -11,6 +11,8 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Symbol/ArmUnwindInfo.h"
@@ -19,6 +21,12 @@
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Symbol/Symtab.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Utility/DataBuffer.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Log.h"
+#include "lldb/Utility/StreamString.h"
 
 // There is one UnwindTable object per ObjectFile.
 // It contains a list of Unwind objects -- one per function, populated lazily --
@@ -29,7 +37,8 @@ using namespace lldb;
 using namespace lldb_private;
 
 UnwindTable::UnwindTable(ObjectFile &objfile)
-    : m_object_file(objfile), m_unwinds(), m_initialized(false), m_mutex(),
+    : m_object_file(objfile), m_unwinds(), m_function_bounds(),
+      m_function_bounds_once(), m_initialized(false), m_mutex(),
       m_eh_frame_up(), m_compact_unwind_up(), m_arm_unwind_up() {}
 
 // We can't do some of this initialization when the ObjectFile is running its
@@ -37,47 +46,156 @@ UnwindTable::UnwindTable(ObjectFile &objfile)
 // until needed for something.
 
 void UnwindTable::Initialize() {
-  if (m_initialized)
+  // Lookups read the unwind info pointers without taking m_mutex, so
+  // m_initialized is only published once they are all set.
+  if (m_initialized.load(std::memory_order_acquire))
     return;
 
+  // Getting the section list can take the module's mutex, don't do it with
+  // m_mutex held.
+  SectionList *sl = m_object_file.GetSectionList();
+
   std::lock_guard<std::mutex> guard(m_mutex);
 
-  if (m_initialized) // check again once we've acquired the lock
+  // check again once we've acquired the lock
+  if (m_initialized.load(std::memory_order_relaxed))
     return;
-  m_initialized = true;
 
-  SectionList *sl = m_object_file.GetSectionList();
-  if (!sl)
-    return;
+  if (sl)
+    InitializeUnwindInfo(*sl);
+  m_initialized.store(true, std::memory_order_release);
+}
 
-  SectionSP sect = sl->FindSectionByType(eSectionTypeEHFrame, true);
+void UnwindTable::InitializeUnwindInfo(SectionList &sl) {
+  SectionSP sect = sl.FindSectionByType(eSectionTypeEHFrame, true);
   if (sect.get()) {
     m_eh_frame_up.reset(
         new DWARFCallFrameInfo(m_object_file, sect, DWARFCallFrameInfo::EH));
   }
 
-  sect = sl->FindSectionByType(eSectionTypeDWARFDebugFrame, true);
+  sect = sl.FindSectionByType(eSectionTypeDWARFDebugFrame, true);
   if (sect) {
     m_debug_frame_up.reset(
         new DWARFCallFrameInfo(m_object_file, sect, DWARFCallFrameInfo::DWARF));
   }
 
-  sect = sl->FindSectionByType(eSectionTypeCompactUnwind, true);
+  sect = sl.FindSectionByType(eSectionTypeCompactUnwind, true);
   if (sect) {
     m_compact_unwind_up.reset(new CompactUnwindInfo(m_object_file, sect));
   }
 
-  sect = sl->FindSectionByType(eSectionTypeARMexidx, true);
+  sect = sl.FindSectionByType(eSectionTypeARMexidx, true);
   if (sect) {
-    SectionSP sect_extab = sl->FindSectionByType(eSectionTypeARMextab, true);
+    SectionSP sect_extab = sl.FindSectionByType(eSectionTypeARMextab, true);
     if (sect_extab.get()) {
       m_arm_unwind_up.reset(new ArmUnwindInfo(m_object_file, sect, sect_extab));
     }
   }
 }
 
+// The ObjectFile is being destroyed when the UnwindTable is, so the unwind
+// plan cache can't be saved here. Process::Finalize saves it instead.
 UnwindTable::~UnwindTable() {}
 
+// Gather the bounds of every function we know about so that finding the
+// function that contains an address is a binary search over an array that
+// doesn't change. Sized code symbols take precedence over FDEs, like they do
+// in GetAddressRange(), and FDEs fill in the functions without a symbol.
+//
+// Reading every FDE takes a long time for large binaries, so the functions
+// without a symbol only get their start address from the .eh_frame_hdr
+// table here. Their size is read from their FDE the first time an address
+// is looked up in them, see ResolveFunctionBounds(). Without an
+// .eh_frame_hdr table, FDEs are only looked at by GetAddressRange().
+void UnwindTable::InitializeFunctionBounds() {
+  std::vector<FunctionBounds> bounds;
+  Symtab *symtab = m_object_file.GetSymtab();
+  if (symtab) {
+    std::lock_guard<std::recursive_mutex> guard(symtab->GetMutex());
+    const size_t num_symbols = symtab->GetNumSymbols();
+    for (size_t i = 0; i < num_symbols; ++i) {
+      const Symbol *symbol = symtab->SymbolAtIndex(i);
+      const SymbolType type = symbol->GetType();
+      if ((type != eSymbolTypeCode && type != eSymbolTypeResolver) ||
+          !symbol->ValueIsAddress() || !symbol->GetByteSizeIsValid() ||
+          symbol->GetByteSize() == 0)
+        continue;
+      const addr_t file_addr = symbol->GetAddressRef().GetFileAddress();
+      if (file_addr != LLDB_INVALID_ADDRESS)
+        bounds.emplace_back(file_addr, symbol->GetByteSize());
+    }
+  }
+  // Sort by address, then largest first, and keep only the first of
+  // overlapping functions (the largest of aliases), a nested symbol would
+  // make the bounds ambiguous.
+  std::sort(bounds.begin(), bounds.end(),
+            [](const FunctionBounds &lhs, const FunctionBounds &rhs) {
+              if (lhs.m_file_addr != rhs.m_file_addr)
+                return lhs.m_file_addr < rhs.m_file_addr;
+              return lhs.GetByteSize() > rhs.GetByteSize();
+            });
+  std::vector<FunctionBounds> function_bounds;
+  for (const FunctionBounds &symbol_bounds : bounds) {
+    if (function_bounds.empty() ||
+        symbol_bounds.m_file_addr >= function_bounds.back().m_file_addr +
+                                         function_bounds.back().GetByteSize())
+      function_bounds.push_back(symbol_bounds);
+  }
+  bounds.clear();
+
+  if (m_eh_frame_up) {
+    m_eh_frame_up->ForEachEHFrameHdrFunctionStart(
+        [&function_bounds, &bounds](addr_t file_addr) {
+          auto pos = std::upper_bound(function_bounds.begin(),
+                                      function_bounds.end(),
+                                      FunctionBounds(file_addr, 0));
+          if (pos == function_bounds.begin() ||
+              std::prev(pos)->m_file_addr + std::prev(pos)->GetByteSize() <=
+                  file_addr)
+            bounds.emplace_back(file_addr, FunctionBounds::kUnresolvedSize);
+          return true;
+        });
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end(),
+                           [](const FunctionBounds &lhs,
+                              const FunctionBounds &rhs) {
+                             return lhs.m_file_addr == rhs.m_file_addr;
+                           }),
+               bounds.end());
+  const size_t num_symbol_bounds = function_bounds.size();
+  function_bounds.insert(function_bounds.end(), bounds.begin(), bounds.end());
+  std::inplace_merge(function_bounds.begin(),
+                     function_bounds.begin() + num_symbol_bounds,
+                     function_bounds.end());
+
+  m_function_bounds.swap(function_bounds);
+}
+
+// Read the size of a function that InitializeFunctionBounds() only knew the
+// start address of from its FDE. The size is cut off at the next function so
+// the bounds stay disjoint. If several threads get here at the same time
+// they all compute the same size.
+lldb::addr_t UnwindTable::ResolveFunctionBounds(
+    std::vector<FunctionBounds>::iterator bounds_pos) {
+  addr_t byte_size = 0;
+  Address func_addr;
+  AddressRange range;
+  if (m_eh_frame_up &&
+      func_addr.ResolveAddressUsingFileSections(
+          bounds_pos->m_file_addr, m_object_file.GetSectionList()) &&
+      m_eh_frame_up->GetAddressRange(func_addr, range) &&
+      range.GetBaseAddress().GetFileAddress() == bounds_pos->m_file_addr) {
+    byte_size = range.GetByteSize();
+    auto next_pos = std::next(bounds_pos);
+    if (next_pos != m_function_bounds.end())
+      byte_size =
+          std::min(byte_size, next_pos->m_file_addr - bounds_pos->m_file_addr);
+  }
+  bounds_pos->m_byte_size.store(byte_size, std::memory_order_release);
+  return byte_size;
+}
+
 llvm::Optional<AddressRange> UnwindTable::GetAddressRange(const Address &addr,
                                                           SymbolContext &sc) {
   AddressRange range;
@@ -103,11 +221,39 @@ FuncUnwindersSP
 UnwindTable::GetFuncUnwindersContainingAddress(const Address &addr,
                                                SymbolContext &sc) {
   Initialize();
-
-  std::lock_guard<std::mutex> guard(m_mutex);
+  std::call_once(m_function_bounds_once,
+                 [this]() { InitializeFunctionBounds(); });
 
   // There is an UnwindTable per object file, so we can safely use file handles
   addr_t file_addr = addr.GetFileAddress();
+  auto bounds_pos = std::upper_bound(m_function_bounds.begin(),
+                                     m_function_bounds.end(),
+                                     FunctionBounds(file_addr, 0));
+  if (bounds_pos != m_function_bounds.begin()) {
+    --bounds_pos;
+    addr_t byte_size = bounds_pos->GetByteSize();
+    if (byte_size == FunctionBounds::kUnresolvedSize)
+      byte_size = ResolveFunctionBounds(bounds_pos);
+    if (file_addr - bounds_pos->m_file_addr < byte_size) {
+      FuncUnwindersSP func_unwinder_sp =
+          std::atomic_load(&bounds_pos->m_func_unwinders_sp);
+      if (func_unwinder_sp)
+        return func_unwinder_sp;
+      FuncUnwindersSP new_func_unwinder_sp(std::make_shared<FuncUnwinders>(
+          *this, AddressRange(bounds_pos->m_file_addr, byte_size,
+                              m_object_file.GetSectionList())));
+      // If another thread created one first, use that one so each function
+      // has a single FuncUnwinders.
+      if (std::atomic_compare_exchange_strong(
+              &bounds_pos->m_func_unwinders_sp, &func_unwinder_sp,
+              new_func_unwinder_sp))
+        return new_func_unwinder_sp;
+      return func_unwinder_sp;
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+
   iterator end = m_unwinds.end();
   iterator insert_pos = end;
   if (!m_unwinds.empty()) {
@@ -152,8 +298,9 @@ UnwindTable::GetUncachedFuncUnwindersContainingAddress(const Address &addr,
 
 void UnwindTable::Dump(Stream &s) {
   std::lock_guard<std::mutex> guard(m_mutex);
-  s.Printf("UnwindTable for '%s':\n",
-           m_object_file.GetFileSpec().GetPath().c_str());
+  s.Printf("UnwindTable for '%s' (%" PRIu64 " function bounds):\n",
+           m_object_file.GetFileSpec().GetPath().c_str(),
+           (uint64_t)m_function_bounds.size());
   const_iterator begin = m_unwinds.begin();
   const_iterator end = m_unwinds.end();
   for (const_iterator pos = begin; pos != end; ++pos) {
@@ -190,3 +337,146 @@ bool UnwindTable::GetArchitecture(lldb_private::ArchSpec &arch) {
 bool UnwindTable::GetAllowAssemblyEmulationUnwindPlans() {
   return m_object_file.AllowAssemblyEmulationUnwindPlans();
 }
+
+static const uint32_t kUnwindPlanCacheMagic = 0x554E5750; // 'UNWP'
+static const uint32_t kUnwindPlanCacheVersion = 1;
+
+void UnwindTable::LoadUnwindPlanCache() {
+  DataFileCache *cache = DataFileCache::GetIndexCache();
+  ModuleSP module_sp(m_object_file.GetModule());
+  if (cache == nullptr || !module_sp)
+    return;
+  CacheSignature signature(*module_sp);
+  if (!signature.IsValid())
+    return;
+
+  std::lock_guard<std::mutex> guard(m_plan_cache_mutex);
+  m_plan_cache_key =
+      DataFileCache::GetModuleCacheKey(*module_sp, "unwind-plans");
+  m_plan_cache_signature = signature;
+  m_plan_cache_addr_byte_size = m_object_file.GetAddressByteSize();
+  DataBufferSP data_sp = cache->GetCachedData(m_plan_cache_key);
+  if (!data_sp)
+    return;
+
+  // Only index the plans here, they are decoded when they are asked for.
+  DataExtractor data(data_sp, endian::InlHostByteOrder(),
+                     m_plan_cache_addr_byte_size);
+  lldb::offset_t offset = 0;
+  CacheSignature cached_signature;
+  bool valid = data.GetU32(&offset) == kUnwindPlanCacheMagic &&
+               data.GetU32(&offset) == kUnwindPlanCacheVersion &&
+               cached_signature.Decode(data, &offset) &&
+               cached_signature == signature;
+  const uint32_t num_plans = valid ? data.GetU32(&offset) : 0;
+  for (uint32_t i = 0; valid && i < num_plans; ++i) {
+    const uint8_t kind = data.GetU8(&offset);
+    const addr_t func_file_addr = data.GetU64(&offset);
+    const uint32_t size = data.GetU32(&offset);
+    const uint8_t *bytes = data.PeekData(offset, size);
+    if (bytes == nullptr) {
+      valid = false;
+      break;
+    }
+    m_cached_plans[CachedUnwindPlanKey(kind, func_file_addr)] =
+        llvm::ArrayRef<uint8_t>(bytes, size);
+    offset += size;
+  }
+
+  Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_UNWIND));
+  if (!valid) {
+    if (log)
+      log->Printf("UnwindTable::LoadUnwindPlanCache: discarding stale unwind "
+                  "plan cache file \"%s\"",
+                  m_plan_cache_key.c_str());
+    m_cached_plans.clear();
+    cache->RemoveCacheFile(m_plan_cache_key);
+    return;
+  }
+  m_plan_cache_data_sp = data_sp;
+  if (log)
+    log->Printf("UnwindTable::LoadUnwindPlanCache: found %u unwind plans in "
+                "cache file \"%s\"",
+                num_plans, m_plan_cache_key.c_str());
+}
+
+UnwindPlanSP UnwindTable::GetCachedUnwindPlan(CachedUnwindPlanKind kind,
+                                              addr_t func_file_addr) {
+  std::call_once(m_plan_cache_once, [this] { LoadUnwindPlanCache(); });
+
+  std::lock_guard<std::mutex> guard(m_plan_cache_mutex);
+  const CachedUnwindPlanKey key(kind, func_file_addr);
+  llvm::ArrayRef<uint8_t> bytes;
+  auto new_pos = m_new_plans.find(key);
+  if (new_pos != m_new_plans.end())
+    bytes = llvm::ArrayRef<uint8_t>(
+        reinterpret_cast<const uint8_t *>(new_pos->second.data()),
+        new_pos->second.size());
+  else {
+    auto pos = m_cached_plans.find(key);
+    if (pos == m_cached_plans.end())
+      return UnwindPlanSP();
+    bytes = pos->second;
+  }
+
+  DataExtractor data(bytes.data(), bytes.size(), endian::InlHostByteOrder(),
+                     m_plan_cache_addr_byte_size);
+  lldb::offset_t offset = 0;
+  UnwindPlanSP plan_sp(new UnwindPlan(eRegisterKindGeneric));
+  if (!plan_sp->Decode(data, &offset, m_object_file.GetSectionList()))
+    return UnwindPlanSP();
+  return plan_sp;
+}
+
+void UnwindTable::CacheUnwindPlan(CachedUnwindPlanKind kind,
+                                  addr_t func_file_addr,
+                                  const UnwindPlan &plan) {
+  std::call_once(m_plan_cache_once, [this] { LoadUnwindPlanCache(); });
+
+  std::lock_guard<std::mutex> guard(m_plan_cache_mutex);
+  if (m_plan_cache_key.empty())
+    return;
+  StreamString strm(Stream::eBinary, m_plan_cache_addr_byte_size,
+                    endian::InlHostByteOrder());
+  if (plan.Encode(strm)) {
+    m_new_plans[CachedUnwindPlanKey(kind, func_file_addr)] =
+        strm.GetString().str();
+    m_plan_cache_dirty = true;
+  }
+}
+
+void UnwindTable::SaveUnwindPlanCache() {
+  std::lock_guard<std::mutex> guard(m_plan_cache_mutex);
+  DataFileCache *cache = DataFileCache::GetIndexCache();
+  if (cache == nullptr || m_plan_cache_key.empty() || !m_plan_cache_dirty)
+    return;
+
+  // Keep the plans of earlier sessions, so the cache file ends up with every
+  // function that has been unwound through.
+  std::map<CachedUnwindPlanKey, llvm::ArrayRef<uint8_t>> plans(
+      m_cached_plans);
+  for (const auto &pos : m_new_plans)
+    plans[pos.first] = llvm::ArrayRef<uint8_t>(
+        reinterpret_cast<const uint8_t *>(pos.second.data()),
+        pos.second.size());
+
+  StreamString strm(Stream::eBinary, m_plan_cache_addr_byte_size,
+                    endian::InlHostByteOrder());
+  strm.PutHex32(kUnwindPlanCacheMagic);
+  strm.PutHex32(kUnwindPlanCacheVersion);
+  m_plan_cache_signature.Encode(strm);
+  strm.PutHex32(plans.size());
+  for (const auto &pos : plans) {
+    strm.PutHex8(pos.first.first);
+    strm.PutHex64(pos.first.second);
+    strm.PutHex32(pos.second.size());
+    strm.Write(pos.second.data(), pos.second.size());
+  }
+  // Only write the file again if more plans are added.
+  if (cache->SetCachedData(
+          m_plan_cache_key,
+          llvm::ArrayRef<uint8_t>(
+              reinterpret_cast<const uint8_t *>(strm.GetData()),
+              strm.GetSize())))
+    m_plan_cache_dirty = false;
+}
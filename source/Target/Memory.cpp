@@ -11,24 +11,46 @@
 // C Includes
 #include <inttypes.h>
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
+#include "llvm/Support/MathExtras.h"
 // Project includes
 #include "lldb/Core/RangeMap.h"
 #include "lldb/Core/State.h"
+#include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Utility/DataBufferHeap.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Log.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
+namespace {
+// Reads bigger than this bypass the page cache. It is unlikely that a
+// caller will ask for the bytes that follow a big read, so caching them
+// isn't worth the memory.
+const size_t kMaxCachedReadSize = 64 * 1024;
+// The most we will read ahead of a sequence of sequential reads.
+const addr_t kMaxPrefetchSize = 64 * 1024;
+const uint32_t kEmptySlot = UINT32_MAX;
+
+// Pages are aligned to their size, so the size must be a power of two.
+uint32_t GetPageSize(Process &process) {
+  return llvm::PowerOf2Ceil(
+      std::max<uint64_t>(process.GetMemoryCacheLineSize(), 16));
+}
+} // namespace
+
 //----------------------------------------------------------------------
 // MemoryCache constructor
 //----------------------------------------------------------------------
 MemoryCache::MemoryCache(Process &process)
-    : m_mutex(), m_L1_cache(), m_L2_cache(), m_invalid_ranges(),
-      m_process(process),
-      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()) {}
+    : m_mutex(), m_L1_cache(), m_pages(), m_page_index(),
+      m_region_permissions(), m_invalid_ranges(), m_process(process),
+      m_page_size(0), m_read_streams(), m_next_read_stream(0), m_stats() {
+  Clear();
+}
 
 //----------------------------------------------------------------------
 // Destructor
@@ -38,10 +60,123 @@ MemoryCache::~MemoryCache() {}
 void MemoryCache::Clear(bool clear_invalid_ranges) {
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
   m_L1_cache.clear();
-  m_L2_cache.clear();
+  m_pages.clear();
+  m_page_index.clear();
+  m_region_permissions.Clear();
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
-  m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  ClearReadStreams();
+  m_page_size = GetPageSize(m_process);
+}
+
+void MemoryCache::ClearWritableData() {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  m_L1_cache.clear();
+  ClearReadStreams();
+
+  // A change of the page size setting invalidates all pages.
+  if (m_page_size != GetPageSize(m_process)) {
+    Clear();
+    return;
+  }
+
+  m_pages.erase(std::remove_if(m_pages.begin(), m_pages.end(),
+                               [](const Page &page) { return !page.read_only; }),
+                m_pages.end());
+  m_stats.num_pages_kept += m_pages.size();
+  for (Page &page : m_pages)
+    page.check_region = true;
+  RebuildPageIndex();
+
+  // The region permissions may have changed while the process ran, e.g.
+  // by a JIT that maps its code pages writable and back. They are looked
+  // up again, once per region, when the kept pages are first used.
+  m_region_permissions.Clear();
+}
+
+uint32_t *MemoryCache::FindPageSlot(addr_t addr) {
+  // Fibonacci hashing of the page number, the slot index comes from the
+  // top bits of the product.
+  const uint64_t mask = m_page_index.size() - 1;
+  uint64_t slot = ((addr / m_page_size) * 0x9E3779B97F4A7C15ull) >> 32;
+  for (;; ++slot) {
+    uint32_t &entry = m_page_index[slot & mask];
+    if (entry == kEmptySlot || m_pages[entry].addr == addr)
+      return &entry;
+  }
+}
+
+MemoryCache::Page *MemoryCache::FindPage(addr_t addr) {
+  if (m_pages.empty())
+    return nullptr;
+  const uint32_t page_idx = *FindPageSlot(addr);
+  if (page_idx == kEmptySlot)
+    return nullptr;
+  Page &page = m_pages[page_idx];
+  if (page.check_region) {
+    // A kept page whose region isn't read only anymore may be stale.
+    if (!IsReadOnly(addr)) {
+      RemovePage(page_idx);
+      return nullptr;
+    }
+    page.check_region = false;
+  }
+  return &page;
+}
+
+void MemoryCache::AddPage(addr_t addr, const uint8_t *src, uint32_t size,
+                          bool read_only) {
+  Page page;
+  page.addr = addr;
+  page.size = size;
+  page.read_only = read_only;
+  page.check_region = false;
+  page.data.reset(new uint8_t[size]);
+  memcpy(page.data.get(), src, size);
+  m_pages.push_back(std::move(page));
+
+  // Keep the index at most half full so that probe sequences stay short.
+  if (m_pages.size() * 2 > m_page_index.size())
+    RebuildPageIndex();
+  else
+    *FindPageSlot(addr) = m_pages.size() - 1;
+}
+
+void MemoryCache::RemovePage(uint32_t page_idx) {
+  // Remove the page from the index by shifting back the entries that
+  // follow it in its probe sequence, so that no tombstones are needed.
+  const size_t mask = m_page_index.size() - 1;
+  size_t hole = FindPageSlot(m_pages[page_idx].addr) - m_page_index.data();
+  for (size_t slot = (hole + 1) & mask; m_page_index[slot] != kEmptySlot;
+       slot = (slot + 1) & mask) {
+    const addr_t addr = m_pages[m_page_index[slot]].addr;
+    const size_t home =
+        (((addr / m_page_size) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    // Move the entry into the hole unless its home slot lies cyclically
+    // in (hole, slot].
+    if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+      m_page_index[hole] = m_page_index[slot];
+      hole = slot;
+    }
+  }
+  m_page_index[hole] = kEmptySlot;
+
+  // Move the last page into the freed spot of m_pages.
+  const uint32_t last_idx = m_pages.size() - 1;
+  if (page_idx != last_idx) {
+    *FindPageSlot(m_pages[last_idx].addr) = page_idx;
+    m_pages[page_idx] = std::move(m_pages[last_idx]);
+  }
+  m_pages.pop_back();
+}
+
+void MemoryCache::RebuildPageIndex() {
+  size_t num_slots = 16;
+  while (num_slots < m_pages.size() * 4)
+    num_slots *= 2;
+  m_page_index.assign(num_slots, kEmptySlot);
+  for (uint32_t i = 0; i < m_pages.size(); ++i)
+    *FindPageSlot(m_pages[i].addr) = i;
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -77,30 +212,35 @@ void MemoryCache::Flush(addr_t addr, size_t size) {
     }
   }
 
-  if (!m_L2_cache.empty()) {
-    const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
-    const addr_t end_addr = (addr + size - 1);
-    const addr_t first_cache_line_addr = addr - (addr % cache_line_byte_size);
-    const addr_t last_cache_line_addr =
-        end_addr - (end_addr % cache_line_byte_size);
-    // Watch for overflow where size will cause us to go off the end of the
-    // 64 bit address space
-    uint32_t num_cache_lines;
-    if (last_cache_line_addr >= first_cache_line_addr)
-      num_cache_lines = ((last_cache_line_addr - first_cache_line_addr) /
-                         cache_line_byte_size) +
-                        1;
-    else
-      num_cache_lines =
-          (UINT64_MAX - first_cache_line_addr + 1) / cache_line_byte_size;
-
-    uint32_t cache_idx = 0;
-    for (addr_t curr_addr = first_cache_line_addr; cache_idx < num_cache_lines;
-         curr_addr += cache_line_byte_size, ++cache_idx) {
-      BlockMap::iterator pos = m_L2_cache.find(curr_addr);
-      if (pos != m_L2_cache.end())
-        m_L2_cache.erase(pos);
+  if (m_pages.empty())
+    return;
+
+  const addr_t first_page_addr = AlignToPage(addr);
+  // Watch for overflow where size will cause us to go off the end of the
+  // 64 bit address space
+  const addr_t last_page_addr =
+      size - 1 > UINT64_MAX - addr ? AlignToPage(UINT64_MAX)
+                                   : AlignToPage(addr + size - 1);
+  const uint64_t num_pages = (last_page_addr - first_page_addr) / m_page_size;
+
+  if (num_pages < m_pages.size()) {
+    for (addr_t page_addr = first_page_addr;; page_addr += m_page_size) {
+      uint32_t page_idx = *FindPageSlot(page_addr);
+      if (page_idx != kEmptySlot)
+        RemovePage(page_idx);
+      if (page_addr == last_page_addr)
+        break;
     }
+  } else {
+    // The range covers more pages than we have, look at each cached page
+    // instead.
+    m_pages.erase(std::remove_if(m_pages.begin(), m_pages.end(),
+                                 [&](const Page &page) {
+                                   return page.addr >= first_page_addr &&
+                                          page.addr <= last_page_addr;
+                                 }),
+                  m_pages.end());
+    RebuildPageIndex();
   }
 }
 
@@ -129,126 +269,350 @@ bool MemoryCache::RemoveInvalidRange(lldb::addr_t base_addr,
   return false;
 }
 
+MemoryCache::Statistics MemoryCache::GetStatistics() {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  return m_stats;
+}
+
+bool MemoryCache::IsReadOnly(addr_t addr) {
+  if (const ReadOnlyRanges::Entry *entry =
+          m_region_permissions.FindEntryThatContains(addr))
+    return entry->data;
+
+  MemoryRegionInfo region_info;
+  if (m_process.GetMemoryRegionInfo(addr, region_info).Fail() ||
+      region_info.GetRange().GetByteSize() == 0 ||
+      !region_info.GetRange().Contains(addr)) {
+    // Remember the failure for this page so we don't ask again.
+    const addr_t page_addr = AlignToPage(addr);
+    const addr_t page_size =
+        std::min<addr_t>(m_page_size, UINT64_MAX - page_addr);
+    m_region_permissions.InsertAndCombine(
+        ReadOnlyRanges::Entry(page_addr, page_size, false));
+    return false;
+  }
+
+  const bool read_only =
+      region_info.GetReadable() == MemoryRegionInfo::eYes &&
+      region_info.GetWritable() == MemoryRegionInfo::eNo;
+  m_region_permissions.InsertAndCombine(ReadOnlyRanges::Entry(
+      region_info.GetRange().GetRangeBase(),
+      region_info.GetRange().GetByteSize(), read_only));
+  return read_only;
+}
+
+void MemoryCache::AddPages(addr_t addr, const uint8_t *src, size_t size) {
+  addr_t read_only_end = addr;
+  bool read_only = false;
+  for (size_t offset = 0; offset < size; offset += m_page_size) {
+    const addr_t curr_addr = addr + offset;
+    if (curr_addr >= read_only_end) {
+      read_only = IsReadOnly(curr_addr);
+      const ReadOnlyRanges::Entry *entry =
+          m_region_permissions.FindEntryThatContains(curr_addr);
+      read_only_end = entry ? entry->GetRangeEnd() : curr_addr + m_page_size;
+    }
+    AddPage(curr_addr, src + offset,
+            std::min<size_t>(m_page_size, size - offset),
+            read_only && curr_addr + m_page_size <= read_only_end);
+  }
+}
+
+bool MemoryCache::ReadPages(addr_t page_addr, addr_t last_page_addr,
+                            addr_t &readable_end, Status &error) {
+  // Read the run of missing pages starting at page_addr with a single
+  // read.
+  addr_t end_addr = page_addr + m_page_size;
+  while (end_addr != 0 && end_addr <= last_page_addr && !FindPage(end_addr) &&
+         !m_invalid_ranges.FindEntryThatContains(end_addr))
+    end_addr += m_page_size;
+  const addr_t needed_size = end_addr - page_addr;
+
+  // If this read continues where an earlier one ended, read ahead of
+  // it, doubling the amount each time the pattern continues.
+  ReadStream &stream = GetReadStream(page_addr);
+  const addr_t prefetch_end =
+      end_addr + std::min<addr_t>(stream.prefetch_size, UINT64_MAX - end_addr);
+  while (end_addr != 0 && end_addr < prefetch_end && !FindPage(end_addr) &&
+         !m_invalid_ranges.FindEntryThatContains(end_addr))
+    end_addr += m_page_size;
+  stream.next_addr = end_addr;
+
+  std::vector<uint8_t> buffer(end_addr - page_addr);
+  size_t bytes_read = m_process.ReadMemoryFromInferior(
+      page_addr, buffer.data(), buffer.size(), error);
+  ++m_stats.num_process_reads;
+  if (bytes_read < needed_size && buffer.size() > needed_size) {
+    // The read ahead may have run into unreadable memory and failed the
+    // whole read. Try again with just what was asked for.
+    error.Clear();
+    bytes_read = m_process.ReadMemoryFromInferior(page_addr, buffer.data(),
+                                                  needed_size, error);
+    ++m_stats.num_process_reads;
+  }
+  // Reads that end early don't continue a stream, the next miss won't
+  // start where this read was supposed to end.
+  if (bytes_read < buffer.size())
+    stream = ReadStream();
+  m_stats.bytes_read += bytes_read;
+  if (bytes_read > needed_size)
+    m_stats.bytes_prefetched += bytes_read - needed_size;
+  else if (bytes_read < needed_size)
+    readable_end = page_addr + bytes_read;
+
+  AddPages(page_addr, buffer.data(), bytes_read);
+  return bytes_read > 0;
+}
+
+MemoryCache::ReadStream &MemoryCache::GetReadStream(addr_t page_addr) {
+  for (ReadStream &stream : m_read_streams) {
+    if (stream.next_addr == page_addr) {
+      stream.prefetch_size =
+          std::min(std::max<addr_t>(stream.prefetch_size * 2, m_page_size),
+                   kMaxPrefetchSize);
+      return stream;
+    }
+  }
+  // Start a new stream in place of the oldest one.
+  ReadStream &stream = m_read_streams[m_next_read_stream];
+  m_next_read_stream = (m_next_read_stream + 1) % kNumReadStreams;
+  stream.next_addr = LLDB_INVALID_ADDRESS;
+  stream.prefetch_size = 0;
+  return stream;
+}
+
+void MemoryCache::ClearReadStreams() {
+  for (ReadStream &stream : m_read_streams)
+    stream = ReadStream();
+  m_next_read_stream = 0;
+}
+
+bool MemoryCache::ReadFromL1Cache(addr_t addr, void *dst, size_t dst_len) {
+  // The L1 cache contains chunks of memory that are not required to be
+  // page aligned, so we don't try anything tricky when reading from them
+  // (no partial reads from the L1 cache).
+  if (m_L1_cache.empty())
+    return false;
+  AddrRange read_range(addr, dst_len);
+  BlockMap::iterator pos = m_L1_cache.upper_bound(addr);
+  if (pos != m_L1_cache.begin()) {
+    --pos;
+  }
+  AddrRange chunk_range(pos->first, pos->second->GetByteSize());
+  if (!chunk_range.Contains(read_range))
+    return false;
+  memcpy(dst, pos->second->GetBytes() + addr - chunk_range.GetRangeBase(),
+         dst_len);
+  return true;
+}
+
+bool MemoryCache::ReadFromMappedMemory(addr_t addr, void *dst,
+                                       size_t dst_len) {
+  DataExtractor data;
+  if (dst == nullptr || dst_len == 0 ||
+      m_process.PeekMemory(addr, dst_len, data) < dst_len)
+    return false;
+  memcpy(dst, data.GetDataStart(), dst_len);
+  return true;
+}
+
 size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
                          Status &error) {
-  size_t bytes_left = dst_len;
+  // Memory the process has mapped into the debugger, like the memory of a
+  // core file, is as cheap to copy as a cache hit, so it isn't cached.
+  if (ReadFromMappedMemory(addr, dst, dst_len))
+    return dst_len;
 
   // Check the L1 cache for a range that contain the entire memory read.
   // If we find a range in the L1 cache that does, we use it. Else we fall
-  // back to reading memory in m_L2_cache_line_byte_size byte sized chunks.
-  // The L1 cache contains chunks of memory that are not required to be
-  // m_L2_cache_line_byte_size bytes in size, so we don't try anything
-  // tricky when reading from them (no partial reads from the L1 cache).
-
+  // back to reading memory in m_page_size byte sized pages.
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  if (!m_L1_cache.empty()) {
-    AddrRange read_range(addr, dst_len);
-    BlockMap::iterator pos = m_L1_cache.upper_bound(addr);
-    if (pos != m_L1_cache.begin()) {
-      --pos;
-    }
-    AddrRange chunk_range(pos->first, pos->second->GetByteSize());
-    if (chunk_range.Contains(read_range)) {
-      memcpy(dst, pos->second->GetBytes() + addr - chunk_range.GetRangeBase(),
-             dst_len);
-      return dst_len;
-    }
+  if (ReadFromL1Cache(addr, dst, dst_len)) {
+    ++m_stats.num_hits;
+    return dst_len;
   }
 
-  // If this memory read request is larger than the cache line size, then
-  // we (1) try to read as much of it at once as possible, and (2) don't
-  // add the data to the memory cache.  We don't want to split a big read
-  // up into more separate reads than necessary, and with a large memory read
-  // request, it is unlikely that the caller function will ask for the next
-  // 4 bytes after the large memory read - so there's little benefit to saving
-  // it in the cache.
-  if (dst && dst_len > m_L2_cache_line_byte_size) {
+  if (dst == nullptr || dst_len == 0)
+    return 0;
+
+  // If this memory read request is large, then we (1) try to read all of
+  // it at once, and (2) don't add the data to the page cache, it is
+  // unlikely that the caller will come back for more memory around it.
+  if (dst_len > kMaxCachedReadSize) {
+    ++m_stats.num_misses;
+    ++m_stats.num_process_reads;
     size_t bytes_read =
         m_process.ReadMemoryFromInferior(addr, dst, dst_len, error);
-    // Add this non block sized range to the L1 cache if we actually read
+    m_stats.bytes_read += bytes_read;
+    // Add this non page sized range to the L1 cache if we actually read
     // anything
     if (bytes_read > 0)
       AddL1CacheData(addr, dst, bytes_read);
     return bytes_read;
   }
 
-  if (dst && bytes_left > 0) {
-    const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
-    uint8_t *dst_buf = (uint8_t *)dst;
-    addr_t curr_addr = addr - (addr % cache_line_byte_size);
-    addr_t cache_offset = addr - curr_addr;
-
-    while (bytes_left > 0) {
-      if (m_invalid_ranges.FindEntryThatContains(curr_addr)) {
-        error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64,
-                                       curr_addr);
-        return dst_len - bytes_left;
-      }
-
-      BlockMap::const_iterator pos = m_L2_cache.find(curr_addr);
-      BlockMap::const_iterator end = m_L2_cache.end();
+  bool missed = false;
+  const size_t bytes_read =
+      ReadFromPages(addr, (uint8_t *)dst, dst_len, missed, error);
+  if (missed)
+    ++m_stats.num_misses;
+  else
+    ++m_stats.num_hits;
+  return bytes_read;
+}
 
-      if (pos != end) {
-        size_t curr_read_size = cache_line_byte_size - cache_offset;
-        if (curr_read_size > bytes_left)
-          curr_read_size = bytes_left;
+size_t MemoryCache::ReadFromPages(addr_t addr, uint8_t *dst, size_t dst_len,
+                                  bool &missed, Status &error) {
+  const addr_t last_page_addr =
+      dst_len - 1 > UINT64_MAX - addr ? AlignToPage(UINT64_MAX)
+                                      : AlignToPage(addr + dst_len - 1);
+  // The end of the memory we managed to read from the process. Nothing
+  // after it could be read, so don't try again.
+  addr_t readable_end = LLDB_INVALID_ADDRESS;
+  size_t bytes_done = 0;
+  addr_t curr_addr = addr;
+  while (bytes_done < dst_len) {
+    const addr_t page_addr = AlignToPage(curr_addr);
+    if (m_invalid_ranges.FindEntryThatContains(page_addr)) {
+      error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64,
+                                     page_addr);
+      break;
+    }
 
-        memcpy(dst_buf + dst_len - bytes_left,
-               pos->second->GetBytes() + cache_offset, curr_read_size);
+    Page *page = FindPage(page_addr);
+    if (page == nullptr) {
+      if (readable_end != LLDB_INVALID_ADDRESS && curr_addr >= readable_end)
+        break;
+      missed = true;
+      if (!ReadPages(page_addr, last_page_addr, readable_end, error))
+        break;
+      page = FindPage(page_addr);
+      assert(page != nullptr);
+    }
 
-        bytes_left -= curr_read_size;
-        curr_addr += curr_read_size + cache_offset;
-        cache_offset = 0;
+    const size_t page_offset = curr_addr - page_addr;
+    if (page_offset >= page->size)
+      break;
+    const size_t curr_read_size =
+        std::min<size_t>(page->size - page_offset, dst_len - bytes_done);
+    memcpy(dst + bytes_done, page->data.get() + page_offset, curr_read_size);
+    bytes_done += curr_read_size;
+    curr_addr += curr_read_size;
+
+    // We have a cache page that succeeded to read some bytes but not an
+    // entire page. If this happens, we must cap off how much data we are
+    // able to read...
+    if (page->size != m_page_size)
+      break;
+  }
+  return bytes_done;
+}
 
-        if (bytes_left > 0) {
-          // Get sequential cache page hits
-          for (++pos; (pos != end) && (bytes_left > 0); ++pos) {
-            assert((curr_addr % cache_line_byte_size) == 0);
+std::vector<size_t>
+MemoryCache::ReadRanges(llvm::ArrayRef<Range<addr_t, size_t>> ranges,
+                        llvm::MutableArrayRef<uint8_t> buffer,
+                        Status &error) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
-            if (pos->first != curr_addr)
-              break;
+  // Find the pages that are missing for all of the ranges, so that they
+  // can be read from the process with as few requests as possible.
+  std::vector<bool> range_missed(ranges.size(), false);
+  std::vector<bool> range_mapped(ranges.size(), false);
+  std::vector<addr_t> missing_pages;
+  size_t offset = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const addr_t addr = ranges[i].GetRangeBase();
+    const size_t size = ranges[i].GetByteSize();
+    uint8_t *dst = buffer.data() + offset;
+    offset += size;
+    if (ReadFromMappedMemory(addr, dst, size)) {
+      range_mapped[i] = true;
+      continue;
+    }
+    if (size == 0 || size > kMaxCachedReadSize ||
+        ReadFromL1Cache(addr, dst, size))
+      continue;
+    const addr_t last_page_addr = size - 1 > UINT64_MAX - addr
+                                      ? AlignToPage(UINT64_MAX)
+                                      : AlignToPage(addr + size - 1);
+    for (addr_t page_addr = AlignToPage(addr);; page_addr += m_page_size) {
+      if (!FindPage(page_addr) &&
+          !m_invalid_ranges.FindEntryThatContains(page_addr)) {
+        missing_pages.push_back(page_addr);
+        range_missed[i] = true;
+      }
+      if (page_addr == last_page_addr)
+        break;
+    }
+  }
 
-            curr_read_size = pos->second->GetByteSize();
-            if (curr_read_size > bytes_left)
-              curr_read_size = bytes_left;
+  if (!missing_pages.empty()) {
+    std::sort(missing_pages.begin(), missing_pages.end());
+    missing_pages.erase(std::unique(missing_pages.begin(), missing_pages.end()),
+                        missing_pages.end());
 
-            memcpy(dst_buf + dst_len - bytes_left, pos->second->GetBytes(),
-                   curr_read_size);
+    // Merge adjacent pages into runs.
+    std::vector<Range<addr_t, size_t>> runs;
+    for (addr_t page_addr : missing_pages) {
+      if (!runs.empty() && runs.back().GetRangeEnd() == page_addr)
+        runs.back().SetByteSize(runs.back().GetByteSize() + m_page_size);
+      else
+        runs.push_back(Range<addr_t, size_t>(page_addr, m_page_size));
+    }
 
-            bytes_left -= curr_read_size;
-            curr_addr += curr_read_size;
+    std::vector<uint8_t> data(missing_pages.size() * m_page_size);
+    Status read_error;
+    std::vector<size_t> bytes_read =
+        m_process.ReadMemoryRangesFromInferior(runs, data, read_error);
+    ++m_stats.num_process_reads;
+    size_t data_offset = 0;
+    for (size_t i = 0; i < runs.size(); ++i) {
+      m_stats.bytes_read += bytes_read[i];
+      AddPages(runs[i].GetRangeBase(), data.data() + data_offset,
+               bytes_read[i]);
+      data_offset += runs[i].GetByteSize();
+    }
+  }
 
-            // We have a cache page that succeeded to read some bytes
-            // but not an entire page. If this happens, we must cap
-            // off how much data we are able to read...
-            if (pos->second->GetByteSize() != cache_line_byte_size)
-              return dst_len - bytes_left;
-          }
-        }
-      }
+  // Everything we could read is in the cache now. Ranges that couldn't be
+  // read completely are retried individually, which will set the error.
+  std::vector<size_t> result;
+  result.reserve(ranges.size());
+  offset = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const addr_t addr = ranges[i].GetRangeBase();
+    const size_t size = ranges[i].GetByteSize();
+    uint8_t *dst = buffer.data() + offset;
+    offset += size;
+
+    Status range_error;
+    size_t bytes_read;
+    if (range_mapped[i]) {
+      bytes_read = size;
+    } else if (size == 0 || size > kMaxCachedReadSize) {
+      bytes_read = Read(addr, dst, size, range_error);
+    } else if (!range_missed[i] && ReadFromL1Cache(addr, dst, size)) {
+      ++m_stats.num_hits;
+      bytes_read = size;
+    } else {
+      bool missed = range_missed[i];
+      bytes_read = ReadFromPages(addr, dst, size, missed, range_error);
+      if (missed)
+        ++m_stats.num_misses;
+      else
+        ++m_stats.num_hits;
+    }
 
-      // We need to read from the process
-
-      if (bytes_left > 0) {
-        assert((curr_addr % cache_line_byte_size) == 0);
-        std::unique_ptr<DataBufferHeap> data_buffer_heap_ap(
-            new DataBufferHeap(cache_line_byte_size, 0));
-        size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-            curr_addr, data_buffer_heap_ap->GetBytes(),
-            data_buffer_heap_ap->GetByteSize(), error);
-        if (process_bytes_read == 0)
-          return dst_len - bytes_left;
-
-        if (process_bytes_read != cache_line_byte_size)
-          data_buffer_heap_ap->SetByteSize(process_bytes_read);
-        m_L2_cache[curr_addr] = DataBufferSP(data_buffer_heap_ap.release());
-        // We have read data and put it into the cache, continue through the
-        // loop again to get the data out of the cache...
-      }
+    if (bytes_read < size && error.Success()) {
+      if (range_error.Fail())
+        error = range_error;
+      else
+        error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64,
+                                       addr + bytes_read);
     }
+    result.push_back(bytes_read);
   }
-
-  return dst_len - bytes_left;
+  return result;
 }
 
 AllocatedBlock::AllocatedBlock(lldb::addr_t addr, uint32_t byte_size,
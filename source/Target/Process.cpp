@@ -37,11 +37,13 @@
 #include "lldb/Host/HostInfo.h"
 #include "lldb/Host/OptionParser.h"
 #include "lldb/Host/Pipe.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Host/Terminal.h"
 #include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/OptionValueProperties.h"
 #include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/CPPLanguageRuntime.h"
@@ -149,6 +151,9 @@ static PropertyDefinition g_properties[] = {
     {"stop-on-exec", OptionValue::eTypeBoolean, true, true,
      nullptr, nullptr,
      "If true, stop when a shared library is loaded or unloaded."},
+    {"parallel-unwind", OptionValue::eTypeBoolean, false, true, nullptr,
+     nullptr, "If true, commands that show the stacks of many threads, like "
+              "\"thread backtrace all\", unwind several threads at a time."},
     {nullptr, OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr}};
 
 enum {
@@ -161,7 +166,8 @@ enum {
   ePropertyDetachKeepsStopped,
   ePropertyMemCacheLineSize,
   ePropertyWarningOptimization,
-  ePropertyStopOnExec
+  ePropertyStopOnExec,
+  ePropertyParallelUnwind
 };
 
 ProcessProperties::ProcessProperties(lldb_private::Process *process)
@@ -284,6 +290,12 @@ bool ProcessProperties::GetStopOnExec() const {
       nullptr, idx, g_properties[idx].default_uint_value != 0);
 }
 
+bool ProcessProperties::GetParallelUnwind() const {
+  const uint32_t idx = ePropertyParallelUnwind;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 void ProcessInstanceInfo::Dump(Stream &s, Platform *platform) const {
   const char *cstr;
   if (m_pid != LLDB_INVALID_PROCESS_ID)
@@ -855,6 +867,15 @@ void Process::Finalize() {
     break;
   }
 
+  // The modules of the process can outlive it in the shared module list,
+  // write the unwind plans that were built for it to the cache now.
+  if (TargetSP target_sp = m_target_sp.lock()) {
+    for (const ModuleSP &module_sp : target_sp->GetImages().Modules()) {
+      if (ObjectFile *objfile = module_sp->GetObjectFile())
+        objfile->GetUnwindTable().SaveUnwindPlanCache();
+    }
+  }
+
   // Clear our broadcaster before we proceed with destroying
   Broadcaster::Clear();
 
@@ -1826,7 +1847,7 @@ void Process::SetPrivateState(StateType new_state) {
       m_mod_id.BumpStopID();
       if (!m_mod_id.IsLastResumeForUserExpression())
         m_mod_id.SetStopEventForLastNaturalStopID(event_sp);
-      m_memory_cache.Clear();
+      m_memory_cache.ClearWritableData();
       if (log)
         log->Printf("Process::SetPrivateState (%s) stop_id = %u",
                     StateAsCString(new_state), m_mod_id.GetStopID());
@@ -2179,8 +2200,14 @@ Status Process::EnableSoftwareBreakpoint(BreakpointSite *bp_site) {
     if (DoReadMemory(bp_addr, bp_site->GetSavedOpcodeBytes(), bp_opcode_size,
                      error) == bp_opcode_size) {
       // Write a software breakpoint in place of the original opcode
-      if (DoWriteMemory(bp_addr, bp_opcode_bytes, bp_opcode_size, error) ==
-          bp_opcode_size) {
+      const size_t bytes_written =
+          DoWriteMemory(bp_addr, bp_opcode_bytes, bp_opcode_size, error);
+#if defined(ENABLE_MEMORY_CACHING)
+      // Code pages stay in the memory cache across stops, don't let it keep
+      // the original opcode.
+      m_memory_cache.Flush(bp_addr, bp_opcode_size);
+#endif
+      if (bytes_written == bp_opcode_size) {
         uint8_t verify_bp_opcode_bytes[64];
         if (DoReadMemory(bp_addr, verify_bp_opcode_bytes, bp_opcode_size,
                          error) == bp_opcode_size) {
@@ -2242,8 +2269,15 @@ Status Process::DisableSoftwareBreakpoint(BreakpointSite *bp_site) {
           break_op_found = true;
           // We found a valid breakpoint opcode at this address, now restore
           // the saved opcode.
-          if (DoWriteMemory(bp_addr, bp_site->GetSavedOpcodeBytes(),
-                            break_op_size, error) == break_op_size) {
+          const size_t bytes_written =
+              DoWriteMemory(bp_addr, bp_site->GetSavedOpcodeBytes(),
+                            break_op_size, error);
+#if defined(ENABLE_MEMORY_CACHING)
+          // Code pages stay in the memory cache across stops, don't let it
+          // keep the trap opcode once there is no site left to mask it.
+          m_memory_cache.Flush(bp_addr, break_op_size);
+#endif
+          if (bytes_written == break_op_size) {
             verify = true;
           } else
             error.SetErrorString(
@@ -2365,6 +2399,24 @@ size_t Process::ReadCStringFromMemory(addr_t addr, std::string &out_str,
   return out_str.size();
 }
 
+std::vector<size_t>
+Process::ReadMemoryRanges(llvm::ArrayRef<Range<addr_t, size_t>> ranges,
+                          llvm::MutableArrayRef<uint8_t> buffer,
+                          Status &error) {
+  error.Clear();
+  size_t total_size = 0;
+  for (const Range<addr_t, size_t> &range : ranges)
+    total_size += range.GetByteSize();
+  if (total_size > buffer.size()) {
+    error.SetErrorString("buffer is too small for the memory ranges");
+    return std::vector<size_t>(ranges.size(), 0);
+  }
+
+  if (!GetDisableMemoryCache())
+    return m_memory_cache.ReadRanges(ranges, buffer, error);
+  return ReadMemoryRangesFromInferior(ranges, buffer, error);
+}
+
 size_t Process::ReadStringFromMemory(addr_t addr, char *dst, size_t max_bytes,
                                      Status &error, size_t type_width) {
   size_t total_bytes_read = 0;
@@ -2488,6 +2540,53 @@ size_t Process::ReadMemoryFromInferior(addr_t addr, void *buf, size_t size,
   return bytes_read;
 }
 
+std::vector<size_t> Process::ReadMemoryRangesFromInferior(
+    llvm::ArrayRef<Range<addr_t, size_t>> ranges,
+    llvm::MutableArrayRef<uint8_t> buffer, Status &error) {
+  std::vector<size_t> bytes_read = DoReadMemoryRanges(ranges, buffer, error);
+  bytes_read.resize(ranges.size(), 0);
+
+  // Replace any software breakpoint opcodes that fall into the ranges back
+  // into the buffer before we return
+  size_t offset = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (bytes_read[i] > 0)
+      RemoveBreakpointOpcodesFromBuffer(ranges[i].GetRangeBase(),
+                                        bytes_read[i], buffer.data() + offset);
+    offset += ranges[i].GetByteSize();
+  }
+  return bytes_read;
+}
+
+std::vector<size_t>
+Process::DoReadMemoryRanges(llvm::ArrayRef<Range<addr_t, size_t>> ranges,
+                            llvm::MutableArrayRef<uint8_t> buffer,
+                            Status &error) {
+  std::vector<size_t> bytes_read;
+  bytes_read.reserve(ranges.size());
+  uint8_t *dst = buffer.data();
+  for (const Range<addr_t, size_t> &range : ranges) {
+    const addr_t addr = range.GetRangeBase();
+    const size_t size = range.GetByteSize();
+    Status range_error;
+    size_t range_bytes_read = 0;
+    while (range_bytes_read < size) {
+      const size_t curr_size = size - range_bytes_read;
+      const size_t curr_bytes_read =
+          DoReadMemory(addr + range_bytes_read, dst + range_bytes_read,
+                       curr_size, range_error);
+      range_bytes_read += curr_bytes_read;
+      if (curr_bytes_read == curr_size || curr_bytes_read == 0)
+        break;
+    }
+    if (range_bytes_read < size && range_error.Fail() && error.Success())
+      error = range_error;
+    bytes_read.push_back(range_bytes_read);
+    dst += size;
+  }
+  return bytes_read;
+}
+
 uint64_t Process::ReadUnsignedIntegerFromMemory(lldb::addr_t vm_addr,
                                                 size_t integer_byte_size,
                                                 uint64_t fail_value,
@@ -5935,6 +6034,67 @@ size_t Process::GetThreadStatus(Stream &strm,
   return num_thread_infos_dumped;
 }
 
+void Process::UnwindThreads(llvm::ArrayRef<ThreadSP> threads,
+                            uint32_t max_frames) {
+  if (threads.empty() || max_frames == 0)
+    return;
+
+  PrefetchThreadStacks(threads);
+
+  auto unwind_thread = [threads, max_frames](size_t idx) {
+    // This caches the frames in the thread's StackFrameList.
+    Thread &thread = *threads[idx];
+    if (max_frames == UINT32_MAX)
+      thread.GetStackFrameCount();
+    else
+      thread.GetStackFrameAtIndex(max_frames - 1);
+  };
+
+  // The registers of threads that come from an operating system plug-in
+  // are provided by a script, which we don't run on several threads.
+  if (threads.size() == 1 || !GetParallelUnwind() || m_os_ap) {
+    for (size_t i = 0; i < threads.size(); ++i)
+      unwind_thread(i);
+    return;
+  }
+
+  // The unwinder creates these the first time it needs them, do it now
+  // instead of letting the threads race to do it.
+  GetABI();
+  GetDynamicLoader();
+
+  TaskMapOverInt(0, threads.size(), unwind_thread);
+}
+
+void Process::PrefetchThreadStacks(llvm::ArrayRef<ThreadSP> threads) {
+  // Unwinding reads the top of each stack a few bytes at a time. Read the
+  // top of all of the stacks into the memory cache with a single request
+  // instead, which plug-ins can turn into a single packet.
+  if (threads.size() < 2 || m_os_ap || GetDisableMemoryCache())
+    return;
+
+  const size_t stack_prefetch_size = 4096;
+  std::vector<Range<addr_t, size_t>> ranges;
+  for (const ThreadSP &thread_sp : threads) {
+    RegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext();
+    if (!reg_ctx_sp)
+      continue;
+    const addr_t sp = reg_ctx_sp->GetSP(LLDB_INVALID_ADDRESS);
+    if (sp == LLDB_INVALID_ADDRESS || sp == 0 ||
+        sp > UINT64_MAX - stack_prefetch_size)
+      continue;
+    ranges.push_back(Range<addr_t, size_t>(sp, stack_prefetch_size));
+  }
+  if (ranges.size() < 2)
+    return;
+
+  // Failing to read some of the stacks is fine, the unwinder will find
+  // out when it gets there.
+  std::vector<uint8_t> buffer(ranges.size() * stack_prefetch_size);
+  Status error;
+  ReadMemoryRanges(ranges, buffer, error);
+}
+
 void Process::AddInvalidMemoryRegion(const LoadRange &region) {
   m_memory_cache.AddInvalidRange(region.GetRangeBase(), region.GetByteSize());
 }
@@ -6049,6 +6209,9 @@ addr_t Process::ResolveIndirectFunction(const Address *address, Status &error) {
 }
 
 void Process::ModulesDidLoad(ModuleList &module_list) {
+  // Read only memory the cache kept across stops may have been remapped.
+  m_memory_cache.Clear();
+
   SystemRuntime *sys_runtime = GetSystemRuntime();
   if (sys_runtime) {
     sys_runtime->ModulesDidLoad(module_list);
@@ -0,0 +1,215 @@
+//===-- Statistics.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Target/Statistics.h"
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <mutex>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Breakpoint/BreakpointList.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Symbol/SymbolFile.h"
+#include "lldb/Symbol/SymbolVendor.h"
+#include "lldb/Target/Memory.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/ConstString.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+typedef std::map<std::string, TargetStats::Callback> CallbackMap;
+
+std::mutex &GetCallbackMutex() {
+  static std::mutex g_mutex;
+  return g_mutex;
+}
+
+CallbackMap &GetCallbacks() {
+  static CallbackMap g_callbacks;
+  return g_callbacks;
+}
+
+struct ModuleTotals {
+  double symtab_parse_time = 0;
+  double symtab_index_time = 0;
+  double debug_parse_time = 0;
+  double debug_index_time = 0;
+  uint64_t debug_info_size = 0;
+  uint64_t types_completed = 0;
+  uint64_t debug_info_memory = 0;
+  uint64_t debug_info_evictions = 0;
+  uint64_t debug_info_reparses = 0;
+};
+
+StructuredData::DictionarySP GetModuleStatistics(Module &module,
+                                                 ModuleTotals &totals) {
+  auto module_stats_sp = std::make_shared<StructuredData::Dictionary>();
+  module_stats_sp->AddStringItem("path", module.GetFileSpec().GetPath());
+  if (ConstString object_name = module.GetObjectName())
+    module_stats_sp->AddStringItem("objectName", object_name.GetStringRef());
+  if (module.GetUUID().IsValid())
+    module_stats_sp->AddStringItem("uuid", module.GetUUID().GetAsString());
+  module_stats_sp->AddStringItem("triple",
+                                 module.GetArchitecture().GetTriple().str());
+
+  const double symtab_parse_time = module.GetSymtabParseTime().get().count();
+  const double symtab_index_time = module.GetSymtabIndexTime().get().count();
+  module_stats_sp->AddFloatItem("symbolTableParseTime", symtab_parse_time);
+  module_stats_sp->AddFloatItem("symbolTableIndexTime", symtab_index_time);
+  totals.symtab_parse_time += symtab_parse_time;
+  totals.symtab_index_time += symtab_index_time;
+
+  // Don't create the symbol file just to report that it didn't do anything.
+  SymbolVendor *sym_vendor = module.GetSymbolVendor(false);
+  SymbolFile *sym_file = sym_vendor ? sym_vendor->GetSymbolFile() : nullptr;
+  if (!sym_file)
+    return module_stats_sp;
+
+  const double debug_parse_time = sym_file->GetDebugInfoParseTime().count();
+  const double debug_index_time = sym_file->GetDebugInfoIndexTime().count();
+  const uint64_t debug_info_size = sym_file->GetDebugInfoSize();
+  const uint64_t types_completed = sym_file->GetNumTypesCompleted();
+  const uint64_t debug_info_memory = sym_file->GetDebugInfoMemorySize();
+  const uint64_t debug_info_evictions = sym_file->GetNumDebugInfoEvictions();
+  const uint64_t debug_info_reparses = sym_file->GetNumDebugInfoReparses();
+  module_stats_sp->AddFloatItem("debugInfoParseTime", debug_parse_time);
+  module_stats_sp->AddFloatItem("debugInfoIndexTime", debug_index_time);
+  module_stats_sp->AddIntegerItem("debugInfoByteSize", debug_info_size);
+  module_stats_sp->AddIntegerItem("debugInfoBytesParsed",
+                                  sym_file->GetDebugInfoBytesParsed());
+  module_stats_sp->AddIntegerItem("typesCompleted", types_completed);
+  module_stats_sp->AddIntegerItem("debugInfoMemorySize", debug_info_memory);
+  module_stats_sp->AddIntegerItem("debugInfoEvictions", debug_info_evictions);
+  module_stats_sp->AddIntegerItem("debugInfoReparses", debug_info_reparses);
+  totals.debug_parse_time += debug_parse_time;
+  totals.debug_index_time += debug_index_time;
+  totals.debug_info_size += debug_info_size;
+  totals.types_completed += types_completed;
+  totals.debug_info_memory += debug_info_memory;
+  totals.debug_info_evictions += debug_info_evictions;
+  totals.debug_info_reparses += debug_info_reparses;
+  return module_stats_sp;
+}
+
+} // namespace
+
+void TargetStats::RegisterCallback(llvm::StringRef name, Callback callback) {
+  std::lock_guard<std::mutex> guard(GetCallbackMutex());
+  GetCallbacks()[name] = std::move(callback);
+}
+
+void TargetStats::UnregisterCallback(llvm::StringRef name) {
+  std::lock_guard<std::mutex> guard(GetCallbackMutex());
+  GetCallbacks().erase(name.str());
+}
+
+StructuredData::DictionarySP TargetStats::ReportStatistics(Target &target) {
+  auto stats_sp = std::make_shared<StructuredData::Dictionary>();
+
+  // The counters that are only updated between "statistics enable" and
+  // "statistics disable".
+  uint32_t stat_idx = 0;
+  for (uint32_t count : target.GetStatistics()) {
+    stats_sp->AddIntegerItem(
+        GetStatDescription(static_cast<StatisticKind>(stat_idx)), count);
+    ++stat_idx;
+  }
+
+  auto modules_sp = std::make_shared<StructuredData::Array>();
+  ModuleTotals totals;
+  target.GetImages().ForEach([&](const ModuleSP &module_sp) {
+    modules_sp->AddItem(GetModuleStatistics(*module_sp, totals));
+    return true;
+  });
+  stats_sp->AddItem("modules", modules_sp);
+  stats_sp->AddFloatItem("totalSymbolTableParseTime",
+                         totals.symtab_parse_time);
+  stats_sp->AddFloatItem("totalSymbolTableIndexTime",
+                         totals.symtab_index_time);
+  stats_sp->AddFloatItem("totalDebugInfoParseTime", totals.debug_parse_time);
+  stats_sp->AddFloatItem("totalDebugInfoIndexTime", totals.debug_index_time);
+  stats_sp->AddIntegerItem("totalDebugInfoByteSize", totals.debug_info_size);
+  stats_sp->AddIntegerItem("totalTypesCompleted", totals.types_completed);
+  stats_sp->AddIntegerItem("totalDebugInfoMemorySize",
+                           totals.debug_info_memory);
+  stats_sp->AddIntegerItem("totalDebugInfoEvictions",
+                           totals.debug_info_evictions);
+  stats_sp->AddIntegerItem("totalDebugInfoReparses",
+                           totals.debug_info_reparses);
+
+  auto breakpoints_sp = std::make_shared<StructuredData::Array>();
+  double breakpoint_resolve_time = 0;
+  {
+    BreakpointList &breakpoints = target.GetBreakpointList();
+    std::unique_lock<std::recursive_mutex> lock;
+    breakpoints.GetListMutex(lock);
+    for (BreakpointSP bp_sp : breakpoints.Breakpoints()) {
+      const double resolve_time = bp_sp->GetResolveTime().get().count();
+      auto bp_stats_sp = std::make_shared<StructuredData::Dictionary>();
+      bp_stats_sp->AddIntegerItem("id", bp_sp->GetID());
+      bp_stats_sp->AddIntegerItem("numLocations", bp_sp->GetNumLocations());
+      bp_stats_sp->AddIntegerItem("numResolvedLocations",
+                                  bp_sp->GetNumResolvedLocations());
+      bp_stats_sp->AddFloatItem("resolveTime", resolve_time);
+      breakpoints_sp->AddItem(bp_stats_sp);
+      breakpoint_resolve_time += resolve_time;
+    }
+  }
+  stats_sp->AddItem("breakpoints", breakpoints_sp);
+  stats_sp->AddFloatItem("totalBreakpointResolveTime", breakpoint_resolve_time);
+
+  ConstString::PoolStatistics pool_stats = ConstString::GetPoolStatistics();
+  auto strings_sp = std::make_shared<StructuredData::Dictionary>();
+  strings_sp->AddIntegerItem("count", pool_stats.num_strings);
+  strings_sp->AddIntegerItem("stringBytes", pool_stats.string_bytes);
+  strings_sp->AddIntegerItem("memorySize", pool_stats.memory_size);
+  strings_sp->AddIntegerItem("hits", pool_stats.num_hits);
+  strings_sp->AddIntegerItem("inserts", pool_stats.num_inserts);
+  strings_sp->AddIntegerItem("contended", pool_stats.num_contended);
+  stats_sp->AddItem("constStrings", strings_sp);
+
+  if (ProcessSP process_sp = target.GetProcessSP()) {
+    MemoryCache::Statistics cache_stats =
+        process_sp->GetMemoryCache().GetStatistics();
+    const uint64_t num_reads = cache_stats.num_hits + cache_stats.num_misses;
+    auto cache_sp = std::make_shared<StructuredData::Dictionary>();
+    cache_sp->AddIntegerItem("hits", cache_stats.num_hits);
+    cache_sp->AddIntegerItem("misses", cache_stats.num_misses);
+    cache_sp->AddFloatItem(
+        "hitRate", num_reads ? (double)cache_stats.num_hits / num_reads : 0.0);
+    cache_sp->AddIntegerItem("processReads", cache_stats.num_process_reads);
+    cache_sp->AddIntegerItem("bytesRead", cache_stats.bytes_read);
+    cache_sp->AddIntegerItem("bytesPrefetched", cache_stats.bytes_prefetched);
+    cache_sp->AddIntegerItem("pagesKept", cache_stats.num_pages_kept);
+    stats_sp->AddItem("memoryCache", cache_sp);
+  }
+
+  // Call the callbacks without holding the mutex, they may take a while.
+  CallbackMap callbacks;
+  {
+    std::lock_guard<std::mutex> guard(GetCallbackMutex());
+    callbacks = GetCallbacks();
+  }
+  for (auto &entry : callbacks) {
+    auto dict_sp = std::make_shared<StructuredData::Dictionary>();
+    entry.second(target, *dict_sp);
+    if (dict_sp->GetSize() > 0)
+      stats_sp->AddItem(entry.first, dict_sp);
+  }
+  return stats_sp;
+}
@@ -1616,6 +1616,9 @@ void Target::SymbolsDidLoad(ModuleList &module_list) {
 
 void Target::ModulesDidUnload(ModuleList &module_list, bool delete_locations) {
   if (m_valid && module_list.GetSize()) {
+    // Memory of the unloaded modules may be kept by the memory cache.
+    if (m_process_sp)
+      m_process_sp->GetMemoryCache().Clear();
     UnloadModuleSections(module_list);
     m_breakpoint_list.UpdateBreakpoints(module_list, false, delete_locations);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, false,
@@ -1927,6 +1930,56 @@ bool Target::ReadPointerFromMemory(const Address &addr, bool prefer_file_cache,
   return false;
 }
 
+Status Target::FindSharedModule(const ModuleSpec &module_spec,
+                                ModuleSP &module_sp, ModuleSP *old_module_sp,
+                                bool *did_create_module) {
+  Status error;
+  // If there are image search path entries, try to use them first to acquire
+  // a suitable image.
+  if (m_image_search_paths.GetSize()) {
+    ModuleSpec transformed_spec(module_spec);
+    if (m_image_search_paths.RemapPath(
+            module_spec.GetFileSpec().GetDirectory(),
+            transformed_spec.GetFileSpec().GetDirectory())) {
+      transformed_spec.GetFileSpec().GetFilename() =
+          module_spec.GetFileSpec().GetFilename();
+      error = ModuleList::GetSharedModule(transformed_spec, module_sp,
+                                          &GetExecutableSearchPaths(),
+                                          old_module_sp, did_create_module);
+    }
+  }
+
+  if (!module_sp) {
+    // If we have a UUID, we can check our global shared module list in case
+    // we already have it. If we don't have a valid UUID, then we can't since
+    // the path in "module_spec" will be a platform path, and we will need to
+    // let the platform find that file. For example, we could be asking for
+    // "/usr/lib/dyld" and if we do not have a UUID, we don't want to pick
+    // the local copy of "/usr/lib/dyld" since our platform could be a remote
+    // platform that has its own "/usr/lib/dyld" in an SDK or in a local file
+    // cache.
+    if (module_spec.GetUUID().IsValid()) {
+      // We have a UUID, it is OK to check the global module list...
+      error = ModuleList::GetSharedModule(module_spec, module_sp,
+                                          &GetExecutableSearchPaths(),
+                                          old_module_sp, did_create_module);
+    }
+
+    if (!module_sp) {
+      // The platform is responsible for finding and caching an appropriate
+      // module in the shared module cache.
+      if (m_platform_sp) {
+        error = m_platform_sp->GetSharedModule(
+            module_spec, m_process_sp.get(), module_sp,
+            &GetExecutableSearchPaths(), old_module_sp, did_create_module);
+      } else {
+        error.SetErrorString("no platform is currently set");
+      }
+    }
+  }
+  return error;
+}
+
 ModuleSP Target::GetSharedModule(const ModuleSpec &module_spec,
                                  Status *error_ptr) {
   ModuleSP module_sp;
@@ -1946,49 +1999,8 @@ ModuleSP Target::GetSharedModule(const ModuleSpec &module_spec,
                             // of the library
     bool did_create_module = false;
 
-    // If there are image search path entries, try to use them first to acquire
-    // a suitable image.
-    if (m_image_search_paths.GetSize()) {
-      ModuleSpec transformed_spec(module_spec);
-      if (m_image_search_paths.RemapPath(
-              module_spec.GetFileSpec().GetDirectory(),
-              transformed_spec.GetFileSpec().GetDirectory())) {
-        transformed_spec.GetFileSpec().GetFilename() =
-            module_spec.GetFileSpec().GetFilename();
-        error = ModuleList::GetSharedModule(transformed_spec, module_sp,
-                                            &GetExecutableSearchPaths(),
-                                            &old_module_sp, &did_create_module);
-      }
-    }
-
-    if (!module_sp) {
-      // If we have a UUID, we can check our global shared module list in case
-      // we already have it. If we don't have a valid UUID, then we can't since
-      // the path in "module_spec" will be a platform path, and we will need to
-      // let the platform find that file. For example, we could be asking for
-      // "/usr/lib/dyld" and if we do not have a UUID, we don't want to pick
-      // the local copy of "/usr/lib/dyld" since our platform could be a remote
-      // platform that has its own "/usr/lib/dyld" in an SDK or in a local file
-      // cache.
-      if (module_spec.GetUUID().IsValid()) {
-        // We have a UUID, it is OK to check the global module list...
-        error = ModuleList::GetSharedModule(module_spec, module_sp,
-                                            &GetExecutableSearchPaths(),
-                                            &old_module_sp, &did_create_module);
-      }
-
-      if (!module_sp) {
-        // The platform is responsible for finding and caching an appropriate
-        // module in the shared module cache.
-        if (m_platform_sp) {
-          error = m_platform_sp->GetSharedModule(
-              module_spec, m_process_sp.get(), module_sp,
-              &GetExecutableSearchPaths(), &old_module_sp, &did_create_module);
-        } else {
-          error.SetErrorString("no platform is currently set");
-        }
-      }
-    }
+    error = FindSharedModule(module_spec, module_sp, &old_module_sp,
+                             &did_create_module);
 
     // We found a module that wasn't in our target list.  Let's make sure that
     // there wasn't an equivalent
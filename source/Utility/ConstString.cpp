@@ -11,67 +11,85 @@
 
 #include "lldb/Utility/Stream.h"
 
-#include "llvm/ADT/StringExtras.h"
-#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/iterator.h"            // for iterator_facade_base
 #include "llvm/Support/Allocator.h"       // for BumpPtrAllocator
 #include "llvm/Support/FormatProviders.h" // for format_provider
-#include "llvm/Support/RWMutex.h"
 #include "llvm/Support/Threading.h"
 
 #include <algorithm> // for min
 #include <array>
-#include <utility> // for make_pair, pair
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new> // for placement new
+#include <vector>
 
+#include <assert.h>   // for assert
 #include <inttypes.h> // for PRIu64
 #include <stdint.h>   // for uint8_t, uint32_t, uint64_t
 #include <string.h>   // for size_t, strlen
 
 using namespace lldb_private;
 
+//----------------------------------------------------------------------
+// The string pool is split into 256 shards that each own an open
+// addressed hash table. The string is hashed once: the top bits of the
+// hash select the shard and the low bits the first bucket to probe.
+//
+// Looking up a string that is already in the pool doesn't take any
+// locks. Entries are never removed and a bucket only ever goes from
+// empty to full, so readers can probe a table with acquire loads while
+// another thread is inserting into it. Inserting takes the shard's
+// mutex. When a table gets too full, a bigger copy is published and the
+// old table is kept alive since readers may still be probing it.
+//----------------------------------------------------------------------
 class Pool {
 public:
-  typedef const char *StringPoolValueType;
-  typedef llvm::StringMap<StringPoolValueType, llvm::BumpPtrAllocator>
-      StringPool;
-  typedef llvm::StringMapEntry<StringPoolValueType> StringPoolEntryType;
-
-  static StringPoolEntryType &
-  GetStringMapEntryFromKeyData(const char *keyData) {
-    return StringPoolEntryType::GetStringMapEntryFromKeyData(keyData);
+  //------------------------------------------------------------------
+  // Every uniqued string is preceded by one of these so that the
+  // length and mangled counterpart of a const string can be found from
+  // the string pointer alone.
+  //------------------------------------------------------------------
+  struct Entry {
+    std::atomic<const char *> mangled;
+    uint32_t length;
+    uint32_t hash;
+
+    const char *GetKeyData() const {
+      return reinterpret_cast<const char *>(this + 1);
+    }
+
+    bool Matches(const llvm::StringRef &s, uint32_t s_hash) const {
+      return hash == s_hash && length == s.size() &&
+             memcmp(GetKeyData(), s.data(), length) == 0;
+    }
+  };
+
+  static Entry &GetEntryFromKeyData(const char *keyData) {
+    return *(reinterpret_cast<Entry *>(const_cast<char *>(keyData)) - 1);
   }
 
   static size_t GetConstCStringLength(const char *ccstr) {
     if (ccstr != nullptr) {
       // Since the entry is read only, and we derive the entry entirely from the
       // pointer, we don't need the lock.
-      const StringPoolEntryType &entry = GetStringMapEntryFromKeyData(ccstr);
-      return entry.getKey().size();
+      return GetEntryFromKeyData(ccstr).length;
     }
     return 0;
   }
 
-  StringPoolValueType GetMangledCounterpart(const char *ccstr) const {
-    if (ccstr != nullptr) {
-      const uint8_t h = hash(llvm::StringRef(ccstr));
-      llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-      return GetStringMapEntryFromKeyData(ccstr).getValue();
-    }
+  const char *GetMangledCounterpart(const char *ccstr) const {
+    if (ccstr != nullptr)
+      return GetEntryFromKeyData(ccstr).mangled.load(std::memory_order_acquire);
     return nullptr;
   }
 
   bool SetMangledCounterparts(const char *key_ccstr, const char *value_ccstr) {
     if (key_ccstr != nullptr && value_ccstr != nullptr) {
-      {
-        const uint8_t h = hash(llvm::StringRef(key_ccstr));
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-        GetStringMapEntryFromKeyData(key_ccstr).setValue(value_ccstr);
-      }
-      {
-        const uint8_t h = hash(llvm::StringRef(value_ccstr));
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-        GetStringMapEntryFromKeyData(value_ccstr).setValue(key_ccstr);
-      }
+      GetEntryFromKeyData(key_ccstr).mangled.store(value_ccstr,
+                                                   std::memory_order_release);
+      GetEntryFromKeyData(value_ccstr)
+          .mangled.store(key_ccstr, std::memory_order_release);
       return true;
     }
     return false;
@@ -90,54 +108,98 @@ public:
   }
 
   const char *GetConstCStringWithStringRef(const llvm::StringRef &string_ref) {
-    if (string_ref.data()) {
-      const uint8_t h = hash(string_ref);
-
-      {
-        llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-        auto it = m_string_pools[h].m_string_map.find(string_ref);
-        if (it != m_string_pools[h].m_string_map.end())
-          return it->getKeyData();
-      }
-
-      llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-      StringPoolEntryType &entry =
-          *m_string_pools[h]
-               .m_string_map.insert(std::make_pair(string_ref, nullptr))
-               .first;
-      return entry.getKeyData();
-    }
+    if (string_ref.data())
+      return GetConstCStringWithHash(string_ref, ConstString::Hash(string_ref));
     return nullptr;
   }
 
+  // Unique a string with a hash that comes from outside the pool, such as
+  // an accelerator table on disk. Entries only match if both their hash
+  // and their string are equal, so a hit proves the hash right. The hash
+  // is computed again before a new entry is added, so that a wrong hash
+  // can't add a second entry for the same string.
+  const char *
+  GetConstCStringWithUncheckedHash(const llvm::StringRef &string_ref,
+                                   uint32_t hash) {
+    if (string_ref.data() == nullptr)
+      return nullptr;
+
+    const uint32_t mixed = Mix(hash);
+    Shard &shard = m_shards[mixed >> 24];
+    const Table &table = *shard.m_table.load(std::memory_order_acquire);
+    if (const Entry *entry = Find(table, string_ref, hash, mixed)) {
+      shard.m_num_hits.fetch_add(1, std::memory_order_relaxed);
+      return entry->GetKeyData();
+    }
+    return GetConstCStringWithStringRef(string_ref);
+  }
+
+  const char *GetConstCStringWithHash(const llvm::StringRef &string_ref,
+                                      uint32_t hash,
+                                      const char *mangled_ccstr = nullptr) {
+    if (string_ref.data() == nullptr)
+      return nullptr;
+    assert(hash == ConstString::Hash(string_ref) && "wrong string hash");
+
+    const uint32_t mixed = Mix(hash);
+    Shard &shard = m_shards[mixed >> 24];
+
+    const Table *current = shard.m_table.load(std::memory_order_acquire);
+    if (const Entry *entry = Find(*current, string_ref, hash, mixed)) {
+      shard.m_num_hits.fetch_add(1, std::memory_order_relaxed);
+      return entry->GetKeyData();
+    }
+
+    std::unique_lock<std::mutex> lock(shard.m_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      shard.m_num_contended.fetch_add(1, std::memory_order_relaxed);
+      lock.lock();
+    }
+
+    // Another thread may have added the string since we looked.
+    Table *table = shard.m_table.load(std::memory_order_relaxed);
+    if (const Entry *entry = Find(*table, string_ref, hash, mixed)) {
+      shard.m_num_hits.fetch_add(1, std::memory_order_relaxed);
+      return entry->GetKeyData();
+    }
+
+    // Keep the load factor at or below 3/4 so probe sequences stay short
+    // and every probe is guaranteed to reach an empty bucket.
+    if ((shard.m_num_entries + 1) * 4 > (table->mask + 1) * 3)
+      table = Grow(shard);
+
+    const size_t length = string_ref.size();
+    void *storage =
+        shard.m_allocator.Allocate(sizeof(Entry) + length + 1, alignof(Entry));
+    Entry *entry = new (storage) Entry();
+    entry->mangled.store(mangled_ccstr, std::memory_order_relaxed);
+    entry->length = length;
+    entry->hash = hash;
+    char *key_data = const_cast<char *>(entry->GetKeyData());
+    memcpy(key_data, string_ref.data(), length);
+    key_data[length] = '\0';
+
+    Insert(*table, entry, mixed);
+    ++shard.m_num_entries;
+    shard.m_string_bytes += sizeof(Entry) + length + 1;
+    shard.m_num_inserts.fetch_add(1, std::memory_order_relaxed);
+    return entry->GetKeyData();
+  }
+
   const char *
   GetConstCStringAndSetMangledCounterPart(const char *demangled_cstr,
                                           const char *mangled_ccstr) {
     if (demangled_cstr != nullptr) {
-      const char *demangled_ccstr = nullptr;
-
-      {
-        llvm::StringRef string_ref(demangled_cstr);
-        const uint8_t h = hash(string_ref);
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-
-        // Make string pool entry with the mangled counterpart already set
-        StringPoolEntryType &entry =
-            *m_string_pools[h]
-                 .m_string_map.insert(std::make_pair(string_ref, mangled_ccstr))
-                 .first;
-
-        // Extract the const version of the demangled_cstr
-        demangled_ccstr = entry.getKeyData();
-      }
-
-      {
-        // Now assign the demangled const string as the counterpart of the
-        // mangled const string...
-        const uint8_t h = hash(llvm::StringRef(mangled_ccstr));
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-        GetStringMapEntryFromKeyData(mangled_ccstr).setValue(demangled_ccstr);
-      }
+      // Make string pool entry with the mangled counterpart already set
+      llvm::StringRef string_ref(demangled_cstr);
+      const char *demangled_ccstr = GetConstCStringWithHash(
+          string_ref, ConstString::Hash(string_ref), mangled_ccstr);
+
+      // Now assign the demangled const string as the counterpart of the
+      // mangled const string...
+      if (mangled_ccstr != nullptr)
+        GetEntryFromKeyData(mangled_ccstr)
+            .mangled.store(demangled_ccstr, std::memory_order_release);
 
       // Return the constant demangled C string
       return demangled_ccstr;
@@ -154,33 +216,105 @@ public:
     return nullptr;
   }
 
+  ConstString::PoolStatistics GetStatistics() {
+    ConstString::PoolStatistics stats;
+    stats.memory_size = sizeof(Pool);
+    for (Shard &shard : m_shards) {
+      std::lock_guard<std::mutex> guard(shard.m_mutex);
+      stats.num_strings += shard.m_num_entries;
+      stats.string_bytes += shard.m_string_bytes;
+      stats.memory_size += shard.m_allocator.getTotalMemory();
+      for (const auto &table : shard.m_tables)
+        stats.memory_size +=
+            sizeof(Table) + (table->mask + 1) * sizeof(std::atomic<Entry *>);
+      stats.num_hits += shard.m_num_hits.load(std::memory_order_relaxed);
+      stats.num_inserts += shard.m_num_inserts.load(std::memory_order_relaxed);
+      stats.num_contended +=
+          shard.m_num_contended.load(std::memory_order_relaxed);
+    }
+    return stats;
+  }
+
   //------------------------------------------------------------------
   // Return the size in bytes that this object and any items in its
   // collection of uniqued strings + data count values takes in
   // memory.
   //------------------------------------------------------------------
-  size_t MemorySize() const {
-    size_t mem_size = sizeof(Pool);
-    for (const auto &pool : m_string_pools) {
-      llvm::sys::SmartScopedReader<false> rlock(pool.m_mutex);
-      for (const auto &entry : pool.m_string_map)
-        mem_size += sizeof(StringPoolEntryType) + entry.getKey().size();
+  size_t MemorySize() { return GetStatistics().memory_size; }
+
+protected:
+  struct Table {
+    explicit Table(uint32_t capacity)
+        : mask(capacity - 1), buckets(new std::atomic<Entry *>[capacity]()) {}
+
+    const uint32_t mask;
+    std::unique_ptr<std::atomic<Entry *>[]> buckets;
+  };
+
+  struct Shard {
+    Shard() : m_table(nullptr) {
+      m_tables.emplace_back(new Table(16));
+      m_table.store(m_tables.back().get(), std::memory_order_relaxed);
     }
-    return mem_size;
+
+    std::mutex m_mutex;
+    // The table readers should probe. Every table this shard ever used
+    // is owned by m_tables, the current one is the last.
+    std::atomic<Table *> m_table;
+    std::vector<std::unique_ptr<Table>> m_tables;
+    llvm::BumpPtrAllocator m_allocator;
+    uint32_t m_num_entries = 0;
+    uint64_t m_string_bytes = 0;
+    std::atomic<uint64_t> m_num_hits{0};
+    std::atomic<uint64_t> m_num_inserts{0};
+    std::atomic<uint64_t> m_num_contended{0};
+  };
+
+  // The DJB hash we are given is weak in its high bits for short strings,
+  // so spread it out before using it to pick a shard and a bucket.
+  static uint32_t Mix(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
   }
 
-protected:
-  uint8_t hash(const llvm::StringRef &s) const {
-    uint32_t h = llvm::HashString(s);
-    return ((h >> 24) ^ (h >> 16) ^ (h >> 8) ^ h) & 0xff;
+  static const Entry *Find(const Table &table, const llvm::StringRef &s,
+                           uint32_t hash, uint32_t mixed) {
+    for (uint32_t i = mixed & table.mask;; i = (i + 1) & table.mask) {
+      const Entry *entry = table.buckets[i].load(std::memory_order_acquire);
+      if (entry == nullptr)
+        return nullptr;
+      if (entry->Matches(s, hash))
+        return entry;
+    }
   }
 
-  struct PoolEntry {
-    mutable llvm::sys::SmartRWMutex<false> m_mutex;
-    StringPool m_string_map;
-  };
+  static void Insert(Table &table, Entry *entry, uint32_t mixed) {
+    uint32_t i = mixed & table.mask;
+    while (table.buckets[i].load(std::memory_order_relaxed) != nullptr)
+      i = (i + 1) & table.mask;
+    table.buckets[i].store(entry, std::memory_order_release);
+  }
 
-  std::array<PoolEntry, 256> m_string_pools;
+  // Must be called with the shard's mutex held.
+  static Table *Grow(Shard &shard) {
+    const Table &old_table = *shard.m_tables.back();
+    const uint32_t old_capacity = old_table.mask + 1;
+    std::unique_ptr<Table> new_table(new Table(old_capacity * 2));
+    for (uint32_t i = 0; i < old_capacity; ++i) {
+      if (Entry *entry = old_table.buckets[i].load(std::memory_order_relaxed))
+        Insert(*new_table, entry, Mix(entry->hash));
+    }
+    Table *table = new_table.get();
+    shard.m_tables.push_back(std::move(new_table));
+    shard.m_table.store(table, std::memory_order_release);
+    return table;
+  }
+
+  std::array<Shard, 256> m_shards;
 };
 
 //----------------------------------------------------------------------
@@ -213,6 +347,9 @@ ConstString::ConstString(const char *cstr, size_t cstr_len)
 ConstString::ConstString(const llvm::StringRef &s)
     : m_string(StringPool().GetConstCStringWithLength(s.data(), s.size())) {}
 
+ConstString::ConstString(const llvm::StringRef &s, uint32_t hash)
+    : m_string(StringPool().GetConstCStringWithUncheckedHash(s, hash)) {}
+
 bool ConstString::operator<(const ConstString &rhs) const {
   if (m_string == rhs.m_string)
     return false;
@@ -333,6 +470,10 @@ size_t ConstString::StaticMemorySize() {
   return StringPool().MemorySize();
 }
 
+ConstString::PoolStatistics ConstString::GetPoolStatistics() {
+  return StringPool().GetStatistics();
+}
+
 void llvm::format_provider<ConstString>::format(const ConstString &CS,
                                                 llvm::raw_ostream &OS,
                                                 llvm::StringRef Options) {
@@ -98,6 +98,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
         return eServerPacketType_QEnvironmentHexEncoded;
       if (PACKET_STARTS_WITH("QEnableErrorStrings"))
         return eServerPacketType_QEnableErrorStrings;
+      if (PACKET_STARTS_WITH("QEnableCompression:"))
+        return eServerPacketType_QEnableCompression;
       break;
 
     case 'P':
@@ -400,6 +402,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
     return eServerPacketType_m;
 
   case 'M':
+    if (PACKET_STARTS_WITH("MultiMemRead:"))
+      return eServerPacketType_MultiMemRead;
     return eServerPacketType_M;
 
   case 'p':
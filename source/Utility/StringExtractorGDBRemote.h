@@ -74,6 +74,7 @@ public:
     eServerPacketType_qFileLoadAddress,
     eServerPacketType_QEnvironment,
     eServerPacketType_QEnableErrorStrings,
+    eServerPacketType_QEnableCompression,
     eServerPacketType_QLaunchArch,
     eServerPacketType_QSetDisableASLR,
     eServerPacketType_QSetDetachOnError,
@@ -153,6 +154,7 @@ public:
     eServerPacketType_k,
     eServerPacketType_m,
     eServerPacketType_M,
+    eServerPacketType_MultiMemRead,
     eServerPacketType_p,
     eServerPacketType_P,
     eServerPacketType_s,
@@ -13,18 +13,31 @@
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Initialization/SystemLifetimeManager.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/ClangASTImporter.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/StackFrame.h"
+#include "lldb/Target/StopInfo.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/TargetList.h"
+#include "lldb/Target/Thread.h"
 #include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/StreamString.h"
+#include "lldb/Utility/StructuredData.h"
 
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
+#include <chrono>
+#include <iostream>
 #include <thread>
 
 using namespace lldb;
@@ -35,6 +48,8 @@ namespace opts {
 cl::SubCommand ModuleSubcommand("module-sections",
                                 "Display LLDB Module Information");
 cl::SubCommand SymbolsSubcommand("symbols", "Dump symbols for an object file");
+cl::SubCommand SymbolicateSubcommand(
+    "symbolicate", "Print the backtraces of the threads in core files as JSON");
 
 namespace module {
 cl::opt<bool> SectionContents("contents",
@@ -48,6 +63,28 @@ namespace symbols {
 cl::list<std::string> InputFilenames(cl::Positional, cl::desc("<input files>"),
                                      cl::OneOrMore, cl::sub(SymbolsSubcommand));
 }
+
+namespace symbolicate {
+cl::opt<std::string> Executable("executable",
+                                cl::desc("The executable the cores are from"),
+                                cl::sub(SymbolicateSubcommand));
+cl::list<std::string>
+    Modules("module",
+            cl::desc("Load the symbols of a module once and keep them for "
+                     "every core"),
+            cl::ZeroOrMore, cl::sub(SymbolicateSubcommand));
+cl::opt<unsigned> MaxFrames("max-frames",
+                            cl::desc("Maximum number of frames per thread"),
+                            cl::init(UINT32_MAX),
+                            cl::sub(SymbolicateSubcommand));
+cl::opt<bool> Pretty("pretty", cl::desc("Pretty print the JSON"),
+                     cl::sub(SymbolicateSubcommand));
+cl::list<std::string>
+    CoreFiles(cl::Positional,
+              cl::desc("<core files> (read from stdin, one per line, when "
+                       "none are given)"),
+              cl::ZeroOrMore, cl::sub(SymbolicateSubcommand));
+} // namespace symbolicate
 } // namespace opts
 
 static llvm::ManagedStatic<SystemLifetimeManager> DebuggerLifetime;
@@ -103,6 +140,160 @@ static void dumpModules(Debugger &Dbg) {
   }
 }
 
+static StructuredData::DictionarySP symbolicateCore(Debugger &Dbg,
+                                                    llvm::StringRef Core,
+                                                    size_t &NumFrames) {
+  auto Result = std::make_shared<StructuredData::Dictionary>();
+  Result->AddStringItem("core", Core);
+
+  TargetSP Target;
+  Status Error = Dbg.GetTargetList().CreateTarget(
+      Dbg, opts::symbolicate::Executable, "", false, nullptr, Target);
+  if (Error.Fail()) {
+    Result->AddStringItem("error", Error.AsCString());
+    return Result;
+  }
+
+  // The target is deleted without removing the orphaned shared modules, so
+  // the modules of this core stay in the shared module list and the next
+  // core that uses them doesn't load and index them again.
+  auto DeleteTarget = llvm::make_scope_exit([&] {
+    Dbg.GetTargetList().DeleteTarget(Target);
+    Target->Destroy();
+  });
+
+  FileSpec CoreSpec(Core, true);
+  ProcessSP Process = Target->CreateProcess(Dbg.GetListener(), "", &CoreSpec);
+  if (!Process) {
+    Result->AddStringItem("error", "unable to find a plug-in for the core");
+    return Result;
+  }
+  Error = Process->LoadCore();
+  if (Error.Fail()) {
+    Result->AddStringItem("error", Error.AsCString());
+    return Result;
+  }
+  Result->AddIntegerItem("pid", Process->GetID());
+
+  std::vector<ThreadSP> Threads;
+  for (ThreadSP Thread : Process->Threads())
+    Threads.push_back(Thread);
+  Process->PrefetchThreadRegisters(Threads);
+  Process->UnwindThreads(Threads, opts::symbolicate::MaxFrames);
+
+  // The stack frame lists of the threads were filled in by UnwindThreads,
+  // including the inlined frames of each concrete frame.
+  auto ThreadsArray = std::make_shared<StructuredData::Array>();
+  for (const ThreadSP &Thread : Threads) {
+    auto ThreadDict = std::make_shared<StructuredData::Dictionary>();
+    ThreadDict->AddIntegerItem("tid", Thread->GetID());
+    if (StopInfoSP StopInfo = Thread->GetStopInfo())
+      ThreadDict->AddStringItem("stop-reason", StopInfo->GetDescription());
+
+    auto Frames = std::make_shared<StructuredData::Array>();
+    for (uint32_t I = 0; I < opts::symbolicate::MaxFrames; ++I) {
+      StackFrameSP Frame = Thread->GetStackFrameAtIndex(I);
+      if (!Frame)
+        break;
+      auto FrameDict = std::make_shared<StructuredData::Dictionary>();
+      FrameDict->AddIntegerItem(
+          "pc", Frame->GetFrameCodeAddress().GetLoadAddress(Target.get()));
+      if (Frame->IsInlined())
+        FrameDict->AddBooleanItem("inlined", true);
+      const SymbolContext &SC = Frame->GetSymbolContext(
+          eSymbolContextModule | eSymbolContextFunction | eSymbolContextBlock |
+          eSymbolContextSymbol | eSymbolContextLineEntry);
+      if (SC.module_sp)
+        FrameDict->AddStringItem("module",
+                                 SC.module_sp->GetFileSpec().GetPath());
+      if (ConstString Name = SC.GetFunctionName())
+        FrameDict->AddStringItem("function", Name.GetStringRef());
+      if (SC.line_entry.IsValid()) {
+        FrameDict->AddStringItem("file", SC.line_entry.file.GetPath());
+        FrameDict->AddIntegerItem("line", SC.line_entry.line);
+      }
+      Frames->AddItem(FrameDict);
+      ++NumFrames;
+    }
+    ThreadDict->AddItem("frames", Frames);
+    ThreadsArray->AddItem(ThreadDict);
+  }
+  Result->AddItem("threads", ThreadsArray);
+  return Result;
+}
+
+static int symbolicateCores(Debugger &Dbg) {
+  using Clock = std::chrono::steady_clock;
+  using Seconds = std::chrono::duration<double>;
+
+  // Load and index the modules up front, and hold on to them so they stay
+  // in the shared module list for as long as the tool runs.
+  Clock::time_point Start = Clock::now();
+  std::vector<ModuleSP> Preloaded;
+  for (const auto &File : opts::symbolicate::Modules) {
+    ModuleSP Module;
+    Status Error = ModuleList::GetSharedModule(
+        ModuleSpec(FileSpec(File, true)), Module, nullptr, nullptr, nullptr);
+    if (!Module) {
+      llvm::errs() << "Could not load module " << File << ": "
+                   << Error.AsCString("unknown error") << "\n";
+      continue;
+    }
+    Module->PreloadSymbols();
+    Preloaded.push_back(Module);
+  }
+  if (!Preloaded.empty())
+    llvm::errs() << formatv("Preloaded {0} modules in {1:f3}s\n",
+                            Preloaded.size(),
+                            Seconds(Clock::now() - Start).count());
+
+  size_t NumCores = 0;
+  size_t NumFailed = 0;
+  size_t TotalFrames = 0;
+  Seconds Total(0);
+  auto Symbolicate = [&](llvm::StringRef Core) {
+    size_t NumFrames = 0;
+    Clock::time_point CoreStart = Clock::now();
+    StructuredData::DictionarySP Result =
+        symbolicateCore(Dbg, Core, NumFrames);
+    Seconds Elapsed = Clock::now() - CoreStart;
+    Result->AddFloatItem("seconds", Elapsed.count());
+
+    StreamString Stream;
+    Result->Dump(Stream, opts::symbolicate::Pretty);
+    llvm::outs() << Stream.GetString() << "\n";
+    llvm::outs().flush();
+
+    ++NumCores;
+    if (Result->HasKey("error"))
+      ++NumFailed;
+    TotalFrames += NumFrames;
+    Total += Elapsed;
+  };
+
+  if (!opts::symbolicate::CoreFiles.empty()) {
+    for (const auto &Core : opts::symbolicate::CoreFiles)
+      Symbolicate(Core);
+  } else {
+    // Keep serving cores from stdin, so that a crash pipeline can start the
+    // tool once and reuse the loaded modules for all of its cores.
+    std::string Line;
+    while (std::getline(std::cin, Line)) {
+      llvm::StringRef Core = llvm::StringRef(Line).trim();
+      if (!Core.empty())
+        Symbolicate(Core);
+    }
+  }
+
+  if (NumCores != 0)
+    llvm::errs() << formatv(
+        "Symbolicated {0} cores ({1} failed), {2} frames in {3:f3}s: "
+        "{4:f1} cores/s, {5:f3}s per core\n",
+        NumCores, NumFailed, TotalFrames, Total.count(),
+        NumCores / Total.count(), Total.count() / NumCores);
+  return NumFailed == 0 ? 0 : 1;
+}
+
 int main(int argc, const char *argv[]) {
   StringRef ToolName = argv[0];
   sys::PrintStackTraceOnErrorSignal(ToolName);
@@ -116,11 +307,14 @@ int main(int argc, const char *argv[]) {
 
   auto Dbg = lldb_private::Debugger::CreateInstance();
 
+  int Result = 0;
   if (opts::ModuleSubcommand)
     dumpModules(*Dbg);
   else if (opts::SymbolsSubcommand)
     dumpSymbols(*Dbg);
+  else if (opts::SymbolicateSubcommand)
+    Result = symbolicateCores(*Dbg);
 
   DebuggerLifetime->Terminate();
-  return 0;
+  return Result;
 }
@@ -0,0 +1,112 @@
+//===-- DataFileCacheTest.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/DataFileCache.h"
+#include "lldb/Utility/DataBuffer.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Endian.h"
+#include "lldb/Utility/StreamString.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+
+using namespace lldb_private;
+using namespace lldb;
+
+namespace {
+class DataFileCacheTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    llvm::SmallString<128> dir;
+    ASSERT_FALSE(
+        llvm::sys::fs::createUniqueDirectory("DataFileCacheTest", dir));
+    m_cache_dir = FileSpec(dir.str(), false);
+  }
+
+  void TearDown() override {
+    llvm::sys::fs::remove_directories(m_cache_dir.GetPath());
+  }
+
+protected:
+  FileSpec m_cache_dir;
+};
+} // namespace
+
+TEST_F(DataFileCacheTest, SetGetRemove) {
+  DataFileCache cache(m_cache_dir);
+  EXPECT_FALSE(cache.GetCachedData("a.out-dwarf-index"));
+
+  const uint8_t bytes[] = {1, 2, 3, 4, 5};
+  ASSERT_TRUE(cache.SetCachedData("a.out-dwarf-index", bytes));
+  DataBufferSP data_sp = cache.GetCachedData("a.out-dwarf-index");
+  ASSERT_TRUE(data_sp);
+  ASSERT_EQ(sizeof(bytes), data_sp->GetByteSize());
+  EXPECT_EQ(0, memcmp(bytes, data_sp->GetBytes(), sizeof(bytes)));
+
+  // Overwriting an existing entry replaces it.
+  const uint8_t new_bytes[] = {6, 7};
+  ASSERT_TRUE(cache.SetCachedData("a.out-dwarf-index", new_bytes));
+  data_sp = cache.GetCachedData("a.out-dwarf-index");
+  ASSERT_TRUE(data_sp);
+  EXPECT_EQ(sizeof(new_bytes), data_sp->GetByteSize());
+
+  EXPECT_TRUE(cache.RemoveCacheFile("a.out-dwarf-index").Success());
+  EXPECT_FALSE(cache.GetCachedData("a.out-dwarf-index"));
+}
+
+TEST_F(DataFileCacheTest, ForEachAndPurge) {
+  DataFileCache cache(m_cache_dir);
+  const uint8_t bytes[] = {1, 2, 3};
+  ASSERT_TRUE(cache.SetCachedData("one", bytes));
+  ASSERT_TRUE(cache.SetCachedData("two", bytes));
+
+  uint64_t total_size = 0;
+  EXPECT_EQ(2u, cache.ForEachCacheFile(
+                    [&total_size](const FileSpec &file, uint64_t size) {
+                      total_size += size;
+                      return true;
+                    }));
+  EXPECT_EQ(2 * sizeof(bytes), total_size);
+
+  EXPECT_TRUE(cache.Purge().Success());
+  EXPECT_EQ(0u, cache.ForEachCacheFile(
+                    [](const FileSpec &file, uint64_t size) { return true; }));
+}
+
+TEST(CacheSignatureTest, EncodeDecode) {
+  CacheSignature signature;
+  const uint8_t uuid[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd,
+                          0xef, 0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54,
+                          0x32, 0x10, 0x11, 0x22, 0x33, 0x44};
+  signature.m_uuid.SetBytes(uuid, sizeof(uuid));
+  signature.m_mod_time = 0x12345678;
+  signature.m_obj_mod_time = 0x9abcdef0;
+
+  StreamString strm(Stream::eBinary, 8, endian::InlHostByteOrder());
+  signature.Encode(strm);
+
+  DataExtractor data(strm.GetData(), strm.GetSize(),
+                     endian::InlHostByteOrder(), 8);
+  lldb::offset_t offset = 0;
+  CacheSignature decoded;
+  ASSERT_TRUE(decoded.Decode(data, &offset));
+  EXPECT_EQ(strm.GetSize(), offset);
+  EXPECT_TRUE(signature == decoded);
+
+  decoded.m_mod_time += 1;
+  EXPECT_TRUE(signature != decoded);
+
+  // Truncated data must be rejected.
+  DataExtractor truncated(strm.GetData(), strm.GetSize() - 1,
+                          endian::InlHostByteOrder(), 8);
+  offset = 0;
+  EXPECT_FALSE(decoded.Decode(truncated, &offset));
+}
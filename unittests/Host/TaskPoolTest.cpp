@@ -2,6 +2,10 @@
 
 #include "lldb/Host/TaskPool.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 using namespace lldb_private;
 
 TEST(TaskPoolTest, AddTask) {
@@ -43,3 +47,95 @@ TEST(TaskPoolTest, TaskMap) {
   ASSERT_EQ(data[2], 4);
   ASSERT_EQ(data[3], 9);
 }
+
+TEST(TaskPoolTest, NestedTaskMap) {
+  // With a single worker thread busy running an outer task, the inner
+  // TaskMapOverInt can't wait for helpers that never get to run.
+  const unsigned old_thread_count = TaskPool::GetThreadCount();
+  TaskPool::SetThreadCount(1);
+
+  std::vector<std::future<size_t>> futures;
+  for (size_t i = 0; i < 8; ++i) {
+    futures.push_back(TaskPool::AddTask([i]() {
+      std::atomic<size_t> sum{0};
+      TaskMapOverInt(0, 100, [&sum, i](size_t j) { sum += i * j; });
+      return sum.load();
+    }));
+  }
+  for (size_t i = 0; i < 8; ++i)
+    ASSERT_EQ(i * 99 * 100 / 2, futures[i].get());
+
+  TaskPool::SetThreadCount(old_thread_count);
+}
+
+TEST(TaskPoolTest, TaskMapThreadLimit) {
+  // No more threads than the pool is limited to work on the values at once.
+  const unsigned old_thread_count = TaskPool::GetThreadCount();
+  TaskPool::SetThreadCount(2);
+
+  std::atomic<unsigned> active{0};
+  std::atomic<unsigned> max_active{0};
+  TaskMapOverInt(0, 64, [&](size_t) {
+    unsigned now = ++active;
+    unsigned prev = max_active;
+    while (now > prev && !max_active.compare_exchange_weak(prev, now))
+      ;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    --active;
+  });
+  EXPECT_LE(max_active.load(), 2u);
+
+  TaskPool::SetThreadCount(old_thread_count);
+}
+
+TEST(TaskPoolTest, ThreadCount) {
+  const unsigned old_thread_count = TaskPool::GetThreadCount();
+  TaskPool::SetThreadCount(3);
+  EXPECT_EQ(3u, TaskPool::GetThreadCount());
+  TaskPool::SetThreadCount(0);
+  EXPECT_EQ(GetHardwareConcurrencyHint(), TaskPool::GetThreadCount());
+
+  // Tasks still complete after the pool was resized.
+  std::atomic<size_t> sum{0};
+  TaskMapOverInt(0, 1000, [&sum](size_t i) { sum += i; });
+  EXPECT_EQ(999u * 1000u / 2, sum);
+
+  TaskPool::SetThreadCount(old_thread_count);
+}
+
+// This is a benchmark rather than a test, run it with
+// --gtest_also_run_disabled_tests.
+TEST(TaskPoolTest, DISABLED_TinyTaskThroughput) {
+  // Measure how many trivial tasks per second the pool can run, both as
+  // individual futures and through TaskMapOverInt. The numbers are recorded
+  // as test properties (see --gtest_output=xml) for comparing pool
+  // implementations; the test itself only checks the results.
+  const size_t num_tasks = 100000;
+  std::vector<size_t> results(num_tasks);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_tasks);
+  for (size_t i = 0; i < num_tasks; ++i)
+    futures.push_back(
+        TaskPool::AddTask([&results, i]() { results[i] = i * 2; }));
+  for (auto &future : futures)
+    future.wait();
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  RecordProperty("add_task_per_second",
+                 std::to_string(num_tasks * 1000000 /
+                                std::max<int64_t>(1, elapsed.count())));
+  for (size_t i = 0; i < num_tasks; ++i)
+    ASSERT_EQ(i * 2, results[i]);
+
+  start = std::chrono::steady_clock::now();
+  TaskMapOverInt(0, num_tasks, [&results](size_t i) { results[i] = i * 3; });
+  elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  RecordProperty("task_map_per_second",
+                 std::to_string(num_tasks * 1000000 /
+                                std::max<int64_t>(1, elapsed.count())));
+  for (size_t i = 0; i < num_tasks; ++i)
+    ASSERT_EQ(i * 3, results[i]);
+}
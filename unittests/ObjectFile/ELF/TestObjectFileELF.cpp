@@ -11,13 +11,19 @@
 #include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
 #include "Plugins/SymbolVendor/ELF/SymbolVendorELF.h"
 #include "TestingSupport/TestUtilities.h"
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Host/HostInfo.h"
+#include "lldb/Symbol/Symtab.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/StreamString.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/raw_ostream.h"
@@ -98,3 +104,162 @@ TEST_F(ObjectFileELFTest, SectionsResolveConsistently) {
   ASSERT_NE(nullptr, start);
   EXPECT_EQ(text_sp, start->GetAddress().GetSection());
 }
+
+TEST_F(ObjectFileELFTest, SymtabEncodeDecode) {
+  std::string yaml = GetInputFilePath("sections-resolve-consistently.yaml");
+  llvm::SmallString<128> obj;
+  ASSERT_NO_ERROR(llvm::sys::fs::createTemporaryFile(
+      "symtab-encode-decode-%%%%%%", "obj", obj));
+
+  llvm::FileRemover remover(obj);
+  const char *args[] = {YAML2OBJ, yaml.c_str(), nullptr};
+  llvm::StringRef obj_ref = obj;
+  const llvm::Optional<llvm::StringRef> redirects[] = {llvm::None, obj_ref,
+                                                       llvm::None};
+  ASSERT_EQ(0, llvm::sys::ExecuteAndWait(YAML2OBJ, args, nullptr, redirects));
+
+  ModuleSpec spec{FileSpec(obj, false)};
+  spec.GetSymbolFileSpec().SetFile(obj, false);
+  auto module_sp = std::make_shared<Module>(spec);
+  Symtab *symtab = module_sp->GetObjectFile()->GetSymtab();
+  ASSERT_NE(nullptr, symtab);
+
+  StreamString strm(Stream::eBinary, 8, eByteOrderLittle);
+  symtab->Encode(strm);
+  DataExtractor data(strm.GetData(), strm.GetSize(), eByteOrderLittle, 8);
+
+  Symtab decoded(module_sp->GetObjectFile());
+  lldb::offset_t offset = 0;
+  ASSERT_TRUE(decoded.Decode(data, &offset));
+  EXPECT_EQ(strm.GetSize(), offset);
+  ASSERT_EQ(symtab->GetNumSymbols(), decoded.GetNumSymbols());
+  for (size_t i = 0; i < symtab->GetNumSymbols(); ++i) {
+    const Symbol *expected = symtab->SymbolAtIndex(i);
+    const Symbol *actual = decoded.SymbolAtIndex(i);
+    EXPECT_EQ(expected->GetID(), actual->GetID());
+    EXPECT_EQ(expected->GetName(), actual->GetName());
+    EXPECT_EQ(expected->GetType(), actual->GetType());
+    EXPECT_EQ(expected->GetAddressRef(), actual->GetAddressRef());
+    EXPECT_EQ(expected->GetByteSize(), actual->GetByteSize());
+    EXPECT_EQ(expected->IsExternal(), actual->IsExternal());
+  }
+
+  // Lookups by name use the name indexes that were decoded.
+  for (const char *name : {"X", "Y", "_start"}) {
+    const Symbol *symbol = decoded.FindFirstSymbolWithNameAndType(
+        ConstString(name), eSymbolTypeAny, Symtab::eDebugAny,
+        Symtab::eVisibilityAny);
+    ASSERT_NE(nullptr, symbol) << name;
+    EXPECT_EQ(ConstString(name), symbol->GetName());
+  }
+
+  // Truncated data is rejected and leaves the symbol table empty.
+  DataExtractor truncated(data, 0, strm.GetSize() / 2);
+  offset = 0;
+  EXPECT_FALSE(decoded.Decode(truncated, &offset));
+  EXPECT_EQ(0u, decoded.GetNumSymbols());
+}
+
+TEST_F(ObjectFileELFTest, SymtabEncodeDecodeAbsoluteSymbols) {
+  std::string yaml = GetInputFilePath("sections-resolve-consistently.yaml");
+  llvm::SmallString<128> obj;
+  ASSERT_NO_ERROR(llvm::sys::fs::createTemporaryFile(
+      "symtab-absolute-%%%%%%", "obj", obj));
+
+  llvm::FileRemover remover(obj);
+  const char *args[] = {YAML2OBJ, yaml.c_str(), nullptr};
+  llvm::StringRef obj_ref = obj;
+  const llvm::Optional<llvm::StringRef> redirects[] = {llvm::None, obj_ref,
+                                                       llvm::None};
+  ASSERT_EQ(0, llvm::sys::ExecuteAndWait(YAML2OBJ, args, nullptr, redirects));
+
+  ModuleSpec spec{FileSpec(obj, false)};
+  auto module_sp = std::make_shared<Module>(spec);
+  ObjectFile *objfile = module_sp->GetObjectFile();
+  SectionList *section_list = module_sp->GetSectionList();
+  ASSERT_NE(nullptr, section_list);
+
+  // The sections made up for absolute symbols all have the same ID.
+  Symtab symtab(objfile);
+  for (addr_t addr : {0x1000, 0x2000}) {
+    std::string name = llvm::formatv("abs_{0:x}", addr).str();
+    auto section_sp = std::make_shared<Section>(
+        module_sp, objfile, llvm::ELF::SHN_ABS,
+        ConstString(".absolute." + name), eSectionTypeAbsoluteAddress, addr,
+        0x10, 0, 0, 0, 0);
+    section_list->AddSection(section_sp);
+    symtab.AddSymbol(Symbol(symtab.GetNumSymbols(), name.c_str(), false,
+                            eSymbolTypeAbsolute, true, false, false, false,
+                            section_sp, 0, 0x10, true, false, 0));
+  }
+
+  StreamString strm(Stream::eBinary, 8, eByteOrderLittle);
+  symtab.Encode(strm);
+  DataExtractor data(strm.GetData(), strm.GetSize(), eByteOrderLittle, 8);
+
+  Symtab decoded(objfile);
+  lldb::offset_t offset = 0;
+  ASSERT_TRUE(decoded.Decode(data, &offset));
+  ASSERT_EQ(2u, decoded.GetNumSymbols());
+  for (size_t i = 0; i < 2; ++i) {
+    const Symbol *expected = symtab.SymbolAtIndex(i);
+    const Symbol *actual = decoded.SymbolAtIndex(i);
+    EXPECT_EQ(expected->GetAddressRef(), actual->GetAddressRef());
+    EXPECT_EQ(expected->GetAddressRef().GetFileAddress(),
+              actual->GetAddressRef().GetFileAddress());
+  }
+}
+
+TEST_F(ObjectFileELFTest, SymtabCacheRestoresAddressClasses) {
+  std::string yaml = GetInputFilePath("arm-mapping-symbols.yaml");
+  llvm::SmallString<128> obj;
+  ASSERT_NO_ERROR(llvm::sys::fs::createTemporaryFile(
+      "symtab-cache-%%%%%%", "obj", obj));
+  llvm::FileRemover remover(obj);
+  const char *args[] = {YAML2OBJ, yaml.c_str(), nullptr};
+  llvm::StringRef obj_ref = obj;
+  const llvm::Optional<llvm::StringRef> redirects[] = {llvm::None, obj_ref,
+                                                       llvm::None};
+  ASSERT_EQ(0, llvm::sys::ExecuteAndWait(YAML2OBJ, args, nullptr, redirects));
+
+  llvm::SmallString<128> cache_dir;
+  ASSERT_NO_ERROR(
+      llvm::sys::fs::createUniqueDirectory("symtab-cache", cache_dir));
+  ModuleListProperties &properties =
+      ModuleList::GetGlobalModuleListProperties();
+  properties.SetIndexCachePath(cache_dir);
+  properties.SetEnableIndexCache(true);
+
+  ModuleSpec spec{FileSpec(obj, false)};
+  auto parsed_module_sp = std::make_shared<Module>(spec);
+  ObjectFile *parsed = parsed_module_sp->GetObjectFile();
+  ASSERT_NE(nullptr, parsed->GetSymtab());
+  EXPECT_EQ(eAddressClassCode, parsed->GetAddressClass(0x1004));
+  EXPECT_EQ(eAddressClassCodeAlternateISA, parsed->GetAddressClass(0x100a));
+  EXPECT_EQ(eAddressClassData, parsed->GetAddressClass(0x100c));
+
+  FileSpec cache_file(cache_dir, false);
+  cache_file.AppendPathComponent(
+      DataFileCache::GetModuleCacheKey(*parsed_module_sp, "symtab"));
+  llvm::sys::fs::UniqueID saved_id;
+  ASSERT_NO_ERROR(llvm::sys::fs::getUniqueID(cache_file.GetPath(), saved_id));
+
+  // A module for the same file loads the symbol table from the cache, along
+  // with the address classes that parsing the symbols computed.
+  auto loaded_module_sp = std::make_shared<Module>(spec);
+  ObjectFile *loaded = loaded_module_sp->GetObjectFile();
+  ASSERT_NE(nullptr, loaded->GetSymtab());
+  EXPECT_EQ(parsed->GetSymtab()->GetNumSymbols(),
+            loaded->GetSymtab()->GetNumSymbols());
+  EXPECT_EQ(eAddressClassCode, loaded->GetAddressClass(0x1004));
+  EXPECT_EQ(eAddressClassCodeAlternateISA, loaded->GetAddressClass(0x100a));
+  EXPECT_EQ(eAddressClassData, loaded->GetAddressClass(0x100c));
+
+  // The cache file was used as it was, not discarded and written again.
+  llvm::sys::fs::UniqueID loaded_id;
+  ASSERT_NO_ERROR(llvm::sys::fs::getUniqueID(cache_file.GetPath(), loaded_id));
+  EXPECT_EQ(saved_id, loaded_id);
+
+  properties.SetEnableIndexCache(false);
+  llvm::sys::fs::remove_directories(cache_dir);
+}
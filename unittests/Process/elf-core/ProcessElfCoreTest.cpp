@@ -0,0 +1,144 @@
+//===-- ProcessElfCoreTest.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "Plugins/Process/elf-core/ProcessElfCore.h"
+#include "TestingSupport/TestUtilities.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Target/Memory.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/TargetList.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Listener.h"
+#include "gtest/gtest.h"
+
+using namespace lldb_private;
+using namespace lldb;
+
+namespace {
+// Load segments of linux-x86_64.core, see "readelf -l".
+// The executable, whose file is mapped in full.
+const addr_t k_exe_addr = 0x400000;
+// The stack, followed by unmapped memory.
+const addr_t k_stack_addr = 0x7ffe0c026000;
+const addr_t k_stack_end = 0x7ffe0c029000;
+// Two segments that directly follow each other in memory and in the file.
+const addr_t k_vdso_boundary = 0x7ffe0c16d000;
+
+class ProcessElfCoreTest : public testing::Test {
+public:
+  void SetUp() override {
+    HostInfo::Initialize();
+    Debugger::Initialize(nullptr);
+    ObjectFileELF::Initialize();
+    ProcessElfCore::Initialize();
+    ArchSpec arch("x86_64-pc-linux");
+    Platform::SetHostPlatform(
+        platform_linux::PlatformLinux::CreateInstance(true, &arch));
+    m_debugger_sp = Debugger::CreateInstance();
+    PlatformSP platform_sp;
+    ASSERT_TRUE(m_debugger_sp->GetTargetList()
+                    .CreateTarget(*m_debugger_sp, "", arch, false,
+                                  platform_sp, m_target_sp)
+                    .Success());
+    FileSpec core_spec(GetInputFilePath("linux-x86_64.core"), false);
+    m_process_sp = m_target_sp->CreateProcess(
+        Listener::MakeListener("elf-core-test"), "elf-core", &core_spec);
+    ASSERT_TRUE(m_process_sp);
+    ASSERT_TRUE(m_process_sp->DoLoadCore().Success());
+  }
+
+  void TearDown() override {
+    m_process_sp.reset();
+    m_target_sp.reset();
+    Debugger::Destroy(m_debugger_sp);
+    ProcessElfCore::Terminate();
+    ObjectFileELF::Terminate();
+    Debugger::Terminate();
+    HostInfo::Terminate();
+  }
+
+protected:
+  DebuggerSP m_debugger_sp;
+  TargetSP m_target_sp;
+  ProcessSP m_process_sp;
+};
+} // namespace
+
+TEST_F(ProcessElfCoreTest, PeekMemorySharesCoreFile) {
+  DataExtractor first, second;
+  ASSERT_EQ(16u, m_process_sp->PeekMemory(k_stack_addr + 0x100, 16, first));
+  ASSERT_EQ(16u, m_process_sp->PeekMemory(k_stack_addr + 0x100, 16, second));
+  // Both refer to the bytes in the core file rather than to copies.
+  EXPECT_EQ(first.GetDataStart(), second.GetDataStart());
+
+  uint8_t bytes[16];
+  Status error;
+  ASSERT_EQ(16u, m_process_sp->ReadMemory(k_stack_addr + 0x100, bytes,
+                                          sizeof(bytes), error));
+  EXPECT_EQ(0, memcmp(bytes, first.GetDataStart(), sizeof(bytes)));
+
+  // Adjacent segments are one range, so reads across them are shared too.
+  DataExtractor data;
+  EXPECT_EQ(16u, m_process_sp->PeekMemory(k_vdso_boundary - 8, 16, data));
+
+  // Only the part that is in the segment is handed out.
+  EXPECT_EQ(8u, m_process_sp->PeekMemory(k_stack_end - 8, 16, data));
+  EXPECT_EQ(0u, m_process_sp->PeekMemory(k_stack_end, 16, data));
+}
+
+TEST_F(ProcessElfCoreTest, MemoryCacheCopiesMappedMemory) {
+  MemoryCache cache(*m_process_sp);
+  std::vector<uint8_t> expected(64), bytes(64);
+  Status error;
+
+  // A read inside a segment is copied straight out of the core file.
+  ASSERT_EQ(64u, m_process_sp->ReadMemory(k_exe_addr, expected.data(),
+                                          expected.size(), error));
+  EXPECT_EQ(64u, cache.Read(k_exe_addr, bytes.data(), bytes.size(), error));
+  EXPECT_EQ(expected, bytes);
+  EXPECT_EQ(0u, cache.GetStatistics().num_misses);
+  EXPECT_EQ(0u, cache.GetStatistics().num_process_reads);
+
+  // A read that runs past the end of a segment can't be shared, and is
+  // read from the process instead.
+  const addr_t addr = k_stack_end - 16;
+  ASSERT_EQ(16u, m_process_sp->ReadMemory(addr, expected.data(), 16, error));
+  error.Clear();
+  EXPECT_EQ(16u, cache.Read(addr, bytes.data(), 32, error));
+  EXPECT_TRUE(std::equal(expected.begin(), expected.begin() + 16,
+                         bytes.begin()));
+  EXPECT_EQ(1u, cache.GetStatistics().num_misses);
+}
+
+TEST_F(ProcessElfCoreTest, InMemoryObjectFileSharesSectionData) {
+  ModuleSP module_sp = m_process_sp->ReadModuleFromMemory(
+      FileSpec("linux-x86_64.out", false), k_exe_addr, 0x1000);
+  ASSERT_TRUE(module_sp);
+  ObjectFile *objfile = module_sp->GetObjectFile();
+  ASSERT_NE(nullptr, objfile);
+  ASSERT_TRUE(objfile->IsInMemory());
+  SectionSP text_sp =
+      objfile->GetSectionList()->FindSectionByName(ConstString(".text"));
+  ASSERT_TRUE(text_sp);
+  ASSERT_TRUE(
+      m_target_sp->SetSectionLoadAddress(text_sp, text_sp->GetFileAddress()));
+
+  DataExtractor section_data, core_data;
+  const size_t size = text_sp->GetByteSize();
+  ASSERT_EQ(size, objfile->ReadSectionData(text_sp.get(), section_data));
+  ASSERT_EQ(size, m_process_sp->PeekMemory(text_sp->GetFileAddress(), size,
+                                           core_data));
+  EXPECT_EQ(core_data.GetDataStart(), section_data.GetDataStart());
+}
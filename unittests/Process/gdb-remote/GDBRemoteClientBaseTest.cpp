@@ -7,6 +7,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include <future>
+#include <thread>
 
 #include "GDBRemoteTestUtils.h"
 
@@ -339,3 +340,77 @@ TEST_F(GDBRemoteClientBaseTest, InterruptNoResponse) {
   ASSERT_TRUE(async_result.get());
   ASSERT_EQ(eStateInvalid, continue_state.get());
 }
+
+TEST_F(GDBRemoteClientBaseTest, SendPacketsAndWaitForResponses) {
+  std::vector<std::string> payloads = {"qA", "qB", "qC"};
+  std::vector<StringExtractorGDBRemote> responses;
+  std::future<PacketResult> async_result = std::async(std::launch::async, [&] {
+    return client.SendPacketsAndWaitForResponses(payloads, responses, false);
+  });
+
+  // All packets arrive before we send the first response.
+  StringExtractorGDBRemote request;
+  for (const std::string &payload : payloads) {
+    ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+    ASSERT_EQ(payload, request.GetStringRef());
+  }
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("A"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("B"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("C"));
+
+  ASSERT_EQ(PacketResult::Success, async_result.get());
+  ASSERT_EQ(3u, responses.size());
+  EXPECT_EQ("A", responses[0].GetStringRef());
+  EXPECT_EQ("B", responses[1].GetStringRef());
+  EXPECT_EQ("C", responses[2].GetStringRef());
+}
+
+TEST_F(GDBRemoteClientBaseTest, SendPacketsAndWaitForResponsesLateReplies) {
+  client.SetPacketTimeout(std::chrono::seconds(1));
+  std::vector<std::string> payloads = {"qA", "qB", "qC"};
+  std::vector<StringExtractorGDBRemote> responses;
+  std::future<PacketResult> async_result = std::async(std::launch::async, [&] {
+    return client.SendPacketsAndWaitForResponses(payloads, responses, false);
+  });
+
+  StringExtractorGDBRemote request;
+  for (size_t i = 0; i < payloads.size(); ++i)
+    ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("A"));
+  // The reply to qB times out, but it and the reply to qC still arrive
+  // while the client waits for the replies in flight.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("B"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("C"));
+  ASSERT_EQ(PacketResult::ErrorReplyTimeout, async_result.get());
+  EXPECT_EQ("A", responses[0].GetStringRef());
+
+  // The late replies aren't mistaken for the reply to the next packet.
+  StringExtractorGDBRemote response;
+  std::future<PacketResult> next_result = std::async(std::launch::async, [&] {
+    return client.SendPacketAndWaitForResponse("qD", response, false);
+  });
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("qD", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("D"));
+  ASSERT_EQ(PacketResult::Success, next_result.get());
+  EXPECT_EQ("D", response.GetStringRef());
+}
+
+TEST_F(GDBRemoteClientBaseTest, SendPacketsAndWaitForResponsesNoReplies) {
+  client.SetPacketTimeout(std::chrono::seconds(1));
+  std::vector<std::string> payloads = {"qA", "qB", "qC"};
+  std::vector<StringExtractorGDBRemote> responses;
+  std::future<PacketResult> async_result = std::async(std::launch::async, [&] {
+    return client.SendPacketsAndWaitForResponses(payloads, responses, false);
+  });
+
+  StringExtractorGDBRemote request;
+  for (size_t i = 0; i < payloads.size(); ++i)
+    ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("A"));
+  ASSERT_EQ(PacketResult::ErrorReplyTimeout, async_result.get());
+
+  // We can't tell which reply belongs to which packet anymore.
+  EXPECT_FALSE(client.IsConnected());
+}
@@ -135,6 +135,30 @@ TEST_F(GDBRemoteCommunicationClientTest, ReadRegister) {
             memcmp(buffer_sp->GetBytes(), all_registers, sizeof all_registers));
 }
 
+TEST_F(GDBRemoteCommunicationClientTest, ReadRegistersPipelined) {
+  std::vector<std::pair<lldb::tid_t, uint32_t>> regs = {{0x47, 4},
+                                                        {0x48, 4}};
+  std::future<std::vector<DataBufferSP>> read_result = std::async(
+      std::launch::async, [&] { return client.ReadRegisters(regs); });
+  Handle_QThreadSuffixSupported(server, true);
+
+  // Both packets are sent before the first response arrives.
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("p4;thread:0047;", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("p4;thread:0048;", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket(one_register_hex));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("E01"));
+
+  std::vector<DataBufferSP> buffers = read_result.get();
+  ASSERT_EQ(2u, buffers.size());
+  ASSERT_TRUE(bool(buffers[0]));
+  ASSERT_EQ(0,
+            memcmp(buffers[0]->GetBytes(), one_register, sizeof one_register));
+  ASSERT_FALSE(bool(buffers[1]));
+}
+
 TEST_F(GDBRemoteCommunicationClientTest, SaveRestoreRegistersNoSuffix) {
   const lldb::tid_t tid = 0x47;
   uint32_t save_id;
@@ -342,6 +366,150 @@ TEST_F(GDBRemoteCommunicationClientTest, GetMemoryRegionInfoInvalidResponse) {
   EXPECT_FALSE(result.get().Success());
 }
 
+TEST_F(GDBRemoteCommunicationClientTest, MultiMemRead) {
+  std::vector<Range<addr_t, size_t>> ranges = {{0x1000, 4}, {0x2000, 4}};
+  uint8_t buffer[8] = {0};
+  Status error;
+  std::future<std::vector<size_t>> result = std::async(
+      std::launch::async, [&] { return client.MultiMemRead(ranges, buffer, error); });
+
+  // The second range is only partially readable.
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,4;", "4,2;ABCDEF");
+  EXPECT_EQ(std::vector<size_t>({4, 2}), result.get());
+  EXPECT_TRUE(error.Success());
+  EXPECT_EQ("ABCD", llvm::StringRef((const char *)buffer, 4));
+  EXPECT_EQ("EF", llvm::StringRef((const char *)buffer + 4, 2));
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, MultiMemReadInvalidResponse) {
+  std::vector<Range<addr_t, size_t>> ranges = {{0x1000, 4}, {0x2000, 4}};
+  uint8_t buffer[8] = {0};
+  Status error;
+  std::future<std::vector<size_t>> result = std::async(
+      std::launch::async, [&] { return client.MultiMemRead(ranges, buffer, error); });
+
+  // More data than the sizes say.
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,4;", "4,2;ABCDEFGH");
+  EXPECT_EQ(std::vector<size_t>({0, 0}), result.get());
+  EXPECT_TRUE(error.Fail());
+
+  error.Clear();
+  result = std::async(std::launch::async,
+                      [&] { return client.MultiMemRead(ranges, buffer, error); });
+
+  // A size that is bigger than the range.
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,4;", "5,2;ABCDEFG");
+  EXPECT_EQ(std::vector<size_t>({0, 0}), result.get());
+  EXPECT_TRUE(error.Fail());
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadExtFeature) {
+  std::string out;
+  Status error;
+  std::future<bool> result = std::async(std::launch::async, [&] {
+    return client.ReadExtFeature(ConstString("features"),
+                                 ConstString("target.xml"), out, error);
+  });
+
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_TRUE(request.GetStringRef().find("qSupported") == 0);
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("PacketSize=5"));
+
+  // The first chunk is requested on its own, after that the client asks for
+  // twice as many chunks per round trip.
+  HandlePacket(server, "qXfer:features:read:target.xml:0,4", "mabcd");
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("qXfer:features:read:target.xml:4,4", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("qXfer:features:read:target.xml:8,4", request.GetStringRef());
+  // A short chunk invalidates the chunks that were requested after it.
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("mef"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("mijkl"));
+  for (const char *offset : {"6", "a", "e", "12"}) {
+    ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+    ASSERT_EQ(std::string("qXfer:features:read:target.xml:") + offset + ",4",
+              request.GetStringRef());
+  }
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("mghij"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("lk"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("l"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("l"));
+
+  ASSERT_TRUE(result.get());
+  ASSERT_TRUE(error.Success());
+  ASSERT_EQ("abcdefghijk", out);
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, CompressionOffByDefault) {
+  std::future<bool> supported = std::async(
+      std::launch::async, [&] { return client.GetQPassSignalsSupported(); });
+
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_TRUE(request.GetStringRef().find("qSupported") == 0);
+  ASSERT_EQ(PacketResult::Success,
+            server.SendPacket("PacketSize=1000;SupportedCompressions=lz4"));
+  ASSERT_FALSE(supported.get());
+
+  // The next packet is ours, not a QEnableCompression.
+  std::future<std::string> result = std::async(std::launch::async, [&] {
+    StringExtractorGDBRemote response;
+    client.SendPacketAndWaitForResponse("qC", response, false);
+    return response.GetStringRef();
+  });
+  HandlePacket(server, "qC", "QC47");
+  ASSERT_EQ("QC47", result.get());
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, EnableCompression) {
+  client.SetPacketCompressionEnabled(true);
+  std::future<bool> supported = std::async(
+      std::launch::async, [&] { return client.GetQPassSignalsSupported(); });
+
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_TRUE(request.GetStringRef().find("qSupported") == 0);
+  ASSERT_EQ(PacketResult::Success,
+            server.SendPacket("PacketSize=1000;SupportedCompressions=lz4"));
+  HandlePacket(server, "QEnableCompression:type:lz4;", "OK");
+  ASSERT_FALSE(supported.get());
+  server.SetSendCompression(CompressionType::LZ4, 64);
+
+  // Replies from now on are either compressed or prefixed with 'N'.
+  const std::string memory(512, 'a');
+  std::future<std::string> result = std::async(std::launch::async, [&] {
+    StringExtractorGDBRemote response;
+    client.SendPacketAndWaitForResponse("x1000,200", response, false);
+    return response.GetStringRef();
+  });
+  HandlePacket(server, "x1000,200", memory);
+  ASSERT_EQ(memory, result.get());
+
+  result = std::async(std::launch::async, [&] {
+    StringExtractorGDBRemote response;
+    client.SendPacketAndWaitForResponse("qC", response, false);
+    return response.GetStringRef();
+  });
+  HandlePacket(server, "qC", "QC47");
+  ASSERT_EQ("QC47", result.get());
+
+  uint64_t num_packets, compressed_bytes, decompressed_bytes;
+  client.GetCompressionStatistics(num_packets, compressed_bytes,
+                                  decompressed_bytes);
+  EXPECT_EQ(1u, num_packets);
+  EXPECT_EQ(memory.size(), decompressed_bytes);
+  EXPECT_LT(compressed_bytes, memory.size());
+
+  GDBRemoteClientBase::PacketStatisticsMap stats =
+      client.GetPacketStatistics();
+  ASSERT_EQ(1u, stats.count("x"));
+  EXPECT_EQ(1u, stats["x"].num_packets);
+  EXPECT_EQ(memory.size(), stats["x"].bytes_received);
+  EXPECT_EQ(1u, stats.count("qC"));
+  EXPECT_EQ(1u, stats.count("QEnableCompression"));
+}
+
 TEST_F(GDBRemoteCommunicationClientTest, SendStartTracePacket) {
   TraceOptions options;
   Status error;
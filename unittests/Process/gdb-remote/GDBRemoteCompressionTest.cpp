@@ -0,0 +1,115 @@
+//===-- GDBRemoteCompressionTest.cpp ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "Plugins/Process/gdb-remote/GDBRemoteCompression.h"
+
+#include <string.h>
+
+#include <random>
+
+using namespace lldb_private::process_gdb_remote;
+
+namespace {
+
+std::vector<uint8_t> RoundTrip(CompressionType type,
+                               const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> compressed;
+  EXPECT_TRUE(CompressBuffer(type, data, compressed));
+  std::vector<uint8_t> decompressed(data.size());
+  EXPECT_EQ(data.size(), DecompressBuffer(type, compressed, decompressed));
+  return decompressed;
+}
+
+std::vector<uint8_t> MakeTestData(size_t size, unsigned seed) {
+  // A mix of repeated text, zeros and random bytes, like a memory read.
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> data;
+  const char *text = "$pc = 0x0000000100000f50 (main + 16)\n";
+  while (data.size() < size) {
+    switch (rng() % 3) {
+    case 0:
+      data.insert(data.end(), text, text + strlen(text));
+      break;
+    case 1:
+      data.resize(data.size() + rng() % 300);
+      break;
+    case 2:
+      for (unsigned i = rng() % 64; i > 0; --i)
+        data.push_back(rng());
+      break;
+    }
+  }
+  data.resize(size);
+  return data;
+}
+
+} // namespace
+
+TEST(GDBRemoteCompressionTest, Names) {
+  for (CompressionType type :
+       {CompressionType::ZlibDeflate, CompressionType::LZFSE,
+        CompressionType::LZ4, CompressionType::LZMA})
+    EXPECT_EQ(type, GetCompressionTypeFromName(GetCompressionName(type)));
+  EXPECT_EQ(CompressionType::None, GetCompressionTypeFromName("zstd"));
+  EXPECT_TRUE(CompressionTypeIsSupported(CompressionType::LZ4));
+  EXPECT_FALSE(CompressionTypeIsSupported(CompressionType::None));
+}
+
+TEST(GDBRemoteCompressionTest, RoundTrip) {
+  for (CompressionType type :
+       {CompressionType::ZlibDeflate, CompressionType::LZFSE,
+        CompressionType::LZ4, CompressionType::LZMA}) {
+    if (!CompressionTypeIsSupported(type))
+      continue;
+    SCOPED_TRACE(GetCompressionName(type).str());
+    for (size_t size : {1, 5, 12, 13, 100, 4096, 70000}) {
+      std::vector<uint8_t> data = MakeTestData(size, size);
+      EXPECT_EQ(data, RoundTrip(type, data));
+    }
+  }
+}
+
+TEST(GDBRemoteCompressionTest, LZ4) {
+  // Long runs need the extra length bytes for both literals and matches.
+  std::vector<uint8_t> zeros(100000);
+  std::vector<uint8_t> compressed;
+  ASSERT_TRUE(CompressBuffer(CompressionType::LZ4, zeros, compressed));
+  EXPECT_LT(compressed.size(), 1000u);
+  EXPECT_EQ(zeros, RoundTrip(CompressionType::LZ4, zeros));
+
+  std::mt19937 rng(0);
+  std::vector<uint8_t> random(1000);
+  for (uint8_t &byte : random)
+    byte = rng();
+  EXPECT_EQ(random, RoundTrip(CompressionType::LZ4, random));
+
+  // A block with a literal "abcd" and an overlapping 8 byte match.
+  const uint8_t block[] = {0x44, 'a', 'b', 'c', 'd', 4, 0, 0x10, 'e'};
+  uint8_t out[13];
+  ASSERT_EQ(13u, DecompressBuffer(CompressionType::LZ4, block, out));
+  EXPECT_EQ("abcdabcdabcde", std::string(out, out + 13));
+}
+
+TEST(GDBRemoteCompressionTest, LZ4InvalidInput) {
+  uint8_t out[64];
+  // The match offset points before the start of the output.
+  const uint8_t bad_offset[] = {0x10, 'a', 2, 0};
+  EXPECT_EQ(0u, DecompressBuffer(CompressionType::LZ4, bad_offset, out));
+  // The literal length is longer than the input.
+  const uint8_t short_literals[] = {0x50, 'a', 'b'};
+  EXPECT_EQ(0u, DecompressBuffer(CompressionType::LZ4, short_literals, out));
+  // The output doesn't fit.
+  std::vector<uint8_t> data = MakeTestData(1000, 1);
+  std::vector<uint8_t> compressed;
+  ASSERT_TRUE(CompressBuffer(CompressionType::LZ4, data, compressed));
+  std::vector<uint8_t> small(data.size() - 1);
+  EXPECT_EQ(0u, DecompressBuffer(CompressionType::LZ4, compressed, small));
+}
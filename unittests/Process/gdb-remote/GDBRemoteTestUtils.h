@@ -42,6 +42,11 @@ struct MockServer : public GDBRemoteCommunicationServer {
                                sync_on_timeout);
   }
 
+  void SetSendCompression(CompressionType type, size_t min_size) {
+    m_send_compression_type = type;
+    m_send_compression_min_size = min_size;
+  }
+
   using GDBRemoteCommunicationServer::SendOKResponse;
   using GDBRemoteCommunicationServer::SendUnimplementedResponse;
 };
@@ -18,6 +18,7 @@
 #include "TestingSupport/TestUtilities.h"
 #include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/DataBufferHeap.h"
 #include "lldb/Utility/DataBufferLLVM.h"
 #include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/FileSpec.h"
@@ -50,6 +51,15 @@ public:
     ASSERT_GT(parser->GetData().size(), 0UL);
   }
 
+  void SetUpBuffer(const std::vector<uint8_t> &buffer) {
+    lldb::DataBufferSP data_sp(
+        new DataBufferHeap(buffer.data(), buffer.size()));
+    llvm::Optional<MinidumpParser> optional_parser =
+        MinidumpParser::Create(data_sp);
+    ASSERT_TRUE(optional_parser.hasValue());
+    parser.reset(new MinidumpParser(optional_parser.getValue()));
+  }
+
   std::unique_ptr<MinidumpParser> parser;
 };
 
@@ -233,6 +243,170 @@ TEST_F(MinidumpParserTest, GetMemoryRegionInfo) {
   check_region_info(parser, 0x40000, yes, no, no);
 }
 
+template <typename T>
+static void AppendObject(std::vector<uint8_t> &buffer, const T &object) {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&object);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+// Build a full memory minidump with a Memory64List and a MemoryInfoList of
+// num_regions regions of 16 bytes, one every other page, listed in reverse
+// order. Each region is filled with the low byte of its index.
+static std::vector<uint8_t> MakeMinidumpWithManyRegions(uint64_t num_regions) {
+  const uint64_t region_size = 16;
+  const uint32_t streams_count = 2;
+  const uint32_t memory64_rva =
+      sizeof(MinidumpHeader) + streams_count * sizeof(MinidumpDirectory);
+  const uint32_t memory64_size =
+      16 + num_regions * sizeof(MinidumpMemoryDescriptor64);
+  const uint32_t memory_info_rva = memory64_rva + memory64_size;
+  const uint32_t memory_info_size = sizeof(MinidumpMemoryInfoListHeader) +
+                                    num_regions * sizeof(MinidumpMemoryInfo);
+  const uint64_t base_rva = memory_info_rva + memory_info_size;
+
+  std::vector<uint8_t> buffer;
+  MinidumpHeader header = {};
+  header.signature = static_cast<uint32_t>(MinidumpHeaderConstants::Signature);
+  header.version = static_cast<uint32_t>(MinidumpHeaderConstants::Version);
+  header.streams_count = streams_count;
+  header.stream_directory_rva = sizeof(MinidumpHeader);
+  AppendObject(buffer, header);
+
+  MinidumpDirectory directory;
+  directory.stream_type =
+      static_cast<uint32_t>(MinidumpStreamType::Memory64List);
+  directory.location.data_size = memory64_size;
+  directory.location.rva = memory64_rva;
+  AppendObject(buffer, directory);
+  directory.stream_type =
+      static_cast<uint32_t>(MinidumpStreamType::MemoryInfoList);
+  directory.location.data_size = memory_info_size;
+  directory.location.rva = memory_info_rva;
+  AppendObject(buffer, directory);
+
+  auto region_addr = [=](uint64_t i) {
+    return 0x10000 + (num_regions - 1 - i) * 0x2000;
+  };
+
+  AppendObject(buffer, llvm::support::ulittle64_t(num_regions));
+  AppendObject(buffer, llvm::support::ulittle64_t(base_rva));
+  for (uint64_t i = 0; i < num_regions; ++i) {
+    MinidumpMemoryDescriptor64 memory_desc;
+    memory_desc.start_of_memory_range = region_addr(i);
+    memory_desc.data_size = region_size;
+    AppendObject(buffer, memory_desc);
+  }
+
+  MinidumpMemoryInfoListHeader info_header;
+  info_header.size_of_header = sizeof(MinidumpMemoryInfoListHeader);
+  info_header.size_of_entry = sizeof(MinidumpMemoryInfo);
+  info_header.num_of_entries = num_regions;
+  AppendObject(buffer, info_header);
+  for (uint64_t i = 0; i < num_regions; ++i) {
+    MinidumpMemoryInfo info = {};
+    info.base_address = region_addr(i);
+    info.allocation_base = region_addr(i);
+    info.region_size = 0x1000;
+    info.state = static_cast<uint32_t>(MinidumpMemoryInfoState::MemCommit);
+    info.protect =
+        static_cast<uint32_t>(MinidumpMemoryProtectionContants::PageReadWrite);
+    AppendObject(buffer, info);
+  }
+
+  for (uint64_t i = 0; i < num_regions; ++i)
+    buffer.insert(buffer.end(), region_size, uint8_t(i));
+  return buffer;
+}
+
+TEST_F(MinidumpParserTest, FindMemoryRangeWithManyRegions) {
+  const uint64_t num_regions = 10000;
+  SetUpBuffer(MakeMinidumpWithManyRegions(num_regions));
+
+  const auto yes = MemoryRegionInfo::eYes;
+  const auto no = MemoryRegionInfo::eNo;
+
+  EXPECT_FALSE(parser->FindMemoryRange(0x00).hasValue());
+  check_region_info(parser, 0x00, no, no, no);
+  for (uint64_t i = 0; i < num_regions; ++i) {
+    const uint64_t addr = 0x10000 + (num_regions - 1 - i) * 0x2000;
+    check_mem_range_exists(parser, addr, 16);
+    EXPECT_FALSE(parser->FindMemoryRange(addr + 16).hasValue());
+
+    llvm::ArrayRef<uint8_t> memory = parser->GetMemory(addr + 8, 16);
+    ASSERT_EQ(8UL, memory.size());
+    EXPECT_EQ(uint8_t(i), memory[0]);
+
+    check_region_info(parser, addr + 0xfff, yes, yes, no);
+    check_region_info(parser, addr + 0x1000, no, no, no);
+    auto region_info = parser->GetMemoryRegionInfo(addr + 0x1000);
+    ASSERT_TRUE(region_info.hasValue());
+    EXPECT_EQ(i == 0 ? LLDB_INVALID_ADDRESS : addr + 0x2000,
+              region_info->GetRange().GetRangeEnd());
+  }
+}
+
+// Makes a minidump with a Memory64List of the given ranges. The bytes of
+// each range are its index in the list.
+static std::vector<uint8_t> MakeMinidumpWithMemory64List(
+    const std::vector<std::pair<uint64_t, uint64_t>> &ranges) {
+  const uint32_t streams_count = 1;
+  const uint32_t memory64_rva =
+      sizeof(MinidumpHeader) + streams_count * sizeof(MinidumpDirectory);
+  const uint32_t memory64_size =
+      16 + ranges.size() * sizeof(MinidumpMemoryDescriptor64);
+  const uint64_t base_rva = memory64_rva + memory64_size;
+
+  std::vector<uint8_t> buffer;
+  MinidumpHeader header = {};
+  header.signature = static_cast<uint32_t>(MinidumpHeaderConstants::Signature);
+  header.version = static_cast<uint32_t>(MinidumpHeaderConstants::Version);
+  header.streams_count = streams_count;
+  header.stream_directory_rva = sizeof(MinidumpHeader);
+  AppendObject(buffer, header);
+
+  MinidumpDirectory directory;
+  directory.stream_type =
+      static_cast<uint32_t>(MinidumpStreamType::Memory64List);
+  directory.location.data_size = memory64_size;
+  directory.location.rva = memory64_rva;
+  AppendObject(buffer, directory);
+
+  AppendObject(buffer, llvm::support::ulittle64_t(ranges.size()));
+  AppendObject(buffer, llvm::support::ulittle64_t(base_rva));
+  for (const auto &range : ranges) {
+    MinidumpMemoryDescriptor64 memory_desc;
+    memory_desc.start_of_memory_range = range.first;
+    memory_desc.data_size = range.second;
+    AppendObject(buffer, memory_desc);
+  }
+
+  for (size_t i = 0; i < ranges.size(); ++i)
+    buffer.insert(buffer.end(), ranges[i].second, uint8_t(i));
+  return buffer;
+}
+
+TEST_F(MinidumpParserTest, FindMemoryRangeWithOverlappingRanges) {
+  SetUpBuffer(MakeMinidumpWithMemory64List(
+      {{0x1000, 0x100}, {0x1010, 0x10}, {0x1080, 0x100}}));
+
+  // The second range lies within the first one, which still covers the
+  // addresses after it.
+  check_mem_range_exists(parser, 0x1000, 0x100);
+  llvm::ArrayRef<uint8_t> memory = parser->GetMemory(0x1050, 0x10);
+  ASSERT_EQ(0x10UL, memory.size());
+  EXPECT_EQ(0, memory[0]);
+
+  // The overlapping part of the third range was cut off.
+  check_mem_range_exists(parser, 0x1100, 0x80);
+  memory = parser->GetMemory(0x10f8, 0x10);
+  ASSERT_EQ(8UL, memory.size());
+  EXPECT_EQ(0, memory[0]);
+  memory = parser->GetMemory(0x1100, 0x10);
+  ASSERT_EQ(0x10UL, memory.size());
+  EXPECT_EQ(2, memory[0]);
+  EXPECT_FALSE(parser->FindMemoryRange(0x1180).hasValue());
+}
+
 // Windows Minidump tests
 // fizzbuzz_no_heap.dmp is copied from the WinMiniDump tests
 TEST_F(MinidumpParserTest, GetArchitectureWindows) {
@@ -18,11 +18,15 @@
 #include "lldb/Utility/StreamString.h"
 #include "TestingSupport/TestUtilities.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
+#include <chrono>
+
 using namespace lldb_private;
 using namespace lldb;
 
@@ -39,7 +43,8 @@ public:
   }
 
 protected:
-  void TestBasic(DWARFCallFrameInfo::Type type, llvm::StringRef symbol);
+  void TestBasic(DWARFCallFrameInfo::Type type, llvm::StringRef symbol,
+                 llvm::StringRef input = "basic-call-frame-info.yaml");
 };
 
 #define ASSERT_NO_ERROR(x)                                                     \
@@ -88,8 +93,9 @@ static UnwindPlan::Row GetExpectedRow2() {
 }
 
 void DWARFCallFrameInfoTest::TestBasic(DWARFCallFrameInfo::Type type,
-                                       llvm::StringRef symbol) {
-  std::string yaml = GetInputFilePath("basic-call-frame-info.yaml");
+                                       llvm::StringRef symbol,
+                                       llvm::StringRef input) {
+  std::string yaml = GetInputFilePath(input);
   llvm::SmallString<128> obj;
 
   ASSERT_NO_ERROR(llvm::sys::fs::createTemporaryFile(
@@ -141,3 +147,181 @@ TEST_F(DWARFCallFrameInfoTest, Basic_dwarf4) {
 TEST_F(DWARFCallFrameInfoTest, Basic_eh) {
   TestBasic(DWARFCallFrameInfo::EH, "eh_frame");
 }
+
+TEST_F(DWARFCallFrameInfoTest, Basic_eh_frame_hdr) {
+  TestBasic(DWARFCallFrameInfo::EH, "eh_frame", "eh-frame-hdr.yaml");
+}
+
+// Append value to str as little endian hex bytes, as yaml2obj expects.
+static void AppendHex32(std::string &str, uint32_t value) {
+  llvm::raw_string_ostream os(str);
+  for (int i = 0; i < 4; ++i)
+    os << llvm::format_hex_no_prefix((value >> (i * 8)) & 0xff, 2, true);
+}
+
+// Write an ELF file with num_functions functions of 16 bytes each and an
+// .eh_frame FDE for every one of them, and optionally the .eh_frame_hdr
+// search table.
+static void WriteManyFunctionsYAML(llvm::raw_ostream &os,
+                                   uint32_t num_functions, bool with_hdr) {
+  const uint32_t func_size = 0x10;
+  const uint32_t cie_size = 0x18;
+  const uint32_t fde_size = 0x20;
+  const uint32_t text_addr = 0x1000;
+  const uint32_t eh_frame_addr =
+      llvm::alignTo(text_addr + num_functions * func_size, 8);
+  const uint32_t hdr_addr =
+      llvm::alignTo(eh_frame_addr + cie_size + num_functions * fde_size, 4);
+
+  std::string text(num_functions * func_size * 2, '0');
+  std::string eh_frame = "1400000000000000017A5200017810011B0C070890010000";
+  std::string hdr = "011B033B";
+  AppendHex32(hdr, eh_frame_addr - (hdr_addr + 4));
+  AppendHex32(hdr, num_functions);
+  for (uint32_t i = 0; i < num_functions; ++i) {
+    const uint32_t func_addr = text_addr + i * func_size;
+    const uint32_t fde_offset = cie_size + i * fde_size;
+    eh_frame += "1C000000";
+    AppendHex32(eh_frame, fde_offset + 4);
+    AppendHex32(eh_frame, func_addr - (eh_frame_addr + fde_offset + 8));
+    AppendHex32(eh_frame, func_size);
+    eh_frame += "00410E108602430D0600000000000000";
+    AppendHex32(hdr, func_addr - hdr_addr);
+    AppendHex32(hdr, eh_frame_addr + fde_offset - hdr_addr);
+  }
+
+  os << "--- !ELF\n"
+        "FileHeader:\n"
+        "  Class:           ELFCLASS64\n"
+        "  Data:            ELFDATA2LSB\n"
+        "  Type:            ET_DYN\n"
+        "  Machine:         EM_X86_64\n"
+        "Sections:\n"
+        "  - Name:            .text\n"
+        "    Type:            SHT_PROGBITS\n"
+        "    Flags:           [ SHF_ALLOC, SHF_EXECINSTR ]\n"
+        "    Address:         "
+     << llvm::format_hex(text_addr, 10)
+     << "\n"
+        "    AddressAlign:    0x10\n"
+        "    Content:         "
+     << text
+     << "\n"
+        "  - Name:            .eh_frame\n"
+        "    Type:            SHT_X86_64_UNWIND\n"
+        "    Flags:           [ SHF_ALLOC ]\n"
+        "    Address:         "
+     << llvm::format_hex(eh_frame_addr, 10)
+     << "\n"
+        "    AddressAlign:    0x8\n"
+        "    Content:         "
+     << eh_frame << "\n";
+  if (with_hdr)
+    os << "  - Name:            .eh_frame_hdr\n"
+          "    Type:            SHT_PROGBITS\n"
+          "    Flags:           [ SHF_ALLOC ]\n"
+          "    Address:         "
+       << llvm::format_hex(hdr_addr, 10)
+       << "\n"
+          "    AddressAlign:    0x4\n"
+          "    Content:         "
+       << hdr << "\n";
+  os << "...\n";
+}
+
+// Look up one function in a file with many FDEs, with and without the
+// .eh_frame_hdr table, and record how long the first lookup takes. Without
+// the table the whole .eh_frame section is scanned before the first lookup
+// can be answered.
+TEST_F(DWARFCallFrameInfoTest, FirstLookupWithEHFrameHdr) {
+  const uint32_t num_functions = 20000;
+  const uint32_t func_index = num_functions / 2 + 3;
+  const addr_t func_addr = 0x1000 + func_index * 0x10;
+
+  AddressRange ranges[2];
+  for (bool with_hdr : {false, true}) {
+    llvm::SmallString<128> yaml;
+    ASSERT_NO_ERROR(llvm::sys::fs::createTemporaryFile(
+        "many-functions-%%%%%%", "yaml", yaml));
+    llvm::FileRemover yaml_remover(yaml);
+    {
+      std::error_code ec;
+      llvm::raw_fd_ostream os(yaml, ec, llvm::sys::fs::F_Text);
+      ASSERT_NO_ERROR(ec);
+      WriteManyFunctionsYAML(os, num_functions, with_hdr);
+    }
+
+    llvm::SmallString<128> obj;
+    ASSERT_NO_ERROR(llvm::sys::fs::createTemporaryFile(
+        "many-functions-%%%%%%", "obj", obj));
+    llvm::FileRemover obj_remover(obj);
+
+    const char *args[] = {YAML2OBJ, yaml.c_str(), nullptr};
+    llvm::StringRef obj_ref = obj;
+    const llvm::Optional<llvm::StringRef> redirects[] = {llvm::None, obj_ref,
+                                                         llvm::None};
+    ASSERT_EQ(0,
+              llvm::sys::ExecuteAndWait(YAML2OBJ, args, nullptr, redirects));
+
+    auto module_sp = std::make_shared<Module>(ModuleSpec(FileSpec(obj, false)));
+    SectionList *list = module_sp->GetSectionList();
+    ASSERT_NE(nullptr, list);
+    auto section_sp = list->FindSectionByType(eSectionTypeEHFrame, false);
+    ASSERT_NE(nullptr, section_sp);
+
+    Address addr;
+    ASSERT_TRUE(module_sp->ResolveFileAddress(func_addr + 4, addr));
+
+    DWARFCallFrameInfo cfi(*module_sp->GetObjectFile(), section_sp,
+                           DWARFCallFrameInfo::EH);
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(cfi.GetAddressRange(addr, ranges[with_hdr]));
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    RecordProperty(with_hdr ? "EHFrameHdrFirstLookupMicroseconds"
+                            : "EHFrameScanFirstLookupMicroseconds",
+                   elapsed.count());
+
+    UnwindPlan plan(eRegisterKindGeneric);
+    ASSERT_TRUE(cfi.GetUnwindPlan(addr, plan));
+    ASSERT_EQ(3, plan.GetRowCount());
+    EXPECT_EQ(GetExpectedRow2(), *plan.GetRowAtIndex(2));
+
+    // The last function is found too.
+    Address end_addr;
+    ASSERT_TRUE(module_sp->ResolveFileAddress(
+        0x1000 + num_functions * 0x10 - 1, end_addr));
+    AddressRange end_range;
+    EXPECT_TRUE(cfi.GetAddressRange(end_addr, end_range));
+    EXPECT_EQ(0x1000 + (num_functions - 1) * 0x10,
+              end_range.GetBaseAddress().GetFileAddress());
+
+    size_t fde_count = 0;
+    cfi.ForEachFDEEntries([&fde_count](addr_t, uint32_t, dw_offset_t) {
+      ++fde_count;
+      return true;
+    });
+    EXPECT_EQ(num_functions, fde_count);
+
+    // The start addresses come straight from the .eh_frame_hdr table.
+    std::vector<addr_t> starts;
+    EXPECT_EQ(with_hdr,
+              cfi.ForEachEHFrameHdrFunctionStart([&starts](addr_t start) {
+                starts.push_back(start);
+                return true;
+              }));
+    if (with_hdr) {
+      ASSERT_EQ(num_functions, starts.size());
+      for (uint32_t i = 0; i < num_functions; ++i)
+        ASSERT_EQ(0x1000 + i * 0x10, starts[i]) << i;
+    } else {
+      EXPECT_TRUE(starts.empty());
+    }
+  }
+
+  EXPECT_EQ(func_addr, ranges[false].GetBaseAddress().GetFileAddress());
+  EXPECT_EQ(0x10u, ranges[false].GetByteSize());
+  EXPECT_EQ(ranges[false].GetBaseAddress().GetFileAddress(),
+            ranges[true].GetBaseAddress().GetFileAddress());
+  EXPECT_EQ(ranges[false].GetByteSize(), ranges[true].GetByteSize());
+}
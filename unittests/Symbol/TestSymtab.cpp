@@ -0,0 +1,82 @@
+//===-- TestSymtab.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Symbol/Symbol.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Symbol/Symtab.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+class SymtabTest : public ::testing::Test {
+protected:
+  void AddCodeSymbol(Symtab &symtab, llvm::StringRef name) {
+    const uint32_t id = symtab.GetNumSymbols();
+    symtab.AddSymbol(Symbol(id, name.str().c_str(), true, eSymbolTypeCode,
+                            true, false, false, false, SectionSP(),
+                            0x1000 + id * 0x10, 0x10, true, false, 0));
+  }
+
+  size_t CountFunctions(Symtab &symtab, const char *name,
+                        uint32_t name_type_mask) {
+    SymbolContextList sc_list;
+    return symtab.FindFunctionSymbols(ConstString(name), name_type_mask,
+                                      sc_list);
+  }
+};
+} // namespace
+
+TEST_F(SymtabTest, NameIndexesAcrossChunks) {
+  // Enough symbols that the name indexes are computed in several chunks.
+  const size_t num_fillers = 100000;
+  Symtab symtab(nullptr);
+
+  // foo::bar() could be a function in a namespace or a method. Only the
+  // destructor at the end of the symbol table, which is indexed in another
+  // chunk, tells that foo is a class.
+  AddCodeSymbol(symtab, "_ZN3foo3barEv");
+  // ns::func(int) stays ambiguous, so it is both a basename and a method.
+  AddCodeSymbol(symtab, "_ZN2ns4funcEi");
+  AddCodeSymbol(symtab, "_Z6globalv");
+  for (size_t i = 0; i < num_fillers; ++i) {
+    std::string basename = "f" + std::to_string(i);
+    std::string name;
+    llvm::raw_string_ostream(name)
+        << "_ZN6filler" << basename.size() << basename << "Ev";
+    AddCodeSymbol(symtab, name);
+  }
+  AddCodeSymbol(symtab, "_ZN3fooD2Ev");
+
+  auto start = std::chrono::steady_clock::now();
+  symtab.PreloadSymbols();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  RecordProperty("InitNameIndexesMilliseconds", elapsed.count());
+
+  EXPECT_EQ(0u, CountFunctions(symtab, "bar", eFunctionNameTypeBase));
+  EXPECT_EQ(1u, CountFunctions(symtab, "bar", eFunctionNameTypeMethod));
+  EXPECT_EQ(1u, CountFunctions(symtab, "func", eFunctionNameTypeBase));
+  EXPECT_EQ(1u, CountFunctions(symtab, "func", eFunctionNameTypeMethod));
+  EXPECT_EQ(1u, CountFunctions(symtab, "global", eFunctionNameTypeBase));
+  EXPECT_EQ(1u, CountFunctions(symtab, "f12345", eFunctionNameTypeBase));
+  EXPECT_EQ(1u, CountFunctions(symtab, "f99999", eFunctionNameTypeMethod));
+
+  // Both the mangled and the demangled names are full names.
+  std::vector<uint32_t> indexes;
+  symtab.AppendSymbolIndexesWithName(ConstString("_ZN3foo3barEv"), indexes);
+  symtab.AppendSymbolIndexesWithName(ConstString("foo::bar()"), indexes);
+  EXPECT_EQ(std::vector<uint32_t>({0, 0}), indexes);
+}
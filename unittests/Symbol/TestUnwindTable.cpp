@@ -0,0 +1,195 @@
+//===-- TestUnwindTable.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
+#include "TestingSupport/TestUtilities.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Host/TaskPool.h"
+#include "lldb/Symbol/FuncUnwinders.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/StreamString.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Program.h"
+#include "gtest/gtest.h"
+
+using namespace lldb_private;
+using namespace lldb;
+
+class UnwindTableTest : public testing::Test {
+public:
+  void SetUp() override {
+    HostInfo::Initialize();
+    ObjectFileELF::Initialize();
+  }
+
+  void TearDown() override {
+    ObjectFileELF::Terminate();
+    HostInfo::Terminate();
+  }
+};
+
+TEST_F(UnwindTableTest, FuncUnwindersFromFunctionBounds) {
+  std::string yaml = GetInputFilePath("basic-call-frame-info.yaml");
+  llvm::SmallString<128> obj;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile(
+      "basic-call-frame-info-%%%%%%", "obj", obj));
+  llvm::FileRemover obj_remover(obj);
+
+  const char *args[] = {YAML2OBJ, yaml.c_str(), nullptr};
+  llvm::StringRef obj_ref = obj;
+  const llvm::Optional<llvm::StringRef> redirects[] = {llvm::None, obj_ref,
+                                                       llvm::None};
+  ASSERT_EQ(0, llvm::sys::ExecuteAndWait(YAML2OBJ, args, nullptr, redirects));
+
+  auto module_sp = std::make_shared<Module>(ModuleSpec(FileSpec(obj, false)));
+  ASSERT_NE(nullptr, module_sp->GetObjectFile());
+  UnwindTable &table = module_sp->GetObjectFile()->GetUnwindTable();
+
+  for (const char *name : {"eh_frame", "debug_frame3", "debug_frame4"}) {
+    const Symbol *sym = module_sp->FindFirstSymbolWithNameAndType(
+        ConstString(name), eSymbolTypeAny);
+    ASSERT_NE(nullptr, sym) << name;
+    Address addr = sym->GetAddress();
+    addr.Slide(4);
+
+    // The function is found from its bounds even without a symbol context.
+    SymbolContext sc;
+    FuncUnwindersSP func_unwinders_sp =
+        table.GetFuncUnwindersContainingAddress(addr, sc);
+    ASSERT_NE(nullptr, func_unwinders_sp) << name;
+    EXPECT_EQ(sym->GetAddress(), func_unwinders_sp->GetFunctionStartAddress());
+    EXPECT_TRUE(func_unwinders_sp->ContainsAddress(addr));
+
+    // Every thread gets the same FuncUnwinders for the function.
+    std::vector<FuncUnwindersSP> found(64);
+    TaskMapOverInt(0, found.size(), [&](size_t idx) {
+      SymbolContext thread_sc;
+      found[idx] = table.GetFuncUnwindersContainingAddress(addr, thread_sc);
+    });
+    for (const FuncUnwindersSP &sp : found)
+      EXPECT_EQ(func_unwinders_sp, sp) << name;
+  }
+}
+
+TEST_F(UnwindTableTest, UnwindPlanEncodeDecode) {
+  UnwindPlan plan(eRegisterKindDWARF);
+  plan.SetSourceName("assembly insn profiling");
+  plan.SetReturnAddressRegister(16);
+  plan.SetSourcedFromCompiler(eLazyBoolNo);
+  plan.SetUnwindPlanValidAtAllInstructions(eLazyBoolYes);
+
+  UnwindPlan::RowSP row_sp(new UnwindPlan::Row);
+  row_sp->GetCFAValue().SetIsRegisterPlusOffset(7, 8);
+  row_sp->SetRegisterLocationToAtCFAPlusOffset(16, -8, true);
+  plan.AppendRow(row_sp);
+
+  row_sp.reset(new UnwindPlan::Row(*row_sp));
+  row_sp->SetOffset(1);
+  row_sp->GetCFAValue().SetIsRegisterPlusOffset(7, 16);
+  row_sp->SetRegisterLocationToAtCFAPlusOffset(6, -16, true);
+  row_sp->SetRegisterLocationToRegister(3, 12, true);
+  row_sp->SetRegisterLocationToSame(13, true);
+  plan.AppendRow(row_sp);
+
+  StreamString strm(Stream::eBinary, 8, eByteOrderLittle);
+  ASSERT_TRUE(plan.Encode(strm));
+  DataExtractor data(strm.GetData(), strm.GetSize(), eByteOrderLittle, 8);
+
+  UnwindPlan decoded(eRegisterKindGeneric);
+  lldb::offset_t offset = 0;
+  ASSERT_TRUE(decoded.Decode(data, &offset, nullptr));
+  EXPECT_EQ(strm.GetSize(), offset);
+  EXPECT_EQ(eRegisterKindDWARF, decoded.GetRegisterKind());
+  EXPECT_EQ(16u, decoded.GetReturnAddressRegister());
+  EXPECT_EQ(plan.GetSourceName(), decoded.GetSourceName());
+  EXPECT_EQ(eLazyBoolNo, decoded.GetSourcedFromCompiler());
+  EXPECT_EQ(eLazyBoolYes, decoded.GetUnwindPlanValidAtAllInstructions());
+  ASSERT_EQ(plan.GetRowCount(), decoded.GetRowCount());
+  for (int i = 0; i < plan.GetRowCount(); ++i)
+    EXPECT_EQ(*plan.GetRowAtIndex(i), *decoded.GetRowAtIndex(i)) << i;
+
+  // Truncated data is rejected rather than decoded into a partial plan.
+  DataExtractor truncated(data, 0, data.GetByteSize() - 1);
+  offset = 0;
+  EXPECT_FALSE(decoded.Decode(truncated, &offset, nullptr));
+
+  // Rows with DWARF expressions point into the eh_frame or debug_frame
+  // data, so plans using them aren't saved.
+  static const uint8_t expr[] = {0x77, 0x08}; // DW_OP_breg7 8
+  row_sp.reset(new UnwindPlan::Row(*row_sp));
+  row_sp->SetOffset(2);
+  row_sp->GetCFAValue().SetIsDWARFExpression(expr, sizeof(expr));
+  plan.AppendRow(row_sp);
+  StreamString expr_strm(Stream::eBinary, 8, eByteOrderLittle);
+  EXPECT_FALSE(plan.Encode(expr_strm));
+}
+
+TEST_F(UnwindTableTest, UnwindPlanCacheSurvivesModule) {
+  std::string yaml = GetInputFilePath("basic-call-frame-info.yaml");
+  llvm::SmallString<128> obj;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile(
+      "unwind-plan-cache-%%%%%%", "obj", obj));
+  llvm::FileRemover obj_remover(obj);
+
+  const char *args[] = {YAML2OBJ, yaml.c_str(), nullptr};
+  llvm::StringRef obj_ref = obj;
+  const llvm::Optional<llvm::StringRef> redirects[] = {llvm::None, obj_ref,
+                                                       llvm::None};
+  ASSERT_EQ(0, llvm::sys::ExecuteAndWait(YAML2OBJ, args, nullptr, redirects));
+
+  llvm::SmallString<128> cache_dir;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("unwind-plan-cache", cache_dir));
+  ModuleListProperties &properties =
+      ModuleList::GetGlobalModuleListProperties();
+  properties.SetIndexCachePath(cache_dir);
+  properties.SetEnableIndexCache(true);
+
+  UnwindPlan plan(eRegisterKindDWARF);
+  plan.SetSourceName("assembly insn profiling");
+  UnwindPlan::RowSP row_sp(new UnwindPlan::Row);
+  row_sp->GetCFAValue().SetIsRegisterPlusOffset(7, 8);
+  row_sp->SetRegisterLocationToAtCFAPlusOffset(16, -8, true);
+  plan.AppendRow(row_sp);
+
+  // A plan that isn't saved explicitly is dropped with its module, the
+  // UnwindTable can't save it while its object file is being destroyed.
+  {
+    auto module_sp = std::make_shared<Module>(ModuleSpec(FileSpec(obj, false)));
+    UnwindTable &table = module_sp->GetObjectFile()->GetUnwindTable();
+    table.CacheUnwindPlan(UnwindTable::eCachedUnwindPlanAssembly, 0x260, plan);
+  }
+  {
+    auto module_sp = std::make_shared<Module>(ModuleSpec(FileSpec(obj, false)));
+    UnwindTable &table = module_sp->GetObjectFile()->GetUnwindTable();
+    EXPECT_EQ(nullptr, table.GetCachedUnwindPlan(
+                           UnwindTable::eCachedUnwindPlanAssembly, 0x260));
+    table.CacheUnwindPlan(UnwindTable::eCachedUnwindPlanAssembly, 0x260, plan);
+    table.SaveUnwindPlanCache();
+  }
+  {
+    auto module_sp = std::make_shared<Module>(ModuleSpec(FileSpec(obj, false)));
+    UnwindTable &table = module_sp->GetObjectFile()->GetUnwindTable();
+    UnwindPlanSP cached_sp = table.GetCachedUnwindPlan(
+        UnwindTable::eCachedUnwindPlanAssembly, 0x260);
+    ASSERT_NE(nullptr, cached_sp);
+    ASSERT_EQ(1, cached_sp->GetRowCount());
+    EXPECT_EQ(*row_sp, *cached_sp->GetRowAtIndex(0));
+  }
+
+  properties.SetEnableIndexCache(false);
+  llvm::sys::fs::remove_directories(cache_dir);
+}
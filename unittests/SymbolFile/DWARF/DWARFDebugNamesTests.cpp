@@ -0,0 +1,229 @@
+//===-- DWARFDebugNamesTests.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "Plugins/SymbolFile/DWARF/DWARFDebugNames.h"
+#include "lldb/Core/MappedHash.h"
+#include "llvm/ADT/STLExtras.h"
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+// Builds the .debug_names and .debug_str contents for a test.
+class DebugNamesBuilder {
+public:
+  struct Name {
+    std::string name;
+    // (cu index, DIE offset, tag) of each entry
+    std::vector<std::tuple<uint32_t, uint32_t, dw_tag_t>> entries;
+  };
+
+  // Append a 32 bit DWARF name index with one bucket per name, unless
+  // bucket_count is given.
+  void AddNameIndex(const std::vector<uint32_t> &cu_offsets,
+                    std::vector<Name> names, uint32_t bucket_count = 0) {
+    if (bucket_count == 0)
+      bucket_count = names.size();
+    // The hash table requires the names to be sorted by bucket.
+    std::stable_sort(names.begin(), names.end(),
+                     [bucket_count](const Name &lhs, const Name &rhs) {
+                       return DWARFDebugNames::HashName(lhs.name) %
+                                  bucket_count <
+                              DWARFDebugNames::HashName(rhs.name) %
+                                  bucket_count;
+                     });
+
+    std::vector<uint8_t> index;
+    PutU16(index, 5); // version
+    PutU16(index, 0); // padding
+    PutU32(index, cu_offsets.size());
+    PutU32(index, 0); // local type units
+    PutU32(index, 0); // foreign type units
+    PutU32(index, bucket_count);
+    PutU32(index, names.size());
+
+    // One abbreviation per tag, with the tag as its code. Every entry has
+    // a compile unit index and a DIE offset.
+    std::vector<uint8_t> abbrevs;
+    std::vector<dw_tag_t> tags;
+    for (const Name &name : names)
+      for (const auto &entry : name.entries)
+        if (std::find(tags.begin(), tags.end(), std::get<2>(entry)) ==
+            tags.end())
+          tags.push_back(std::get<2>(entry));
+    for (dw_tag_t tag : tags) {
+      PutULEB(abbrevs, tag);
+      PutULEB(abbrevs, tag);
+      PutULEB(abbrevs, DWARFDebugNames::eIndexCompileUnit);
+      PutULEB(abbrevs, DW_FORM_data1);
+      PutULEB(abbrevs, DWARFDebugNames::eIndexDIEOffset);
+      PutULEB(abbrevs, DW_FORM_ref4);
+      PutULEB(abbrevs, 0);
+      PutULEB(abbrevs, 0);
+    }
+    PutULEB(abbrevs, 0);
+    PutU32(index, abbrevs.size());
+    PutU32(index, 4); // augmentation string size
+    index.insert(index.end(), {'T', 'E', 'S', 'T'});
+
+    for (uint32_t cu_offset : cu_offsets)
+      PutU32(index, cu_offset);
+
+    std::vector<uint32_t> buckets(bucket_count, 0);
+    for (size_t i = names.size(); i > 0; --i)
+      buckets[DWARFDebugNames::HashName(names[i - 1].name) % bucket_count] = i;
+    for (uint32_t bucket : buckets)
+      PutU32(index, bucket);
+    for (const Name &name : names)
+      PutU32(index, DWARFDebugNames::HashName(name.name));
+
+    std::vector<uint8_t> entry_pool;
+    std::vector<uint32_t> entry_offsets;
+    for (const Name &name : names) {
+      PutU32(index, m_string_table.size());
+      m_string_table.insert(m_string_table.end(), name.name.begin(),
+                            name.name.end());
+      m_string_table.push_back(0);
+
+      entry_offsets.push_back(entry_pool.size());
+      for (const auto &entry : name.entries) {
+        PutULEB(entry_pool, std::get<2>(entry));
+        entry_pool.push_back(std::get<0>(entry));
+        PutU32(entry_pool, std::get<1>(entry));
+      }
+      PutULEB(entry_pool, 0);
+    }
+    for (uint32_t entry_offset : entry_offsets)
+      PutU32(index, entry_offset);
+    index.insert(index.end(), abbrevs.begin(), abbrevs.end());
+    index.insert(index.end(), entry_pool.begin(), entry_pool.end());
+
+    PutU32(m_section, index.size());
+    m_section.insert(m_section.end(), index.begin(), index.end());
+  }
+
+  std::unique_ptr<DWARFDebugNames> Finish() {
+    m_data.SetData(m_section.data(), m_section.size(), eByteOrderLittle);
+    m_str_data.SetData(m_string_table.data(), m_string_table.size(),
+                       eByteOrderLittle);
+    return llvm::make_unique<DWARFDebugNames>(m_data, m_str_data);
+  }
+
+private:
+  static void PutU16(std::vector<uint8_t> &data, uint16_t value) {
+    data.push_back(value);
+    data.push_back(value >> 8);
+  }
+
+  static void PutU32(std::vector<uint8_t> &data, uint32_t value) {
+    PutU16(data, value);
+    PutU16(data, value >> 16);
+  }
+
+  static void PutULEB(std::vector<uint8_t> &data, uint64_t value) {
+    do {
+      uint8_t byte = value & 0x7f;
+      value >>= 7;
+      if (value)
+        byte |= 0x80;
+      data.push_back(byte);
+    } while (value);
+  }
+
+  std::vector<uint8_t> m_section;
+  std::vector<uint8_t> m_string_table{0};
+  DWARFDataExtractor m_data;
+  DWARFDataExtractor m_str_data;
+};
+
+std::vector<std::pair<dw_offset_t, dw_offset_t>>
+Find(const DWARFDebugNames &debug_names, llvm::StringRef name,
+     dw_tag_t tag = 0) {
+  DWARFDebugNames::EntryArray entries;
+  debug_names.FindByName(name, entries);
+  std::vector<std::pair<dw_offset_t, dw_offset_t>> result;
+  for (const auto &entry : entries)
+    if (tag == 0 || entry.tag == tag)
+      result.push_back(std::make_pair(entry.cu_offset, entry.die_offset));
+  return result;
+}
+
+typedef std::vector<std::pair<dw_offset_t, dw_offset_t>> OffsetPairs;
+
+} // namespace
+
+TEST(DWARFDebugNamesTests, HashName) {
+  EXPECT_EQ(MappedHash::HashStringUsingDJB("main"),
+            DWARFDebugNames::HashName("main"));
+  EXPECT_EQ(DWARFDebugNames::HashName("main"),
+            DWARFDebugNames::HashName("MAIN"));
+  EXPECT_NE(DWARFDebugNames::HashName("main"),
+            DWARFDebugNames::HashName("mainx"));
+}
+
+TEST(DWARFDebugNamesTests, FindByName) {
+  DebugNamesBuilder builder;
+  builder.AddNameIndex(
+      {0x0, 0x100},
+      {{"main", {std::make_tuple(0, 0x20, DW_TAG_subprogram)}},
+       {"foo",
+        {std::make_tuple(0, 0x30, DW_TAG_subprogram),
+         std::make_tuple(1, 0x40, DW_TAG_variable)}},
+       {"Foo", {std::make_tuple(1, 0x50, DW_TAG_structure_type)}},
+       {"ns", {std::make_tuple(1, 0x60, DW_TAG_namespace)}}});
+  std::unique_ptr<DWARFDebugNames> debug_names = builder.Finish();
+  ASSERT_TRUE(debug_names->IsValid());
+
+  std::vector<dw_offset_t> cu_offsets;
+  debug_names->GetCompileUnitOffsets(cu_offsets);
+  EXPECT_EQ((std::vector<dw_offset_t>{0x0, 0x100}), cu_offsets);
+
+  EXPECT_EQ((OffsetPairs{{0x0, 0x20}}), Find(*debug_names, "main"));
+  // "foo" and "Foo" hash to the same bucket, but only match themselves.
+  EXPECT_EQ((OffsetPairs{{0x0, 0x30}, {0x100, 0x40}}),
+            Find(*debug_names, "foo"));
+  EXPECT_EQ((OffsetPairs{{0x100, 0x40}}),
+            Find(*debug_names, "foo", DW_TAG_variable));
+  EXPECT_EQ((OffsetPairs{{0x100, 0x50}}), Find(*debug_names, "Foo"));
+  EXPECT_EQ((OffsetPairs{{0x100, 0x60}}), Find(*debug_names, "ns"));
+  EXPECT_TRUE(Find(*debug_names, "bar").empty());
+  EXPECT_TRUE(Find(*debug_names, "").empty());
+}
+
+TEST(DWARFDebugNamesTests, MultipleNameIndexes) {
+  // Linkers that don't merge the indexes leave one per object file.
+  DebugNamesBuilder builder;
+  builder.AddNameIndex({0x0},
+                       {{"main", {std::make_tuple(0, 0x20, DW_TAG_subprogram)}},
+                        {"g_a", {std::make_tuple(0, 0x28, DW_TAG_variable)}}});
+  builder.AddNameIndex(
+      {0x80}, {{"main", {std::make_tuple(0, 0x10, DW_TAG_subprogram)}}},
+      /*bucket_count=*/1);
+  std::unique_ptr<DWARFDebugNames> debug_names = builder.Finish();
+  ASSERT_TRUE(debug_names->IsValid());
+
+  EXPECT_EQ((OffsetPairs{{0x0, 0x20}, {0x80, 0x10}}),
+            Find(*debug_names, "main"));
+  EXPECT_EQ((OffsetPairs{{0x0, 0x28}}), Find(*debug_names, "g_a"));
+}
+
+TEST(DWARFDebugNamesTests, Invalid) {
+  DebugNamesBuilder builder;
+  std::unique_ptr<DWARFDebugNames> debug_names = builder.Finish();
+  EXPECT_FALSE(debug_names->IsValid());
+  EXPECT_TRUE(Find(*debug_names, "main").empty());
+}
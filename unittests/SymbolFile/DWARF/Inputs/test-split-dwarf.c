@@ -0,0 +1,35 @@
+// Each compile unit is built separately so that every one gets its own
+// split DWARF unit, and the .dwo files are packaged into a .dwp next to the
+// executable:
+//
+//   for i in 1 2 3 4; do
+//     gcc -c -O0 -gdwarf-4 -gsplit-dwarf -DCU=$i \
+//         -fdebug-prefix-map=$PWD=. test-split-dwarf.c -o cu$i.o
+//   done
+//   gcc -nostdlib -Wl,-e,main cu1.o cu2.o cu3.o cu4.o -o test-split-dwarf.elf
+//   dwp -e test-split-dwarf.elf -o test-split-dwarf.elf.dwp
+
+#if CU == 1
+struct cu1_type { int a; };
+int cu1_global = 1;
+int cu1_func(struct cu1_type *t) { return t->a + cu1_global; }
+int cu2_func(int);
+int cu3_func(int);
+int cu4_func(int);
+int main() {
+  struct cu1_type t = {1};
+  return cu1_func(&t) + cu2_func(2) + cu3_func(3) + cu4_func(4);
+}
+#elif CU == 2
+struct cu2_type { int b; };
+int cu2_global = 2;
+int cu2_func(int x) { struct cu2_type t = {x}; return t.b + cu2_global; }
+#elif CU == 3
+struct cu3_type { int c; };
+int cu3_global = 3;
+int cu3_func(int x) { struct cu3_type t = {x}; return t.c + cu3_global; }
+#elif CU == 4
+struct cu4_type { int d; };
+int cu4_global = 4;
+int cu4_func(int x) { struct cu4_type t = {x}; return t.d + cu4_global; }
+#endif
@@ -15,6 +15,10 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 
+#include <mutex>
+#include <thread>
+
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
 #include "Plugins/ObjectFile/PECOFF/ObjectFilePECOFF.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
 #include "Plugins/SymbolFile/PDB/SymbolFilePDB.h"
@@ -27,6 +31,7 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/LineTable.h"
 #include "lldb/Symbol/SymbolVendor.h"
+#include "lldb/Symbol/VariableList.h"
 #include "lldb/Utility/ArchSpec.h"
 #include "lldb/Utility/FileSpec.h"
 
@@ -39,12 +44,14 @@ public:
 // AST every time so that modifications to the AST from each test don't
 // leak into the next test.
     HostInfo::Initialize();
+    ObjectFileELF::Initialize();
     ObjectFilePECOFF::Initialize();
     SymbolFileDWARF::Initialize();
     ClangASTContext::Initialize();
     SymbolFilePDB::Initialize();
 
     m_dwarf_test_exe = GetInputFilePath("test-dwarf.exe");
+    m_split_dwarf_test_exe = GetInputFilePath("test-split-dwarf.elf");
   }
 
   void TearDown() override {
@@ -52,11 +59,13 @@ public:
     ClangASTContext::Initialize();
     SymbolFileDWARF::Terminate();
     ObjectFilePECOFF::Terminate();
+    ObjectFileELF::Terminate();
     HostInfo::Terminate();
   }
 
 protected:
   std::string m_dwarf_test_exe;
+  std::string m_split_dwarf_test_exe;
 };
 
 TEST_F(SymbolFileDWARFTests, TestAbilitiesForDWARF) {
@@ -74,3 +83,51 @@ TEST_F(SymbolFileDWARFTests, TestAbilitiesForDWARF) {
   uint32_t expected_abilities = SymbolFile::kAllAbilities;
   EXPECT_EQ(expected_abilities, symfile->CalculateAbilities());
 }
+
+TEST_F(SymbolFileDWARFTests, TestParallelIndexSplitDWARF) {
+  // Index several copies of a split DWARF module (one .dwo unit per compile
+  // unit, packaged in a .dwp) at the same time. Each thread holds its
+  // module's lock while indexing, like PreloadSymbols() does, which used to
+  // deadlock once DIE extraction for the compile units ran in parallel.
+  const size_t num_modules = 8;
+  std::vector<lldb::ModuleSP> modules;
+  for (size_t i = 0; i < num_modules; ++i) {
+    FileSpec fspec(m_split_dwarf_test_exe, false);
+    ArchSpec aspec("x86_64-pc-linux");
+    modules.push_back(std::make_shared<Module>(fspec, aspec));
+  }
+
+  std::vector<std::thread> threads;
+  for (lldb::ModuleSP &module : modules) {
+    threads.emplace_back([module]() {
+      std::lock_guard<std::recursive_mutex> guard(module->GetMutex());
+      SymbolVendor *plugin = module->GetSymbolVendor();
+      ASSERT_NE(nullptr, plugin);
+      SymbolFile *symfile = plugin->GetSymbolFile();
+      ASSERT_NE(nullptr, symfile);
+      symfile->PreloadSymbols();
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  for (lldb::ModuleSP &module : modules) {
+    SymbolFile *symfile = module->GetSymbolVendor()->GetSymbolFile();
+    EXPECT_EQ(4u, symfile->GetNumCompileUnits());
+    for (const char *name :
+         {"main", "cu1_func", "cu2_func", "cu3_func", "cu4_func"}) {
+      SymbolContextList sc_list;
+      EXPECT_EQ(1u, symfile->FindFunctions(ConstString(name), nullptr,
+                                           lldb::eFunctionNameTypeFull, false,
+                                           false, sc_list))
+          << name;
+    }
+    for (const char *name :
+         {"cu1_global", "cu2_global", "cu3_global", "cu4_global"}) {
+      VariableList variables;
+      EXPECT_EQ(1u, symfile->FindGlobalVariables(ConstString(name), nullptr,
+                                                 false, UINT32_MAX, variables))
+          << name;
+    }
+  }
+}
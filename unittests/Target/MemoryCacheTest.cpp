@@ -0,0 +1,265 @@
+//===-- MemoryCacheTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Target/Memory.h"
+#include "lldb/Target/MemoryRegionInfo.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/TargetList.h"
+#include "lldb/Utility/Listener.h"
+#include "gtest/gtest.h"
+
+using namespace lldb_private;
+using namespace lldb;
+
+namespace {
+// A process whose memory is a function of the address, in the regions
+// it was given.
+class FakeMemoryProcess : public Process {
+public:
+  struct Region {
+    addr_t base;
+    addr_t size;
+    bool writable;
+    // Whether GetMemoryRegionInfo() knows about the region.
+    bool has_info;
+  };
+
+  FakeMemoryProcess(TargetSP target_sp, ListenerSP listener_sp)
+      : Process(target_sp, listener_sp) {}
+
+  ~FakeMemoryProcess() override { Finalize(); }
+
+  static uint8_t ByteAt(addr_t addr) { return addr * 7 + (addr >> 12); }
+
+  bool CanDebug(TargetSP target, bool plugin_specified_by_name) override {
+    return true;
+  }
+
+  Status DoDestroy() override { return Status(); }
+
+  void RefreshStateAfterStop() override {}
+
+  bool UpdateThreadList(ThreadList &old_thread_list,
+                        ThreadList &new_thread_list) override {
+    return false;
+  }
+
+  ConstString GetPluginName() override { return ConstString("fake-memory"); }
+
+  uint32_t GetPluginVersion() override { return 1; }
+
+  size_t DoReadMemory(addr_t addr, void *buf, size_t size,
+                      Status &error) override {
+    ++m_num_reads;
+    size_t bytes_read = 0;
+    for (; bytes_read < size; ++bytes_read) {
+      if (!FindRegion(addr + bytes_read))
+        break;
+      static_cast<uint8_t *>(buf)[bytes_read] = ByteAt(addr + bytes_read);
+    }
+    if (bytes_read == 0)
+      error.SetErrorStringWithFormat("no memory at 0x%" PRIx64, addr);
+    return bytes_read;
+  }
+
+  std::vector<size_t>
+  DoReadMemoryRanges(llvm::ArrayRef<Range<addr_t, size_t>> ranges,
+                     llvm::MutableArrayRef<uint8_t> buffer,
+                     Status &error) override {
+    ++m_num_range_reads;
+    return Process::DoReadMemoryRanges(ranges, buffer, error);
+  }
+
+  Status GetMemoryRegionInfo(addr_t addr,
+                             MemoryRegionInfo &region_info) override {
+    ++m_num_region_queries;
+    const Region *region = FindRegion(addr);
+    if (!region || !region->has_info)
+      return Status("no region at 0x%" PRIx64, addr);
+    region_info.GetRange().SetRangeBase(region->base);
+    region_info.GetRange().SetByteSize(region->size);
+    region_info.SetReadable(MemoryRegionInfo::eYes);
+    region_info.SetWritable(region->writable ? MemoryRegionInfo::eYes
+                                             : MemoryRegionInfo::eNo);
+    return Status();
+  }
+
+  const Region *FindRegion(addr_t addr) const {
+    for (const Region &region : m_regions)
+      if (addr >= region.base && addr - region.base < region.size)
+        return &region;
+    return nullptr;
+  }
+
+  std::vector<Region> m_regions;
+  size_t m_num_reads = 0;
+  size_t m_num_region_queries = 0;
+  size_t m_num_range_reads = 0;
+};
+
+class MemoryCacheTest : public testing::Test {
+public:
+  void SetUp() override {
+    HostInfo::Initialize();
+    Debugger::Initialize(nullptr);
+    ArchSpec arch("x86_64-pc-linux");
+    Platform::SetHostPlatform(
+        platform_linux::PlatformLinux::CreateInstance(true, &arch));
+    m_debugger_sp = Debugger::CreateInstance();
+    PlatformSP platform_sp;
+    ASSERT_TRUE(m_debugger_sp->GetTargetList()
+                    .CreateTarget(*m_debugger_sp, "", arch, false,
+                                  platform_sp, m_target_sp)
+                    .Success());
+    m_process_sp = std::make_shared<FakeMemoryProcess>(
+        m_target_sp, Listener::MakeListener("memory-cache-test"));
+  }
+
+  void TearDown() override {
+    m_process_sp.reset();
+    m_target_sp.reset();
+    Debugger::Destroy(m_debugger_sp);
+    Debugger::Terminate();
+    HostInfo::Terminate();
+  }
+
+protected:
+  void ExpectBytes(const std::vector<uint8_t> &bytes, addr_t addr) {
+    for (size_t i = 0; i < bytes.size(); ++i)
+      ASSERT_EQ(FakeMemoryProcess::ByteAt(addr + i), bytes[i]) << i;
+  }
+
+  DebuggerSP m_debugger_sp;
+  TargetSP m_target_sp;
+  std::shared_ptr<FakeMemoryProcess> m_process_sp;
+};
+} // namespace
+
+TEST_F(MemoryCacheTest, RegionPermissionsLookedUpOncePerStop) {
+  m_process_sp->m_regions = {{0x10000, 0x1000, false, true},
+                             {0x20000, 0x1000, true, true},
+                             {0x30000, 0x1000, false, false}};
+  MemoryCache cache(*m_process_sp);
+  std::vector<uint8_t> bytes(16);
+  Status error;
+
+  for (int stop = 0; stop < 3; ++stop) {
+    EXPECT_EQ(16u, cache.Read(0x10010, bytes.data(), bytes.size(), error));
+    ExpectBytes(bytes, 0x10010);
+    EXPECT_EQ(16u, cache.Read(0x20010, bytes.data(), bytes.size(), error));
+    ExpectBytes(bytes, 0x20010);
+    // Memory whose region can't be looked up is treated as writable.
+    EXPECT_EQ(16u, cache.Read(0x30010, bytes.data(), bytes.size(), error));
+    ExpectBytes(bytes, 0x30010);
+    cache.ClearWritableData();
+  }
+
+  // Each region was looked up once per stop, even the one that failed.
+  // The read only page was only read once, the others once per stop.
+  EXPECT_EQ(3u * 3u, m_process_sp->m_num_region_queries);
+  EXPECT_EQ(3u, cache.GetStatistics().num_pages_kept);
+  EXPECT_EQ(1u + 3u + 3u, m_process_sp->m_num_reads);
+}
+
+TEST_F(MemoryCacheTest, RemappedPagesAreReadAgain) {
+  m_process_sp->m_regions = {{0x10000, 0x1000, false, true}};
+  MemoryCache cache(*m_process_sp);
+  std::vector<uint8_t> bytes(16);
+  Status error;
+
+  EXPECT_EQ(16u, cache.Read(0x10010, bytes.data(), bytes.size(), error));
+  cache.ClearWritableData();
+  EXPECT_EQ(16u, cache.Read(0x10010, bytes.data(), bytes.size(), error));
+  EXPECT_EQ(1u, m_process_sp->m_num_reads);
+
+  // The process made the page writable while it ran, the kept page may
+  // be stale.
+  m_process_sp->m_regions[0].writable = true;
+  cache.ClearWritableData();
+  EXPECT_EQ(16u, cache.Read(0x10010, bytes.data(), bytes.size(), error));
+  ExpectBytes(bytes, 0x10010);
+  EXPECT_EQ(2u, m_process_sp->m_num_reads);
+}
+
+TEST_F(MemoryCacheTest, ReadAheadStopsAtUnreadableMemory) {
+  const addr_t page_size = m_process_sp->GetMemoryCacheLineSize();
+  m_process_sp->m_regions = {{0x10000, page_size * 5 + 8, true, true}};
+  MemoryCache cache(*m_process_sp);
+  std::vector<uint8_t> bytes(page_size);
+  Status error;
+
+  // Walk forward until the read ahead runs past the end of the region.
+  addr_t addr = 0x10000;
+  for (; addr < 0x10000 + page_size * 5; addr += page_size) {
+    ASSERT_EQ(page_size, cache.Read(addr, bytes.data(), bytes.size(), error));
+    ExpectBytes(bytes, addr);
+  }
+  // Only the bytes that are there are returned.
+  EXPECT_EQ(8u, cache.Read(addr, bytes.data(), bytes.size(), error));
+  bytes.resize(8);
+  ExpectBytes(bytes, addr);
+}
+
+TEST_F(MemoryCacheTest, ReadAheadAtTopOfAddressSpace) {
+  const addr_t page_size = m_process_sp->GetMemoryCacheLineSize();
+  const addr_t base = 0 - page_size * 4;
+  m_process_sp->m_regions = {{base, page_size * 4 - 1, true, true}};
+  MemoryCache cache(*m_process_sp);
+  std::vector<uint8_t> bytes(page_size);
+  Status error;
+
+  // Reads that continue each other make the cache read ahead, which must
+  // not wrap around to address zero.
+  for (addr_t addr = base; addr != 0 - page_size; addr += page_size) {
+    ASSERT_EQ(page_size, cache.Read(addr, bytes.data(), bytes.size(), error));
+    ExpectBytes(bytes, addr);
+  }
+  EXPECT_EQ(page_size - 1,
+            cache.Read(0 - page_size, bytes.data(), bytes.size(), error));
+}
+
+TEST_F(MemoryCacheTest, ReadRanges) {
+  const addr_t page_size = m_process_sp->GetMemoryCacheLineSize();
+  m_process_sp->m_regions = {{0x10000, page_size * 4, true, true}};
+  MemoryCache cache(*m_process_sp);
+  typedef Range<addr_t, size_t> AddrRange;
+  // A range inside a page, one that crosses into the next page and one
+  // that can't be read.
+  const AddrRange ranges[] = {AddrRange(0x10010, 16),
+                              AddrRange(0x10000 + page_size - 8, 16),
+                              AddrRange(0x50000, 8)};
+  std::vector<uint8_t> buffer(16 + 16 + 8);
+  Status error;
+
+  std::vector<size_t> bytes_read = cache.ReadRanges(ranges, buffer, error);
+  EXPECT_EQ(std::vector<size_t>({16, 16, 0}), bytes_read);
+  EXPECT_TRUE(error.Fail());
+  ExpectBytes(std::vector<uint8_t>(buffer.begin(), buffer.begin() + 16),
+              0x10010);
+  ExpectBytes(std::vector<uint8_t>(buffer.begin() + 16, buffer.begin() + 32),
+              0x10000 + page_size - 8);
+  // All of the missing pages were asked for with a single request.
+  EXPECT_EQ(1u, m_process_sp->m_num_range_reads);
+
+  // The readable ranges are cached now.
+  const size_t num_reads = m_process_sp->m_num_reads;
+  error.Clear();
+  std::fill(buffer.begin(), buffer.end(), 0);
+  bytes_read = cache.ReadRanges(llvm::makeArrayRef(ranges, 2), buffer, error);
+  EXPECT_EQ(std::vector<size_t>({16, 16}), bytes_read);
+  EXPECT_TRUE(error.Success());
+  ExpectBytes(std::vector<uint8_t>(buffer.begin(), buffer.begin() + 16),
+              0x10010);
+  EXPECT_EQ(1u, m_process_sp->m_num_range_reads);
+  EXPECT_EQ(num_reads, m_process_sp->m_num_reads);
+}
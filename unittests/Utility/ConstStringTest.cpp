@@ -11,8 +11,106 @@
 #include "llvm/Support/FormatVariadic.h"
 #include "gtest/gtest.h"
 
+#include <string>
+#include <thread>
+#include <vector>
+
 using namespace lldb_private;
 
 TEST(ConstStringTest, format_provider) {
   EXPECT_EQ("foo", llvm::formatv("{0}", ConstString("foo")).str());
 }
+
+TEST(ConstStringTest, Uniquing) {
+  ConstString foo("foo");
+  EXPECT_EQ(foo.GetCString(), ConstString("foo").GetCString());
+  EXPECT_EQ(foo.GetCString(),
+            ConstString(llvm::StringRef("foobar", 3)).GetCString());
+  EXPECT_NE(foo.GetCString(), ConstString("foobar").GetCString());
+  EXPECT_EQ(3u, foo.GetLength());
+
+  // Embedded NUL characters are part of the string.
+  ConstString with_nul(llvm::StringRef("a\0b", 3));
+  EXPECT_EQ(3u, with_nul.GetLength());
+  EXPECT_NE(ConstString("a").GetCString(), with_nul.GetCString());
+
+  ConstString empty("");
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_NE(nullptr, empty.GetCString());
+  EXPECT_EQ(nullptr, ConstString(static_cast<const char *>(nullptr)).GetCString());
+}
+
+TEST(ConstStringTest, Hash) {
+  // The pool uses the same DJB hash as the accelerator tables.
+  EXPECT_EQ(5381u, ConstString::Hash(""));
+  EXPECT_EQ(193491849u, ConstString::Hash("foo"));
+
+  llvm::StringRef name("precomputed_hash");
+  ConstString hashed(name, ConstString::Hash(name));
+  EXPECT_EQ(ConstString(name).GetCString(), hashed.GetCString());
+  EXPECT_EQ(name, hashed.GetStringRef());
+
+  // A wrong hash still finds the pooled string, and doesn't add a second
+  // entry for a new string.
+  ConstString wrong(name, ConstString::Hash(name) + 1);
+  EXPECT_EQ(hashed.GetCString(), wrong.GetCString());
+  llvm::StringRef new_name("wrong_hash_for_new_string");
+  ConstString wrong_new(new_name, 0);
+  EXPECT_EQ(ConstString(new_name).GetCString(), wrong_new.GetCString());
+}
+
+TEST(ConstStringTest, MangledCounterpart) {
+  ConstString mangled("_Z3foov");
+  ConstString demangled;
+  demangled.SetCStringWithMangledCounterpart("foo()", mangled);
+  EXPECT_EQ("foo()", demangled.GetStringRef());
+
+  ConstString counterpart;
+  EXPECT_TRUE(demangled.GetMangledCounterpart(counterpart));
+  EXPECT_EQ(mangled, counterpart);
+  EXPECT_TRUE(mangled.GetMangledCounterpart(counterpart));
+  EXPECT_EQ(demangled, counterpart);
+
+  EXPECT_FALSE(ConstString("no_counterpart").GetMangledCounterpart(counterpart));
+}
+
+TEST(ConstStringTest, PoolStatistics) {
+  ConstString::PoolStatistics before = ConstString::GetPoolStatistics();
+  ConstString first("pool_statistics_unique_string");
+  ConstString second("pool_statistics_unique_string");
+  ConstString::PoolStatistics after = ConstString::GetPoolStatistics();
+
+  EXPECT_EQ(before.num_strings + 1, after.num_strings);
+  EXPECT_EQ(before.num_inserts + 1, after.num_inserts);
+  EXPECT_LE(before.num_hits + 1, after.num_hits);
+  EXPECT_LT(before.string_bytes, after.string_bytes);
+  EXPECT_LE(after.string_bytes, after.memory_size);
+  EXPECT_EQ(after.memory_size, ConstString::StaticMemorySize());
+}
+
+TEST(ConstStringTest, ConcurrentInsert) {
+  // Have several threads race to add the same strings, which forces the
+  // hash tables to grow while other threads are reading them.
+  const size_t num_threads = 8;
+  const size_t num_strings = 20000;
+  std::vector<std::vector<const char *>> results(num_threads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([t, &results] {
+      results[t].resize(num_strings);
+      for (size_t i = 0; i < num_strings; ++i) {
+        const size_t idx = (i + t * 997) % num_strings;
+        std::string str = "concurrent_" + std::to_string(idx);
+        results[t][idx] = ConstString(str).GetCString();
+      }
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  for (size_t i = 0; i < num_strings; ++i) {
+    EXPECT_EQ("concurrent_" + std::to_string(i), results[0][i]);
+    for (size_t t = 1; t < num_threads; ++t)
+      EXPECT_EQ(results[0][i], results[t][i]);
+  }
+}
@@ -9,6 +9,7 @@
 
 #include "TestBase.h"
 #include "lldb/Host/Host.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Testing/Support/Error.h"
 
 using namespace llgs_tests;
@@ -49,3 +50,39 @@ TEST_F(TestBase, DS_TEST(DebugserverEnv)) {
       HasValue(testing::Property(&StopReply::getKind,
                                  WaitStatus{WaitStatus::Exit, 0})));
 }
+
+TEST_F(TestBase, LLGS_TEST(MultiMemRead)) {
+  // The inferior stops when it writes to a null pointer.
+  auto ClientOr = TestClient::launch(getLogFileName(),
+                                     {getInferiorPath("thread_inferior"), "0"});
+  ASSERT_THAT_EXPECTED(ClientOr, Succeeded());
+  auto &Client = **ClientOr;
+
+  ASSERT_THAT_ERROR(Client.ListThreadsInStopReply(), Succeeded());
+  ASSERT_THAT_ERROR(Client.ContinueAll(), Succeeded());
+  auto StopReplyOr = Client.GetLatestStopReplyAs<StopReplyStop>();
+  ASSERT_THAT_EXPECTED(StopReplyOr, Succeeded());
+  const RegisterMap &ThreadPcs = StopReplyOr->getThreadPcs();
+  auto PcIt = ThreadPcs.find(StopReplyOr->getThreadId());
+  ASSERT_NE(ThreadPcs.end(), PcIt);
+  const uint64_t Pc = PcIt->second.GetAsUInt64();
+
+  std::string Hex;
+  ASSERT_THAT_ERROR(
+      Client.SendMessage(formatv("m{0:x-},20", Pc).str(), Hex), Succeeded());
+  const std::string Expected = fromHex(Hex);
+  ASSERT_EQ(0x20u, Expected.size());
+
+  // The range at address zero can't be read, the others overlap.
+  std::string Response;
+  ASSERT_THAT_ERROR(
+      Client.SendMessage(
+          formatv("MultiMemRead:ranges:{0:x-},20,0,8,{1:x-},10;", Pc, Pc + 8)
+              .str(),
+          Response),
+      Succeeded());
+  StringRef Sizes, Data;
+  std::tie(Sizes, Data) = StringRef(Response).split(';');
+  EXPECT_EQ("20,0,10", Sizes);
+  EXPECT_EQ(Expected + Expected.substr(8, 0x10), Data);
+}